@@ -0,0 +1,195 @@
+// 引入背景音訊分析器標頭檔
+#include "audioanalyzer.h"
+
+// 引入 Qt 音訊解碼器類別
+#include <QAudioDecoder>
+// 引入 Qt 音訊緩衝區類別
+#include <QAudioBuffer>
+// 引入 Qt URL 處理類別
+#include <QUrl>
+// 引入 Qt 動態陣列類別
+#include <QVector>
+
+// 在背景執行緒中執行解碼的物件（所有成員只在背景執行緒中存取）
+class AudioAnalyzer::Worker : public QObject
+{
+public:
+    explicit Worker(AudioAnalyzer* owner)
+        : owner(owner)
+        , decoder(nullptr)
+        , requestId(-1)
+    {
+    }
+
+    // 開始解碼，取消正在進行的解碼
+    void start(int id, const QString& audioFilePath, const QList<QSharedPointer<AudioAnalysisPass>>& analysisPasses)
+    {
+        stop();
+
+        if (!decoder) {
+            decoder = new QAudioDecoder(this);
+            connect(decoder, &QAudioDecoder::bufferReady, this, [this]() { readBuffers(); });
+            connect(decoder, &QAudioDecoder::finished, this, [this]() {
+                readBuffers();
+                complete(true);
+            });
+            connect(decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this,
+                    [this](QAudioDecoder::Error) { complete(false); });
+
+            // 要求解碼器直接輸出分析步驟使用的格式，不符時在 convert() 中轉換
+            QAudioFormat format;
+            format.setSampleFormat(QAudioFormat::Float);
+            format.setChannelCount(CHANNELS);
+            format.setSampleRate(SAMPLE_RATE);
+            decoder->setAudioFormat(format);
+        }
+
+        requestId = id;
+        passes = analysisPasses;
+        decodePasses.clear();
+        for (const QSharedPointer<AudioAnalysisPass>& pass : passes) {
+            if (pass->prepare(audioFilePath)) {
+                decodePasses.append(pass);
+            }
+        }
+        if (decodePasses.isEmpty()) {
+            complete(true);
+            return;
+        }
+        decoder->setSource(QUrl::fromLocalFile(audioFilePath));
+        decoder->start();
+    }
+
+    // 取消正在進行的解碼
+    void stop()
+    {
+        if (requestId < 0) {
+            return;
+        }
+        decoder->stop();
+        complete(false);
+    }
+
+private:
+    // 讀取所有已解碼的緩衝區並交給分析步驟
+    void readBuffers()
+    {
+        while (requestId >= 0 && decoder->bufferAvailable()) {
+            const QAudioBuffer buffer = decoder->read();
+            const qsizetype frames = buffer.frameCount();
+            if (frames <= 0) {
+                continue;
+            }
+
+            const QAudioFormat format = buffer.format();
+            const float* samples = nullptr;
+            if (format.sampleFormat() == QAudioFormat::Float && format.channelCount() == CHANNELS) {
+                samples = buffer.constData<float>();
+            } else {
+                samples = convert(buffer);
+            }
+            for (const QSharedPointer<AudioAnalysisPass>& pass : decodePasses) {
+                pass->process(samples, frames, format.sampleRate());
+            }
+        }
+    }
+
+    // 將其他格式的緩衝區轉成雙聲道浮點數（單聲道複製到兩個聲道，多聲道只取前兩個）
+    const float* convert(const QAudioBuffer& buffer)
+    {
+        const QAudioFormat format = buffer.format();
+        const int channels = qMax(1, format.channelCount());
+        const int bytesPerSample = format.bytesPerSample();
+        const qsizetype frames = buffer.frameCount();
+        const char* data = buffer.constData<char>();
+
+        scratch.resize(frames * CHANNELS);
+        for (qsizetype frame = 0; frame < frames; frame++) {
+            const char* frameData = data + frame * format.bytesPerFrame();
+            const float left = format.normalizedSampleValue(frameData);
+            const float right = channels > 1 ? format.normalizedSampleValue(frameData + bytesPerSample) : left;
+            scratch[frame * CHANNELS] = left;
+            scratch[frame * CHANNELS + 1] = right;
+        }
+        return scratch.constData();
+    }
+
+    // 結束目前的解碼，通知分析步驟與建立分析器的執行緒
+    void complete(bool ok)
+    {
+        if (requestId < 0) {
+            return;
+        }
+        const int id = requestId;
+        requestId = -1;
+        for (const QSharedPointer<AudioAnalysisPass>& pass : passes) {
+            pass->finish(ok);
+        }
+        passes.clear();
+        decodePasses.clear();
+
+        AudioAnalyzer* analyzer = owner;
+        QMetaObject::invokeMethod(analyzer, [analyzer, id, ok]() {
+            if (analyzer->activeRequestId == id) {
+                analyzer->activeRequestId = -1;
+            }
+            emit analyzer->finished(id, ok);
+        }, Qt::QueuedConnection);
+    }
+
+    // 建立此物件的分析器
+    AudioAnalyzer* owner;
+    // 音訊解碼器（第一次分析時建立）
+    QAudioDecoder* decoder;
+    // 目前的分析編號（-1 表示沒有）
+    int requestId;
+    // 目前的分析步驟與其中需要樣本的分析步驟
+    QList<QSharedPointer<AudioAnalysisPass>> passes;
+    QList<QSharedPointer<AudioAnalysisPass>> decodePasses;
+    // 格式轉換用的暫存區
+    QVector<float> scratch;
+};
+
+AudioAnalyzer::AudioAnalyzer(QObject* parent)
+    : QObject(parent)
+    , worker(new Worker(this))
+    , nextRequestId(1)
+    , activeRequestId(-1)
+{
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    // 分析不急，讓出 CPU 給播放與介面
+    thread.start(QThread::LowPriority);
+}
+
+AudioAnalyzer::~AudioAnalyzer()
+{
+    // 在背景執行緒中停止解碼，之後不再發出信號
+    Worker* decodeWorker = worker;
+    QMetaObject::invokeMethod(worker, [decodeWorker]() { decodeWorker->stop(); });
+    thread.quit();
+    thread.wait();
+}
+
+int AudioAnalyzer::analyze(const QString& audioFilePath, const QList<QSharedPointer<AudioAnalysisPass>>& passes)
+{
+    const int id = nextRequestId++;
+    activeRequestId = id;
+
+    Worker* decodeWorker = worker;
+    QMetaObject::invokeMethod(worker, [decodeWorker, id, audioFilePath, passes]() {
+        decodeWorker->start(id, audioFilePath, passes);
+    });
+    return id;
+}
+
+void AudioAnalyzer::cancel()
+{
+    Worker* decodeWorker = worker;
+    QMetaObject::invokeMethod(worker, [decodeWorker]() { decodeWorker->stop(); });
+}
+
+bool AudioAnalyzer::isBusy() const
+{
+    return activeRequestId >= 0;
+}
@@ -0,0 +1,78 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef AUDIOANALYZER_H
+#define AUDIOANALYZER_H
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt 執行緒類別
+#include <QThread>
+// 引入 Qt 共享指標類別
+#include <QSharedPointer>
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 音訊分析步驟
+//
+// 由 AudioAnalyzer 在背景執行緒中呼叫：解碼開始前呼叫一次 prepare()，解碼出的樣本
+// 依序交給 process()，解碼結束時呼叫一次 finish()。同一個檔案的多個分析步驟共用同一次解碼；
+// 所有分析步驟都不需要樣本時不會解碼。
+class AudioAnalysisPass
+{
+public:
+    virtual ~AudioAnalysisPass() = default;
+    // 解碼開始前的準備（可以讀取檔案），回傳 false 表示不需要樣本（仍會呼叫 finish()）
+    virtual bool prepare(const QString& audioFilePath) { Q_UNUSED(audioFilePath); return true; }
+
+    // 一段解碼後的樣本：交錯的雙聲道浮點數（frames × 2 個值，範圍 -1.0 ~ 1.0）
+    virtual void process(const float* samples, qsizetype frames, int sampleRate) = 0;
+    // 解碼結束，ok 為 false 表示解碼失敗或被取消（結果不完整）
+    virtual void finish(bool ok) = 0;
+};
+
+// 背景音訊分析器
+//
+// 以 QAudioDecoder 在專屬的低優先權執行緒中解碼音訊檔案，
+// 樣本統一轉成 48 kHz 雙聲道浮點數後交給各個 AudioAnalysisPass，GUI 執行緒與播放不受影響。
+// 一次只分析一個檔案，新的 analyze() 會取消正在進行的分析；
+// 結束時在建立分析器的執行緒中發出 finished()，之後才可以讀取分析步驟的結果。
+class AudioAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 交給分析步驟的取樣率與聲道數
+    static const int SAMPLE_RATE = 48000;
+    static const int CHANNELS = 2;
+
+    // 建構函式，啟動背景執行緒
+    explicit AudioAnalyzer(QObject* parent = nullptr);
+    // 解構函式，取消分析並等待背景執行緒結束
+    ~AudioAnalyzer() override;
+
+    // 開始分析檔案，回傳分析編號（finished() 信號中使用）
+    int analyze(const QString& audioFilePath, const QList<QSharedPointer<AudioAnalysisPass>>& passes);
+    // 取消正在進行的分析（仍會以 ok 為 false 發出 finished()）
+    void cancel();
+    // 是否有尚未結束的分析
+    bool isBusy() const;
+
+signals:
+    // 分析結束，ok 為 false 表示解碼失敗或被取消
+    void finished(int requestId, bool ok);
+
+private:
+    // 在背景執行緒中執行解碼的物件，定義於 audioanalyzer.cpp
+    class Worker;
+
+    // 背景執行緒
+    QThread thread;
+    // 背景執行緒中的解碼物件
+    Worker* worker;
+    // 下一個分析編號
+    int nextRequestId;
+    // 最近一次送出、尚未結束的分析編號（-1 表示沒有）
+    int activeRequestId;
+};
+
+// 結束標頭檔保護宏
+#endif // AUDIOANALYZER_H
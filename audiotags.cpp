@@ -0,0 +1,533 @@
+// 引入音訊標籤讀取標頭檔
+#include "audiotags.h"
+
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 記憶體緩衝裝置類別
+#include <QBuffer>
+// 引入 Qt 位元組序轉換函式
+#include <QtEndian>
+// 引入 C 字串函式（memcmp）
+#include <cstring>
+
+namespace {
+    // 單一標籤區塊的讀取上限，避免損毀的檔案宣告巨大長度
+    const qint64 MAX_TAG_BYTES = 16 * 1024 * 1024;
+    // 尋找 Ogg 註解標頭時最多檢查的頁數
+    const int MAX_OGG_PAGES = 64;
+
+    const uchar* bytes(const QByteArray& data)
+    {
+        return reinterpret_cast<const uchar*>(data.constData());
+    }
+
+    // ID3v2 的 syncsafe 整數（每個位元組只用低 7 位元）
+    qint64 syncSafe(const uchar* p)
+    {
+        return (qint64(p[0] & 0x7f) << 21) | (qint64(p[1] & 0x7f) << 14) |
+               (qint64(p[2] & 0x7f) << 7) | qint64(p[3] & 0x7f);
+    }
+
+    // 還原 ID3v2 的 unsynchronisation（移除 0xFF 後插入的 0x00）
+    QByteArray removeUnsynchronisation(const QByteArray& data)
+    {
+        QByteArray result;
+        result.reserve(data.size());
+        for (int i = 0; i < data.size(); i++) {
+            result.append(data[i]);
+            if (uchar(data[i]) == 0xFF && i + 1 < data.size() && data[i + 1] == '\0') {
+                i++;
+            }
+        }
+        return result;
+    }
+
+    // 解碼 UTF-16 文字，遇到結尾的空字元即停止（多值欄位只取第一個）
+    QString decodeUtf16(const QByteArray& data, bool bigEndian)
+    {
+        int offset = 0;
+        if (data.size() >= 2) {
+            const uchar* p = bytes(data);
+            if (p[0] == 0xFF && p[1] == 0xFE) {
+                bigEndian = false;
+                offset = 2;
+            } else if (p[0] == 0xFE && p[1] == 0xFF) {
+                bigEndian = true;
+                offset = 2;
+            }
+        }
+
+        QString text;
+        const int units = (data.size() - offset) / 2;
+        text.reserve(units);
+        for (int i = 0; i < units; i++) {
+            const uchar* p = bytes(data) + offset + i * 2;
+            const ushort unit = bigEndian ? ushort((p[0] << 8) | p[1]) : ushort((p[1] << 8) | p[0]);
+            if (unit == 0) {
+                break;
+            }
+            text.append(QChar(unit));
+        }
+        return text;
+    }
+
+    // 截斷到第一個空字元
+    QByteArray untilNull(const QByteArray& data)
+    {
+        const int end = data.indexOf('\0');
+        return end < 0 ? data : data.left(end);
+    }
+
+    // 解碼 ID3v2 文字訊框（第一個位元組為編碼方式）
+    QString decodeId3Text(const QByteArray& payload)
+    {
+        if (payload.isEmpty()) {
+            return QString();
+        }
+        const QByteArray body = payload.mid(1);
+        switch (uchar(payload[0])) {
+        case 1:  // UTF-16，附 BOM
+            return decodeUtf16(body, false).trimmed();
+        case 2:  // UTF-16BE
+            return decodeUtf16(body, true).trimmed();
+        case 3:  // UTF-8
+            return QString::fromUtf8(untilNull(body)).trimmed();
+        default: // ISO-8859-1
+            return QString::fromLatin1(untilNull(body)).trimmed();
+        }
+    }
+
+    // 依序走訪 ID3v2 訊框，只讀取標題與藝術家，其餘訊框（例如封面圖片）直接跳過
+    void readId3Frames(QIODevice& device, qint64 end, int majorVersion, AudioTags& tags)
+    {
+        const int idLength = majorVersion == 2 ? 3 : 4;
+        const int headerLength = majorVersion == 2 ? 6 : 10;
+        QString albumArtist;
+
+        while (device.pos() + headerLength <= end) {
+            const QByteArray header = device.read(headerLength);
+            // 讀到填充區（全為 0）代表訊框已結束
+            if (header.size() < headerLength || header[0] == '\0') {
+                break;
+            }
+
+            const uchar* h = bytes(header);
+            const QByteArray id = header.left(idLength);
+            qint64 size = 0;
+            quint16 flags = 0;
+            if (majorVersion == 2) {
+                size = (qint64(h[3]) << 16) | (qint64(h[4]) << 8) | h[5];
+            } else if (majorVersion == 3) {
+                size = qFromBigEndian<quint32>(h + 4);
+                flags = quint16((h[8] << 8) | h[9]);
+            } else {
+                size = syncSafe(h + 4);
+                flags = quint16((h[8] << 8) | h[9]);
+            }
+            if (size <= 0 || device.pos() + size > end) {
+                break;
+            }
+
+            const bool isTitle = id == "TIT2" || id == "TT2";
+            const bool isArtist = id == "TPE1" || id == "TP1";
+            const bool isAlbumArtist = id == "TPE2" || id == "TP2";
+            if (!isTitle && !isArtist && !isAlbumArtist) {
+                if (!device.seek(device.pos() + size)) {
+                    break;
+                }
+                continue;
+            }
+
+            QByteArray payload = device.read(size);
+            if (majorVersion == 3) {
+                // 壓縮或加密的訊框不處理；群組訊框前有一個群組編號
+                if (flags & 0x00C0) {
+                    continue;
+                }
+                if (flags & 0x0020) {
+                    payload.remove(0, 1);
+                }
+            } else if (majorVersion == 4) {
+                if (flags & 0x000C) {
+                    continue;
+                }
+                if (flags & 0x0040) {
+                    payload.remove(0, 1);
+                }
+                if (flags & 0x0001) {
+                    payload.remove(0, 4);
+                }
+                if (flags & 0x0002) {
+                    payload = removeUnsynchronisation(payload);
+                }
+            }
+
+            const QString text = decodeId3Text(payload);
+            if (isTitle && tags.title.isEmpty()) {
+                tags.title = text;
+            } else if (isArtist && tags.artist.isEmpty()) {
+                tags.artist = text;
+            } else if (isAlbumArtist && albumArtist.isEmpty()) {
+                albumArtist = text;
+            }
+            if (!tags.title.isEmpty() && !tags.artist.isEmpty()) {
+                return;
+            }
+        }
+
+        if (tags.artist.isEmpty()) {
+            tags.artist = albumArtist;
+        }
+    }
+
+    // 跳過 ID3v2 的擴充標頭，無法解析時回傳 false
+    bool skipId3ExtendedHeader(QIODevice& device, int majorVersion, quint8 flags)
+    {
+        if (!(flags & 0x40)) {
+            return true;
+        }
+        // v2.2 的這個旗標代表整個標籤經過壓縮
+        if (majorVersion == 2) {
+            return false;
+        }
+        const QByteArray sizeBytes = device.read(4);
+        if (sizeBytes.size() < 4) {
+            return false;
+        }
+        // v2.3 的長度不含長度欄位本身，v2.4 則包含且為 syncsafe
+        if (majorVersion == 3) {
+            return device.seek(device.pos() + qFromBigEndian<quint32>(bytes(sizeBytes)));
+        }
+        return device.seek(device.pos() - 4 + syncSafe(bytes(sizeBytes)));
+    }
+
+    // 讀取檔案開頭的 ID3v2 標籤，回傳標籤結束的位置（沒有標籤時為 0）
+    qint64 readId3v2(QFile& file, AudioTags& tags)
+    {
+        file.seek(0);
+        const QByteArray header = file.read(10);
+        if (header.size() < 10 || !header.startsWith("ID3")) {
+            return 0;
+        }
+
+        const uchar* h = bytes(header);
+        const int majorVersion = h[3];
+        const quint8 flags = h[5];
+        const qint64 tagSize = syncSafe(h + 6);
+        // v2.4 可能在標籤後附加 10 位元組的頁尾
+        const qint64 tagEnd = 10 + tagSize + ((majorVersion == 4 && (flags & 0x10)) ? 10 : 0);
+        if (majorVersion < 2 || majorVersion > 4) {
+            return tagEnd;
+        }
+
+        if (majorVersion < 4 && (flags & 0x80)) {
+            // 整個標籤經過 unsynchronisation，先讀入記憶體還原後再解析
+            if (tagSize > MAX_TAG_BYTES) {
+                return tagEnd;
+            }
+            QByteArray body = removeUnsynchronisation(file.read(tagSize));
+            QBuffer buffer(&body);
+            buffer.open(QIODevice::ReadOnly);
+            if (skipId3ExtendedHeader(buffer, majorVersion, flags)) {
+                readId3Frames(buffer, body.size(), majorVersion, tags);
+            }
+        } else if (skipId3ExtendedHeader(file, majorVersion, flags)) {
+            readId3Frames(file, 10 + tagSize, majorVersion, tags);
+        }
+        return tagEnd;
+    }
+
+    // 讀取檔案結尾的 ID3v1 標籤，只補上尚未取得的欄位
+    void readId3v1(QFile& file, AudioTags& tags)
+    {
+        if (file.size() < 128 || !file.seek(file.size() - 128)) {
+            return;
+        }
+        const QByteArray tag = file.read(128);
+        if (tag.size() < 128 || !tag.startsWith("TAG")) {
+            return;
+        }
+
+        auto field = [&tag](int offset) {
+            return QString::fromLatin1(untilNull(tag.mid(offset, 30))).trimmed();
+        };
+        if (tags.title.isEmpty()) {
+            tags.title = field(3);
+        }
+        if (tags.artist.isEmpty()) {
+            tags.artist = field(33);
+        }
+    }
+
+    // 解析 Vorbis 註解（FLAC 與 Ogg 共用，整數皆為小端序）
+    void readVorbisComment(const QByteArray& data, AudioTags& tags)
+    {
+        const uchar* p = bytes(data);
+        const qint64 size = data.size();
+        qint64 pos = 0;
+        auto readLength = [&](quint32& value) {
+            if (pos + 4 > size) {
+                return false;
+            }
+            value = qFromLittleEndian<quint32>(p + pos);
+            pos += 4;
+            return true;
+        };
+
+        quint32 vendorLength = 0;
+        if (!readLength(vendorLength) || pos + vendorLength > size) {
+            return;
+        }
+        pos += vendorLength;
+
+        quint32 count = 0;
+        if (!readLength(count)) {
+            return;
+        }
+
+        QString albumArtist;
+        for (quint32 i = 0; i < count; i++) {
+            quint32 length = 0;
+            if (!readLength(length) || pos + length > size) {
+                break;
+            }
+            const QByteArray field = QByteArray::fromRawData(data.constData() + pos, static_cast<int>(length));
+            pos += length;
+
+            const int separator = field.indexOf('=');
+            if (separator <= 0) {
+                continue;
+            }
+            const QByteArray key = field.left(separator).toUpper();
+            if (key == "TITLE" && tags.title.isEmpty()) {
+                tags.title = QString::fromUtf8(field.mid(separator + 1)).trimmed();
+            } else if (key == "ARTIST" && tags.artist.isEmpty()) {
+                tags.artist = QString::fromUtf8(field.mid(separator + 1)).trimmed();
+            } else if (key == "ALBUMARTIST" && albumArtist.isEmpty()) {
+                albumArtist = QString::fromUtf8(field.mid(separator + 1)).trimmed();
+            }
+        }
+
+        if (tags.artist.isEmpty()) {
+            tags.artist = albumArtist;
+        }
+    }
+
+    // 讀取 FLAC 的 VORBIS_COMMENT 區塊，offset 處不是 FLAC 串流時回傳 false
+    bool readFlac(QFile& file, qint64 offset, AudioTags& tags)
+    {
+        if (!file.seek(offset) || file.read(4) != "fLaC") {
+            return false;
+        }
+
+        while (true) {
+            const QByteArray header = file.read(4);
+            if (header.size() < 4) {
+                break;
+            }
+            const uchar* h = bytes(header);
+            const bool isLast = (h[0] & 0x80) != 0;
+            const int type = h[0] & 0x7f;
+            const qint64 length = (qint64(h[1]) << 16) | (qint64(h[2]) << 8) | h[3];
+
+            // 區塊類型 4 為 VORBIS_COMMENT
+            if (type == 4) {
+                readVorbisComment(file.read(length), tags);
+                break;
+            }
+            if (isLast || !file.seek(file.pos() + length)) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    // 讀取 Ogg 串流的第二個封包（Vorbis 或 Opus 的註解標頭）
+    bool readOgg(QFile& file, AudioTags& tags)
+    {
+        file.seek(0);
+        QByteArray packet;
+        int packetIndex = 0;
+        quint32 streamSerial = 0;
+        bool hasSerial = false;
+
+        for (int page = 0; page < MAX_OGG_PAGES; page++) {
+            const QByteArray header = file.read(27);
+            if (header.size() < 27 || !header.startsWith("OggS")) {
+                return false;
+            }
+            const uchar* h = bytes(header);
+            const quint32 serial = qFromLittleEndian<quint32>(h + 14);
+            const int segmentCount = h[26];
+            const QByteArray segments = file.read(segmentCount);
+            if (segments.size() < segmentCount) {
+                return false;
+            }
+
+            // 多路串流時只追蹤第一個邏輯串流
+            if (!hasSerial) {
+                streamSerial = serial;
+                hasSerial = true;
+            }
+            if (serial != streamSerial) {
+                qint64 bodySize = 0;
+                for (int i = 0; i < segmentCount; i++) {
+                    bodySize += uchar(segments[i]);
+                }
+                file.seek(file.pos() + bodySize);
+                continue;
+            }
+
+            for (int i = 0; i < segmentCount; i++) {
+                const int length = uchar(segments[i]);
+                if (packetIndex == 1 && packet.size() < MAX_TAG_BYTES) {
+                    packet.append(file.read(length));
+                } else {
+                    file.seek(file.pos() + length);
+                }
+                // 長度小於 255 的區段代表封包結束
+                if (length < 255) {
+                    if (packetIndex == 1) {
+                        if (packet.startsWith("\x03" "vorbis")) {
+                            readVorbisComment(packet.mid(7), tags);
+                        } else if (packet.startsWith("OpusTags")) {
+                            readVorbisComment(packet.mid(8), tags);
+                        }
+                        return true;
+                    }
+                    packetIndex++;
+                }
+            }
+        }
+        return false;
+    }
+
+    // 在 [begin, end) 範圍內尋找指定類型的 MP4 atom，找到時回傳其內容範圍
+    bool findAtom(QFile& file, qint64 begin, qint64 end, const char* type,
+                  qint64& contentBegin, qint64& contentEnd)
+    {
+        qint64 pos = begin;
+        while (pos + 8 <= end) {
+            if (!file.seek(pos)) {
+                return false;
+            }
+            const QByteArray header = file.read(8);
+            if (header.size() < 8) {
+                return false;
+            }
+
+            qint64 size = qFromBigEndian<quint32>(bytes(header));
+            qint64 headerSize = 8;
+            if (size == 1) {
+                // 64 位元長度
+                const QByteArray largeSize = file.read(8);
+                if (largeSize.size() < 8) {
+                    return false;
+                }
+                size = static_cast<qint64>(qFromBigEndian<quint64>(bytes(largeSize)));
+                headerSize = 16;
+            } else if (size == 0) {
+                // 長度 0 代表延伸到範圍結尾
+                size = end - pos;
+            }
+            if (size < headerSize || size > end - pos) {
+                return false;
+            }
+
+            if (memcmp(header.constData() + 4, type, 4) == 0) {
+                contentBegin = pos + headerSize;
+                contentEnd = pos + size;
+                return true;
+            }
+            pos += size;
+        }
+        return false;
+    }
+
+    // 讀取 ilst 項目中 data atom 的文字
+    QString readMp4Text(QFile& file, qint64 begin, qint64 end)
+    {
+        qint64 dataBegin = 0;
+        qint64 dataEnd = 0;
+        if (!findAtom(file, begin, end, "data", dataBegin, dataEnd) ||
+            dataEnd - dataBegin < 8 || dataEnd - dataBegin > MAX_TAG_BYTES) {
+            return QString();
+        }
+
+        file.seek(dataBegin);
+        const QByteArray data = file.read(dataEnd - dataBegin);
+        if (data.size() < 8) {
+            return QString();
+        }
+        // 前 4 位元組的低 24 位元為資料型別，接著 4 位元組的語系欄位
+        const quint32 dataType = qFromBigEndian<quint32>(bytes(data)) & 0x00FFFFFF;
+        const QByteArray payload = data.mid(8);
+        if (dataType == 2) {
+            return decodeUtf16(payload, true).trimmed();
+        }
+        return QString::fromUtf8(payload).trimmed();
+    }
+
+    // 讀取 MP4 的 moov/udta/meta/ilst 標籤
+    bool readMp4(QFile& file, AudioTags& tags)
+    {
+        qint64 begin = 0;
+        qint64 end = file.size();
+        if (!findAtom(file, begin, end, "moov", begin, end) ||
+            !findAtom(file, begin, end, "udta", begin, end) ||
+            !findAtom(file, begin, end, "meta", begin, end)) {
+            return false;
+        }
+
+        // meta 通常是 full box（前 4 位元組為版本與旗標），QuickTime 產生的檔案則沒有
+        file.seek(begin + 4);
+        if (file.read(4) != "hdlr") {
+            begin += 4;
+        }
+        if (!findAtom(file, begin, end, "ilst", begin, end)) {
+            return false;
+        }
+
+        qint64 itemBegin = 0;
+        qint64 itemEnd = 0;
+        if (findAtom(file, begin, end, "\xA9" "nam", itemBegin, itemEnd)) {
+            tags.title = readMp4Text(file, itemBegin, itemEnd);
+        }
+        if (findAtom(file, begin, end, "\xA9" "ART", itemBegin, itemEnd)) {
+            tags.artist = readMp4Text(file, itemBegin, itemEnd);
+        }
+        if (tags.artist.isEmpty() && findAtom(file, begin, end, "aART", itemBegin, itemEnd)) {
+            tags.artist = readMp4Text(file, itemBegin, itemEnd);
+        }
+        return true;
+    }
+}
+
+bool readAudioTags(const QString& filePath, AudioTags& tags)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray magic = file.read(12);
+    if (magic.startsWith("ID3")) {
+        const qint64 tagEnd = readId3v2(file, tags);
+        // 有些 FLAC 檔案前面也帶有 ID3v2；欄位仍不齊時再看檔尾的 ID3v1
+        if (tags.title.isEmpty() || tags.artist.isEmpty()) {
+            if (!readFlac(file, tagEnd, tags)) {
+                readId3v1(file, tags);
+            }
+        }
+    } else if (magic.startsWith("fLaC")) {
+        readFlac(file, 0, tags);
+    } else if (magic.startsWith("OggS")) {
+        readOgg(file, tags);
+    } else if (magic.mid(4, 4) == "ftyp") {
+        readMp4(file, tags);
+    } else {
+        readId3v1(file, tags);
+    }
+
+    return !tags.title.isEmpty() || !tags.artist.isEmpty();
+}
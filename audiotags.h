@@ -0,0 +1,26 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef AUDIOTAGS_H
+#define AUDIOTAGS_H
+
+// 引入 Qt 字串類別
+#include <QString>
+
+// 音訊檔案內嵌的標籤資訊
+struct AudioTags {
+    QString title;    // 標題
+    QString artist;   // 藝術家（沒有時退回專輯藝術家）
+};
+
+// 讀取音訊檔案內嵌的標籤
+//
+// 依檔案開頭的魔術字判斷格式，不依賴副檔名：
+//   ID3v2（v2.2/v2.3/v2.4）與 ID3v1   MP3、AAC 等
+//   FLAC 的 VORBIS_COMMENT 區塊       FLAC（含前置 ID3v2 的檔案）
+//   Ogg 的註解標頭                    Ogg Vorbis、Opus
+//   MP4 的 moov/udta/meta/ilst        M4A、AAC in MP4
+// 只讀取需要的區塊，封面圖片等大型資料以 seek 跳過。
+// 讀到標題或藝術家任一欄位時回傳 true。
+bool readAudioTags(const QString& filePath, AudioTags& tags);
+
+// 結束標頭檔保護宏
+#endif // AUDIOTAGS_H
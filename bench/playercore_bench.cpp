@@ -0,0 +1,353 @@
+// 播放器核心效能測試
+//
+// 以合成的曲庫（1k ~ 1M 首）與數小時長的字幕量測 playercore 的熱點：
+// 播放清單的儲存與載入、重複曲目檢查、隨機播放抽選、全文搜尋、SRT 載入與字幕清單建立。
+// 結果以 JSON 輸出（格式與 Google Benchmark 相近），可保存下來比較各版本的差異。
+// 用法：playercore_bench [--tracks 1000,10000,100000] [--srt-hours 1,3] [--iterations 5] [--out 檔案]
+
+// 引入播放清單持久化引擎
+#include "../playliststore.h"
+// 引入播放順序
+#include "../playorder.h"
+// 引入字幕解析器
+#include "../subtitleparser.h"
+// 引入字幕段落資料模型
+#include "../subtitlemodel.h"
+// 引入全文搜尋索引
+#include "../searchindex.h"
+
+// 引入 Qt 核心應用程式類別
+#include <QCoreApplication>
+// 引入 Qt 命令列解析類別
+#include <QCommandLineParser>
+// 引入 Qt 計時器類別
+#include <QElapsedTimer>
+// 引入 Qt 暫存目錄類別
+#include <QTemporaryDir>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 目錄處理類別
+#include <QDir>
+// 引入 Qt 日期時間類別
+#include <QDateTime>
+// 引入 Qt 系統資訊類別
+#include <QSysInfo>
+// 引入 Qt 執行緒類別
+#include <QThread>
+// 引入 Qt JSON 類別
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+// 引入 Qt 文字串流類別
+#include <QTextStream>
+// 引入 C++ 演算法函式庫
+#include <algorithm>
+
+namespace {
+    // 每個字幕段落的長度（毫秒），與 Whisper 的典型分段相近
+    const qint64 CUE_DURATION_MS = 2500;
+    // 隨機播放抽選的次數（模擬一段聆聽過程）
+    const int SHUFFLE_DRAWS = 1000;
+    // 曲庫中每個資料夾的曲目數（讓路徑前綴與頻道名稱有重複，接近真實曲庫）
+    const int TRACKS_PER_FOLDER = 12;
+    // 每隔多少首曲目有一份一小時的字幕（10 萬首時約有兩千萬個字幕詞）
+    const int TRANSCRIBED_TRACK_INTERVAL = 100;
+
+    // 一項量測結果
+    struct Result {
+        QString name;
+        int iterations;
+        double bestMs;
+        double meanMs;
+        qint64 items;
+    };
+
+    // 執行多次，記錄最短與平均耗時（毫秒）
+    template <typename Function>
+    Result measure(const QString& name, int iterations, qint64 items, Function function)
+    {
+        double best = 1e30;
+        double total = 0.0;
+        for (int i = 0; i < iterations; i++) {
+            QElapsedTimer timer;
+            timer.start();
+            function();
+            const double elapsed = timer.nsecsElapsed() / 1e6;
+            best = std::min(best, elapsed);
+            total += elapsed;
+        }
+        return Result{ name, iterations, best, total / iterations, items };
+    }
+
+    // 產生指定曲目數的合成曲庫：一個包含全部曲目的播放清單
+    Playlist makePlaylist(int tracks)
+    {
+        QList<VideoInfo> videos;
+        videos.reserve(tracks);
+        for (int i = 0; i < tracks; i++) {
+            const int folder = i / TRACKS_PER_FOLDER;
+            VideoInfo video;
+            video.filePath = QString("/home/user/Music/Artist %1/Album %2/%3 - Track %4.flac")
+                                 .arg(folder % 997).arg(folder).arg(i % TRACKS_PER_FOLDER + 1, 2, 10, QChar('0')).arg(i);
+            video.title = QString("Track %1 第 %2 首").arg(i).arg(i % TRACKS_PER_FOLDER + 1);
+            video.channelTitle = QString("Artist %1").arg(folder % 997);
+            video.isFavorite = (i % 17) == 0;
+            video.isLocalFile = true;
+            videos.append(video);
+        }
+        Playlist playlist;
+        playlist.name = "Library";
+        playlist.setVideos(videos);
+        return playlist;
+    }
+
+    QString formatTimestamp(qint64 ms)
+    {
+        return QString("%1:%2:%3,%4")
+            .arg(ms / 3600000, 2, 10, QChar('0'))
+            .arg(ms / 60000 % 60, 2, 10, QChar('0'))
+            .arg(ms / 1000 % 60, 2, 10, QChar('0'))
+            .arg(ms % 1000, 3, 10, QChar('0'));
+    }
+
+    // 產生指定長度的合成 SRT（中英混合的文字）
+    QString makeSrt(int hours)
+    {
+        QString srt;
+        QTextStream out(&srt);
+        const qint64 totalMs = qint64(hours) * 3600000;
+        int sequence = 1;
+        for (qint64 start = 0; start < totalMs; start += CUE_DURATION_MS) {
+            out << sequence << "\n"
+                << formatTimestamp(start) << " --> " << formatTimestamp(start + CUE_DURATION_MS) << "\n"
+                << "第 " << sequence << " 段：今天我們討論 lecture topic number " << sequence % 97 << "\n\n";
+            sequence++;
+        }
+        out.flush();
+        return srt;
+    }
+
+    // 解析以逗號分隔的正整數清單
+    QList<int> parseSizes(const QString& text)
+    {
+        QList<int> sizes;
+        for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+            const int value = part.trimmed().toInt();
+            if (value > 0) {
+                sizes.append(value);
+            }
+        }
+        return sizes;
+    }
+
+    // 播放清單相關的量測
+    void benchPlaylists(int tracks, int iterations, const QString& directory, QList<Result>& results)
+    {
+        const QString suffix = "/" + QString::number(tracks);
+        const Playlist library = makePlaylist(tracks);
+        // 曲目數多時減少重複次數，避免單項量測耗時過長
+        const int slowIterations = tracks >= 1000000 ? qMin(iterations, 2) : iterations;
+
+        // 儲存：壓縮成完整快照並重建二進位快取（savePlaylistsToFile 的實際路徑）
+        const QString storeDirectory = QDir(directory).filePath("store" + QString::number(tracks));
+        QDir().mkpath(storeDirectory);
+        results.append(measure("store/save" + suffix, slowIterations, tracks, [&]() {
+            PlaylistStore store(storeDirectory);
+            store.setSnapshotProvider([&library]() {
+                PlaylistSnapshot snapshot;
+                snapshot.playlists = { library };
+                snapshot.lastPlaylistName = library.name;
+                return snapshot;
+            });
+            store.compact();
+            store.flush();
+        }));
+
+        // 載入：映射二進位快取（loadPlaylistsFromFile），再展開全部曲目
+        results.append(measure("store/load" + suffix, iterations, tracks, [&]() {
+            PlaylistStore store(storeDirectory);
+            PlaylistSnapshot snapshot;
+            store.load(snapshot);
+        }));
+        results.append(measure("store/load_materialize" + suffix, slowIterations, tracks, [&]() {
+            PlaylistStore store(storeDirectory);
+            PlaylistSnapshot snapshot;
+            store.load(snapshot);
+            for (Playlist& playlist : snapshot.playlists) {
+                store.materialize(playlist);
+            }
+        }));
+
+        // 快取不存在時的 JSON 快照解析
+        QFile snapshotFile(QDir(storeDirectory).filePath("youtube_playlists.json"));
+        snapshotFile.open(QIODevice::ReadOnly);
+        const QByteArray json = snapshotFile.readAll();
+        snapshotFile.close();
+        results.append(measure("store/parse_json" + suffix, slowIterations, tracks, [&]() {
+            PlaylistSnapshot snapshot;
+            PlaylistStore::parseSnapshot(json, snapshot);
+        }));
+
+        // 重複曲目檢查：建立雜湊索引後查詢每首曲目，一半已存在、一半不存在
+        results.append(measure("playlist/duplicates" + suffix, iterations, tracks, [&]() {
+            Playlist playlist = library;
+            playlist.setVideos(library.videos);
+            int found = 0;
+            for (int i = 0; i < tracks; i++) {
+                VideoInfo video = library.videos[i];
+                if (i % 2) {
+                    video.filePath += ".new";
+                }
+                found += playlist.contains(video) ? 1 : 0;
+            }
+            Q_UNUSED(found);
+        }));
+
+        // 隨機播放：連續前進並預看接下來的曲目，與播放下一首及 PlaybackCursor::upcoming() 相同
+        const int draws = qMin(SHUFFLE_DRAWS, tracks);
+        results.append(measure("playorder/shuffle" + suffix, iterations, draws, [&]() {
+            PlayOrder order;
+            order.reset(tracks);
+            order.setShuffle(true);
+            order.markPlayed(0);
+            for (int i = 0; i < draws; i++) {
+                order.upcoming(3);
+                order.markPlayed(order.next());
+            }
+        }));
+
+        // 隨機播放中編輯播放清單：在開頭插入與刪除曲目（列號全部位移的最壞情況）
+        results.append(measure("playorder/edit" + suffix, iterations, draws, [&]() {
+            PlayOrder order;
+            order.reset(tracks);
+            order.setShuffle(true);
+            order.markPlayed(0);
+            for (int i = 0; i < draws; i++) {
+                order.markPlayed(order.next());
+                order.trackInserted(0);
+                order.trackRemoved(1);
+            }
+        }));
+    }
+
+    // 全文搜尋的量測：收錄曲目資訊與字幕，再查詢常見與罕見的詞
+    void benchSearch(int tracks, int iterations, QList<Result>& results)
+    {
+        const QString suffix = "/" + QString::number(tracks);
+        const Playlist library = makePlaylist(tracks);
+        const SubtitleCueList transcript = SubtitleParser::parse(makeSrt(1));
+
+        SearchIndex index;
+        results.append(measure("search/build" + suffix, 1, tracks, [&]() {
+            index.clear();
+            for (const VideoInfo& video : library.videos) {
+                index.addTrack(video);
+            }
+            for (int i = 0; i < tracks; i += TRANSCRIBED_TRACK_INTERVAL) {
+                index.setTranscript(trackKey(library.videos[i]), transcript);
+            }
+        }));
+
+        // 搜尋框的一次查詢（與 onSearchTextChanged 相同的筆數上限）
+        const QStringList queries = { "Track 4242", "artist 42", "第 3 首", "我們討論", "lecture topic 42", "討論 number" };
+        results.append(measure("search/query" + suffix, iterations, queries.size(), [&]() {
+            for (const QString& query : queries) {
+                index.search(query, 200);
+            }
+        }));
+    }
+
+    // 字幕相關的量測
+    void benchSubtitles(int hours, int iterations, const QString& directory, QList<Result>& results)
+    {
+        const QString suffix = "/" + QString::number(hours) + "h";
+        const QString srtPath = QDir(directory).filePath(QString("bench%1.srt").arg(hours));
+        QFile file(srtPath);
+        file.open(QIODevice::WriteOnly);
+        file.write(makeSrt(hours).toUtf8());
+        file.close();
+
+        // 載入字幕檔案（loadSrt 的解析部分）
+        SubtitleCueList cues;
+        results.append(measure("subtitle/load_srt" + suffix, iterations, 0, [&]() {
+            bool ok = false;
+            cues = SubtitleParser::parseFile(srtPath, &ok);
+        }));
+        results.last().items = cues.size();
+
+        // 建立字幕清單並依播放位置查找段落（取代舊版產生整份字幕 HTML）
+        results.append(measure("subtitle/model" + suffix, iterations, cues.size(), [&]() {
+            SubtitleModel model;
+            model.setCues(cues);
+            const qint64 totalMs = qint64(hours) * 3600000;
+            for (qint64 position = 0; position < totalMs; position += 1000) {
+                model.setActiveRow(model.rowAt(position));
+            }
+        }));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({ "tracks", "Comma-separated library sizes.", "sizes", "1000,10000,100000" });
+    parser.addOption({ "srt-hours", "Comma-separated subtitle lengths in hours.", "hours", "1,3" });
+    parser.addOption({ "iterations", "Repetitions per measurement.", "count", "5" });
+    parser.addOption({ "out", "Write JSON to this file instead of stdout.", "file" });
+    parser.process(app);
+
+    const int iterations = qMax(1, parser.value("iterations").toInt());
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        return 1;
+    }
+
+    QList<Result> results;
+    for (int tracks : parseSizes(parser.value("tracks"))) {
+        benchPlaylists(tracks, iterations, directory.path(), results);
+        benchSearch(tracks, iterations, results);
+    }
+    for (int hours : parseSizes(parser.value("srt-hours"))) {
+        benchSubtitles(hours, iterations, directory.path(), results);
+    }
+
+    QJsonObject context;
+    context["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    context["host_name"] = QSysInfo::machineHostName();
+    context["num_cpus"] = QThread::idealThreadCount();
+    context["qt_version"] = QString(qVersion());
+    context["cpu_architecture"] = QSysInfo::currentCpuArchitecture();
+
+    QJsonArray benchmarks;
+    for (const Result& result : results) {
+        QJsonObject entry;
+        entry["name"] = result.name;
+        entry["iterations"] = result.iterations;
+        entry["real_time"] = result.bestMs;
+        entry["mean_time"] = result.meanMs;
+        entry["time_unit"] = "ms";
+        entry["items"] = static_cast<double>(result.items);
+        benchmarks.append(entry);
+    }
+
+    QJsonObject root;
+    root["context"] = context;
+    root["benchmarks"] = benchmarks;
+    const QByteArray json = QJsonDocument(root).toJson();
+
+    if (parser.isSet("out")) {
+        QFile out(parser.value("out"));
+        if (!out.open(QIODevice::WriteOnly)) {
+            return 1;
+        }
+        out.write(json);
+    } else {
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+        out.write(json);
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+// 字幕解析效能測試
+//
+// 產生數小時長的合成 SRT 字幕，比較串流解析器與舊版逐行正規表達式解析的耗時。
+// 用法：subtitleparser_bench [小時數] [重複次數]
+
+// 引入字幕解析器
+#include "../subtitleparser.h"
+
+// 引入 Qt 核心應用程式類別
+#include <QCoreApplication>
+// 引入 Qt 計時器類別
+#include <QElapsedTimer>
+// 引入 Qt 正則表達式類別
+#include <QRegularExpression>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+// 引入 Qt 文字串流類別
+#include <QTextStream>
+// 引入 C++ 演算法函式庫
+#include <algorithm>
+
+namespace {
+    // 每個段落的長度（毫秒），與 Whisper 的典型分段相近
+    const qint64 CUE_DURATION_MS = 2500;
+
+    QString formatTimestamp(qint64 ms)
+    {
+        return QString("%1:%2:%3,%4")
+            .arg(ms / 3600000, 2, 10, QChar('0'))
+            .arg(ms / 60000 % 60, 2, 10, QChar('0'))
+            .arg(ms / 1000 % 60, 2, 10, QChar('0'))
+            .arg(ms % 1000, 3, 10, QChar('0'));
+    }
+
+    // 產生指定長度的合成 SRT（中英混合的文字）
+    QString makeSrt(int hours)
+    {
+        QString srt;
+        QTextStream out(&srt);
+        const qint64 totalMs = qint64(hours) * 3600000;
+        int sequence = 1;
+        for (qint64 start = 0; start < totalMs; start += CUE_DURATION_MS) {
+            out << sequence << "\n"
+                << formatTimestamp(start) << " --> " << formatTimestamp(start + CUE_DURATION_MS) << "\n"
+                << "第 " << sequence << " 段：今天我們討論 lecture topic number " << sequence % 97 << "\n\n";
+            sequence++;
+        }
+        out.flush();
+        return srt;
+    }
+
+    // 舊版 Widget::loadSrt() 的解析方式：逐行執行正規表達式
+    int legacyParse(const QString& srtContent)
+    {
+        const QRegularExpression srtTimestampRegex(
+            R"((\d{2}):(\d{2}):(\d{2}),(\d{3})\s*-->\s*(\d{2}):(\d{2}):(\d{2}),(\d{3}))");
+        const QRegularExpression sequenceNumberRegex(R"(^\d+$)");
+
+        int cues = 0;
+        const QStringList lines = srtContent.split('\n');
+        int i = 0;
+        while (i < lines.size()) {
+            const QString line = lines[i].trimmed();
+            if (line.isEmpty() || sequenceNumberRegex.match(line).hasMatch()) {
+                i++;
+                continue;
+            }
+            const QRegularExpressionMatch match = srtTimestampRegex.match(line);
+            if (!match.hasMatch()) {
+                i++;
+                continue;
+            }
+            i++;
+            QString subtitleText;
+            while (i < lines.size()) {
+                const QString textLine = lines[i].trimmed();
+                if (textLine.isEmpty() || sequenceNumberRegex.match(textLine).hasMatch() ||
+                    srtTimestampRegex.match(textLine).hasMatch()) {
+                    break;
+                }
+                if (!subtitleText.isEmpty()) {
+                    subtitleText += " ";
+                }
+                subtitleText += textLine;
+                i++;
+            }
+            cues++;
+        }
+        return cues;
+    }
+
+    // 執行多次並回傳最短耗時（毫秒）
+    template <typename Function>
+    double bestOf(int iterations, Function function)
+    {
+        double best = 1e30;
+        for (int i = 0; i < iterations; i++) {
+            QElapsedTimer timer;
+            timer.start();
+            function();
+            best = std::min(best, timer.nsecsElapsed() / 1e6);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int hours = args.size() > 1 ? qMax(1, args[1].toInt()) : 3;
+    const int iterations = args.size() > 2 ? qMax(1, args[2].toInt()) : 10;
+
+    const QString srt = makeSrt(hours);
+    QTextStream out(stdout);
+
+    int cueCount = 0;
+    const double streamingMs = bestOf(iterations, [&]() {
+        cueCount = SubtitleParser::parse(srt).size();
+    });
+
+    // 模擬邊讀邊解析：每次餵入 64 KiB
+    const double chunkedMs = bestOf(iterations, [&]() {
+        SubtitleParser parser;
+        const QStringView view(srt);
+        for (qsizetype offset = 0; offset < view.size(); offset += 32 * 1024) {
+            parser.feed(view.mid(offset, 32 * 1024));
+        }
+        parser.finish();
+        cueCount = parser.takeCues().size();
+    });
+
+    int legacyCount = 0;
+    const double legacyMs = bestOf(qMin(iterations, 3), [&]() {
+        legacyCount = legacyParse(srt);
+    });
+
+    out << "synthetic SRT: " << hours << " h, " << srt.size() * 2 / 1024 << " KiB, "
+        << cueCount << " cues\n";
+    out << "SubtitleParser::parse     " << QString::number(streamingMs, 'f', 2) << " ms\n";
+    out << "SubtitleParser::feed 64K  " << QString::number(chunkedMs, 'f', 2) << " ms\n";
+    out << "legacy regex loadSrt      " << QString::number(legacyMs, 'f', 2) << " ms ("
+        << legacyCount << " cues)\n";
+    return cueCount == legacyCount ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+// 引入顯示區域 HTML 標頭檔
+#include "displayhtml.h"
+
+namespace {
+    // 通用 HTML 基礎樣式
+    const QString BASE_HTML_STYLE =
+        "body { background-color: #000000; color: #FFFFFF; font-family: Arial, sans-serif; text-align: center; padding: 50px; }"
+        "h2 { color: #1DB954; font-size: 32px; margin-bottom: 20px; }"
+        "p { font-size: 18px; margin: 20px 0; color: #B3B3B3; }";
+}
+
+QString welcomeHtml()
+{
+    return QString(
+        "<!DOCTYPE html>"
+        "<html>"
+        "<head>"
+        "<style>%1</style>"
+        "</head>"
+        "<body>"
+        "<h2>🎵 音樂播放器</h2>"
+        "<p>選擇一首歌曲開始播放</p>"
+        "</body>"
+        "</html>"
+    ).arg(BASE_HTML_STYLE);
+}
+
+QString youTubeHtml(const QString& title, const QString& channel, const QString& videoId)
+{
+    QString watchUrl = QString("https://www.youtube.com/watch?v=%1").arg(videoId);
+    return QString(
+        "<!DOCTYPE html>"
+        "<html>"
+        "<head>"
+        "<style>"
+        "%1"
+        "a { color: #1DB954; text-decoration: none; font-size: 20px; font-weight: bold; }"
+        "a:hover { color: #1ED760; text-decoration: underline; }"
+        ".info { font-size: 14px; color: #888; margin: 30px 0; }"
+        "</style>"
+        "</head>"
+        "<body>"
+        "<h2>🎵 %2</h2>"
+        "<p>%3</p>"
+        "<div style='margin: 40px 0;'>"
+        "<a href='%4'>🔗 點擊此處在瀏覽器中播放</a>"
+        "</div>"
+        "<p class='info'>由於不使用 WebEngine，YouTube 影片將在瀏覽器中播放</p>"
+        "</body>"
+        "</html>"
+    ).arg(BASE_HTML_STYLE)
+     .arg(title.toHtmlEscaped())
+     .arg(channel.toHtmlEscaped())
+     .arg(watchUrl);
+}
+
+QString localMusicHtml(const QString& title, const QString& status)
+{
+    return QString(
+        "<!DOCTYPE html>"
+        "<html>"
+        "<head>"
+        "<style>"
+        "%1"
+        ".subtitle-section { margin-top: 30px; padding-top: 20px; border-top: 1px solid #282828; }"
+        ".subtitle-title { font-size: 16px; color: #1DB954; margin-bottom: 10px; font-weight: bold; }"
+        ".subtitle-content { font-size: 14px; color: #B3B3B3; line-height: 1.6; }"
+        "</style>"
+        "</head>"
+        "<body>"
+        "<h2>🎵 %2</h2>"
+        "<p style='font-size: 14px; color: #888;'>本地音樂</p>"
+        "<div class='subtitle-section'>"
+        "<div class='subtitle-title'>📝 字幕</div>"
+        "<div class='subtitle-content'>%3</div>"
+        "</div>"
+        "</body>"
+        "</html>"
+    ).arg(BASE_HTML_STYLE)
+     .arg(title.toHtmlEscaped())
+     .arg(status);
+}
@@ -0,0 +1,18 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef DISPLAYHTML_H
+#define DISPLAYHTML_H
+
+// 引入 Qt 字串類別
+#include <QString>
+
+// 主視窗顯示區域（QTextBrowser）的 HTML 內容，文字參數在這裡跳脫
+
+// 歡迎畫面
+QString welcomeHtml();
+// YouTube 影片：標題、頻道與在瀏覽器中播放的連結
+QString youTubeHtml(const QString& title, const QString& channel, const QString& videoId);
+// 本地音樂：標題與字幕狀態訊息 status（已是 HTML，字幕段落顯示在另外的清單中）
+QString localMusicHtml(const QString& title, const QString& status);
+
+// 結束標頭檔保護宏
+#endif // DISPLAYHTML_H
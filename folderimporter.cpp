@@ -0,0 +1,183 @@
+// 引入資料夾匯入器標頭檔
+#include "folderimporter.h"
+// 引入音訊標籤讀取函式
+#include "audiotags.h"
+
+// 引入 Qt 並行運算函式
+#include <QtConcurrent>
+// 引入 Qt 非同步結果回報類別
+#include <QPromise>
+// 引入 Qt 目錄迭代器類別
+#include <QDirIterator>
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+
+namespace {
+    // 合併送出曲目的間隔（毫秒）
+    const int BATCH_INTERVAL_MS = 100;
+
+    // 遞迴收集資料夾中所有支援格式的音訊檔案
+    void scanDirectory(QPromise<QStringList>& promise, const QString& directory)
+    {
+        QStringList nameFilters;
+        for (const QString& suffix : FolderImporter::supportedSuffixes()) {
+            nameFilters.append("*." + suffix);
+        }
+
+        // 不跟隨符號連結，避免連結形成迴圈時無限走訪
+        QStringList files;
+        QDirIterator it(directory, nameFilters, QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            if (promise.isCanceled()) {
+                return;
+            }
+            files.append(it.next());
+        }
+
+        // 依路徑排序，讓同一張專輯的曲目連在一起
+        files.sort(Qt::CaseInsensitive);
+        promise.addResult(files);
+    }
+}
+
+FolderImporter::FolderImporter(QObject* parent)
+    : QObject(parent)
+    , nextTrack(0)
+    , running(false)
+    , canceled(false)
+{
+    batchTimer.setSingleShot(true);
+    batchTimer.setInterval(BATCH_INTERVAL_MS);
+    connect(&batchTimer, &QTimer::timeout, this, &FolderImporter::flushPendingTracks);
+
+    connect(&scanWatcher, &QFutureWatcher<QStringList>::finished, this, &FolderImporter::onScanFinished);
+    connect(&tagWatcher, &QFutureWatcher<VideoInfo>::resultsReadyAt, this, &FolderImporter::onTracksReadyAt);
+    connect(&tagWatcher, &QFutureWatcher<VideoInfo>::progressValueChanged, this, [this](int value) {
+        emit progressChanged(value, tagWatcher.progressMaximum());
+    });
+    connect(&tagWatcher, &QFutureWatcher<VideoInfo>::finished, this, &FolderImporter::onTagsFinished);
+}
+
+FolderImporter::~FolderImporter()
+{
+    // 解構時只停止背景工作，不再發出信號
+    canceled = true;
+    scanWatcher.cancel();
+    tagWatcher.cancel();
+    scanWatcher.waitForFinished();
+    tagWatcher.waitForFinished();
+}
+
+void FolderImporter::start(const QString& directory)
+{
+    if (running) {
+        return;
+    }
+
+    running = true;
+    canceled = false;
+    pendingTracks.clear();
+    nextTrack = 0;
+    emit progressChanged(0, 0);
+    scanWatcher.setFuture(QtConcurrent::run(scanDirectory, directory));
+}
+
+void FolderImporter::cancel()
+{
+    if (!running || canceled) {
+        return;
+    }
+
+    // 取消前已連續讀好的曲目仍然送出
+    onTracksReadyAt(0, 0);
+    canceled = true;
+    scanWatcher.cancel();
+    tagWatcher.cancel();
+    flushPendingTracks();
+}
+
+bool FolderImporter::isRunning() const
+{
+    return running;
+}
+
+VideoInfo FolderImporter::readTrack(const QString& filePath)
+{
+    const QFileInfo fileInfo(filePath);
+    AudioTags tags;
+    readAudioTags(filePath, tags);
+
+    VideoInfo video;
+    video.filePath = fileInfo.absoluteFilePath();
+    video.videoId = "";
+    video.title = tags.title.isEmpty() ? fileInfo.completeBaseName() : tags.title;
+    video.channelTitle = tags.artist.isEmpty() ? QString("本地音樂") : tags.artist;
+    video.isFavorite = false;
+    video.isLocalFile = true;
+    return video;
+}
+
+QStringList FolderImporter::supportedSuffixes()
+{
+    return { "mp3", "wav", "flac", "m4a", "ogg", "opus", "aac" };
+}
+
+void FolderImporter::onScanFinished()
+{
+    if (canceled || scanWatcher.future().resultCount() == 0) {
+        running = false;
+        emit finished(canceled);
+        return;
+    }
+
+    const QStringList files = scanWatcher.result();
+    if (files.isEmpty()) {
+        running = false;
+        emit finished(false);
+        return;
+    }
+
+    emit progressChanged(0, files.size());
+    tagWatcher.setFuture(QtConcurrent::mapped(files, &FolderImporter::readTrack));
+}
+
+void FolderImporter::onTracksReadyAt(int, int)
+{
+    if (canceled) {
+        return;
+    }
+
+    // resultCount() 是從頭開始連續可用的結果數，前面的曲目還在讀取時先不收集後面的曲目
+    const QFuture<VideoInfo> future = tagWatcher.future();
+    const int readyCount = future.resultCount();
+    if (nextTrack >= readyCount) {
+        return;
+    }
+    while (nextTrack < readyCount) {
+        pendingTracks.append(future.resultAt(nextTrack++));
+    }
+    if (!batchTimer.isActive()) {
+        batchTimer.start();
+    }
+}
+
+void FolderImporter::onTagsFinished()
+{
+    onTracksReadyAt(0, 0);
+    batchTimer.stop();
+    flushPendingTracks();
+    running = false;
+    emit finished(canceled);
+}
+
+void FolderImporter::flushPendingTracks()
+{
+    batchTimer.stop();
+    if (pendingTracks.isEmpty()) {
+        return;
+    }
+
+    const QList<VideoInfo> tracks = pendingTracks;
+    pendingTracks.clear();
+    emit tracksReady(tracks);
+}
@@ -0,0 +1,84 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef FOLDERIMPORTER_H
+#define FOLDERIMPORTER_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt 非同步結果監看類別
+#include <QFutureWatcher>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+// 引入 Qt 計時器類別
+#include <QTimer>
+
+// 資料夾匯入器
+//
+// 分兩個階段在背景執行，GUI 執行緒只負責接收結果：
+//   1. 掃描：在執行緒池中遞迴走訪資料夾，收集支援格式的音訊檔案路徑
+//   2. 讀取標籤：以 QtConcurrent::mapped 將每個檔案分配到所有核心，
+//      讀取內嵌標籤（見 readAudioTags）產生 VideoInfo
+// 讀好的曲目先累積起來，每 100 毫秒以 tracksReady() 整批送出，
+// 避免大量小檔案時每首曲目都觸發一次介面更新。
+// 工作執行緒完成的順序不固定，曲目仍依掃描順序送出：只送出從頭開始已連續讀好的部分；
+// cancel() 會停止尚未開始的工作並立即返回，取消前已連續讀好的曲目仍會送出。
+class FolderImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 建構函式
+    explicit FolderImporter(QObject* parent = nullptr);
+    // 解構函式，取消並等待背景工作結束
+    ~FolderImporter() override;
+
+    // 開始匯入指定資料夾（包含所有子資料夾），正在匯入時忽略
+    void start(const QString& directory);
+    // 取消匯入，已送出的曲目不受影響
+    void cancel();
+    // 是否正在匯入
+    bool isRunning() const;
+
+    // 讀取單一檔案的標籤並建立曲目資訊，沒有標籤時以檔名為標題
+    static VideoInfo readTrack(const QString& filePath);
+    // 支援的音訊檔案副檔名（小寫、不含點）
+    static QStringList supportedSuffixes();
+
+signals:
+    // 匯入進度，total 為 0 表示仍在掃描資料夾
+    void progressChanged(int done, int total);
+    // 一批曲目已讀取完成
+    void tracksReady(const QList<VideoInfo>& tracks);
+    // 匯入結束，canceled 表示是否被取消
+    void finished(bool canceled);
+
+private:
+    // 掃描完成後開始讀取標籤
+    void onScanFinished();
+    // 收集讀取完成的曲目
+    void onTracksReadyAt(int begin, int end);
+    // 標籤讀取全部結束
+    void onTagsFinished();
+    // 送出累積的曲目
+    void flushPendingTracks();
+
+    // 掃描資料夾的背景工作
+    QFutureWatcher<QStringList> scanWatcher;
+    // 讀取標籤的背景工作
+    QFutureWatcher<VideoInfo> tagWatcher;
+    // 累積中、尚未送出的曲目
+    QList<VideoInfo> pendingTracks;
+    // 下一首要收集的曲目在掃描結果中的位置
+    int nextTrack;
+    // 合併送出曲目的計時器
+    QTimer batchTimer;
+    // 是否正在匯入
+    bool running;
+    // 是否已被取消
+    bool canceled;
+};
+
+// 結束標頭檔保護宏
+#endif // FOLDERIMPORTER_H
@@ -0,0 +1,306 @@
+// 引入無縫播放器標頭檔
+#include "gaplessplayer.h"
+
+// 引入 C++ 數學函式（淡入淡出曲線）
+#include <cmath>
+
+namespace {
+    // 淡入淡出時更新音量的間隔（毫秒）
+    const int FADE_INTERVAL_MS = 20;
+    // 四分之一圓周（淡入淡出曲線的相位範圍）
+    const float HALF_PI = 1.57079632679f;
+}
+
+GaplessPlayer::GaplessPlayer(QObject* parent)
+    : QObject(parent)
+    , activeDeck(0)
+    , crossfadeMs(0)
+    , volumeLevel(1.0f)
+    , fading(false)
+    , queuedNextGain(1.0f)
+    , stopRequested(false)
+    , pendingPosition(-1)
+    , fadeTimer(new QTimer(this))
+{
+    for (int deck = 0; deck < 2; deck++) {
+        players[deck] = new QMediaPlayer(this);
+        outputs[deck] = new QAudioOutput(this);
+        players[deck]->setAudioOutput(outputs[deck]);
+        gains[deck] = 1.0f;
+        connectDeck(deck);
+    }
+
+    fadeTimer->setInterval(FADE_INTERVAL_MS);
+    connect(fadeTimer, &QTimer::timeout, this, [this]() {
+        if (fadeClock.elapsed() >= crossfadeMs) {
+            finishFade();
+        } else {
+            updateVolumes();
+        }
+    });
+
+    updateVolumes();
+}
+
+void GaplessPlayer::connectDeck(int deck)
+{
+    QMediaPlayer* player = players[deck];
+
+    // 只轉發目前播放那一組的信號；預先開啟與淡出中的播放器不影響對外狀態
+    connect(player, &QMediaPlayer::playbackStateChanged, this, [this, deck](QMediaPlayer::PlaybackState state) {
+        if (deck != activeDeck) {
+            return;
+        }
+        // 播放到結尾：有預先開啟的下一首時直接接上，不對外回報停止
+        if (state == QMediaPlayer::StoppedState && !stopRequested &&
+            players[deck]->mediaStatus() == QMediaPlayer::EndOfMedia && isNextReady()) {
+            advance();
+            return;
+        }
+        emit playbackStateChanged(state);
+    });
+    connect(player, &QMediaPlayer::mediaStatusChanged, this, [this, deck](QMediaPlayer::MediaStatus status) {
+        // 開啟完成前設定的播放位置（例如啟動時恢復上次的位置）
+        if (status == QMediaPlayer::LoadedMedia && deck == activeDeck && pendingPosition >= 0) {
+            players[deck]->setPosition(pendingPosition);
+            pendingPosition = -1;
+            return;
+        }
+        if (status != QMediaPlayer::EndOfMedia) {
+            return;
+        }
+        if (deck != activeDeck) {
+            // 淡出中的前一首已播完
+            if (fading) {
+                finishFade();
+            }
+            return;
+        }
+        if (isNextReady()) {
+            advance();
+        }
+    });
+    connect(player, &QMediaPlayer::positionChanged, this, [this, deck](qint64 position) {
+        if (deck != activeDeck) {
+            return;
+        }
+        emit positionChanged(position);
+
+        // 交叉淡入淡出：在結束前 crossfadeMs 開始下一首
+        const qint64 total = players[deck]->duration();
+        if (crossfadeMs > 0 && !fading && total > crossfadeMs && total - position <= crossfadeMs &&
+            players[deck]->playbackState() == QMediaPlayer::PlayingState && isNextReady()) {
+            advance();
+        }
+    });
+    connect(player, &QMediaPlayer::durationChanged, this, [this, deck](qint64 duration) {
+        if (deck == activeDeck) {
+            emit durationChanged(duration);
+        }
+    });
+}
+
+QMediaPlayer* GaplessPlayer::activePlayer() const
+{
+    return players[activeDeck];
+}
+
+QMediaPlayer* GaplessPlayer::nextPlayer() const
+{
+    return players[1 - activeDeck];
+}
+
+void GaplessPlayer::setSource(const QUrl& source, float gain)
+{
+    if (fading) {
+        finishFade();
+    }
+
+    stopRequested = true;
+    pendingPosition = -1;
+    activePlayer()->stop();
+    if (!source.isEmpty() && source == nextPlayer()->source() &&
+        nextPlayer()->mediaStatus() != QMediaPlayer::InvalidMedia) {
+        // 要播放的正是預先開啟的曲目，直接換到那一組播放器
+        activePlayer()->setSource(QUrl());
+        activeDeck = 1 - activeDeck;
+    } else {
+        activePlayer()->setSource(source);
+    }
+    gains[activeDeck] = gain;
+    stopRequested = false;
+
+    updateVolumes();
+    emit durationChanged(duration());
+    emit positionChanged(position());
+}
+
+QUrl GaplessPlayer::source() const
+{
+    return activePlayer()->source();
+}
+
+void GaplessPlayer::setNextSource(const QUrl& source, float gain)
+{
+    // 另一組播放器還在淡出前一首，淡出結束後才開啟
+    if (fading) {
+        queuedNextSource = source;
+        queuedNextGain = gain;
+        return;
+    }
+    gains[1 - activeDeck] = gain;
+    if (source == nextPlayer()->source()) {
+        return;
+    }
+    // 設定媒體後播放器會在背景開啟檔案，但在 play() 之前不會發出聲音
+    nextPlayer()->setSource(source);
+}
+
+QUrl GaplessPlayer::nextSource() const
+{
+    return fading ? queuedNextSource : nextPlayer()->source();
+}
+
+void GaplessPlayer::setCrossfadeDuration(int ms)
+{
+    crossfadeMs = qMax(0, ms);
+}
+
+int GaplessPlayer::crossfadeDuration() const
+{
+    return crossfadeMs;
+}
+
+void GaplessPlayer::setVolume(float volume)
+{
+    volumeLevel = qBound(0.0f, volume, 1.0f);
+    updateVolumes();
+}
+
+float GaplessPlayer::volume() const
+{
+    return volumeLevel;
+}
+
+void GaplessPlayer::setGain(float gain)
+{
+    gains[activeDeck] = gain;
+    updateVolumes();
+}
+
+float GaplessPlayer::gain() const
+{
+    return gains[activeDeck];
+}
+
+void GaplessPlayer::play()
+{
+    activePlayer()->play();
+}
+
+void GaplessPlayer::pause()
+{
+    if (fading) {
+        finishFade();
+    }
+    activePlayer()->pause();
+}
+
+void GaplessPlayer::stop()
+{
+    if (fading) {
+        finishFade();
+    }
+    stopRequested = true;
+    activePlayer()->stop();
+    stopRequested = false;
+}
+
+void GaplessPlayer::setPosition(qint64 position)
+{
+    if (activePlayer()->mediaStatus() == QMediaPlayer::LoadingMedia) {
+        pendingPosition = position;
+        emit positionChanged(position);
+        return;
+    }
+    pendingPosition = -1;
+    activePlayer()->setPosition(position);
+}
+
+QMediaPlayer::PlaybackState GaplessPlayer::playbackState() const
+{
+    return activePlayer()->playbackState();
+}
+
+qint64 GaplessPlayer::position() const
+{
+    return pendingPosition >= 0 ? pendingPosition : activePlayer()->position();
+}
+
+qint64 GaplessPlayer::duration() const
+{
+    return activePlayer()->duration();
+}
+
+bool GaplessPlayer::isNextReady() const
+{
+    const QMediaPlayer* player = nextPlayer();
+    if (player->source().isEmpty()) {
+        return false;
+    }
+    const QMediaPlayer::MediaStatus status = player->mediaStatus();
+    return status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia;
+}
+
+void GaplessPlayer::advance()
+{
+    QMediaPlayer* outgoing = activePlayer();
+    activeDeck = 1 - activeDeck;
+
+    if (crossfadeMs > 0 && outgoing->playbackState() == QMediaPlayer::PlayingState) {
+        // 前一首繼續在另一組播放器中淡出
+        fading = true;
+        queuedNextSource.clear();
+        fadeClock.start();
+        fadeTimer->start();
+    } else {
+        outgoing->stop();
+        outgoing->setSource(QUrl());
+    }
+
+    updateVolumes();
+    activePlayer()->play();
+
+    emit durationChanged(duration());
+    emit positionChanged(position());
+    emit advancedToNextSource(source());
+}
+
+void GaplessPlayer::finishFade()
+{
+    fading = false;
+    fadeTimer->stop();
+
+    // 淡出期間設定的下一首改由這組播放器預先開啟
+    QMediaPlayer* outgoing = nextPlayer();
+    outgoing->stop();
+    outgoing->setSource(queuedNextSource);
+    gains[1 - activeDeck] = queuedNextGain;
+    queuedNextSource.clear();
+    queuedNextGain = 1.0f;
+    updateVolumes();
+}
+
+void GaplessPlayer::updateVolumes()
+{
+    // 等功率曲線：兩首音量的平方和維持不變，交會處不會變小聲
+    float fadeIn = 1.0f;
+    float fadeOut = 0.0f;
+    if (fading && crossfadeMs > 0) {
+        const float progress = qBound(0.0f, float(fadeClock.elapsed()) / crossfadeMs, 1.0f);
+        fadeIn = std::sin(progress * HALF_PI);
+        fadeOut = std::cos(progress * HALF_PI);
+    }
+    outputs[activeDeck]->setVolume(qMin(1.0f, volumeLevel * gains[activeDeck]) * fadeIn);
+    outputs[1 - activeDeck]->setVolume(qMin(1.0f, volumeLevel * gains[1 - activeDeck]) * fadeOut);
+}
@@ -0,0 +1,119 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef GAPLESSPLAYER_H
+#define GAPLESSPLAYER_H
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt 媒體播放器類別
+#include <QMediaPlayer>
+// 引入 Qt 音訊輸出類別
+#include <QAudioOutput>
+// 引入 Qt 計時器類別
+#include <QTimer>
+// 引入 Qt 經過時間計時器類別
+#include <QElapsedTimer>
+// 引入 Qt URL 處理類別
+#include <QUrl>
+
+// 無縫接續播放的媒體播放器
+//
+// 內部有兩組 QMediaPlayer/QAudioOutput：一組正在播放，另一組以 setNextSource()
+// 預先開啟下一首（解碼器在背景完成初始化），目前曲目播放結束時立即切換到預先開啟的播放器，
+// 不需要等待 stop()/setSource() 重新開啟檔案。設定 setCrossfadeDuration() 後，
+// 會在曲目結束前提早開始下一首，以等功率曲線交叉淡入淡出。
+//
+// 對外的介面與信號只反映正在播放的那一組，用法與 QMediaPlayer 相同；
+// 自動切換到下一首時發出 advancedToNextSource()。
+// 以 setSource() 播放的正好是預先開啟的曲目時（例如按下一首），也直接使用預先開啟的播放器。
+// 每首曲目可以附帶增益（響度正規化），與使用者音量相乘後設定到該組輸出。
+class GaplessPlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 建構函式
+    explicit GaplessPlayer(QObject* parent = nullptr);
+
+    // 設定目前播放的媒體與其增益（停止目前的播放與淡出）
+    void setSource(const QUrl& source, float gain = 1.0f);
+    // 目前播放的媒體
+    QUrl source() const;
+    // 預先開啟下一首與其增益，空的 URL 表示沒有下一首（播放結束時停止）
+    void setNextSource(const QUrl& source, float gain = 1.0f);
+    // 預先開啟的下一首
+    QUrl nextSource() const;
+
+    // 交叉淡入淡出的長度（毫秒），0 表示不淡出、在曲目結束時直接接上
+    void setCrossfadeDuration(int ms);
+    int crossfadeDuration() const;
+    // 音量（0.0 ~ 1.0）
+    void setVolume(float volume);
+    float volume() const;
+    // 目前播放的媒體的增益（線性，QAudioOutput 音量上限為 1.0，超過的部分無效）
+    void setGain(float gain);
+    float gain() const;
+
+    // 播放控制，作用於目前播放的媒體
+    void play();
+    void pause();
+    void stop();
+    // 設定播放位置；媒體仍在開啟中時記下位置，開啟完成後再定位
+    void setPosition(qint64 position);
+
+    // 目前播放的媒體的狀態
+    QMediaPlayer::PlaybackState playbackState() const;
+    qint64 position() const;
+    qint64 duration() const;
+
+signals:
+    // 播放狀態改變
+    void playbackStateChanged(QMediaPlayer::PlaybackState state);
+    // 播放位置改變（毫秒）
+    void positionChanged(qint64 position);
+    // 媒體長度改變（毫秒）
+    void durationChanged(qint64 duration);
+    // 已自動切換到預先開啟的下一首，source 為新的目前媒體
+    void advancedToNextSource(const QUrl& source);
+
+private:
+    // 連接第 deck 組播放器的信號
+    void connectDeck(int deck);
+    // 預先開啟的下一首是否已可以立即播放
+    bool isNextReady() const;
+    // 切換到預先開啟的下一首
+    void advance();
+    // 結束淡出，停止前一首
+    void finishFade();
+    // 依淡入淡出進度設定兩組輸出的音量
+    void updateVolumes();
+    // 目前播放的播放器與預先開啟的播放器
+    QMediaPlayer* activePlayer() const;
+    QMediaPlayer* nextPlayer() const;
+
+    // 兩組播放器與音訊輸出
+    QMediaPlayer* players[2];
+    QAudioOutput* outputs[2];
+    // 兩組播放器各自媒體的增益
+    float gains[2];
+    // 目前播放的那一組
+    int activeDeck;
+    // 交叉淡入淡出長度（毫秒）
+    int crossfadeMs;
+    // 使用者設定的音量
+    float volumeLevel;
+    // 是否正在交叉淡入淡出（前一首在另一組播放器中淡出）
+    bool fading;
+    // 淡出期間設定的下一首，淡出結束後才開啟
+    QUrl queuedNextSource;
+    float queuedNextGain;
+    // 是否正由 stop() 停止（不視為播放結束）
+    bool stopRequested;
+    // 媒體開啟完成後要定位到的位置（-1 表示沒有）
+    qint64 pendingPosition;
+    // 淡入淡出的音量更新計時器與經過時間
+    QTimer* fadeTimer;
+    QElapsedTimer fadeClock;
+};
+
+// 結束標頭檔保護宏
+#endif // GAPLESSPLAYER_H
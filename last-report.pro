@@ -1,4 +1,4 @@
-QT       += core gui multimedia multimediawidgets
+QT       += core gui multimedia multimediawidgets concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -8,16 +8,38 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Headless core (playlists, play order, subtitle parsing, transcription)
+include(playercore.pri)
+
 SOURCES += \
+    audioanalyzer.cpp \
+    gaplessplayer.cpp \
+    loudnessmeter.cpp \
+    loudnessscanner.cpp \
     main.cpp \
+    playlistdelegate.cpp \
+    subtitledelegate.cpp \
+    waveformpeaks.cpp \
+    waveformslider.cpp \
     widget.cpp
 
 HEADERS += \
+    audioanalyzer.h \
+    gaplessplayer.h \
+    loudnessmeter.h \
+    loudnessscanner.h \
+    playlistdelegate.h \
+    subtitledelegate.h \
+    waveformpeaks.h \
+    waveformslider.h \
     widget.h
 
 FORMS += \
     widget.ui
 
+DISTFILES += \
+    whisper_transcribe.py
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,173 @@
+// 引入響度量測標頭檔
+#include "loudnessmeter.h"
+// 引入波形峰值（SIMD 最小/最大值）
+#include "waveformpeaks.h"
+
+// 引入 C++ 數學函式
+#include <cmath>
+
+namespace {
+    // 每個能量區段的長度（秒的倒數：100 毫秒）
+    const int STEPS_PER_SECOND = 10;
+    // 每個響度區塊包含的區段數（400 毫秒）
+    const int STEPS_PER_BLOCK = 4;
+    // 相對門檻（LU）
+    const double RELATIVE_GATE_LU = -10.0;
+    // 圓周率
+    const double PI = 3.14159265358979323846;
+
+    // 區塊能量對應的響度（BS.1770 公式）
+    double energyToLoudness(double energy)
+    {
+        return -0.691 + 10.0 * std::log10(energy);
+    }
+}
+
+double LoudnessMeter::Biquad::filter(int channel, double input)
+{
+    const double output = b0 * input + z1[channel];
+    z1[channel] = b1 * input - a1 * output + z2[channel];
+    z2[channel] = b2 * input - a2 * output;
+    return output;
+}
+
+LoudnessMeter::LoudnessMeter()
+    : rate(0)
+    , shelf()
+    , highPass()
+    , stepFrames(0)
+    , pendingFrames(0)
+    , pendingEnergy(0.0)
+    , minimumSample(0.0f)
+    , maximumSample(0.0f)
+    , valid(false)
+    , loudness(SILENCE_LUFS)
+{
+}
+
+void LoudnessMeter::setSampleRate(int sampleRate)
+{
+    rate = sampleRate;
+    stepFrames = qMax(1, sampleRate / STEPS_PER_SECOND);
+
+    // 第一級：約 1.68 kHz 以上提升 4 dB 的高架濾波器（模擬頭部的聲學效應）
+    {
+        const double f0 = 1681.974450955533;
+        const double gain = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(PI * f0 / sampleRate);
+        const double vh = std::pow(10.0, gain / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf = Biquad{ (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                        2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0, {}, {} };
+    }
+    // 第二級：約 38 Hz 的高通濾波器
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(PI * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass = Biquad{ 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0, {}, {} };
+    }
+}
+
+void LoudnessMeter::process(const float* samples, qsizetype frames, int sampleRate)
+{
+    if (rate != sampleRate) {
+        setSampleRate(sampleRate);
+    }
+
+    WaveformPeaks::minMax(samples, frames * AudioAnalyzer::CHANNELS, &minimumSample, &maximumSample);
+
+    for (qsizetype frame = 0; frame < frames; frame++) {
+        for (int channel = 0; channel < AudioAnalyzer::CHANNELS; channel++) {
+            const double weighted = highPass.filter(channel, shelf.filter(channel, samples[frame * AudioAnalyzer::CHANNELS + channel]));
+            pendingEnergy += weighted * weighted;
+        }
+        if (++pendingFrames == stepFrames) {
+            finishStep();
+        }
+    }
+}
+
+void LoudnessMeter::finishStep()
+{
+    // 左右聲道權重皆為 1，各聲道均方值直接相加
+    stepEnergies.append(pendingEnergy / pendingFrames);
+    pendingFrames = 0;
+    pendingEnergy = 0.0;
+}
+
+void LoudnessMeter::finish(bool ok)
+{
+    valid = false;
+    if (!ok || rate == 0) {
+        return;
+    }
+
+    // 400 毫秒區塊，每 100 毫秒一個；不足一個區塊的短音訊以全部樣本為一個區塊
+    QVector<double> blockEnergies;
+    if (stepEnergies.size() < STEPS_PER_BLOCK) {
+        double energy = 0.0;
+        for (double stepEnergy : stepEnergies) {
+            energy += stepEnergy;
+        }
+        if (!stepEnergies.isEmpty()) {
+            blockEnergies.append(energy / stepEnergies.size());
+        }
+    } else {
+        double window = 0.0;
+        for (int i = 0; i < stepEnergies.size(); i++) {
+            window += stepEnergies[i];
+            if (i >= STEPS_PER_BLOCK) {
+                window -= stepEnergies[i - STEPS_PER_BLOCK];
+            }
+            if (i >= STEPS_PER_BLOCK - 1) {
+                blockEnergies.append(window / STEPS_PER_BLOCK);
+            }
+        }
+    }
+
+    // 絕對門檻
+    double sum = 0.0;
+    int count = 0;
+    for (double energy : blockEnergies) {
+        if (energy > 0.0 && energyToLoudness(energy) > SILENCE_LUFS) {
+            sum += energy;
+            count++;
+        }
+    }
+    loudness = SILENCE_LUFS;
+    if (count > 0) {
+        // 相對門檻
+        const double relativeGate = energyToLoudness(sum / count) + RELATIVE_GATE_LU;
+        double gatedSum = 0.0;
+        int gatedCount = 0;
+        for (double energy : blockEnergies) {
+            if (energy > 0.0 && energyToLoudness(energy) > SILENCE_LUFS && energyToLoudness(energy) > relativeGate) {
+                gatedSum += energy;
+                gatedCount++;
+            }
+        }
+        if (gatedCount > 0) {
+            loudness = energyToLoudness(gatedSum / gatedCount);
+        }
+    }
+    valid = true;
+}
+
+bool LoudnessMeter::isValid() const
+{
+    return valid;
+}
+
+double LoudnessMeter::integratedLoudness() const
+{
+    return loudness;
+}
+
+float LoudnessMeter::samplePeak() const
+{
+    return qMax(std::fabs(minimumSample), std::fabs(maximumSample));
+}
@@ -0,0 +1,72 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef LOUDNESSMETER_H
+#define LOUDNESSMETER_H
+
+// 引入背景音訊分析器（分析步驟介面）
+#include "audioanalyzer.h"
+
+// 引入 Qt 動態陣列類別
+#include <QVector>
+
+// EBU R128 / ITU-R BS.1770 整合響度量測
+//
+// 樣本先經過 K 加權濾波（高架濾波器加高通濾波器，係數依取樣率計算），
+// 每 100 毫秒累積一次能量，以 400 毫秒、重疊 75% 的區塊計算響度，
+// 再依絕對門檻（-70 LUFS）與相對門檻（低於未相對門檻響度 10 LU）排除安靜的區塊，
+// 得到整合響度。同時記錄樣本峰值（不做超取樣，不是真實峰值）。
+class LoudnessMeter : public AudioAnalysisPass
+{
+public:
+    // 沒有任何區塊高於絕對門檻時回報的響度（LUFS）
+    static constexpr double SILENCE_LUFS = -70.0;
+
+    // 建構函式
+    LoudnessMeter();
+
+    void process(const float* samples, qsizetype frames, int sampleRate) override;
+    void finish(bool ok) override;
+
+    // 是否已完整分析（finish(true) 之後）
+    bool isValid() const;
+    // 整合響度（LUFS）
+    double integratedLoudness() const;
+    // 樣本峰值（線性，1.0 為滿刻度）
+    float samplePeak() const;
+
+private:
+    // 雙二階濾波器（Direct Form II transposed），每個聲道各一組狀態
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+        double z1[AudioAnalyzer::CHANNELS];
+        double z2[AudioAnalyzer::CHANNELS];
+
+        double filter(int channel, double input);
+    };
+
+    // 依取樣率設定 K 加權濾波器係數
+    void setSampleRate(int sampleRate);
+    // 結束目前的 100 毫秒能量區段
+    void finishStep();
+
+    // 目前的取樣率（0 表示尚未收到樣本）
+    int rate;
+    // K 加權的兩級濾波器
+    Biquad shelf;
+    Biquad highPass;
+    // 每個 100 毫秒區段的樣本框數
+    qint64 stepFrames;
+    // 目前區段已累積的樣本框數與各聲道加總後的平方和
+    qint64 pendingFrames;
+    double pendingEnergy;
+    // 每個完整區段的平均能量（各聲道均方值的和）
+    QVector<double> stepEnergies;
+    // 樣本的最小值與最大值
+    float minimumSample;
+    float maximumSample;
+    // 分析結果
+    bool valid;
+    double loudness;
+};
+
+// 結束標頭檔保護宏
+#endif // LOUDNESSMETER_H
@@ -0,0 +1,226 @@
+// 引入背景響度掃描器標頭檔
+#include "loudnessscanner.h"
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+
+LoudnessScanner::LoudnessScanner(const QString& peaksDirectory, QObject* parent)
+    : QObject(parent)
+    , peaksDirectory(peaksDirectory)
+    , workerLimit(1)
+    , doneCount(0)
+    , totalCount(0)
+    , playingAnalyzer(nullptr)
+    , playingRequestId(-1)
+{
+}
+
+void LoudnessScanner::setMaxWorkers(int count)
+{
+    workerLimit = qMax(1, count);
+    startPendingJobs();
+}
+
+int LoudnessScanner::maxWorkers() const
+{
+    return workerLimit;
+}
+
+void LoudnessScanner::enqueue(const QStringList& audioFilePaths)
+{
+    for (const QString& path : audioFilePaths) {
+        if (path.isEmpty() || pending.contains(path) || isRunning(path)) {
+            continue;
+        }
+        pending.append(path);
+        totalCount++;
+    }
+    emit progressChanged(doneCount, totalCount);
+    startPendingJobs();
+}
+
+void LoudnessScanner::prioritize(const QStringList& audioFilePaths)
+{
+    // 由後往前插到最前面，維持給定的順序
+    for (int i = audioFilePaths.size() - 1; i >= 0; i--) {
+        const QString& path = audioFilePaths[i];
+        if (path.isEmpty() || isRunning(path)) {
+            continue;
+        }
+        if (pending.removeOne(path)) {
+            pending.prepend(path);
+        } else {
+            pending.prepend(path);
+            totalCount++;
+        }
+    }
+    emit progressChanged(doneCount, totalCount);
+    startPendingJobs();
+}
+
+void LoudnessScanner::cancel()
+{
+    totalCount -= pending.size();
+    pending.clear();
+    // 取消後分析器仍會發出 finished()，由 onAnalysisFinished() 收尾；正在播放的曲目沿用的分析不取消
+    for (const Worker& worker : workers) {
+        if (worker.requestId >= 0 && worker.audioFilePath != playingPath) {
+            worker.analyzer->cancel();
+        }
+    }
+    if (!isScanning()) {
+        doneCount = 0;
+        totalCount = 0;
+        emit finished();
+    }
+}
+
+bool LoudnessScanner::isScanning() const
+{
+    if (!pending.isEmpty()) {
+        return true;
+    }
+    for (const Worker& worker : workers) {
+        if (worker.requestId >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LoudnessScanner::analyzePlaying(const QString& audioFilePath, bool measureLoudness)
+{
+    // 分析器一次只分析一個檔案，新的分析會取消之前曲目的分析
+    playingRequestId = -1;
+    playingPath = audioFilePath;
+    playingWaveform.reset();
+    playingMeter.reset();
+    if (audioFilePath.isEmpty()) {
+        if (playingAnalyzer && playingAnalyzer->isBusy()) {
+            playingAnalyzer->cancel();
+        }
+        return;
+    }
+
+    // 正在背景分析時，該次解碼結束後由 onAnalysisFinished() 送出波形
+    if (isRunning(audioFilePath)) {
+        return;
+    }
+    // 在等待清單中時改由這次分析一併量測
+    if (pending.removeOne(audioFilePath)) {
+        totalCount--;
+        measureLoudness = true;
+        emit progressChanged(doneCount, totalCount);
+    }
+
+    if (!playingAnalyzer) {
+        playingAnalyzer = new AudioAnalyzer(this);
+        connect(playingAnalyzer, &AudioAnalyzer::finished, this, &LoudnessScanner::onPlayingAnalysisFinished);
+    }
+    playingWaveform.reset(new CachedWaveformPass(peaksDirectory));
+    QList<QSharedPointer<AudioAnalysisPass>> passes = { playingWaveform };
+    if (measureLoudness) {
+        playingMeter.reset(new LoudnessMeter());
+        passes.append(playingMeter);
+    }
+    playingRequestId = playingAnalyzer->analyze(audioFilePath, passes);
+    startPendingJobs();
+}
+
+bool LoudnessScanner::isRunning(const QString& audioFilePath) const
+{
+    if (playingRequestId >= 0 && playingPath == audioFilePath) {
+        return true;
+    }
+    for (const Worker& worker : workers) {
+        if (worker.requestId >= 0 && worker.audioFilePath == audioFilePath) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LoudnessScanner::startPendingJobs()
+{
+    for (int i = 0; i < workerLimit && !pending.isEmpty(); i++) {
+        if (i == workers.size()) {
+            AudioAnalyzer* analyzer = new AudioAnalyzer(this);
+            connect(analyzer, &AudioAnalyzer::finished, this, [this, analyzer](int requestId, bool ok) {
+                onAnalysisFinished(analyzer, requestId, ok);
+            });
+            workers.append(Worker{ analyzer, -1, QString(), QSharedPointer<LoudnessMeter>() });
+        }
+        Worker& worker = workers[i];
+        if (worker.requestId >= 0) {
+            continue;
+        }
+
+        const QString path = pending.takeFirst();
+        if (!QFileInfo::exists(path)) {
+            doneCount++;
+            i--;
+            continue;
+        }
+
+        // 波形峰值快取中還沒有這個檔案時，同一次解碼一併產生（指紋在分析器的背景執行緒中計算）
+        worker.meter.reset(new LoudnessMeter());
+        worker.waveform.reset(new CachedWaveformPass(peaksDirectory));
+        const QList<QSharedPointer<AudioAnalysisPass>> passes = { worker.meter, worker.waveform };
+        worker.audioFilePath = path;
+        worker.requestId = worker.analyzer->analyze(path, passes);
+    }
+    emit progressChanged(doneCount, totalCount);
+
+    if (!isScanning() && totalCount > 0) {
+        doneCount = 0;
+        totalCount = 0;
+        emit finished();
+    }
+}
+
+void LoudnessScanner::onAnalysisFinished(AudioAnalyzer* analyzer, int requestId, bool ok)
+{
+    for (Worker& worker : workers) {
+        if (worker.analyzer != analyzer || worker.requestId != requestId) {
+            continue;
+        }
+        const QString path = worker.audioFilePath;
+        const QSharedPointer<LoudnessMeter> meter = worker.meter;
+        const QSharedPointer<CachedWaveformPass> waveform = worker.waveform;
+        worker.requestId = -1;
+        worker.audioFilePath.clear();
+        worker.meter.reset();
+        worker.waveform.reset();
+        doneCount++;
+
+        // 正在播放的曲目沿用了這次解碼
+        if (playingRequestId < 0 && path == playingPath) {
+            playingPath.clear();
+            emit waveformReady(path, waveform->peaks());
+        }
+        if (ok && meter->isValid()) {
+            emit trackAnalyzed(path, meter->integratedLoudness(), meter->samplePeak());
+        }
+        break;
+    }
+    startPendingJobs();
+}
+
+void LoudnessScanner::onPlayingAnalysisFinished(int requestId, bool ok)
+{
+    // 之前曲目的分析（已被取消）不再需要
+    if (requestId != playingRequestId) {
+        return;
+    }
+    const QString path = playingPath;
+    const QSharedPointer<CachedWaveformPass> waveform = playingWaveform;
+    const QSharedPointer<LoudnessMeter> meter = playingMeter;
+    playingRequestId = -1;
+    playingPath.clear();
+    playingWaveform.reset();
+    playingMeter.reset();
+
+    emit waveformReady(path, waveform->peaks());
+    if (ok && meter && meter->isValid()) {
+        emit trackAnalyzed(path, meter->integratedLoudness(), meter->samplePeak());
+    }
+}
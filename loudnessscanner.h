@@ -0,0 +1,105 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef LOUDNESSSCANNER_H
+#define LOUDNESSSCANNER_H
+
+// 引入背景音訊分析器
+#include "audioanalyzer.h"
+// 引入響度量測
+#include "loudnessmeter.h"
+// 引入波形峰值
+#include "waveformpeaks.h"
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 背景響度掃描器
+//
+// 以最多 maxWorkers() 個 AudioAnalyzer 平行分析等待中的檔案，每個檔案量測整合響度與峰值，
+// 結果以 trackAnalyzed() 通知，由接收端寫回各播放清單的 VideoInfo。
+// 波形峰值快取中還沒有的檔案，同一次解碼也一併產生波形峰值，之後播放時不需要再解碼一次；
+// 查詢快取所需的檔案指紋在分析器的背景執行緒中計算，GUI 執行緒不讀取檔案內容。
+// 以 enqueue() 加入整個播放清單，以 prioritize() 讓即將播放的曲目插隊。
+// 正在播放的曲目以 analyzePlaying() 立即分析（不佔分析名額）；檔案已在背景分析時沿用同一次解碼，
+// 已在等待清單中時改由正在播放的分析一併量測，同一個檔案不會解碼兩次。
+class LoudnessScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 建構函式，peaksDirectory 為波形峰值快取目錄
+    explicit LoudnessScanner(const QString& peaksDirectory, QObject* parent = nullptr);
+
+    // 設定同時分析的檔案數量上限（至少為 1）
+    void setMaxWorkers(int count);
+    // 同時分析的檔案數量上限
+    int maxWorkers() const;
+
+    // 將檔案加入等待清單尾端，已在等待或分析中的檔案會被略過
+    void enqueue(const QStringList& audioFilePaths);
+    // 將檔案移到等待清單最前面（依給定的順序）
+    void prioritize(const QStringList& audioFilePaths);
+    // 清除等待清單並取消分析中的檔案
+    void cancel();
+    // 是否有等待或分析中的檔案
+    bool isScanning() const;
+    // 分析正在播放的曲目：波形峰值從快取讀取或重新計算，完成時以 waveformReady() 通知；
+    // measureLoudness 為 true 時同一次解碼量測響度（以 trackAnalyzed() 通知）。
+    // 空字串表示不再需要之前曲目的波形
+    void analyzePlaying(const QString& audioFilePath, bool measureLoudness);
+
+signals:
+    // 一個檔案分析完成，loudness 為整合響度（LUFS），peak 為樣本峰值
+    void trackAnalyzed(const QString& audioFilePath, double loudness, float peak);
+    // 掃描進度（本輪已結束的檔案數 / 本輪的檔案總數）
+    void progressChanged(int done, int total);
+    // 等待清單中的檔案全部結束
+    void finished();
+    // 正在播放曲目的波形峰值（無法取得時為空）
+    void waveformReady(const QString& audioFilePath, const WaveformPeaks& peaks);
+
+private:
+    // 一個分析名額
+    struct Worker {
+        AudioAnalyzer* analyzer;
+        int requestId;
+        QString audioFilePath;
+        QSharedPointer<LoudnessMeter> meter;
+        QSharedPointer<CachedWaveformPass> waveform;
+    };
+
+    // 在名額內依序開始分析等待中的檔案
+    void startPendingJobs();
+    // 分析結束的處理
+    void onAnalysisFinished(AudioAnalyzer* analyzer, int requestId, bool ok);
+    // 正在播放曲目的分析結束的處理
+    void onPlayingAnalysisFinished(int requestId, bool ok);
+    // 檔案是否正在分析
+    bool isRunning(const QString& audioFilePath) const;
+
+    // 波形峰值快取目錄
+    QString peaksDirectory;
+    // 同時分析的檔案數量上限
+    int workerLimit;
+    // 分析名額（分析器在需要時才建立）
+    QList<Worker> workers;
+    // 等待中的檔案
+    QStringList pending;
+    // 本輪已結束的檔案數與檔案總數（全部結束後歸零）
+    int doneCount;
+    int totalCount;
+    // 正在播放曲目的分析器（第一次需要時建立）與分析編號（-1 表示沒有，沿用背景分析時也是 -1）
+    AudioAnalyzer* playingAnalyzer;
+    int playingRequestId;
+    // 等待波形的正在播放曲目，沒有時為空字串
+    QString playingPath;
+    // 正在播放曲目的分析步驟（不量測響度時 playingMeter 為空）
+    QSharedPointer<CachedWaveformPass> playingWaveform;
+    QSharedPointer<LoudnessMeter> playingMeter;
+};
+
+// 結束標頭檔保護宏
+#endif // LOUDNESSSCANNER_H
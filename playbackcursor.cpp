@@ -0,0 +1,269 @@
+// 引入播放位置標頭檔
+#include "playbackcursor.h"
+// 引入播放清單持久化引擎
+#include "playliststore.h"
+
+// 引入 Qt 檔案處理類別
+#include <QFile>
+
+PlaybackCursor::PlaybackCursor(QList<Playlist>* playlists, PlaylistStore* store)
+    : playlists(playlists)
+    , store(store)
+    , playingPlaylistIndex(-1)
+    , currentRow(-1)
+{
+}
+
+int PlaybackCursor::playlistIndex() const
+{
+    return playingPlaylistIndex;
+}
+
+int PlaybackCursor::row() const
+{
+    return currentRow;
+}
+
+const VideoInfo* PlaybackCursor::currentVideo() const
+{
+    if (playingPlaylistIndex < 0 || playingPlaylistIndex >= playlists->size()) return nullptr;
+    const Playlist& playlist = playlists->at(playingPlaylistIndex);
+    if (currentRow < 0 || currentRow >= playlist.videos.size()) return nullptr;
+    return &playlist.videos[currentRow];
+}
+
+void PlaybackCursor::setShuffle(bool enabled)
+{
+    order.setShuffle(enabled);
+}
+
+bool PlaybackCursor::isShuffle() const
+{
+    return order.isShuffle();
+}
+
+void PlaybackCursor::setRepeat(bool enabled)
+{
+    order.setRepeat(enabled);
+}
+
+bool PlaybackCursor::isRepeat() const
+{
+    return order.isRepeat();
+}
+
+void PlaybackCursor::setPlaylist(int index)
+{
+    if (index == playingPlaylistIndex) return;
+
+    // 播放順序改由新的播放清單決定；待播佇列不受影響
+    playingPlaylistIndex = index;
+    currentRow = -1;
+    order.reset(index >= 0 && index < playlists->size() ? playlists->at(index).videos.size() : 0);
+}
+
+void PlaybackCursor::play(int playlistIndex, int row)
+{
+    setPlaylist(playlistIndex);
+    currentRow = row;
+    order.markPlayed(row);
+    prune();
+}
+
+void PlaybackCursor::stop()
+{
+    currentRow = -1;
+}
+
+TrackLocation PlaybackCursor::next()
+{
+    return upcoming(1).value(0);
+}
+
+int PlaybackCursor::previous()
+{
+    if (playingPlaylistIndex < 0 || playingPlaylistIndex >= playlists->size()) return -1;
+    return order.previous();
+}
+
+QList<TrackLocation> PlaybackCursor::upcoming(int count)
+{
+    QList<TrackLocation> tracks;
+
+    // 待播佇列優先；已失效的項目只略過，由 prune() 移除
+    for (QueueEntry entry = playQueue.first(); entry.handle != 0 && tracks.size() < count;
+         entry = playQueue.after(entry.handle)) {
+        const TrackLocation track = resolve(entry);
+        if (track.row >= 0) {
+            tracks.append(track);
+        }
+    }
+
+    // 接著是正在播放的播放清單的播放順序
+    if (tracks.size() < count && playingPlaylistIndex >= 0 && playingPlaylistIndex < playlists->size()) {
+        for (int row : order.upcoming(count - tracks.size())) {
+            tracks.append({ playingPlaylistIndex, row, 0 });
+        }
+    }
+    return tracks;
+}
+
+const PlayQueue& PlaybackCursor::queue() const
+{
+    return playQueue;
+}
+
+void PlaybackCursor::setQueue(const PlayQueue& queue)
+{
+    playQueue = queue;
+}
+
+void PlaybackCursor::enqueue(int playlistIndex, int row, bool playNext)
+{
+    if (playlistIndex < 0 || playlistIndex >= playlists->size()) return;
+    const Playlist& playlist = playlists->at(playlistIndex);
+    if (row < 0 || row >= playlist.videos.size()) return;
+
+    const QString key = trackKey(playlist.videos[row]);
+    const QueueEntry entry = playNext ? playQueue.playNext(playlist.name, key)
+                                      : playQueue.enqueue(playlist.name, key);
+    store->recordQueued(entry, playNext);
+}
+
+void PlaybackCursor::dequeue(quint64 handle)
+{
+    if (handle != 0 && playQueue.remove(handle)) {
+        store->recordUnqueued(handle);
+    }
+}
+
+void PlaybackCursor::clearQueue()
+{
+    playQueue.clear();
+    store->recordQueueCleared();
+}
+
+void PlaybackCursor::prune()
+{
+    for (QueueEntry entry = playQueue.first(); entry.handle != 0;) {
+        const QueueEntry following = playQueue.after(entry.handle);
+        const int playlistIndex = findPlaylist(entry.playlistName);
+        if (playlistIndex >= 0 && playlists->at(playlistIndex).cacheIndex >= 0) {
+            store->materialize((*playlists)[playlistIndex]);
+        }
+        if (resolve(entry).row < 0) {
+            dequeue(entry.handle);
+        }
+        entry = following;
+    }
+}
+
+void PlaybackCursor::trackInserted(int playlistIndex, int row)
+{
+    if (playlistIndex != playingPlaylistIndex) return;
+    order.trackInserted(row);
+    if (currentRow >= 0) {
+        currentRow = order.current();
+    }
+}
+
+void PlaybackCursor::trackRemoved(int playlistIndex, int row)
+{
+    if (playlistIndex != playingPlaylistIndex) return;
+    order.trackRemoved(row);
+    if (currentRow >= 0) {
+        currentRow = order.current();
+    }
+}
+
+void PlaybackCursor::trackMoved(int playlistIndex, int from, int to)
+{
+    if (playlistIndex != playingPlaylistIndex) return;
+    // 列號已改變，隨機播放的順序跟著曲目移動
+    order.trackMoved(from, to);
+    if (currentRow >= 0) {
+        currentRow = order.current();
+    }
+}
+
+bool PlaybackCursor::playlistRemoved(int index)
+{
+    bool removedPlaying = false;
+    if (index == playingPlaylistIndex) {
+        setPlaylist(-1);
+        removedPlaying = true;
+    } else if (index < playingPlaylistIndex) {
+        playingPlaylistIndex--;
+    }
+    // 該播放清單的佇列項目已失效
+    prune();
+    return removedPlaying;
+}
+
+int PlaybackCursor::findPlaylist(const QString& name) const
+{
+    for (int i = 0; i < playlists->size(); i++) {
+        if (playlists->at(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+TrackLocation PlaybackCursor::locate(const QString& key, int preferredPlaylist)
+{
+    // 同一首曲目可能在多個播放清單中，優先使用正在播放或指定的播放清單中的那一首
+    QList<int> searchOrder = { playingPlaylistIndex, preferredPlaylist };
+    for (int i = 0; i < playlists->size(); i++) {
+        searchOrder.append(i);
+    }
+    for (int playlistIndex : searchOrder) {
+        if (playlistIndex < 0 || playlistIndex >= playlists->size()) continue;
+        if (playlists->at(playlistIndex).cacheIndex >= 0) {
+            store->materialize((*playlists)[playlistIndex]);
+        }
+        const int row = playlists->at(playlistIndex).indexOf(key);
+        if (row >= 0) {
+            return { playlistIndex, row, 0 };
+        }
+    }
+    return TrackLocation();
+}
+
+PlaybackState PlaybackCursor::checkpoint(qint64 positionMs) const
+{
+    PlaybackState state;
+    const VideoInfo* video = currentVideo();
+    if (video && video->isLocalFile) {
+        state.playlistName = playlists->at(playingPlaylistIndex).name;
+        state.trackKey = trackKey(*video);
+        state.positionMs = positionMs;
+    }
+    return state;
+}
+
+TrackLocation PlaybackCursor::locate(const PlaybackState& state)
+{
+    const int playlistIndex = findPlaylist(state.playlistName);
+    if (playlistIndex < 0 || state.trackKey.isEmpty()) return TrackLocation();
+    store->materialize((*playlists)[playlistIndex]);
+    const Playlist& playlist = playlists->at(playlistIndex);
+    const int row = playlist.indexOf(state.trackKey);
+    if (row < 0) return TrackLocation();
+
+    // 檔案已被移動或刪除時不恢復
+    const VideoInfo& video = playlist.videos[row];
+    if (!video.isLocalFile || !QFile::exists(video.filePath)) return TrackLocation();
+    return { playlistIndex, row, 0 };
+}
+
+TrackLocation PlaybackCursor::resolve(const QueueEntry& entry) const
+{
+    // 尚未展開的播放清單不在查詢時展開；prune() 會先展開佇列用到的播放清單
+    const int playlistIndex = findPlaylist(entry.playlistName);
+    if (playlistIndex < 0 || playlists->at(playlistIndex).cacheIndex >= 0) {
+        return TrackLocation();
+    }
+    const int row = playlists->at(playlistIndex).indexOf(entry.trackKey);
+    return row >= 0 ? TrackLocation{ playlistIndex, row, entry.handle } : TrackLocation();
+}
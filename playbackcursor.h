@@ -0,0 +1,121 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYBACKCURSOR_H
+#define PLAYBACKCURSOR_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+// 引入播放順序
+#include "playorder.h"
+// 引入待播佇列
+#include "playqueue.h"
+
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 前向宣告播放清單持久化引擎
+class PlaylistStore;
+// 前向宣告播放狀態檢查點
+struct PlaybackState;
+
+// 播放清單中的一首曲目；queueHandle 不為 0 時來自待播佇列
+struct TrackLocation {
+    int playlistIndex = -1;
+    int row = -1;
+    quint64 queueHandle = 0;
+};
+
+// 播放位置：正在播放的播放清單與曲目、播放順序與待播佇列
+//
+// 與 PlaylistModel 一樣直接包裝 Widget 擁有的 QList<Playlist>，不複製任何曲目，也不依賴任何介面元件。
+// 正在播放的播放清單與顯示中的播放清單無關；播放清單新增、刪除或移動曲目時由呼叫端通知，
+// 正在播放的列號由播放順序（PlayOrder）跟著調整。
+//
+// upcoming() 只是查詢：預先轉錄、預先開啟下一首可以隨時呼叫，不會展開播放清單或改動待播佇列。
+// 曲目或播放清單已被刪除的佇列項目在查詢時略過，由 prune() 移除並記錄到 PlaylistStore；
+// 開始播放一首曲目時（play()）會呼叫 prune()。
+class PlaybackCursor
+{
+public:
+    // 建構函式，playlists 為 Widget 擁有的播放清單列表，store 負責展開播放清單與記錄佇列變更
+    PlaybackCursor(QList<Playlist>* playlists, PlaylistStore* store);
+
+    // 正在播放的播放清單索引，沒有時回傳 -1
+    int playlistIndex() const;
+    // 正在播放的列號，沒有時回傳 -1
+    int row() const;
+    // 正在播放的曲目，沒有時回傳 nullptr
+    const VideoInfo* currentVideo() const;
+
+    // 隨機播放模式，開啟時以目前曲目開始新的一輪
+    void setShuffle(bool enabled);
+    bool isShuffle() const;
+    // 循環播放模式
+    void setRepeat(bool enabled);
+    bool isRepeat() const;
+
+    // 換成由 index 播放清單決定播放順序並清除目前曲目；與正在播放的播放清單相同時不做任何事
+    void setPlaylist(int index);
+    // 開始播放 playlistIndex 中的 row，並移除待播佇列中已失效的項目
+    void play(int playlistIndex, int row);
+    // 目前曲目已停止且不再屬於播放清單（例如被刪除），播放清單與播放順序保留
+    void stop();
+
+    // 下一首會播放的曲目，沒有時 row 為 -1
+    TrackLocation next();
+    // 上一首的列號：隨機播放時為實際播放過的上一首，沒有時回傳 -1
+    int previous();
+    // 接下來 count 首會播放的曲目：先是待播佇列，再依循序、循環與隨機播放模式
+    QList<TrackLocation> upcoming(int count);
+
+    // 待播佇列
+    const PlayQueue& queue() const;
+    // 換成載入的待播佇列（不記錄變更）
+    void setQueue(const PlayQueue& queue);
+    // 將 playlistIndex 中的 row 加入待播佇列，playNext 為 true 時排在最前面
+    void enqueue(int playlistIndex, int row, bool playNext);
+    // 從待播佇列移除項目（handle 為 0 或項目不存在時忽略）
+    void dequeue(quint64 handle);
+    // 清空待播佇列
+    void clearQueue();
+    // 移除曲目或播放清單已不存在的佇列項目；項目所在的播放清單尚未展開時先展開
+    void prune();
+
+    // 播放清單 playlistIndex 在 row 插入了一首曲目
+    void trackInserted(int playlistIndex, int row);
+    // 播放清單 playlistIndex 移除了 row
+    void trackRemoved(int playlistIndex, int row);
+    // 播放清單 playlistIndex 的曲目從 from 列移到 to 列
+    void trackMoved(int playlistIndex, int from, int to);
+    // 播放清單 index 已被刪除；刪除的是正在播放的播放清單時回傳 true（呼叫端停止播放）
+    bool playlistRemoved(int index);
+
+    // 依名稱尋找播放清單，找不到時回傳 -1
+    int findPlaylist(const QString& name) const;
+    // 依曲目鍵值尋找曲目，先找正在播放與 preferredPlaylist 播放清單，找不到時 row 為 -1
+    TrackLocation locate(const QString& key, int preferredPlaylist = -1);
+
+    // 目前的播放狀態檢查點：只記錄播放清單中的本地檔案，沒有時 trackKey 為空
+    PlaybackState checkpoint(qint64 positionMs) const;
+    // 找出檢查點中的曲目（展開其播放清單）；播放清單、曲目或檔案已不存在時 row 為 -1
+    TrackLocation locate(const PlaybackState& state);
+
+private:
+    // 解析佇列項目，曲目或播放清單已不存在（或尚未展開）時 row 為 -1
+    TrackLocation resolve(const QueueEntry& entry) const;
+
+    // Widget 擁有的播放清單列表
+    QList<Playlist>* playlists;
+    // 播放清單持久化引擎
+    PlaylistStore* store;
+    // 正在播放的播放清單索引
+    int playingPlaylistIndex;
+    // 正在播放的列號
+    int currentRow;
+    // 正在播放的播放清單的播放順序
+    PlayOrder order;
+    // 待播佇列（可跨播放清單）
+    PlayQueue playQueue;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYBACKCURSOR_H
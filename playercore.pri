@@ -0,0 +1,46 @@
+# Headless core: playlist model and storage, play order, subtitle parsing, full-text search and
+# transcription orchestration. Qt Core only; shared by the GUI, benchmarks and tools.
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/audiotags.cpp \
+    $$PWD/displayhtml.cpp \
+    $$PWD/folderimporter.cpp \
+    $$PWD/playbackcursor.cpp \
+    $$PWD/playlist.cpp \
+    $$PWD/playlistcache.cpp \
+    $$PWD/playlistlibrary.cpp \
+    $$PWD/playlistmodel.cpp \
+    $$PWD/playliststore.cpp \
+    $$PWD/playorder.cpp \
+    $$PWD/playqueue.cpp \
+    $$PWD/searchindex.cpp \
+    $$PWD/searchindexer.cpp \
+    $$PWD/shuffleorder.cpp \
+    $$PWD/subtitlemodel.cpp \
+    $$PWD/subtitleparser.cpp \
+    $$PWD/transcriptcache.cpp \
+    $$PWD/transcriptionqueue.cpp \
+    $$PWD/whisperserver.cpp
+
+HEADERS += \
+    $$PWD/audiotags.h \
+    $$PWD/displayhtml.h \
+    $$PWD/folderimporter.h \
+    $$PWD/playbackcursor.h \
+    $$PWD/playlist.h \
+    $$PWD/playlistcache.h \
+    $$PWD/playlistlibrary.h \
+    $$PWD/playlistmodel.h \
+    $$PWD/playliststore.h \
+    $$PWD/playorder.h \
+    $$PWD/playqueue.h \
+    $$PWD/searchindex.h \
+    $$PWD/searchindexer.h \
+    $$PWD/shuffleorder.h \
+    $$PWD/subtitlemodel.h \
+    $$PWD/subtitleparser.h \
+    $$PWD/transcriptcache.h \
+    $$PWD/transcriptionqueue.h \
+    $$PWD/whisperserver.h
@@ -0,0 +1,157 @@
+// 引入播放清單結構標頭檔
+#include "playlist.h"
+
+// 引入 Qt 目錄處理類別（路徑正規化）
+#include <QDir>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 正規表示式類別
+#include <QRegularExpression>
+
+// 引入 C++ 數學函式庫
+#include <cmath>
+
+QString trackKey(const VideoInfo& video)
+{
+    if (video.isLocalFile) {
+        QString path = QDir::cleanPath(QDir::fromNativeSeparators(video.filePath));
+#ifdef Q_OS_WIN
+        // Windows 檔案系統不分大小寫
+        path = path.toCaseFolded();
+#endif
+        return QStringLiteral("file:") + path;
+    }
+    return QStringLiteral("yt:") + video.videoId;
+}
+
+bool needsTranscription(const VideoInfo& video)
+{
+    return video.isLocalFile && (video.subtitlePath.isEmpty() || !QFile::exists(video.subtitlePath));
+}
+
+float loudnessGain(const VideoInfo& video, double targetLufs)
+{
+    if (!video.hasLoudness) {
+        return 1.0f;
+    }
+    float gain = static_cast<float>(std::pow(10.0, (targetLufs - video.loudness) / 20.0));
+    if (video.peak > 0.0f) {
+        gain = qMin(gain, 1.0f / video.peak);
+    }
+    return gain;
+}
+
+QString youTubeVideoId(const QString& url)
+{
+    static const QRegularExpression watchPattern("youtube\\.com/watch.*[?&]v=([a-zA-Z0-9_-]+)");
+    static const QRegularExpression shortPattern("youtu\\.be/([a-zA-Z0-9_-]+)");
+    static const QRegularExpression embedPattern("youtube\\.com/embed/([a-zA-Z0-9_-]+)");
+
+    for (const QRegularExpression* pattern : { &watchPattern, &shortPattern, &embedPattern }) {
+        const QRegularExpressionMatch match = pattern->match(url);
+        if (match.hasMatch()) {
+            return match.captured(1);
+        }
+    }
+    return QString();
+}
+
+int Playlist::indexOf(const QString& key) const
+{
+    if (!indexValid) {
+        rebuildIndex();
+    }
+    return rowByKey.value(key, -1);
+}
+
+bool Playlist::contains(const VideoInfo& video) const
+{
+    return indexOf(trackKey(video)) >= 0;
+}
+
+void Playlist::append(const VideoInfo& video)
+{
+    videos.append(video);
+    if (indexValid) {
+        const QString key = trackKey(video);
+        if (rowByKey.contains(key)) {
+            hasDuplicateKeys = true;
+        } else {
+            rowByKey.insert(key, videos.size() - 1);
+        }
+    }
+}
+
+void Playlist::removeAt(int row)
+{
+    if (row < 0 || row >= videos.size()) {
+        return;
+    }
+
+    const QString key = trackKey(videos[row]);
+    videos.removeAt(row);
+
+    if (!indexValid) {
+        return;
+    }
+    // 有重複曲目時，被移除的鍵值可能還對應到其他列，直接重建較簡單
+    if (hasDuplicateKeys) {
+        indexValid = false;
+        return;
+    }
+
+    // 後方曲目的列號往前移一位（與 QList::removeAt 本身同為 O(n)）
+    rowByKey.remove(key);
+    for (auto it = rowByKey.begin(); it != rowByKey.end(); ++it) {
+        if (it.value() > row) {
+            it.value()--;
+        }
+    }
+}
+
+void Playlist::replace(int row, const VideoInfo& video)
+{
+    if (row < 0 || row >= videos.size()) {
+        return;
+    }
+
+    const QString oldKey = trackKey(videos[row]);
+    videos[row] = video;
+
+    const QString newKey = trackKey(video);
+    if (indexValid && oldKey != newKey) {
+        indexValid = false;
+    }
+}
+
+void Playlist::move(int from, int to)
+{
+    if (from < 0 || from >= videos.size() || to < 0 || to >= videos.size() || from == to) {
+        return;
+    }
+    videos.move(from, to);
+    indexValid = false;
+}
+
+void Playlist::setVideos(const QList<VideoInfo>& newVideos)
+{
+    videos = newVideos;
+    indexValid = false;
+}
+
+void Playlist::rebuildIndex() const
+{
+    rowByKey.clear();
+    rowByKey.reserve(videos.size());
+    hasDuplicateKeys = false;
+
+    for (int i = 0; i < videos.size(); i++) {
+        const QString key = trackKey(videos[i]);
+        if (rowByKey.contains(key)) {
+            hasDuplicateKeys = true;
+        } else {
+            rowByKey.insert(key, i);
+        }
+    }
+    indexValid = true;
+}
@@ -0,0 +1,80 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+// 引入 Qt 字串類別
+#include <QString>
+// 引入 Qt 清單容器類別
+#include <QList>
+// 引入 Qt 雜湊表類別
+#include <QHash>
+
+// 影片/音樂資訊結構
+struct VideoInfo {
+    QString videoId;          // YouTube 影片 ID (用於 YouTube 連結)
+    QString filePath;         // 本地檔案路徑 (用於本地音樂)
+    QString title;            // 影片/音樂標題
+    QString channelTitle;     // 頻道名稱/藝術家
+    QString thumbnailUrl;     // 縮圖 URL
+    QString description;      // 描述
+    QString subtitlePath;     // 字幕檔案路徑 (SRT 檔案)
+    bool isFavorite;          // 是否為喜愛的影片/音樂
+    bool isLocalFile;         // 是否為本地檔案
+    bool hasLoudness = false; // 是否已分析響度
+    float loudness = 0.0f;    // 整合響度 (LUFS，EBU R128)
+    float peak = 0.0f;        // 樣本峰值 (線性，1.0 為滿刻度)
+};
+
+// 取得曲目的正規化鍵值，用於判斷兩首曲目是否相同
+// 本地檔案為 "file:" 加正規化路徑，YouTube 影片為 "yt:" 加影片 ID
+QString trackKey(const VideoInfo& video);
+
+// 曲目是否需要轉錄（本地檔案且沒有可用的字幕）
+bool needsTranscription(const VideoInfo& video);
+
+// 曲目的播放增益：把整合響度調整到 targetLufs，但放大後的峰值不超過滿刻度；尚未分析時不調整
+float loudnessGain(const VideoInfo& video, double targetLufs);
+
+// 從 YouTube 連結提取影片 ID，無法識別時回傳空字串
+// 支援 youtube.com/watch?v=ID、youtu.be/ID 與 youtube.com/embed/ID
+QString youTubeVideoId(const QString& url);
+
+// 播放清單結構
+//
+// videos 可以直接讀取；新增、刪除或替換曲目請使用下列成員函式，
+// 以維護「曲目鍵值 → 列號」的雜湊索引，讓重複檢查與查找為 O(1)。
+// 索引在第一次查詢時才建立，直接改寫整份 videos 後呼叫 setVideos() 使其失效即可。
+struct Playlist {
+    QString name;              // 播放清單名稱
+    QList<VideoInfo> videos;   // 影片列表
+    int cacheIndex = -1;       // 尚未從二進位快取展開時的快取索引（-1 表示 videos 已載入）
+
+    // 取得鍵值對應的列號，不存在時回傳 -1
+    int indexOf(const QString& key) const;
+    // 檢查播放清單中是否已有相同的曲目
+    bool contains(const VideoInfo& video) const;
+    // 在尾端加入曲目
+    void append(const VideoInfo& video);
+    // 移除指定列的曲目
+    void removeAt(int row);
+    // 替換指定列的曲目
+    void replace(int row, const VideoInfo& video);
+    // 將曲目從 from 列移動到 to 列
+    void move(int from, int to);
+    // 以新的曲目列表取代整份播放清單
+    void setVideos(const QList<VideoInfo>& newVideos);
+
+private:
+    // 重建雜湊索引
+    void rebuildIndex() const;
+
+    // 曲目鍵值 → 列號的索引（重複曲目只記錄第一列）
+    mutable QHash<QString, int> rowByKey;
+    // 索引是否與 videos 一致
+    mutable bool indexValid = false;
+    // 建立索引時是否發現重複的鍵值（舊版資料可能存在）
+    mutable bool hasDuplicateKeys = false;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYLIST_H
@@ -0,0 +1,324 @@
+// 引入播放清單二進位快取標頭檔
+#include "playlistcache.h"
+
+// 引入 Qt 原子性存檔類別
+#include <QSaveFile>
+// 引入 Qt 雜湊表類別
+#include <QHash>
+// 引入 Qt 動態陣列類別
+#include <QVector>
+// 引入 C 字串函式（memcmp/memcpy）
+#include <cstring>
+
+namespace {
+    // 檔案開頭的魔術字
+    const char CACHE_MAGIC[8] = { 'L', 'R', 'P', 'L', 'C', 'A', 'C', 'H' };
+    // 格式版本，結構變更時遞增
+    const quint32 CACHE_VERSION = 2;
+    // 位元組順序標記，與本機不符時視為過期
+    const quint32 BYTE_ORDER_MARK = 0x01020304;
+    // 每首曲目儲存的字串欄位數
+    const int TRACK_STRING_FIELDS = 7;
+
+    // 曲目旗標
+    enum TrackFlag : quint32 {
+        FavoriteFlag = 0x1,
+        LocalFileFlag = 0x2,
+        LoudnessFlag = 0x4
+    };
+
+    // 向上對齊到 8 位元組
+    quint64 alignUp(quint64 value)
+    {
+        return (value + 7) & ~quint64(7);
+    }
+}
+
+struct PlaylistCache::Header {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    qint64 sourceSize;            // 來源 JSON 快照的大小
+    qint64 sourceModified;        // 來源 JSON 快照的修改時間（毫秒）
+    qint64 sourceSequence;        // 來源 JSON 快照的日誌序號
+    quint32 stringCount;
+    quint32 playlistCount;
+    quint32 trackCount;
+    quint32 lastPlaylistString;
+    quint64 stringOffsetsOffset;
+    quint64 stringDataOffset;
+    quint64 playlistTableOffset;
+    quint64 trackTableOffset;
+};
+
+struct PlaylistCache::PlaylistEntry {
+    quint32 nameString;
+    quint32 firstTrack;
+    quint32 trackCount;
+    quint32 reserved;
+};
+
+struct PlaylistCache::TrackEntry {
+    // 依序為 videoId、filePath、title、channelTitle、thumbnailUrl、description、subtitlePath
+    quint32 strings[TRACK_STRING_FIELDS];
+    quint32 flags;
+    // 整合響度與樣本峰值，只在有 LoudnessFlag 時有效
+    float loudness;
+    float peak;
+};
+
+QSharedPointer<PlaylistCache> PlaylistCache::open(const QString& path, qint64 sourceSize, qint64 sourceModified)
+{
+    QSharedPointer<PlaylistCache> cache(new PlaylistCache());
+    cache->file.setFileName(path);
+    if (!cache->file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    cache->size = cache->file.size();
+    if (cache->size < static_cast<qint64>(sizeof(Header))) {
+        return {};
+    }
+    cache->data = cache->file.map(0, cache->size);
+    if (!cache->data) {
+        return {};
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(cache->data);
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header->version != CACHE_VERSION ||
+        header->byteOrderMark != BYTE_ORDER_MARK) {
+        return {};
+    }
+
+    // 來源快照已被改寫，快取過期
+    if (header->sourceSize != sourceSize || header->sourceModified != sourceModified) {
+        return {};
+    }
+
+    // 驗證所有區段都落在檔案範圍內，避免損毀的快取造成越界讀取
+    const quint64 fileSize = static_cast<quint64>(cache->size);
+    const quint64 stringOffsetsEnd = header->stringOffsetsOffset + (quint64(header->stringCount) + 1) * sizeof(quint32);
+    const quint64 playlistTableEnd = header->playlistTableOffset + quint64(header->playlistCount) * sizeof(PlaylistEntry);
+    const quint64 trackTableEnd = header->trackTableOffset + quint64(header->trackCount) * sizeof(TrackEntry);
+    if (stringOffsetsEnd > fileSize || header->stringDataOffset > fileSize ||
+        playlistTableEnd > fileSize || trackTableEnd > fileSize ||
+        header->stringOffsetsOffset % 8 || header->stringDataOffset % 8 ||
+        header->playlistTableOffset % 8 || header->trackTableOffset % 8) {
+        return {};
+    }
+
+    const quint32* stringOffsets = reinterpret_cast<const quint32*>(cache->data + header->stringOffsetsOffset);
+    const quint64 stringDataEnd = header->stringDataOffset + quint64(stringOffsets[header->stringCount]) * sizeof(QChar);
+    if (stringDataEnd > fileSize) {
+        return {};
+    }
+
+    cache->header = header;
+    cache->stringOffsets = stringOffsets;
+    cache->stringData = reinterpret_cast<const QChar*>(cache->data + header->stringDataOffset);
+    cache->playlistTable = reinterpret_cast<const PlaylistEntry*>(cache->data + header->playlistTableOffset);
+    cache->trackTable = reinterpret_cast<const TrackEntry*>(cache->data + header->trackTableOffset);
+
+    // 播放清單的曲目範圍也必須有效
+    for (quint32 i = 0; i < header->playlistCount; i++) {
+        const PlaylistEntry& entry = cache->playlistTable[i];
+        if (quint64(entry.firstTrack) + entry.trackCount > header->trackCount) {
+            return {};
+        }
+    }
+
+    return cache;
+}
+
+bool PlaylistCache::write(const QString& path, const QList<Playlist>& playlists, const QString& lastPlaylistName,
+                          qint64 sequence, qint64 sourceSize, qint64 sourceModified,
+                          const PlaylistCache* source)
+{
+    // 字串去重：編號 0 固定為空字串
+    QHash<QString, quint32> stringIds;
+    QVector<quint32> stringOffsets;
+    QString stringData;
+    stringOffsets.append(0);
+    stringOffsets.append(0);
+
+    auto intern = [&](const QString& text) -> quint32 {
+        if (text.isEmpty()) {
+            return 0;
+        }
+        auto it = stringIds.constFind(text);
+        if (it != stringIds.constEnd()) {
+            return it.value();
+        }
+        const quint32 id = static_cast<quint32>(stringOffsets.size() - 1);
+        stringData.append(text);
+        stringOffsets.append(static_cast<quint32>(stringData.size()));
+        stringIds.insert(text, id);
+        return id;
+    };
+
+    QVector<PlaylistEntry> playlistEntries;
+    QVector<TrackEntry> trackEntries;
+    playlistEntries.reserve(playlists.size());
+
+    for (const Playlist& playlist : playlists) {
+        const QList<VideoInfo> videos = (playlist.cacheIndex >= 0 && source)
+            ? source->videos(playlist.cacheIndex)
+            : playlist.videos;
+
+        PlaylistEntry entry;
+        entry.nameString = intern(playlist.name);
+        entry.firstTrack = static_cast<quint32>(trackEntries.size());
+        entry.trackCount = static_cast<quint32>(videos.size());
+        entry.reserved = 0;
+        playlistEntries.append(entry);
+
+        for (const VideoInfo& video : videos) {
+            TrackEntry track;
+            track.strings[0] = intern(video.videoId);
+            track.strings[1] = intern(video.filePath);
+            track.strings[2] = intern(video.title);
+            track.strings[3] = intern(video.channelTitle);
+            track.strings[4] = intern(video.thumbnailUrl);
+            track.strings[5] = intern(video.description);
+            track.strings[6] = intern(video.subtitlePath);
+            track.flags = (video.isFavorite ? FavoriteFlag : 0) | (video.isLocalFile ? LocalFileFlag : 0) |
+                          (video.hasLoudness ? LoudnessFlag : 0);
+            track.loudness = video.loudness;
+            track.peak = video.peak;
+            trackEntries.append(track);
+        }
+    }
+
+    Header header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.sourceSize = sourceSize;
+    header.sourceModified = sourceModified;
+    header.sourceSequence = sequence;
+    header.lastPlaylistString = intern(lastPlaylistName);
+    header.stringCount = static_cast<quint32>(stringOffsets.size() - 1);
+    header.playlistCount = static_cast<quint32>(playlistEntries.size());
+    header.trackCount = static_cast<quint32>(trackEntries.size());
+    header.stringOffsetsOffset = alignUp(sizeof(Header));
+    header.stringDataOffset = alignUp(header.stringOffsetsOffset + quint64(stringOffsets.size()) * sizeof(quint32));
+    header.playlistTableOffset = alignUp(header.stringDataOffset + quint64(stringData.size()) * sizeof(QChar));
+    header.trackTableOffset = alignUp(header.playlistTableOffset + quint64(playlistEntries.size()) * sizeof(PlaylistEntry));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    // 依序寫入各區段，區段之間以零填充對齊
+    quint64 written = 0;
+    auto writeAt = [&](quint64 offset, const void* bytes, quint64 length) {
+        static const char padding[8] = {};
+        if (offset > written) {
+            file.write(padding, static_cast<qint64>(offset - written));
+        }
+        file.write(static_cast<const char*>(bytes), static_cast<qint64>(length));
+        written = offset + length;
+    };
+
+    writeAt(0, &header, sizeof(Header));
+    writeAt(header.stringOffsetsOffset, stringOffsets.constData(), quint64(stringOffsets.size()) * sizeof(quint32));
+    writeAt(header.stringDataOffset, stringData.constData(), quint64(stringData.size()) * sizeof(QChar));
+    writeAt(header.playlistTableOffset, playlistEntries.constData(), quint64(playlistEntries.size()) * sizeof(PlaylistEntry));
+    writeAt(header.trackTableOffset, trackEntries.constData(), quint64(trackEntries.size()) * sizeof(TrackEntry));
+
+    return file.commit();
+}
+
+QString PlaylistCache::fileName() const
+{
+    return file.fileName();
+}
+
+qint64 PlaylistCache::sourceSequence() const
+{
+    return header->sourceSequence;
+}
+
+QString PlaylistCache::lastPlaylistName() const
+{
+    return string(header->lastPlaylistString);
+}
+
+int PlaylistCache::playlistCount() const
+{
+    return static_cast<int>(header->playlistCount);
+}
+
+QString PlaylistCache::playlistName(int playlistIndex) const
+{
+    if (playlistIndex < 0 || playlistIndex >= playlistCount()) {
+        return QString();
+    }
+    return string(playlistTable[playlistIndex].nameString);
+}
+
+int PlaylistCache::trackCount(int playlistIndex) const
+{
+    if (playlistIndex < 0 || playlistIndex >= playlistCount()) {
+        return 0;
+    }
+    return static_cast<int>(playlistTable[playlistIndex].trackCount);
+}
+
+QList<VideoInfo> PlaylistCache::videos(int playlistIndex) const
+{
+    QList<VideoInfo> videos;
+    if (playlistIndex < 0 || playlistIndex >= playlistCount()) {
+        return videos;
+    }
+
+    const PlaylistEntry& entry = playlistTable[playlistIndex];
+    videos.reserve(static_cast<int>(entry.trackCount));
+
+    // 同一播放清單中重複的字串（頻道名稱等）共用同一個 QString
+    QHash<quint32, QString> materialized;
+    auto text = [&](quint32 id) -> QString {
+        if (id == 0) {
+            return QString();
+        }
+        auto it = materialized.constFind(id);
+        if (it != materialized.constEnd()) {
+            return it.value();
+        }
+        return materialized.insert(id, string(id)).value();
+    };
+
+    for (quint32 i = 0; i < entry.trackCount; i++) {
+        const TrackEntry& track = trackTable[entry.firstTrack + i];
+        VideoInfo video;
+        video.videoId = text(track.strings[0]);
+        video.filePath = text(track.strings[1]);
+        video.title = text(track.strings[2]);
+        video.channelTitle = text(track.strings[3]);
+        video.thumbnailUrl = text(track.strings[4]);
+        video.description = text(track.strings[5]);
+        video.subtitlePath = text(track.strings[6]);
+        video.isFavorite = (track.flags & FavoriteFlag) != 0;
+        video.isLocalFile = (track.flags & LocalFileFlag) != 0;
+        video.hasLoudness = (track.flags & LoudnessFlag) != 0;
+        video.loudness = track.loudness;
+        video.peak = track.peak;
+        videos.append(video);
+    }
+    return videos;
+}
+
+QString PlaylistCache::string(quint32 id) const
+{
+    if (id == 0 || id >= header->stringCount) {
+        return QString();
+    }
+    const quint32 begin = stringOffsets[id];
+    const quint32 end = stringOffsets[id + 1];
+    if (begin > end || end > stringOffsets[header->stringCount]) {
+        return QString();
+    }
+    return QString(stringData + begin, static_cast<int>(end - begin));
+}
@@ -0,0 +1,71 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYLISTCACHE_H
+#define PLAYLISTCACHE_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 共享指標類別
+#include <QSharedPointer>
+
+// 播放清單的二進位快取（youtube_playlists.<seq>.cache）
+//
+// 由 JSON 快照產生的唯讀側檔，以記憶體映射方式開啟，不需解析即可讀取：
+//   檔頭         魔術字、版本、來源快照的大小/修改時間/序號（用來判斷是否過期）
+//   字串偏移表   quint32[字串數 + 1]，每個字串在字串資料區中的起訖位置（UTF-16 單位）
+//   字串資料區   所有去重後的字串，重複的頻道名稱、路徑前綴等只存一份
+//   播放清單表   每個播放清單的名稱字串編號與曲目範圍
+//   曲目表       每首曲目固定 40 位元組：七個字串編號、旗標、響度與峰值
+// 開啟快取只需驗證檔頭；曲目在需要時才逐一展開成 VideoInfo。
+class PlaylistCache
+{
+public:
+    // 開啟並映射快取，檔案不存在、損毀或與來源快照不符時回傳空指標
+    static QSharedPointer<PlaylistCache> open(const QString& path, qint64 sourceSize, qint64 sourceModified);
+    // 將播放清單寫成快取檔案；尚未展開的播放清單從 source 讀取
+    static bool write(const QString& path, const QList<Playlist>& playlists, const QString& lastPlaylistName,
+                      qint64 sequence, qint64 sourceSize, qint64 sourceModified,
+                      const PlaylistCache* source = nullptr);
+
+    // 映射中的快取檔案路徑
+    QString fileName() const;
+    // 來源快照涵蓋到的日誌序號
+    qint64 sourceSequence() const;
+    // 上次使用的播放清單名稱
+    QString lastPlaylistName() const;
+    // 播放清單數量
+    int playlistCount() const;
+    // 指定播放清單的名稱
+    QString playlistName(int playlistIndex) const;
+    // 指定播放清單的曲目數
+    int trackCount(int playlistIndex) const;
+    // 展開指定播放清單的所有曲目
+    QList<VideoInfo> videos(int playlistIndex) const;
+
+private:
+    // 檔案內的結構，定義於 playlistcache.cpp
+    struct Header;
+    struct PlaylistEntry;
+    struct TrackEntry;
+
+    PlaylistCache() = default;
+    // 依編號讀取字串，編號無效時回傳空字串
+    QString string(quint32 id) const;
+
+    // 映射中的快取檔案（需保持開啟，映射才有效）
+    QFile file;
+    // 映射的起始位址與長度
+    const uchar* data = nullptr;
+    qint64 size = 0;
+    // 指向映射區域內各區段的指標
+    const Header* header = nullptr;
+    const quint32* stringOffsets = nullptr;
+    const QChar* stringData = nullptr;
+    const PlaylistEntry* playlistTable = nullptr;
+    const TrackEntry* trackTable = nullptr;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYLISTCACHE_H
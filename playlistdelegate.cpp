@@ -0,0 +1,81 @@
+// 引入播放清單繪製代理標頭檔
+#include "playlistdelegate.h"
+// 引入播放清單資料模型（自訂資料角色）
+#include "playlistmodel.h"
+
+// 引入 Qt 繪圖類別
+#include <QPainter>
+// 引入 Qt 字型度量類別
+#include <QFontMetrics>
+
+namespace {
+    // 項目內邊距
+    const int ITEM_PADDING = 10;
+    // 次要文字相對標題縮排
+    const int CHANNEL_INDENT = 12;
+}
+
+PlaylistDelegate::PlaylistDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void PlaylistDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    painter->save();
+
+    const bool isCurrent = index.data(PlaylistModel::IsCurrentRole).toBool();
+    const bool isSelected = option.state & QStyle::State_Selected;
+    const bool isHovered = option.state & QStyle::State_MouseOver;
+    const QRect rect = option.rect;
+
+    // 背景：正在播放 > 選取 > 滑鼠懸停
+    if (isCurrent) {
+        painter->fillRect(rect, QColor("#1DB954"));
+    } else if (isSelected) {
+        painter->fillRect(rect, QColor("#1AA34A"));
+    } else if (isHovered) {
+        painter->fillRect(rect, QColor("#282828"));
+    }
+
+    // 底部分隔線
+    painter->setPen(QColor("#282828"));
+    painter->drawLine(rect.bottomLeft(), rect.bottomRight());
+
+    const QRect textRect = rect.adjusted(ITEM_PADDING, ITEM_PADDING, -ITEM_PADDING, -ITEM_PADDING);
+    const bool highlighted = isCurrent || isSelected || isHovered;
+
+    // 標題
+    QFont titleFont = option.font;
+    titleFont.setBold(isCurrent);
+    painter->setFont(titleFont);
+    painter->setPen(highlighted ? QColor("#FFFFFF") : QColor("#B3B3B3"));
+    const QFontMetrics titleMetrics(titleFont);
+    const QString title = titleMetrics.elidedText(index.data(Qt::DisplayRole).toString(),
+                                                  Qt::ElideRight, textRect.width());
+    painter->drawText(QRect(textRect.left(), textRect.top(), textRect.width(), titleMetrics.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter, title);
+
+    // 頻道名稱
+    QFont channelFont = option.font;
+    painter->setFont(channelFont);
+    painter->setPen(highlighted ? QColor("#FFFFFF") : QColor("#B3B3B3"));
+    const QFontMetrics channelMetrics(channelFont);
+    const QRect channelRect(textRect.left() + CHANNEL_INDENT, textRect.top() + titleMetrics.height(),
+                            textRect.width() - CHANNEL_INDENT, channelMetrics.height());
+    const QString channel = channelMetrics.elidedText(index.data(PlaylistModel::ChannelRole).toString(),
+                                                      Qt::ElideRight, channelRect.width());
+    painter->drawText(channelRect, Qt::AlignLeft | Qt::AlignVCenter, channel);
+
+    painter->restore();
+}
+
+QSize PlaylistDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(index);
+    // 兩行文字加上下內邊距，與內容無關，所以所有項目同高
+    QFont boldFont = option.font;
+    boldFont.setBold(true);
+    const int height = QFontMetrics(boldFont).height() + QFontMetrics(option.font).height() + ITEM_PADDING * 2;
+    return QSize(option.rect.width(), height);
+}
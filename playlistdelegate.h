@@ -0,0 +1,27 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYLISTDELEGATE_H
+#define PLAYLISTDELEGATE_H
+
+// 引入 Qt 項目繪製代理基底類別
+#include <QStyledItemDelegate>
+
+// 播放清單項目的繪製代理
+//
+// 以兩行顯示標題與頻道名稱，正在播放的曲目以綠色背景與粗體標示。
+// 所有項目高度相同，搭配 QListView::setUniformItemSizes 只需計算一次尺寸。
+class PlaylistDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    // 建構函式
+    explicit PlaylistDelegate(QObject* parent = nullptr);
+
+    // 繪製單一項目
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    // 項目尺寸（固定高度）
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYLISTDELEGATE_H
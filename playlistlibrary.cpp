@@ -0,0 +1,244 @@
+// 引入播放清單編輯標頭檔
+#include "playlistlibrary.h"
+// 引入播放清單資料模型
+#include "playlistmodel.h"
+// 引入播放位置
+#include "playbackcursor.h"
+// 引入搜尋索引的維護
+#include "searchindexer.h"
+
+// 引入 Qt 集合容器類別
+#include <QSet>
+
+namespace {
+    // 第一次啟動時建立的播放清單
+    const QString DEFAULT_PLAYLIST_NAME = "我的播放清單";
+    const QString FAVORITES_PLAYLIST_NAME = "我的最愛";
+
+    // 本地檔案的曲目鍵值
+    QString localFileKey(const QString& filePath)
+    {
+        VideoInfo audio;
+        audio.filePath = filePath;
+        audio.isLocalFile = true;
+        return trackKey(audio);
+    }
+}
+
+PlaylistLibrary::PlaylistLibrary(QList<Playlist>* playlists, PlaylistModel* model, PlaybackCursor* cursor,
+                                 PlaylistStore* store, SearchIndexer* indexer)
+    : playlists(playlists)
+    , model(model)
+    , cursor(cursor)
+    , store(store)
+    , indexer(indexer)
+{
+}
+
+int PlaylistLibrary::load()
+{
+    // 載入快照並重播變更日誌
+    PlaylistSnapshot snapshot;
+    if (store->load(snapshot)) {
+        *playlists = snapshot.playlists;
+        lastPlaylistName = snapshot.lastPlaylistName;
+        cursor->setQueue(snapshot.queue);
+    }
+
+    if (playlists->isEmpty()) {
+        addPlaylist(DEFAULT_PLAYLIST_NAME);
+        addPlaylist(FAVORITES_PLAYLIST_NAME);
+    }
+
+    // 只展開上次使用的播放清單，其餘播放清單在切換時才從快取展開
+    const int index = qMax(indexOf(lastPlaylistName), 0);
+    select(index);
+    return index;
+}
+
+PlaylistSnapshot PlaylistLibrary::snapshot() const
+{
+    PlaylistSnapshot snapshot;
+    snapshot.playlists = *playlists;
+    snapshot.lastPlaylistName = lastPlaylistName;
+    snapshot.queue = cursor->queue();
+    return snapshot;
+}
+
+int PlaylistLibrary::indexOf(const QString& name) const
+{
+    for (int i = 0; i < playlists->size(); i++) {
+        if (playlists->at(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool PlaylistLibrary::addPlaylist(const QString& name)
+{
+    if (indexOf(name) >= 0) return false;
+
+    Playlist playlist;
+    playlist.name = name;
+    playlists->append(playlist);
+    store->recordPlaylistAdded(name);
+    return true;
+}
+
+bool PlaylistLibrary::removePlaylist(int index)
+{
+    // 刪除後仍在其他播放清單中的曲目保留在搜尋索引
+    QStringList keys;
+    for (const VideoInfo& video : store->videos(playlists->at(index))) {
+        keys.append(trackKey(video));
+    }
+
+    // 先讓模型脫離即將刪除的播放清單（之後的播放清單索引也會改變）
+    model->setPlaylistIndex(-1);
+    playlists->removeAt(index);
+    store->recordPlaylistRemoved(index);
+    indexer->removeTracks(keys);
+    return cursor->playlistRemoved(index);
+}
+
+void PlaylistLibrary::select(int index)
+{
+    Playlist& playlist = (*playlists)[index];
+    store->materialize(playlist);
+    if (lastPlaylistName != playlist.name) {
+        lastPlaylistName = playlist.name;
+        store->recordLastPlaylist(lastPlaylistName);
+    }
+}
+
+int PlaylistLibrary::addTrack(int index, const VideoInfo& video, bool* added)
+{
+    Playlist& playlist = (*playlists)[index];
+    store->materialize(playlist);
+
+    // 透過雜湊索引檢查是否已存在，同時取得其位置
+    const int row = playlist.indexOf(trackKey(video));
+    if (added) {
+        *added = row < 0;
+    }
+    if (row >= 0) return row;
+
+    append(index, { video });
+    return playlist.videos.size() - 1;
+}
+
+int PlaylistLibrary::addTracks(int index, const QList<VideoInfo>& videos)
+{
+    Playlist& playlist = (*playlists)[index];
+    store->materialize(playlist);
+
+    // 透過雜湊索引略過已存在的曲目（同一批內的重複也會被排除）
+    QList<VideoInfo> newTracks;
+    QSet<QString> batchKeys;
+    for (const VideoInfo& video : videos) {
+        const QString key = trackKey(video);
+        if (playlist.indexOf(key) >= 0 || batchKeys.contains(key)) continue;
+        batchKeys.insert(key);
+        newTracks.append(video);
+    }
+    if (!newTracks.isEmpty()) {
+        append(index, newTracks);
+    }
+    return newTracks.size();
+}
+
+void PlaylistLibrary::append(int index, const QList<VideoInfo>& videos)
+{
+    // 顯示中的播放清單透過模型一次插入，其餘直接加入
+    if (index == model->playlistIndex()) {
+        model->appendTracks(videos);
+    } else {
+        Playlist& playlist = (*playlists)[index];
+        for (const VideoInfo& video : videos) {
+            playlist.append(video);
+            cursor->trackInserted(index, playlist.videos.size() - 1);
+        }
+    }
+    for (const VideoInfo& video : videos) {
+        store->recordVideoAdded(index, video);
+        indexer->addTrack(video);
+    }
+}
+
+void PlaylistLibrary::removeTrack(int index, int row)
+{
+    Playlist& playlist = (*playlists)[index];
+    const QString key = trackKey(playlist.videos.at(row));
+
+    // 顯示中的播放清單透過模型移除（只通知被移除的那一列），其餘直接移除
+    if (index == model->playlistIndex()) {
+        model->removeTrack(row);
+    } else {
+        playlist.removeAt(row);
+        cursor->trackRemoved(index, row);
+    }
+    store->recordVideoRemoved(index, row);
+
+    // 曲目已不在任何播放清單中時從搜尋索引移除
+    indexer->removeTracks({ key });
+}
+
+void PlaylistLibrary::setSubtitlePath(int index, int row, const QString& srtFilePath)
+{
+    VideoInfo& video = (*playlists)[index].videos[row];
+    video.subtitlePath = srtFilePath;
+    store->recordVideoUpdated(index, row, video);
+    indexer->indexTranscript(trackKey(video), srtFilePath);
+}
+
+void PlaylistLibrary::saveTranscript(const QString& audioFilePath, const QString& srtFilePath)
+{
+    updateLocalFile(audioFilePath, [&srtFilePath](VideoInfo& video) {
+        if (video.subtitlePath == srtFilePath) return false;
+        video.subtitlePath = srtFilePath;
+        return true;
+    });
+
+    // 新的字幕立即可以搜尋
+    indexer->indexTranscript(localFileKey(audioFilePath), srtFilePath);
+}
+
+void PlaylistLibrary::saveLoudness(const QString& audioFilePath, double loudness, float peak)
+{
+    updateLocalFile(audioFilePath, [loudness, peak](VideoInfo& video) {
+        video.hasLoudness = true;
+        video.loudness = static_cast<float>(loudness);
+        video.peak = peak;
+        return true;
+    });
+}
+
+QStringList PlaylistLibrary::unanalyzedFiles(int index) const
+{
+    QStringList paths;
+    for (const VideoInfo& video : playlists->at(index).videos) {
+        if (video.isLocalFile && !video.hasLoudness) {
+            paths.append(video.filePath);
+        }
+    }
+    return paths;
+}
+
+void PlaylistLibrary::updateLocalFile(const QString& audioFilePath, const std::function<bool(VideoInfo&)>& update)
+{
+    // 透過雜湊索引找出各播放清單中的同一首曲目
+    const QString key = localFileKey(audioFilePath);
+    for (int i = 0; i < playlists->size(); i++) {
+        Playlist& playlist = (*playlists)[i];
+        if (playlist.cacheIndex >= 0) continue;
+
+        const int row = playlist.indexOf(key);
+        if (row < 0) continue;
+
+        VideoInfo& video = playlist.videos[row];
+        if (update(video)) {
+            store->recordVideoUpdated(i, row, video);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYLISTLIBRARY_H
+#define PLAYLISTLIBRARY_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+// 引入播放清單持久化引擎（快照結構）
+#include "playliststore.h"
+
+// 引入 Qt 清單容器類別
+#include <QList>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+
+// 引入 C++ 函式物件
+#include <functional>
+
+// 前向宣告播放清單資料模型
+class PlaylistModel;
+// 前向宣告播放位置
+class PlaybackCursor;
+// 前向宣告搜尋索引的維護
+class SearchIndexer;
+
+// 播放清單的編輯：新增、刪除播放清單與曲目，寫回曲目的字幕與響度
+//
+// 與 PlaybackCursor 一樣直接包裝 Widget 擁有的 QList<Playlist>，不依賴任何介面元件。
+// 每項編輯都通知所有相關的物件：顯示中的播放清單透過 PlaylistModel 修改（播放順序由呼叫端
+// 依模型的列信號調整），其餘播放清單直接修改並通知 PlaybackCursor；變更記錄到 PlaylistStore，
+// 新增的曲目與字幕收錄到 SearchIndexer，刪除後已不在任何播放清單中的曲目從索引移除。
+// 索引參數由呼叫端確認有效。
+class PlaylistLibrary
+{
+public:
+    // 建構函式，playlists 為 Widget 擁有的播放清單列表
+    PlaylistLibrary(QList<Playlist>* playlists, PlaylistModel* model, PlaybackCursor* cursor,
+                    PlaylistStore* store, SearchIndexer* indexer);
+
+    // 載入保存的播放清單與待播佇列，沒有任何播放清單時建立預設的播放清單；
+    // 展開並回傳上次使用的播放清單索引
+    int load();
+    // 壓縮日誌時所需的完整狀態快照
+    PlaylistSnapshot snapshot() const;
+
+    // 名稱為 name 的播放清單索引，不存在時回傳 -1
+    int indexOf(const QString& name) const;
+    // 在尾端新增空的播放清單，名稱已存在時回傳 false
+    bool addPlaylist(const QString& name);
+    // 刪除 index 播放清單（模型脫離顯示中的播放清單，由呼叫端重新設定）；
+    // 刪除的是正在播放的播放清單時回傳 true
+    bool removePlaylist(int index);
+    // 切換到 index 播放清單：從快取展開並記錄為上次使用的播放清單
+    void select(int index);
+
+    // 將 video 加入 index 播放清單並回傳所在的列；已存在時不重複加入，added 設為 false
+    int addTrack(int index, const VideoInfo& video, bool* added = nullptr);
+    // 將 videos 加入 index 播放清單，略過已存在與同一批內重複的曲目，回傳加入的數量
+    int addTracks(int index, const QList<VideoInfo>& videos);
+    // 移除 index 播放清單的 row
+    void removeTrack(int index, int row);
+
+    // 設定 index 播放清單中 row 的字幕檔案並收錄到搜尋索引
+    void setSubtitlePath(int index, int row, const QString& srtFilePath);
+    // 本地檔案 audioFilePath 的字幕完成：寫回各播放清單中的同一首曲目並收錄到搜尋索引
+    void saveTranscript(const QString& audioFilePath, const QString& srtFilePath);
+    // 本地檔案 audioFilePath 的響度分析完成：寫回各播放清單中的同一首曲目
+    void saveLoudness(const QString& audioFilePath, double loudness, float peak);
+    // index 播放清單中還沒有響度的本地檔案
+    QStringList unanalyzedFiles(int index) const;
+
+private:
+    // 將 videos 加入 index 播放清單的尾端（已排除重複）
+    void append(int index, const QList<VideoInfo>& videos);
+    // 以 update 修改各播放清單中的本地檔案 audioFilePath，update 回傳 true 時記錄變更；
+    // 尚未從快取展開的播放清單不展開，之後播放時再從字幕快取或響度分析取得
+    void updateLocalFile(const QString& audioFilePath, const std::function<bool(VideoInfo&)>& update);
+
+    // Widget 擁有的播放清單列表
+    QList<Playlist>* playlists;
+    // 播放清單資料模型（顯示中的播放清單）
+    PlaylistModel* model;
+    // 播放位置
+    PlaybackCursor* cursor;
+    // 播放清單持久化引擎
+    PlaylistStore* store;
+    // 搜尋索引的維護
+    SearchIndexer* indexer;
+    // 上次使用的播放清單名稱
+    QString lastPlaylistName;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYLISTLIBRARY_H
@@ -0,0 +1,245 @@
+// 引入播放清單資料模型標頭檔
+#include "playlistmodel.h"
+
+// 引入 Qt 拖放資料類別
+#include <QMimeData>
+// 引入 Qt 資料串流類別
+#include <QDataStream>
+
+namespace {
+    // 拖放時攜帶列號的 MIME 類型
+    const char* const ROWS_MIME_TYPE = "application/x-last-report-playlist-rows";
+}
+
+PlaylistModel::PlaylistModel(QList<Playlist>* playlists, QObject* parent)
+    : QAbstractListModel(parent)
+    , playlists(playlists)
+    , currentPlaylistIndex(-1)
+    , playingRow(-1)
+{
+}
+
+void PlaylistModel::setPlaylistIndex(int index)
+{
+    beginResetModel();
+    currentPlaylistIndex = index;
+    playingRow = -1;
+    endResetModel();
+}
+
+int PlaylistModel::playlistIndex() const
+{
+    return currentPlaylistIndex;
+}
+
+void PlaylistModel::setCurrentRow(int row)
+{
+    if (row == playingRow) {
+        return;
+    }
+
+    const int previousRow = playingRow;
+    playingRow = row;
+
+    const QVector<int> roles{ IsCurrentRole };
+    if (previousRow >= 0 && previousRow < rowCount()) {
+        emit dataChanged(index(previousRow), index(previousRow), roles);
+    }
+    if (row >= 0 && row < rowCount()) {
+        emit dataChanged(index(row), index(row), roles);
+    }
+}
+
+int PlaylistModel::currentRow() const
+{
+    return playingRow;
+}
+
+void PlaylistModel::appendTrack(const VideoInfo& video)
+{
+    Playlist* list = playlist();
+    if (!list) {
+        return;
+    }
+
+    const int row = list->videos.size();
+    beginInsertRows(QModelIndex(), row, row);
+    list->append(video);
+    endInsertRows();
+}
+
+void PlaylistModel::appendTracks(const QList<VideoInfo>& videos)
+{
+    Playlist* list = playlist();
+    if (!list || videos.isEmpty()) {
+        return;
+    }
+
+    const int first = list->videos.size();
+    beginInsertRows(QModelIndex(), first, first + videos.size() - 1);
+    for (const VideoInfo& video : videos) {
+        list->append(video);
+    }
+    endInsertRows();
+}
+
+void PlaylistModel::removeTrack(int row)
+{
+    Playlist* list = playlist();
+    if (!list || row < 0 || row >= list->videos.size()) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    list->removeAt(row);
+    if (row == playingRow) {
+        playingRow = -1;
+    } else if (row < playingRow) {
+        playingRow--;
+    }
+    endRemoveRows();
+}
+
+void PlaylistModel::trackChanged(int row)
+{
+    if (row >= 0 && row < rowCount()) {
+        emit dataChanged(index(row), index(row));
+    }
+}
+
+int PlaylistModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    const Playlist* list = playlist();
+    return list ? list->videos.size() : 0;
+}
+
+QVariant PlaylistModel::data(const QModelIndex& index, int role) const
+{
+    const Playlist* list = playlist();
+    if (!list || !index.isValid() || index.row() >= list->videos.size()) {
+        return QVariant();
+    }
+
+    const VideoInfo& video = list->videos[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return video.title;
+    case ChannelRole:
+        return video.channelTitle;
+    case IsCurrentRole:
+        return index.row() == playingRow;
+    case IsLocalFileRole:
+        return video.isLocalFile;
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags PlaylistModel::flags(const QModelIndex& index) const
+{
+    Qt::ItemFlags defaultFlags = QAbstractListModel::flags(index);
+    if (index.isValid()) {
+        return defaultFlags | Qt::ItemIsDragEnabled;
+    }
+    return defaultFlags | Qt::ItemIsDropEnabled;
+}
+
+Qt::DropActions PlaylistModel::supportedDropActions() const
+{
+    return Qt::MoveAction;
+}
+
+QStringList PlaylistModel::mimeTypes() const
+{
+    return { ROWS_MIME_TYPE };
+}
+
+QMimeData* PlaylistModel::mimeData(const QModelIndexList& indexes) const
+{
+    QByteArray encoded;
+    QDataStream stream(&encoded, QIODevice::WriteOnly);
+    for (const QModelIndex& index : indexes) {
+        if (index.isValid()) {
+            stream << index.row();
+        }
+    }
+
+    QMimeData* mime = new QMimeData();
+    mime->setData(ROWS_MIME_TYPE, encoded);
+    return mime;
+}
+
+bool PlaylistModel::dropMimeData(const QMimeData* data, Qt::DropAction action,
+                                 int row, int column, const QModelIndex& parent)
+{
+    Q_UNUSED(column);
+    if (action != Qt::MoveAction || !data || !data->hasFormat(ROWS_MIME_TYPE)) {
+        return false;
+    }
+
+    // 放到某一項上時插在該項之前，放到空白處時插在尾端
+    int destination = row;
+    if (destination < 0) {
+        destination = parent.isValid() ? parent.row() : rowCount();
+    }
+
+    QByteArray encoded = data->data(ROWS_MIME_TYPE);
+    QDataStream stream(&encoded, QIODevice::ReadOnly);
+    int sourceRow = -1;
+    stream >> sourceRow;
+    if (sourceRow >= 0) {
+        moveRows(QModelIndex(), sourceRow, 1, QModelIndex(), destination);
+    }
+
+    // 資料已在模型內部移動完成，回傳 false 避免視圖再刪除來源列
+    return false;
+}
+
+bool PlaylistModel::moveRows(const QModelIndex& sourceParent, int sourceRow, int count,
+                             const QModelIndex& destinationParent, int destinationChild)
+{
+    Playlist* list = playlist();
+    if (!list || sourceParent.isValid() || destinationParent.isValid() || count != 1) {
+        return false;
+    }
+    if (sourceRow < 0 || sourceRow >= list->videos.size() ||
+        destinationChild < 0 || destinationChild > list->videos.size()) {
+        return false;
+    }
+    // 移動到自己的位置或緊接在自己後面都不需要變動
+    if (destinationChild == sourceRow || destinationChild == sourceRow + 1) {
+        return false;
+    }
+
+    if (!beginMoveRows(QModelIndex(), sourceRow, sourceRow, QModelIndex(), destinationChild)) {
+        return false;
+    }
+
+    const int to = destinationChild > sourceRow ? destinationChild - 1 : destinationChild;
+    list->move(sourceRow, to);
+
+    // 正在播放的列跟著移動
+    if (playingRow == sourceRow) {
+        playingRow = to;
+    } else if (sourceRow < playingRow && to >= playingRow) {
+        playingRow--;
+    } else if (sourceRow > playingRow && to <= playingRow) {
+        playingRow++;
+    }
+
+    endMoveRows();
+    emit trackMoved(sourceRow, to);
+    return true;
+}
+
+Playlist* PlaylistModel::playlist() const
+{
+    if (!playlists || currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists->size()) {
+        return nullptr;
+    }
+    return &(*playlists)[currentPlaylistIndex];
+}
@@ -0,0 +1,78 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYLISTMODEL_H
+#define PLAYLISTMODEL_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+
+// 引入 Qt 清單模型基底類別
+#include <QAbstractListModel>
+
+// 播放清單的資料模型
+//
+// 直接包裝 Widget 擁有的 QList<Playlist> 中的某一個播放清單，不複製任何曲目。
+// 切換播放清單時重設模型；新增、刪除、移動曲目都發出對應的列信號，
+// 切換正在播放的曲目只對新舊兩列發出 dataChanged，不需重建整個清單。
+class PlaylistModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    // 自訂資料角色
+    enum Roles {
+        ChannelRole = Qt::UserRole + 1,  // 頻道名稱/藝術家
+        IsCurrentRole,                   // 是否為正在播放的曲目
+        IsLocalFileRole                  // 是否為本地檔案
+    };
+
+    // 建構函式，playlists 為 Widget 擁有的播放清單列表
+    explicit PlaylistModel(QList<Playlist>* playlists, QObject* parent = nullptr);
+
+    // 設定要顯示的播放清單索引（重設模型）
+    void setPlaylistIndex(int index);
+    // 目前顯示的播放清單索引
+    int playlistIndex() const;
+    // 設定正在播放的列（只更新新舊兩列）
+    void setCurrentRow(int row);
+    // 正在播放的列，沒有時為 -1
+    int currentRow() const;
+
+    // 在尾端加入曲目
+    void appendTrack(const VideoInfo& video);
+    // 在尾端一次加入多首曲目
+    void appendTracks(const QList<VideoInfo>& videos);
+    // 移除指定列的曲目
+    void removeTrack(int row);
+    // 通知指定列的內容已變更
+    void trackChanged(int row);
+
+    // QAbstractListModel 介面
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    Qt::DropActions supportedDropActions() const override;
+    QStringList mimeTypes() const override;
+    QMimeData* mimeData(const QModelIndexList& indexes) const override;
+    bool dropMimeData(const QMimeData* data, Qt::DropAction action,
+                      int row, int column, const QModelIndex& parent) override;
+    bool moveRows(const QModelIndex& sourceParent, int sourceRow, int count,
+                  const QModelIndex& destinationParent, int destinationChild) override;
+
+signals:
+    // 曲目被拖放移動後發出，from/to 為移動前後的列號
+    void trackMoved(int from, int to);
+
+private:
+    // 取得目前顯示的播放清單，無效時回傳 nullptr
+    Playlist* playlist() const;
+
+    // Widget 擁有的播放清單列表
+    QList<Playlist>* playlists;
+    // 目前顯示的播放清單索引
+    int currentPlaylistIndex;
+    // 正在播放的列
+    int playingRow;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYLISTMODEL_H
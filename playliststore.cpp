@@ -0,0 +1,732 @@
+// 引入播放清單持久化引擎標頭檔
+#include "playliststore.h"
+
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 原子性存檔類別（寫入暫存檔後再更名）
+#include <QSaveFile>
+// 引入 Qt 目錄處理類別
+#include <QDir>
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+// 引入 Qt 日期時間類別
+#include <QDateTime>
+// 引入 Qt JSON 文件類別
+#include <QJsonDocument>
+// 引入 Qt JSON 陣列類別
+#include <QJsonArray>
+// 引入 Qt 並行執行函式
+#include <QtConcurrent/QtConcurrent>
+// 引入 Qt 日誌輸出函式
+#include <QtDebug>
+// 引入 C++ 標準演算法
+#include <algorithm>
+
+namespace {
+    // 快照檔名（沿用舊版檔名，舊檔可直接載入）
+    const char* const SNAPSHOT_FILE_NAME = "youtube_playlists.json";
+    // 變更日誌檔名
+    const char* const LOG_FILE_NAME = "youtube_playlists.log";
+    // 二進位快取檔名的前綴與副檔名，中間是來源快照的序號（舊版沒有序號）
+    const char* const CACHE_FILE_PREFIX = "youtube_playlists.";
+    const char* const CACHE_FILE_SUFFIX = "cache";
+    // 待播佇列快照檔名
+    const char* const QUEUE_FILE_NAME = "play_queue.json";
+    // 播放狀態檢查點檔名
+    const char* const PLAYBACK_STATE_FILE_NAME = "playback_state.json";
+    // 全文搜尋索引檔名
+    const char* const SEARCH_INDEX_FILE_NAME = "search_index.bin";
+    // 日誌紀錄數達到此值時觸發壓縮
+    const int COMPACT_RECORD_THRESHOLD = 512;
+    // 日誌大小達到此值時觸發壓縮
+    const qint64 COMPACT_BYTE_THRESHOLD = 4 * 1024 * 1024;
+    // 合併寫入的時間窗（毫秒），期間內的所有變更一次寫出
+    const int FLUSH_DELAY_MS = 250;
+    // 壓縮失敗後再次自動壓縮前至少等待的時間（毫秒）；期間再累積 COMPACT_RECORD_THRESHOLD 筆紀錄也會重試
+    const int COMPACT_RETRY_DELAY_MS = 60000;
+
+    // 序號 sequence 的快照對應的二進位快取路徑
+    QString cacheFilePath(const QString& directory, qint64 sequence)
+    {
+        return QDir(directory).filePath(CACHE_FILE_PREFIX + QString::number(sequence) + "." + CACHE_FILE_SUFFIX);
+    }
+
+    // 列出目錄中所有的二進位快取，依序號由新到舊排列
+    QStringList listCacheFiles(const QString& directory)
+    {
+        const QDir dir(directory);
+        const QString prefix = CACHE_FILE_PREFIX;
+        const QString suffix = QString(".") + CACHE_FILE_SUFFIX;
+        QList<QPair<qint64, QString>> files;
+        for (const QString& name : dir.entryList({ prefix + "*" + suffix }, QDir::Files)) {
+            // 舊版的 youtube_playlists.cache 沒有序號，排在最後
+            bool ok = false;
+            const qint64 sequence = name.mid(prefix.size(), name.size() - prefix.size() - suffix.size()).toLongLong(&ok);
+            files.append({ ok ? sequence : -1, dir.filePath(name) });
+        }
+        std::sort(files.begin(), files.end(), [](const QPair<qint64, QString>& a, const QPair<qint64, QString>& b) {
+            return a.first > b.first;
+        });
+
+        QStringList paths;
+        for (const auto& file : files) {
+            paths.append(file.second);
+        }
+        return paths;
+    }
+}
+
+PlaylistStore::PlaylistStore(const QString& directory, QObject* parent)
+    : QObject(parent)
+    , nextSequence(1)
+    , snapshotSequence(-1)
+    , recordsSinceSnapshot(0)
+    , logBytes(0)
+    , compactingRecords(0)
+    , compactingBytes(0)
+    , compactingSequence(0)
+    , compactionFailed(false)
+    , compactRetryRecords(0)
+{
+    QDir dir;
+    if (!dir.exists(directory)) {
+        dir.mkpath(directory);
+    }
+    snapshotPath = QDir(directory).filePath(SNAPSHOT_FILE_NAME);
+    logPath = QDir(directory).filePath(LOG_FILE_NAME);
+    storeDirectory = directory;
+    queuePath = QDir(directory).filePath(QUEUE_FILE_NAME);
+    playbackStatePath = QDir(directory).filePath(PLAYBACK_STATE_FILE_NAME);
+    searchIndexPath = QDir(directory).filePath(SEARCH_INDEX_FILE_NAME);
+
+    // 單一寫入執行緒保證紀錄與快照依提交順序落地
+    writerPool.setMaxThreadCount(1);
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(FLUSH_DELAY_MS);
+    connect(&flushTimer, &QTimer::timeout, this, &PlaylistStore::submitPendingRecords);
+    connect(&compactionWatcher, &QFutureWatcher<bool>::finished, this, &PlaylistStore::onCompactionFinished);
+}
+
+PlaylistStore::~PlaylistStore()
+{
+    flush();
+}
+
+QJsonObject PlaylistStore::videoToJson(const VideoInfo& video)
+{
+    QJsonObject videoObj;
+    videoObj["videoId"] = video.videoId;
+    videoObj["filePath"] = video.filePath;
+    videoObj["title"] = video.title;
+    videoObj["channelTitle"] = video.channelTitle;
+    videoObj["thumbnailUrl"] = video.thumbnailUrl;
+    videoObj["description"] = video.description;
+    videoObj["subtitlePath"] = video.subtitlePath;
+    videoObj["isFavorite"] = video.isFavorite;
+    videoObj["isLocalFile"] = video.isLocalFile;
+    // 尚未分析響度的曲目不寫入這兩個欄位
+    if (video.hasLoudness) {
+        videoObj["loudness"] = video.loudness;
+        videoObj["peak"] = video.peak;
+    }
+    return videoObj;
+}
+
+VideoInfo PlaylistStore::videoFromJson(const QJsonObject& videoObj)
+{
+    VideoInfo video;
+    video.videoId = videoObj["videoId"].toString();
+    video.filePath = videoObj["filePath"].toString();
+    video.title = videoObj["title"].toString();
+    video.channelTitle = videoObj["channelTitle"].toString();
+    video.thumbnailUrl = videoObj["thumbnailUrl"].toString();
+    video.description = videoObj["description"].toString();
+    video.subtitlePath = videoObj["subtitlePath"].toString();
+    video.isFavorite = videoObj["isFavorite"].toBool();
+    video.isLocalFile = videoObj["isLocalFile"].toBool();
+    video.hasLoudness = videoObj.contains("loudness");
+    video.loudness = static_cast<float>(videoObj["loudness"].toDouble());
+    video.peak = static_cast<float>(videoObj["peak"].toDouble());
+    return video;
+}
+
+QByteArray PlaylistStore::serializeSnapshot(const PlaylistSnapshot& snapshot, qint64 sequence)
+{
+    QJsonObject rootObj;
+    QJsonArray playlistsArray;
+
+    for (const Playlist& playlist : snapshot.playlists) {
+        QJsonObject playlistObj;
+        playlistObj["name"] = playlist.name;
+
+        // 尚未展開的播放清單直接從快取讀取，不必先在 GUI 執行緒上展開
+        const QList<VideoInfo> videos = (playlist.cacheIndex >= 0 && snapshot.cache)
+            ? snapshot.cache->videos(playlist.cacheIndex)
+            : playlist.videos;
+
+        QJsonArray videosArray;
+        for (const VideoInfo& video : videos) {
+            videosArray.append(videoToJson(video));
+        }
+        playlistObj["videos"] = videosArray;
+        playlistsArray.append(playlistObj);
+    }
+
+    rootObj["playlists"] = playlistsArray;
+    if (!snapshot.lastPlaylistName.isEmpty()) {
+        rootObj["lastPlaylist"] = snapshot.lastPlaylistName;
+    }
+    // 記錄快照涵蓋到的日誌序號，載入時據此跳過已併入快照的紀錄
+    rootObj["seq"] = static_cast<double>(sequence);
+
+    return QJsonDocument(rootObj).toJson();
+}
+
+qint64 PlaylistStore::parseSnapshot(const QByteArray& data, PlaylistSnapshot& snapshot)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (!doc.isObject()) {
+        return -1;
+    }
+
+    QJsonObject rootObj = doc.object();
+    snapshot.lastPlaylistName = rootObj["lastPlaylist"].toString();
+    snapshot.playlists.clear();
+
+    QJsonArray playlistsArray = rootObj["playlists"].toArray();
+    for (const QJsonValue& value : playlistsArray) {
+        QJsonObject playlistObj = value.toObject();
+        Playlist playlist;
+        playlist.name = playlistObj["name"].toString();
+
+        QJsonArray videosArray = playlistObj["videos"].toArray();
+        playlist.videos.reserve(videosArray.size());
+        for (const QJsonValue& videoValue : videosArray) {
+            playlist.videos.append(videoFromJson(videoValue.toObject()));
+        }
+        snapshot.playlists.append(playlist);
+    }
+
+    // 舊版檔案沒有 "seq"，視為序號 0
+    return static_cast<qint64>(rootObj["seq"].toDouble(0));
+}
+
+QByteArray PlaylistStore::serializeQueue(const PlayQueue& queue, qint64 sequence)
+{
+    QJsonArray entriesArray;
+    for (const QueueEntry& entry : queue.entries()) {
+        QJsonObject entryObj;
+        entryObj["handle"] = static_cast<double>(entry.handle);
+        entryObj["playlist"] = entry.playlistName;
+        entryObj["key"] = entry.trackKey;
+        entriesArray.append(entryObj);
+    }
+
+    QJsonObject rootObj;
+    rootObj["entries"] = entriesArray;
+    rootObj["seq"] = static_cast<double>(sequence);
+    return QJsonDocument(rootObj).toJson();
+}
+
+qint64 PlaylistStore::parseQueue(const QByteArray& data, PlayQueue& queue)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (!doc.isObject()) {
+        return -1;
+    }
+
+    QJsonObject rootObj = doc.object();
+    queue.clear();
+    const QJsonArray entriesArray = rootObj["entries"].toArray();
+    for (const QJsonValue& value : entriesArray) {
+        const QJsonObject entryObj = value.toObject();
+        QueueEntry entry;
+        entry.handle = static_cast<quint64>(entryObj["handle"].toDouble());
+        entry.playlistName = entryObj["playlist"].toString();
+        entry.trackKey = entryObj["key"].toString();
+        queue.insert(entry, false);
+    }
+    return static_cast<qint64>(rootObj["seq"].toDouble(0));
+}
+
+bool PlaylistStore::load(PlaylistSnapshot& snapshot)
+{
+    bool found = false;
+    snapshotSequence = -1;
+
+    QFileInfo snapshotInfo(snapshotPath);
+    if (snapshotInfo.exists()) {
+        const qint64 sourceSize = snapshotInfo.size();
+        const qint64 sourceModified = snapshotInfo.lastModified().toMSecsSinceEpoch();
+
+        // 優先使用與快照相符的二進位快取，只建立播放清單名稱，曲目延後展開；
+        // 從最新的快取開始嘗試，其餘的（上次映射中而無法刪除的舊快取）交給寫入執行緒刪除
+        QStringList staleCaches;
+        for (const QString& path : listCacheFiles(storeDirectory)) {
+            if (!cache) {
+                cache = PlaylistCache::open(path, sourceSize, sourceModified);
+            }
+            if (!cache || cache->fileName() != path) {
+                staleCaches.append(path);
+            }
+        }
+        if (!staleCaches.isEmpty()) {
+            writerPool.start([staleCaches]() {
+                for (const QString& path : staleCaches) {
+                    QFile::remove(path);
+                }
+            });
+        }
+
+        if (cache) {
+            snapshot.playlists.clear();
+            snapshot.lastPlaylistName = cache->lastPlaylistName();
+            snapshot.cache = cache;
+            for (int i = 0; i < cache->playlistCount(); i++) {
+                Playlist playlist;
+                playlist.name = cache->playlistName(i);
+                playlist.cacheIndex = i;
+                snapshot.playlists.append(playlist);
+            }
+            snapshotSequence = cache->sourceSequence();
+            found = true;
+        } else {
+            // 快取不存在或已過期，解析 JSON 快照並在背景重建快取
+            QFile file(snapshotPath);
+            if (file.open(QIODevice::ReadOnly)) {
+                qint64 sequence = parseSnapshot(file.readAll(), snapshot);
+                file.close();
+                if (sequence >= 0) {
+                    snapshotSequence = sequence;
+                    found = true;
+
+                    const QList<Playlist> playlists = snapshot.playlists;
+                    const QString lastPlaylistName = snapshot.lastPlaylistName;
+                    const QString path = cacheFilePath(storeDirectory, sequence);
+                    writerPool.start([playlists, lastPlaylistName, sequence, sourceSize, sourceModified, path]() {
+                        if (!PlaylistCache::write(path, playlists, lastPlaylistName, sequence, sourceSize, sourceModified)) {
+                            qWarning("PlaylistStore: failed to write playlist cache %s", qPrintable(path));
+                        }
+                    });
+                }
+            }
+        }
+    }
+    nextSequence = qMax<qint64>(snapshotSequence, 0) + 1;
+
+    // 待播佇列有自己的快照，序號可能與播放清單快照不同（兩者之間當機時）
+    qint64 queueSequence = 0;
+    QFile queueFile(queuePath);
+    if (queueFile.open(QIODevice::ReadOnly)) {
+        queueSequence = qMax<qint64>(0, parseQueue(queueFile.readAll(), snapshot.queue));
+        queueFile.close();
+        nextSequence = qMax(nextSequence, queueSequence + 1);
+    }
+
+    // 重播日誌中序號大於快照序號的紀錄
+    recordsSinceSnapshot = 0;
+    logBytes = 0;
+    QFile logFile(logPath);
+    if (logFile.open(QIODevice::ReadWrite)) {
+        qint64 validBytes = 0;
+        while (!logFile.atEnd()) {
+            QByteArray line = logFile.readLine();
+            // 沒有換行結尾的最後一行是寫到一半的紀錄，捨棄
+            if (!line.endsWith('\n')) {
+                break;
+            }
+            QJsonDocument doc = QJsonDocument::fromJson(line);
+            if (!doc.isObject()) {
+                break;
+            }
+            validBytes += line.size();
+
+            QJsonObject record = doc.object();
+            qint64 sequence = static_cast<qint64>(record["seq"].toDouble());
+            const QString op = record["op"].toString();
+            const bool queueRecord = op == "queue" || op == "unqueue" || op == "clearQueue";
+            if (sequence > (queueRecord ? queueSequence : qMax<qint64>(snapshotSequence, 0))) {
+                applyRecord(snapshot, record);
+                recordsSinceSnapshot++;
+                found = true;
+            }
+            nextSequence = qMax(nextSequence, sequence + 1);
+        }
+
+        // 截掉損毀的尾端，確保之後追加的紀錄不會接在殘缺資料後面
+        if (validBytes < logFile.size()) {
+            logFile.resize(validBytes);
+        }
+        logBytes = validBytes;
+        logFile.close();
+    }
+
+    return found;
+}
+
+void PlaylistStore::materialize(Playlist& playlist) const
+{
+    if (playlist.cacheIndex < 0) {
+        return;
+    }
+    if (cache) {
+        playlist.setVideos(cache->videos(playlist.cacheIndex));
+    }
+    playlist.cacheIndex = -1;
+}
+
+QList<VideoInfo> PlaylistStore::videos(const Playlist& playlist) const
+{
+    if (playlist.cacheIndex < 0) {
+        return playlist.videos;
+    }
+    return cache ? cache->videos(playlist.cacheIndex) : QList<VideoInfo>();
+}
+
+void PlaylistStore::setSnapshotProvider(std::function<PlaylistSnapshot()> provider)
+{
+    snapshotProvider = std::move(provider);
+    maybeCompact();
+}
+
+void PlaylistStore::recordPlaylistAdded(const QString& name)
+{
+    QJsonObject record;
+    record["op"] = "addPlaylist";
+    record["name"] = name;
+    appendRecord(record);
+}
+
+void PlaylistStore::recordPlaylistRemoved(int playlistIndex)
+{
+    QJsonObject record;
+    record["op"] = "removePlaylist";
+    record["playlist"] = playlistIndex;
+    appendRecord(record);
+}
+
+void PlaylistStore::recordVideoAdded(int playlistIndex, const VideoInfo& video)
+{
+    QJsonObject record;
+    record["op"] = "addVideo";
+    record["playlist"] = playlistIndex;
+    record["video"] = videoToJson(video);
+    appendRecord(record);
+}
+
+void PlaylistStore::recordVideoRemoved(int playlistIndex, int row)
+{
+    QJsonObject record;
+    record["op"] = "removeVideo";
+    record["playlist"] = playlistIndex;
+    record["row"] = row;
+    appendRecord(record);
+}
+
+void PlaylistStore::recordVideoUpdated(int playlistIndex, int row, const VideoInfo& video)
+{
+    QJsonObject record;
+    record["op"] = "updateVideo";
+    record["playlist"] = playlistIndex;
+    record["row"] = row;
+    record["video"] = videoToJson(video);
+    appendRecord(record);
+}
+
+void PlaylistStore::recordVideoMoved(int playlistIndex, int from, int to)
+{
+    QJsonObject record;
+    record["op"] = "moveVideo";
+    record["playlist"] = playlistIndex;
+    record["from"] = from;
+    record["to"] = to;
+    appendRecord(record);
+}
+
+void PlaylistStore::recordLastPlaylist(const QString& name)
+{
+    QJsonObject record;
+    record["op"] = "lastPlaylist";
+    record["name"] = name;
+    appendRecord(record);
+}
+
+void PlaylistStore::recordQueued(const QueueEntry& entry, bool atFront)
+{
+    QJsonObject record;
+    record["op"] = "queue";
+    record["handle"] = static_cast<double>(entry.handle);
+    record["name"] = entry.playlistName;
+    record["key"] = entry.trackKey;
+    record["front"] = atFront;
+    appendRecord(record);
+}
+
+void PlaylistStore::recordUnqueued(quint64 handle)
+{
+    QJsonObject record;
+    record["op"] = "unqueue";
+    record["handle"] = static_cast<double>(handle);
+    appendRecord(record);
+}
+
+void PlaylistStore::recordQueueCleared()
+{
+    QJsonObject record;
+    record["op"] = "clearQueue";
+    appendRecord(record);
+}
+
+void PlaylistStore::savePlaybackState(const PlaybackState& state)
+{
+    QJsonObject stateObj;
+    stateObj["playlist"] = state.playlistName;
+    stateObj["key"] = state.trackKey;
+    stateObj["position"] = static_cast<double>(state.positionMs);
+    const QByteArray data = QJsonDocument(stateObj).toJson(QJsonDocument::Compact);
+    const QString path = playbackStatePath;
+
+    // 與日誌共用寫入執行緒，GUI 執行緒不等待磁碟
+    writerPool.start([data, path]() {
+        QSaveFile file(path);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(data);
+            file.commit();
+        }
+    });
+}
+
+bool PlaylistStore::loadPlaybackState(PlaybackState& state) const
+{
+    QFile file(playbackStatePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        return false;
+    }
+
+    QJsonObject stateObj = doc.object();
+    state.playlistName = stateObj["playlist"].toString();
+    state.trackKey = stateObj["key"].toString();
+    state.positionMs = qMax<qint64>(0, static_cast<qint64>(stateObj["position"].toDouble()));
+    return true;
+}
+
+void PlaylistStore::saveSearchIndex(const SearchIndex& index)
+{
+    const QString path = searchIndexPath;
+    writerPool.start([index, path]() {
+        index.save(path);
+    });
+}
+
+bool PlaylistStore::loadSearchIndex(SearchIndex& index) const
+{
+    return index.load(searchIndexPath);
+}
+
+void PlaylistStore::appendRecord(QJsonObject record)
+{
+    record["seq"] = static_cast<double>(nextSequence++);
+    QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    pendingRecords.append(line);
+    logBytes += line.size();
+    recordsSinceSnapshot++;
+
+    // 計時器只在閒置時啟動，連續變更不會無限延後寫入
+    if (!flushTimer.isActive()) {
+        flushTimer.start();
+    }
+
+    maybeCompact();
+}
+
+void PlaylistStore::submitPendingRecords()
+{
+    flushTimer.stop();
+    if (pendingRecords.isEmpty()) {
+        return;
+    }
+
+    const QByteArray records = pendingRecords;
+    const QString path = logPath;
+    pendingRecords.clear();
+
+    writerPool.start([records, path]() {
+        QFile logFile(path);
+        if (logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            logFile.write(records);
+            logFile.close();
+        }
+    });
+}
+
+void PlaylistStore::applyRecord(PlaylistSnapshot& snapshot, const QJsonObject& record) const
+{
+    const QString op = record["op"].toString();
+    const int playlistIndex = record["playlist"].toInt(-1);
+    const bool hasPlaylist = playlistIndex >= 0 && playlistIndex < snapshot.playlists.size();
+
+    // 只展開日誌實際修改到的播放清單
+    if (hasPlaylist && (op == "addVideo" || op == "removeVideo" || op == "updateVideo" || op == "moveVideo")) {
+        materialize(snapshot.playlists[playlistIndex]);
+    }
+
+    if (op == "addPlaylist") {
+        Playlist playlist;
+        playlist.name = record["name"].toString();
+        snapshot.playlists.append(playlist);
+    } else if (op == "removePlaylist") {
+        if (hasPlaylist) {
+            snapshot.playlists.removeAt(playlistIndex);
+        }
+    } else if (op == "addVideo") {
+        if (hasPlaylist) {
+            snapshot.playlists[playlistIndex].append(videoFromJson(record["video"].toObject()));
+        }
+    } else if (op == "removeVideo") {
+        const int row = record["row"].toInt(-1);
+        if (hasPlaylist && row >= 0 && row < snapshot.playlists[playlistIndex].videos.size()) {
+            snapshot.playlists[playlistIndex].removeAt(row);
+        }
+    } else if (op == "updateVideo") {
+        const int row = record["row"].toInt(-1);
+        if (hasPlaylist && row >= 0 && row < snapshot.playlists[playlistIndex].videos.size()) {
+            snapshot.playlists[playlistIndex].replace(row, videoFromJson(record["video"].toObject()));
+        }
+    } else if (op == "moveVideo") {
+        if (hasPlaylist) {
+            snapshot.playlists[playlistIndex].move(record["from"].toInt(-1), record["to"].toInt(-1));
+        }
+    } else if (op == "lastPlaylist") {
+        snapshot.lastPlaylistName = record["name"].toString();
+    } else if (op == "queue") {
+        QueueEntry entry;
+        entry.handle = static_cast<quint64>(record["handle"].toDouble());
+        entry.playlistName = record["name"].toString();
+        entry.trackKey = record["key"].toString();
+        snapshot.queue.insert(entry, record["front"].toBool());
+    } else if (op == "unqueue") {
+        snapshot.queue.remove(static_cast<quint64>(record["handle"].toDouble()));
+    } else if (op == "clearQueue") {
+        snapshot.queue.clear();
+    }
+}
+
+void PlaylistStore::maybeCompact()
+{
+    if (recordsSinceSnapshot < COMPACT_RECORD_THRESHOLD && logBytes < COMPACT_BYTE_THRESHOLD) {
+        return;
+    }
+    // 上次失敗後先等待一段時間或累積更多紀錄，避免每筆紀錄都重寫完整快照
+    if (compactionFailed && recordsSinceSnapshot < compactRetryRecords && !compactRetryDeadline.hasExpired()) {
+        return;
+    }
+    compact();
+}
+
+void PlaylistStore::compact()
+{
+    if (compactionWatcher.isRunning() || !snapshotProvider) {
+        return;
+    }
+
+    // 先送出緩衝中的紀錄，確保排在壓縮之前的日誌內容全部被快照涵蓋
+    submitPendingRecords();
+    // 磁碟上的快照已涵蓋所有紀錄，重寫只會讓映射中的快取過期
+    if (nextSequence - 1 == snapshotSequence) {
+        return;
+    }
+
+    // QList 為隱式共享，複製快照只增加參考計數；之後的修改會在 GUI 執行緒上分離
+    PlaylistSnapshot snapshot = snapshotProvider();
+    snapshot.cache = cache;
+    const qint64 sequence = nextSequence - 1;
+    const QString path = snapshotPath;
+    const QString log = logPath;
+    const QString queueFile = queuePath;
+    // 新的快取寫成另一個檔案：映射中的快取在 Windows 上無法被覆寫或刪除
+    const QString directory = storeDirectory;
+    const QString cacheFile = cacheFilePath(directory, sequence);
+    const QString mappedCache = cache ? cache->fileName() : QString();
+
+    // 壓縮期間新增的紀錄寫在截斷之後，成功時只扣除此時已累積的部分
+    compactingRecords = recordsSinceSnapshot;
+    compactingBytes = logBytes;
+    compactingSequence = sequence;
+
+    compactionWatcher.setFuture(QtConcurrent::run(&writerPool, [snapshot, sequence, path, log, queueFile, directory, cacheFile, mappedCache]() {
+        // 待播佇列先寫入；兩份快照都成功後才清空日誌
+        QSaveFile queueSave(queueFile);
+        if (!queueSave.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        queueSave.write(serializeQueue(snapshot.queue, sequence));
+        if (!queueSave.commit()) {
+            return false;
+        }
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        file.write(serializeSnapshot(snapshot, sequence));
+        if (!file.commit()) {
+            // 快照寫入失敗時保留完整日誌，下次再試
+            return false;
+        }
+
+        // 寫入執行緒依序執行，此時日誌中只有序號不大於快照序號的紀錄，可直接清空；
+        // 若在清空前當機，載入時也會依序號跳過這些紀錄
+        QFile logFile(log);
+        if (logFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            logFile.close();
+        }
+
+        // 以新快照的大小與修改時間重建二進位快取，下次啟動即可直接映射
+        // 快取寫入失敗只影響下次啟動的速度（改為解析 JSON 快照），快照本身已完成
+        QFileInfo info(path);
+        if (!PlaylistCache::write(cacheFile, snapshot.playlists, snapshot.lastPlaylistName, sequence,
+                                  info.size(), info.lastModified().toMSecsSinceEpoch(), snapshot.cache.data())) {
+            qWarning("PlaylistStore: failed to write playlist cache %s", qPrintable(cacheFile));
+            return true;
+        }
+
+        // 刪除之前的快取，映射中的那一份留到下次開啟時再刪除
+        for (const QString& stale : listCacheFiles(directory)) {
+            if (stale != cacheFile && stale != mappedCache) {
+                QFile::remove(stale);
+            }
+        }
+        return true;
+    }));
+}
+
+void PlaylistStore::onCompactionFinished()
+{
+    // 失敗時保留計數（日誌仍完整），並延後下一次自動壓縮
+    if (compactionWatcher.future().result()) {
+        snapshotSequence = compactingSequence;
+        recordsSinceSnapshot = qMax(0, recordsSinceSnapshot - compactingRecords);
+        logBytes = qMax<qint64>(0, logBytes - compactingBytes);
+        compactionFailed = false;
+    } else {
+        qWarning("PlaylistStore: failed to write playlist snapshot, retrying later");
+        compactionFailed = true;
+        compactRetryRecords = recordsSinceSnapshot + COMPACT_RECORD_THRESHOLD;
+        compactRetryDeadline.setRemainingTime(COMPACT_RETRY_DELAY_MS);
+    }
+    compactingRecords = 0;
+    compactingBytes = 0;
+}
+
+void PlaylistStore::flush()
+{
+    submitPendingRecords();
+    writerPool.waitForDone();
+}
@@ -0,0 +1,177 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYLISTSTORE_H
+#define PLAYLISTSTORE_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+// 引入播放清單二進位快取
+#include "playlistcache.h"
+// 引入待播佇列
+#include "playqueue.h"
+// 引入全文搜尋索引
+#include "searchindex.h"
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt JSON 物件類別
+#include <QJsonObject>
+// 引入 Qt 非同步結果監看類別
+#include <QFutureWatcher>
+// 引入 Qt 執行緒池類別
+#include <QThreadPool>
+// 引入 Qt 計時器類別
+#include <QTimer>
+// 引入 Qt 截止時間類別
+#include <QDeadlineTimer>
+// 引入 C++ 函式物件
+#include <functional>
+
+// 播放清單的完整狀態快照（壓縮時整份寫入磁碟）
+struct PlaylistSnapshot {
+    QList<Playlist> playlists;   // 所有播放清單
+    QString lastPlaylistName;    // 上次使用的播放清單名稱
+    PlayQueue queue;             // 待播佇列
+    QSharedPointer<PlaylistCache> cache;  // 尚未展開的播放清單從此快取讀取
+};
+
+// 上次播放的曲目與位置（定期寫入檢查點，啟動時恢復）
+struct PlaybackState {
+    QString playlistName;    // 曲目所在的播放清單名稱
+    QString trackKey;        // 曲目鍵值，空字串表示沒有正在播放的曲目
+    qint64 positionMs = 0;   // 播放位置（毫秒）
+};
+
+// 播放清單持久化引擎
+//
+// 磁碟上由下列檔案組成：
+//   youtube_playlists.json  完整快照（與舊版格式相容，另記錄 "seq"）
+//   youtube_playlists.log   僅追加的變更日誌，每行一筆 JSON 紀錄
+//   youtube_playlists.<seq>.cache 由序號 seq 的快照產生的二進位快取（見 PlaylistCache），啟動時優先使用；
+//                           映射中的快取不能被覆寫（Windows），每次壓縮寫成新的檔案，舊檔在下次開啟時刪除
+//   play_queue.json         待播佇列的快照（另記錄 "seq"），與播放清單快照同時寫入
+//   playback_state.json     播放狀態檢查點（PlaybackState），每次整份覆寫，不經過日誌
+//   search_index.bin        曲目與字幕的全文搜尋索引（見 SearchIndex），每次整份覆寫，不經過日誌
+// 每次變更只追加一行日誌（成本與變更大小成正比），累積到一定數量後
+// 以 QSaveFile 原子性地重寫快照，再截斷日誌。
+// 載入時只重播序號大於快照序號的紀錄，因此任何時間點當機都不會遺失或重複套用變更。
+//
+// 所有磁碟 I/O 都在單一背景寫入執行緒上依序執行：GUI 執行緒只把紀錄放進緩衝區，
+// 短時間內的連續變更會合併成一次寫入。
+//
+// 從快取載入時播放清單只帶名稱，曲目在 materialize() 時才展開，
+// 因此啟動成本不隨曲庫總量增加。
+class PlaylistStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 建構函式，directory 為存放快照與日誌的目錄
+    explicit PlaylistStore(const QString& directory, QObject* parent = nullptr);
+    // 解構函式，寫出所有緩衝中的紀錄
+    ~PlaylistStore() override;
+
+    // 載入快照並重播日誌，檔案不存在時回傳 false
+    bool load(PlaylistSnapshot& snapshot);
+    // 從快取展開尚未載入的播放清單曲目
+    void materialize(Playlist& playlist) const;
+    // 取得播放清單的曲目但不展開：尚未展開時回傳從快取讀取的複本
+    QList<VideoInfo> videos(const Playlist& playlist) const;
+    // 設定壓縮時取得目前完整狀態的回呼
+    void setSnapshotProvider(std::function<PlaylistSnapshot()> provider);
+
+    // 以下函式各自追加一筆變更紀錄
+    void recordPlaylistAdded(const QString& name);
+    void recordPlaylistRemoved(int playlistIndex);
+    void recordVideoAdded(int playlistIndex, const VideoInfo& video);
+    void recordVideoRemoved(int playlistIndex, int row);
+    void recordVideoUpdated(int playlistIndex, int row, const VideoInfo& video);
+    void recordVideoMoved(int playlistIndex, int from, int to);
+    void recordLastPlaylist(const QString& name);
+    void recordQueued(const QueueEntry& entry, bool atFront);
+    void recordUnqueued(quint64 handle);
+    void recordQueueCleared();
+
+    // 在背景寫入播放狀態檢查點（覆寫前一次）
+    void savePlaybackState(const PlaybackState& state);
+    // 讀取上次的播放狀態，檔案不存在或無效時回傳 false
+    bool loadPlaybackState(PlaybackState& state) const;
+    // 在背景寫入執行緒保存搜尋索引；index 是隱式共用的複本，呼叫端可以繼續修改，
+    // 但寫入完成前的第一次修改會複製整個索引
+    void saveSearchIndex(const SearchIndex& index);
+    // 讀取保存的搜尋索引，檔案不存在或損毀時回傳 false（只讀取檔案，可在背景執行緒呼叫）
+    bool loadSearchIndex(SearchIndex& index) const;
+
+    // 立即在背景啟動快照壓縮
+    void compact();
+    // 寫出緩衝中的紀錄並等待所有背景寫入完成（結束程式前呼叫）
+    void flush();
+
+    // VideoInfo 與 JSON 之間的轉換
+    static QJsonObject videoToJson(const VideoInfo& video);
+    static VideoInfo videoFromJson(const QJsonObject& videoObj);
+    // 將快照序列化為 JSON 文件內容
+    static QByteArray serializeSnapshot(const PlaylistSnapshot& snapshot, qint64 sequence);
+    // 將 JSON 文件內容解析為快照，回傳快照序號（失敗時回傳 -1）
+    static qint64 parseSnapshot(const QByteArray& data, PlaylistSnapshot& snapshot);
+    // 待播佇列與 JSON 文件內容之間的轉換，解析時回傳快照序號（失敗時回傳 -1）
+    static QByteArray serializeQueue(const PlayQueue& queue, qint64 sequence);
+    static qint64 parseQueue(const QByteArray& data, PlayQueue& queue);
+
+private:
+    // 追加一筆紀錄到寫入緩衝區
+    void appendRecord(QJsonObject record);
+    // 將緩衝區交給背景寫入執行緒
+    void submitPendingRecords();
+    // 將一筆紀錄套用到快照上
+    void applyRecord(PlaylistSnapshot& snapshot, const QJsonObject& record) const;
+    // 檢查日誌大小，必要時觸發壓縮
+    void maybeCompact();
+    // 背景壓縮結束：成功時扣除已併入快照的紀錄數與日誌大小，失敗時延後下一次自動壓縮
+    void onCompactionFinished();
+
+    // 快照檔案路徑
+    QString snapshotPath;
+    // 日誌檔案路徑
+    QString logPath;
+    // 存放所有檔案的目錄（二進位快取的檔名依快照序號而定）
+    QString storeDirectory;
+    // 待播佇列快照檔案路徑
+    QString queuePath;
+    // 播放狀態檢查點檔案路徑
+    QString playbackStatePath;
+    // 全文搜尋索引檔案路徑
+    QString searchIndexPath;
+    // 啟動時映射的二進位快取（仍有未展開的播放清單時必須保留）
+    QSharedPointer<PlaylistCache> cache;
+    // 下一筆紀錄的序號
+    qint64 nextSequence;
+    // 磁碟上的快照涵蓋到的序號（-1 表示沒有快照），沒有新紀錄時不需要壓縮
+    qint64 snapshotSequence;
+    // 自上次快照以來的紀錄數
+    int recordsSinceSnapshot;
+    // 日誌目前的位元組數
+    qint64 logBytes;
+    // 進行中的壓縮涵蓋的紀錄數與日誌位元組數（壓縮成功後才從上面兩個值扣除）
+    int compactingRecords;
+    qint64 compactingBytes;
+    // 進行中的壓縮的快照序號
+    qint64 compactingSequence;
+    // 上次壓縮失敗（例如磁碟已滿）：紀錄數達到 compactRetryRecords 或過了 compactRetryDeadline 才再自動壓縮，
+    // 不會每追加一筆紀錄就重寫一次完整快照
+    bool compactionFailed;
+    int compactRetryRecords;
+    QDeadlineTimer compactRetryDeadline;
+    // 尚未交給寫入執行緒的紀錄
+    QByteArray pendingRecords;
+    // 合併寫入用的計時器，第一筆紀錄進入緩衝區時啟動
+    QTimer flushTimer;
+    // 只有一條執行緒的執行緒池，保證日誌追加與快照壓縮依序執行
+    QThreadPool writerPool;
+    // 監看背景壓縮的結果
+    QFutureWatcher<bool> compactionWatcher;
+    // 取得目前完整狀態的回呼
+    std::function<PlaylistSnapshot()> snapshotProvider;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYLISTSTORE_H
@@ -0,0 +1,174 @@
+// 引入播放順序標頭檔
+#include "playorder.h"
+
+PlayOrder::PlayOrder()
+    : shuffle(false)
+    , repeat(false)
+    , count(0)
+    , currentRow(-1)
+{
+}
+
+void PlayOrder::setShuffle(bool enabled)
+{
+    shuffle = enabled;
+    if (shuffle) {
+        shuffled.reset(count, currentRow);
+    }
+}
+
+bool PlayOrder::isShuffle() const
+{
+    return shuffle;
+}
+
+void PlayOrder::setRepeat(bool enabled)
+{
+    repeat = enabled;
+}
+
+bool PlayOrder::isRepeat() const
+{
+    return repeat;
+}
+
+void PlayOrder::reset(int trackCount)
+{
+    count = qMax(0, trackCount);
+    currentRow = -1;
+    if (shuffle) {
+        shuffled.reset(count);
+    }
+}
+
+int PlayOrder::trackCount() const
+{
+    return count;
+}
+
+int PlayOrder::current() const
+{
+    return currentRow;
+}
+
+void PlayOrder::trackInserted(int row)
+{
+    if (row < 0 || row > count) return;
+
+    count++;
+    if (currentRow >= row) {
+        currentRow++;
+    }
+    if (shuffle) {
+        shuffled.insert(row);
+    }
+}
+
+void PlayOrder::trackRemoved(int row)
+{
+    if (row < 0 || row >= count) return;
+
+    count--;
+    if (currentRow == row) {
+        currentRow = -1;
+    } else if (currentRow > row) {
+        currentRow--;
+    }
+    if (shuffle) {
+        shuffled.remove(row);
+    }
+}
+
+void PlayOrder::trackMoved(int from, int to)
+{
+    if (from == to || from < 0 || from >= count || to < 0 || to >= count) return;
+
+    if (currentRow == from) {
+        currentRow = to;
+    } else if (from < currentRow && currentRow <= to) {
+        currentRow--;
+    } else if (to <= currentRow && currentRow < from) {
+        currentRow++;
+    }
+    if (shuffle) {
+        shuffled.move(from, to);
+    }
+}
+
+void PlayOrder::markPlayed(int row)
+{
+    if (row < 0 || row >= count) return;
+
+    currentRow = row;
+    if (shuffle) {
+        shuffled.play(row);
+    }
+}
+
+int PlayOrder::next()
+{
+    if (count <= 0) return -1;
+
+    if (shuffle) {
+        continueRound();
+        return shuffled.peek(1);
+    }
+
+    int newIndex = currentRow + 1;
+    if (newIndex >= count) {
+        return repeat ? 0 : -1;
+    }
+    return newIndex;
+}
+
+int PlayOrder::previous()
+{
+    if (count <= 0) return -1;
+
+    if (shuffle) {
+        return shuffled.peek(-1);
+    }
+
+    int newIndex = currentRow - 1;
+    if (newIndex < 0) {
+        newIndex = count - 1;
+    }
+    return newIndex;
+}
+
+QList<int> PlayOrder::upcoming(int limit)
+{
+    QList<int> indices;
+    if (limit <= 0 || count <= 0) return indices;
+
+    if (shuffle) {
+        continueRound();
+        for (int offset = 1; offset <= limit; offset++) {
+            const int row = shuffled.peek(offset);
+            if (row < 0) break;
+            indices.append(row);
+        }
+        return indices;
+    }
+
+    // 循序播放：到結尾時只有循環模式會回到開頭，繞回目前曲目即停止
+    int index = currentRow;
+    while (indices.size() < limit) {
+        index++;
+        if (index >= count) {
+            if (!repeat) break;
+            index = 0;
+        }
+        if (index == currentRow || indices.contains(index)) break;
+        indices.append(index);
+    }
+    return indices;
+}
+
+void PlayOrder::continueRound()
+{
+    // 本輪的歷史在開始新的一輪時捨棄，上一首最多回到本輪的第一首
+    if (repeat && shuffled.isExhausted()) {
+        shuffled.reset(count, currentRow);
+    }
+}
@@ -0,0 +1,71 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYORDER_H
+#define PLAYORDER_H
+
+// 引入隨機播放順序
+#include "shuffleorder.h"
+
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 播放順序
+//
+// 依循序、循環與隨機播放模式決定下一首、上一首與接下來幾首的列號，不依賴任何介面元件。
+// 記錄播放清單的曲目數與目前的列號，播放清單新增、刪除或移動曲目時由呼叫端通知，
+// 隨機播放的順序（ShuffleOrder）隨之調整而不需要重新洗牌；
+// 預先轉錄、預先開啟的曲目正是之後實際播放的曲目，上一首會回到實際播放過的曲目。
+class PlayOrder
+{
+public:
+    // 建構函式，預設為循序播放、不循環
+    PlayOrder();
+
+    // 隨機播放模式，開啟時以目前曲目開始新的一輪
+    void setShuffle(bool enabled);
+    bool isShuffle() const;
+    // 循環播放模式
+    void setRepeat(bool enabled);
+    bool isRepeat() const;
+
+    // 換成有 trackCount 首曲目的播放清單並重新開始一輪（例如切換播放清單）
+    void reset(int trackCount);
+    // 曲目數
+    int trackCount() const;
+    // 目前曲目的列號，沒有時回傳 -1
+    int current() const;
+
+    // 播放清單在 row 插入了一首曲目
+    void trackInserted(int row);
+    // 播放清單移除了 row
+    void trackRemoved(int row);
+    // 播放清單的曲目從 from 列移到 to 列
+    void trackMoved(int from, int to);
+
+    // 記錄曲目已開始播放，成為目前曲目
+    void markPlayed(int row);
+
+    // 下一首的列號（不改變播放順序，markPlayed 之後才前進），沒有下一首時回傳 -1
+    int next();
+    // 上一首的列號：隨機播放時為實際播放過的上一首，沒有時回傳 -1
+    int previous();
+    // 取得接下來 limit 首會播放的列號（不改變播放順序）
+    QList<int> upcoming(int limit);
+
+private:
+    // 隨機循環播放時，本輪已播完就以目前曲目開始新的一輪
+    void continueRound();
+
+    // 是否啟用隨機播放模式
+    bool shuffle;
+    // 是否啟用循環播放模式
+    bool repeat;
+    // 曲目數
+    int count;
+    // 目前曲目的列號
+    int currentRow;
+    // 隨機播放的順序
+    ShuffleOrder shuffled;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYORDER_H
@@ -0,0 +1,134 @@
+// 引入待播佇列標頭檔
+#include "playqueue.h"
+
+PlayQueue::PlayQueue()
+    : head(0)
+    , tail(0)
+    , lastHandle(0)
+{
+}
+
+bool PlayQueue::isEmpty() const
+{
+    return nodes.isEmpty();
+}
+
+int PlayQueue::size() const
+{
+    return nodes.size();
+}
+
+QueueEntry PlayQueue::enqueue(const QString& playlistName, const QString& trackKey)
+{
+    const QueueEntry entry = makeEntry(playlistName, trackKey);
+    insert(entry, false);
+    return entry;
+}
+
+QueueEntry PlayQueue::playNext(const QString& playlistName, const QString& trackKey)
+{
+    const QueueEntry entry = makeEntry(playlistName, trackKey);
+    insert(entry, true);
+    return entry;
+}
+
+void PlayQueue::insert(const QueueEntry& entry, bool atFront)
+{
+    if (entry.handle == 0 || nodes.contains(entry.handle)) {
+        return;
+    }
+    // 重播日誌時保留原本的代號，之後配發的代號不會與其重複
+    lastHandle = qMax(lastHandle, entry.handle);
+
+    Node node;
+    node.entry = entry;
+    if (atFront) {
+        node.next = head;
+        if (head != 0) {
+            nodes[head].previous = entry.handle;
+        } else {
+            tail = entry.handle;
+        }
+        head = entry.handle;
+    } else {
+        node.previous = tail;
+        if (tail != 0) {
+            nodes[tail].next = entry.handle;
+        } else {
+            head = entry.handle;
+        }
+        tail = entry.handle;
+    }
+    nodes.insert(entry.handle, node);
+}
+
+bool PlayQueue::remove(quint64 handle)
+{
+    const auto it = nodes.constFind(handle);
+    if (it == nodes.constEnd()) {
+        return false;
+    }
+    const quint64 previous = it->previous;
+    const quint64 next = it->next;
+    nodes.erase(it);
+
+    if (previous != 0) {
+        nodes[previous].next = next;
+    } else {
+        head = next;
+    }
+    if (next != 0) {
+        nodes[next].previous = previous;
+    } else {
+        tail = previous;
+    }
+    return true;
+}
+
+void PlayQueue::clear()
+{
+    nodes.clear();
+    head = 0;
+    tail = 0;
+}
+
+bool PlayQueue::contains(quint64 handle) const
+{
+    return nodes.contains(handle);
+}
+
+QueueEntry PlayQueue::entry(quint64 handle) const
+{
+    const auto it = nodes.constFind(handle);
+    return it != nodes.constEnd() ? it->entry : QueueEntry();
+}
+
+QueueEntry PlayQueue::first() const
+{
+    return entry(head);
+}
+
+QueueEntry PlayQueue::after(quint64 handle) const
+{
+    const auto it = nodes.constFind(handle);
+    return it != nodes.constEnd() ? entry(it->next) : QueueEntry();
+}
+
+QList<QueueEntry> PlayQueue::entries() const
+{
+    QList<QueueEntry> list;
+    list.reserve(nodes.size());
+    for (auto it = nodes.constFind(head); it != nodes.constEnd(); it = nodes.constFind(it->next)) {
+        list.append(it->entry);
+    }
+    return list;
+}
+
+QueueEntry PlayQueue::makeEntry(const QString& playlistName, const QString& trackKey)
+{
+    QueueEntry entry;
+    entry.handle = ++lastHandle;
+    entry.playlistName = playlistName;
+    entry.trackKey = trackKey;
+    return entry;
+}
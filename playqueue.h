@@ -0,0 +1,82 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef PLAYQUEUE_H
+#define PLAYQUEUE_H
+
+// 引入 Qt 字串類別
+#include <QString>
+// 引入 Qt 清單容器類別
+#include <QList>
+// 引入 Qt 雜湊表類別
+#include <QHash>
+
+// 待播佇列中的一個項目
+//
+// 以播放清單名稱與曲目鍵值（trackKey）指向曲目，不記錄列號，
+// 播放清單新增、刪除、移動曲目或切換顯示的播放清單都不會讓項目失效；
+// 曲目或播放清單被刪除後，項目在解析時找不到曲目即可略過。
+struct QueueEntry {
+    quint64 handle = 0;       // 穩定的項目代號（0 表示沒有項目）
+    QString playlistName;     // 曲目所在的播放清單名稱
+    QString trackKey;         // 曲目鍵值
+};
+
+// 待播佇列（「下一首播放」與「加入待播佇列」）
+//
+// 以雜湊表實作的雙向鏈結串列：項目代號 → 節點，
+// 加到開頭或尾端、依代號移除、取得第一項與下一項都是 O(1)，與佇列長度無關。
+// 項目可以來自不同的播放清單；持久化由 PlaylistStore 以變更日誌負責。
+class PlayQueue
+{
+public:
+    // 建構函式，佇列為空
+    PlayQueue();
+
+    // 佇列是否為空
+    bool isEmpty() const;
+    // 項目數
+    int size() const;
+
+    // 加到佇列尾端，回傳新項目（含配發的代號）
+    QueueEntry enqueue(const QString& playlistName, const QString& trackKey);
+    // 加到佇列開頭（下一首播放），回傳新項目
+    QueueEntry playNext(const QString& playlistName, const QString& trackKey);
+    // 以既有的代號加入項目（重播變更日誌時使用），代號已存在時忽略
+    void insert(const QueueEntry& entry, bool atFront);
+    // 依代號移除項目，項目不存在時回傳 false
+    bool remove(quint64 handle);
+    // 清空佇列
+    void clear();
+
+    // 是否有此代號的項目
+    bool contains(quint64 handle) const;
+    // 依代號取得項目，不存在時回傳空項目（handle 為 0）
+    QueueEntry entry(quint64 handle) const;
+    // 第一個項目，佇列為空時回傳空項目
+    QueueEntry first() const;
+    // 指定項目的下一個項目，沒有時回傳空項目
+    QueueEntry after(quint64 handle) const;
+    // 依順序列出所有項目
+    QList<QueueEntry> entries() const;
+
+private:
+    // 鏈結串列的節點
+    struct Node {
+        QueueEntry entry;
+        quint64 previous = 0;
+        quint64 next = 0;
+    };
+
+    // 配發新的項目代號
+    QueueEntry makeEntry(const QString& playlistName, const QString& trackKey);
+
+    // 項目代號 → 節點
+    QHash<quint64, Node> nodes;
+    // 第一個與最後一個項目的代號（0 表示沒有）
+    quint64 head;
+    quint64 tail;
+    // 最後配發的項目代號
+    quint64 lastHandle;
+};
+
+// 結束標頭檔保護宏
+#endif // PLAYQUEUE_H
@@ -21,11 +21,18 @@ const lyricsData = [
 const audioPlayer = document.getElementById('audio-player');
 // 取得 HTML 頁面中的歌詞容器元素
 const lyricsContainer = document.getElementById('lyrics-container');
+// 依序保存所有歌詞行元素，避免每次更新都查詢 DOM
+let lyricLines = [];
+// 目前啟用的歌詞索引（-1 表示沒有啟用的歌詞）
+let activeLyricIndex = -1;
 
 // 初始化歌詞顯示的函式
 function initLyrics() {
     // 清空歌詞容器的內容
     lyricsContainer.innerHTML = '';
+    // 清空歌詞行元素清單並重設啟用索引
+    lyricLines = [];
+    activeLyricIndex = -1;
     
     // 遍歷歌詞資料陣列中的每一項
     lyricsData.forEach((lyric, index) => {
@@ -56,49 +63,60 @@ function initLyrics() {
         
         // 將歌詞行元素添加到歌詞容器中
         lyricsContainer.appendChild(lyricLine);
+        // 保存歌詞行元素
+        lyricLines.push(lyricLine);
     });
 }
 
+// 以二分搜尋找出當前時間對應的歌詞索引（lyricsData 依時間排序）
+function findLyricIndex(currentTime) {
+    // 搜尋範圍的下界與上界
+    let low = 0;
+    let high = lyricsData.length;
+    // 找出第一個時間戳大於當前時間的歌詞
+    while (low < high) {
+        // 取中間位置
+        const mid = (low + high) >> 1;
+        if (lyricsData[mid].time <= currentTime) {
+            // 中間的歌詞已經開始，往後半段找
+            low = mid + 1;
+        } else {
+            // 中間的歌詞尚未開始，往前半段找
+            high = mid;
+        }
+    }
+    // 前一句就是當前應該啟用的歌詞（-1 表示還沒到第一句）
+    return low - 1;
+}
+
 // 根據當前播放時間更新啟用的歌詞行
 function updateLyrics() {
-    // 取得音頻播放器的當前播放時間
-    const currentTime = audioPlayer.currentTime;
-    // 取得所有歌詞行元素
-    const lyricLines = document.querySelectorAll('.lyrics-line');
+    // 以二分搜尋找出當前應該啟用的歌詞
+    const activeIndex = findLyricIndex(audioPlayer.currentTime);
     
-    // 初始化當前啟用的歌詞索引為 -1（表示沒有啟用的歌詞）
-    let activeIndex = -1;
+    // 啟用的歌詞沒有改變時不需要更新任何元素
+    if (activeIndex === activeLyricIndex) {
+        return;
+    }
     
-    // 從最後一句歌詞開始往前查找當前應該啟用的歌詞
-    for (let i = lyricsData.length - 1; i >= 0; i--) {
-        // 如果當前時間大於等於此歌詞的時間戳
-        if (currentTime >= lyricsData[i].time) {
-            // 設定此歌詞為當前啟用的歌詞
-            activeIndex = i;
-            // 跳出迴圈
-            break;
-        }
+    // 只更新新舊兩個索引之間的歌詞行
+    const first = Math.max(Math.min(activeIndex, activeLyricIndex), 0);
+    const last = Math.max(activeIndex, activeLyricIndex);
+    for (let i = first; i <= last && i < lyricLines.length; i++) {
+        // 啟用的歌詞之前為 passed，啟用的歌詞為 active，之後的歌詞恢復初始狀態
+        lyricLines[i].classList.toggle('passed', i < activeIndex);
+        lyricLines[i].classList.toggle('active', i === activeIndex);
     }
+    // 記錄新的啟用索引
+    activeLyricIndex = activeIndex;
     
-    // 更新所有歌詞行的樣式
-    lyricLines.forEach((line, index) => {
-        // 移除歌詞行的 active 和 passed 類別
-        line.classList.remove('active', 'passed');
-        
-        // 如果此歌詞是當前啟用的歌詞
-        if (index === activeIndex) {
-            // 添加 active 類別（高亮顯示）
-            line.classList.add('active');
-            // 自動捲動到此歌詞行，使其顯示在視窗中央
-            line.scrollIntoView({
-                behavior: 'smooth',  // 使用平滑捲動動畫
-                block: 'center'      // 將元素置於視窗中央
-            });
-        } else if (index < activeIndex) {
-            // 如果此歌詞在當前啟用的歌詞之前，添加 passed 類別
-            line.classList.add('passed');
-        }
-    });
+    // 只在換行時自動捲動到啟用的歌詞行，使其顯示在視窗中央
+    if (activeIndex >= 0) {
+        lyricLines[activeIndex].scrollIntoView({
+            behavior: 'smooth',  // 使用平滑捲動動畫
+            block: 'center'      // 將元素置於視窗中央
+        });
+    }
 }
 
 // 為音頻播放器添加時間更新事件監聽器，當播放時間改變時呼叫 updateLyrics 函式
@@ -142,11 +160,11 @@ audioPlayer.addEventListener('pause', function() {
 
 // 為音頻播放器添加播放結束事件監聽器
 audioPlayer.addEventListener('ended', function() {
-    // 取得所有歌詞行元素
-    const lyricLines = document.querySelectorAll('.lyrics-line');
-    // 遍歷所有歌詞行
-    lyricLines.forEach(line => {
-        // 移除所有歌詞行的 active 和 passed 類別，重置為初始狀態
-        line.classList.remove('active', 'passed');
-    });
+    // 遍歷已標記的歌詞行（啟用索引之後的歌詞行沒有任何類別）
+    for (let i = 0; i <= activeLyricIndex && i < lyricLines.length; i++) {
+        // 移除歌詞行的 active 和 passed 類別，重置為初始狀態
+        lyricLines[i].classList.remove('active', 'passed');
+    }
+    // 重設啟用索引
+    activeLyricIndex = -1;
 });
@@ -0,0 +1,714 @@
+// 引入全文搜尋索引標頭檔
+#include "searchindex.h"
+
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 安全寫入檔案類別（寫入完成才取代原檔）
+#include <QSaveFile>
+// 引入 Qt 資料串流類別
+#include <QDataStream>
+// 引入 C 字串函式（memcmp）
+#include <cstring>
+// 引入 C++ 演算法函式庫
+#include <algorithm>
+
+namespace {
+    // 單一詞的最大長度（UTF-16 單位），過長的字串（例如雜湊值）只取開頭
+    const int MAX_TOKEN_LENGTH = 32;
+    // 被取代的字幕段落少於此數時不清除
+    const int MIN_COMPACT_CUES = 4096;
+    // 每種文件最多計算相關程度的命中數；依前置排序（近似比對含有片語、文字較短）優先計算
+    const int MAX_SCORED_CANDIDATES = 2000;
+    // 索引檔案的魔術字與版本
+    const char INDEX_MAGIC[8] = { 'L', 'R', 'S', 'R', 'C', 'H', 'I', 'X' };
+    const quint32 INDEX_VERSION = 1;
+
+    // 斷詞與比對前的正規化：NFKC 與大小寫摺疊
+    QString normalize(QStringView text)
+    {
+        return text.toString().normalized(QString::NormalizationForm_KC).toCaseFolded();
+    }
+
+    // 正規化後只保留字母、數字（與組成它們的代理對和附加符號），用來比對完整片語
+    QString compactText(QStringView text)
+    {
+        const QString normalized = normalize(text);
+        QString compact;
+        compact.reserve(normalized.size());
+        for (QChar c : normalized) {
+            if (c.isLetterOrNumber() || c.isSurrogate() || c.isMark()) {
+                compact.append(c);
+            }
+        }
+        return compact;
+    }
+
+    // 不做 NFKC 正規化的近似片語比對：只略過非字母數字並摺疊大小寫，
+    // 比 compactText() 便宜得多，只有相容字元（例如全形英數字）會判斷錯誤
+    bool roughlyContains(const QString& phrase, QStringView text)
+    {
+        QString compact;
+        compact.reserve(text.size());
+        for (QChar c : text) {
+            if (c.isLetterOrNumber() || c.isSurrogate() || c.isMark()) {
+                compact.append(c.toCaseFolded());
+            }
+        }
+        return compact.contains(phrase);
+    }
+
+    // 文件與查詢的相關程度：含有完整片語的文件優先（+1），其次是片語佔文件的比例（越短越切題）
+    double relevance(const QString& phrase, QStringView text)
+    {
+        const QString compact = compactText(text);
+        if (compact.isEmpty()) {
+            return 0.0;
+        }
+        const double coverage = qMin(1.0, double(phrase.size()) / compact.size());
+        return (compact.contains(phrase) ? 1.0 : 0.0) + coverage;
+    }
+
+    // 整塊寫入固定大小元素的陣列
+    template <typename T>
+    void writeArray(QDataStream& stream, const QVector<T>& array)
+    {
+        stream << quint32(array.size());
+        stream.writeRawData(reinterpret_cast<const char*>(array.constData()), int(array.size() * sizeof(T)));
+    }
+
+    // 整塊讀取固定大小元素的陣列，長度超過剩餘的檔案內容時視為損毀
+    template <typename T>
+    bool readArray(QDataStream& stream, QVector<T>& array)
+    {
+        quint32 size = 0;
+        stream >> size;
+        const qint64 bytes = qint64(size) * qint64(sizeof(T));
+        if (stream.status() != QDataStream::Ok || bytes > stream.device()->bytesAvailable()) {
+            return false;
+        }
+        array.resize(size);
+        return stream.readRawData(reinterpret_cast<char*>(array.data()), int(bytes)) == bytes;
+    }
+
+    // 是否為中日韓文字（沒有空白分詞，以單字與二元詞收錄）
+    bool isCjk(char32_t ucs4)
+    {
+        switch (QChar::script(ucs4)) {
+        case QChar::Script_Han:
+        case QChar::Script_Hiragana:
+        case QChar::Script_Katakana:
+        case QChar::Script_Hangul:
+        case QChar::Script_Bopomofo:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 各清單的交集中 accept 接受的所有文件，依編號排序
+    //
+    // 只走訪最短的清單，其餘清單以二分搜尋從上次的位置往後找；
+    // 任一清單走到尾端時之後不可能再有交集，直接結束。
+    template <typename Accept>
+    QVector<quint32> intersect(QVector<const QVector<quint32>*> lists, Accept accept)
+    {
+        QVector<quint32> documents;
+        if (lists.isEmpty()) {
+            return documents;
+        }
+        std::sort(lists.begin(), lists.end(), [](const QVector<quint32>* a, const QVector<quint32>* b) {
+            return a->size() < b->size();
+        });
+
+        QVector<const quint32*> cursors;
+        cursors.reserve(lists.size());
+        for (const QVector<quint32>* list : lists) {
+            cursors.append(list->constBegin());
+        }
+
+        for (quint32 document : *lists.first()) {
+            bool matched = true;
+            for (int i = 1; i < lists.size(); i++) {
+                const quint32* end = lists[i]->constEnd();
+                cursors[i] = std::lower_bound(cursors[i], end, document);
+                if (cursors[i] == end) {
+                    return documents;
+                }
+                if (*cursors[i] != document) {
+                    matched = false;
+                    break;
+                }
+            }
+            if (matched && accept(document)) {
+                documents.append(document);
+            }
+        }
+        return documents;
+    }
+
+    // 依相關程度排序交集中的文件，回傳最相關的 limit 份
+    //
+    // relevance() 需要正規化整段文字，不對整個交集計算：先以便宜的前置分數排序所有文件
+    // （近似比對含有片語的優先，其次是文字越短、片語佔的比例越高），
+    // 再依序計算相關程度，已有 limit 份含有完整片語時之後的文件幾乎不可能排得更前面，直接結束；
+    // 最多計算 MAX_SCORED_CANDIDATES 份（limit 較大時為 limit 份）。textOf 回傳文件的文字。
+    template <typename TextOf>
+    QVector<quint32> rank(const QVector<quint32>& documents, const QString& phrase, int limit, TextOf textOf)
+    {
+        struct Candidate {
+            quint32 document;
+            bool quoted;     // 近似比對含有片語
+            int length;      // 原文長度
+            double score;    // 相關程度
+        };
+        QVector<Candidate> candidates;
+        candidates.reserve(documents.size());
+        for (quint32 document : documents) {
+            const auto text = textOf(document);
+            candidates.append(Candidate{ document, roughlyContains(phrase, text), int(text.size()), 0.0 });
+        }
+        // 同分時維持文件編號的順序（曲目的加入順序、字幕段落的時間順序）
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.quoted != b.quoted ? a.quoted : a.length < b.length;
+        });
+
+        const int budget = qMax(limit, MAX_SCORED_CANDIDATES);
+        int scored = 0;
+        int exact = 0;
+        while (scored < candidates.size() && scored < budget && exact < limit) {
+            Candidate& candidate = candidates[scored++];
+            candidate.score = relevance(phrase, textOf(candidate.document));
+            if (candidate.score >= 1.0) {
+                exact++;
+            }
+        }
+        candidates.resize(scored);
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.score > b.score;
+        });
+
+        QVector<quint32> ranked;
+        ranked.reserve(qMin<int>(limit, candidates.size()));
+        for (int i = 0; i < candidates.size() && i < limit; i++) {
+            ranked.append(candidates.at(i).document);
+        }
+        return ranked;
+    }
+}
+
+SearchIndex::SearchIndex()
+    : liveCues(0)
+    , changes(0)
+{
+}
+
+QStringList SearchIndex::tokenize(QStringView text)
+{
+    QStringList tokens;
+    tokenize(text, QueryTokens, tokens);
+    return tokens;
+}
+
+void SearchIndex::tokenize(QStringView text, TokenMode mode, QStringList& tokens)
+{
+    const QString normalized = normalize(text);
+    const int length = normalized.size();
+
+    // 目前的拼音文字詞的起點（-1 表示沒有），與目前中日韓文字段每個字的起點（字可能是代理對）
+    int wordStart = -1;
+    QVector<int> cjkStarts;
+
+    const auto flushWord = [&](int end) {
+        if (wordStart >= 0) {
+            tokens.append(normalized.mid(wordStart, qMin(end - wordStart, MAX_TOKEN_LENGTH)));
+            wordStart = -1;
+        }
+    };
+    const auto flushCjk = [&](int end) {
+        const int count = cjkStarts.size();
+        if (count == 0) {
+            return;
+        }
+        cjkStarts.append(end);
+        for (int i = 0; i < count; i++) {
+            if (mode == IndexTokens || count == 1) {
+                tokens.append(normalized.mid(cjkStarts[i], cjkStarts[i + 1] - cjkStarts[i]));
+            }
+            if (i + 1 < count) {
+                tokens.append(normalized.mid(cjkStarts[i], cjkStarts[i + 2] - cjkStarts[i]));
+            }
+        }
+        cjkStarts.clear();
+    };
+
+    int position = 0;
+    while (position < length) {
+        char32_t ucs4 = normalized.at(position).unicode();
+        int width = 1;
+        if (QChar::isHighSurrogate(ucs4) && position + 1 < length && normalized.at(position + 1).isLowSurrogate()) {
+            ucs4 = QChar::surrogateToUcs4(normalized.at(position), normalized.at(position + 1));
+            width = 2;
+        }
+
+        if (isCjk(ucs4)) {
+            flushWord(position);
+            cjkStarts.append(position);
+        } else if (QChar::isLetterOrNumber(ucs4) || (wordStart >= 0 && QChar::isMark(ucs4))) {
+            flushCjk(position);
+            if (wordStart < 0) {
+                wordStart = position;
+            }
+        } else {
+            flushWord(position);
+            flushCjk(position);
+        }
+        position += width;
+    }
+    flushWord(length);
+    flushCjk(length);
+}
+
+bool SearchIndex::contains(const QString& key) const
+{
+    const int id = trackIds.value(key, -1);
+    return id >= 0 && tracks[id].hasMetadata;
+}
+
+bool SearchIndex::hasTranscript(const QString& key) const
+{
+    const int id = trackIds.value(key, -1);
+    return id >= 0 && tracks[id].hasTranscript;
+}
+
+void SearchIndex::addTrack(const VideoInfo& video)
+{
+    const QString key = trackKey(video);
+    int id = trackIds.value(key, -1);
+    if (id < 0) {
+        id = tracks.size();
+        tracks.append(Track());
+        tracks[id].key = key;
+        trackIds.insert(key, id);
+    }
+
+    QString text = video.title + ' ' + video.channelTitle + ' ' + video.description;
+    if (video.isLocalFile) {
+        text += ' ' + QFileInfo(video.filePath).completeBaseName();
+    }
+    const QVector<int> terms = documentTerms(text);
+
+    Track& track = tracks[id];
+    removePostings(trackPostings, track.terms, id);
+    track.title = video.title;
+    track.channelTitle = video.channelTitle;
+    track.terms = terms;
+    track.hasMetadata = true;
+    addPostings(trackPostings, track.terms, id);
+    changes++;
+}
+
+void SearchIndex::setTranscript(const QString& key, const SubtitleCueList& cueList)
+{
+    const int id = trackIds.value(key, -1);
+    if (id < 0) {
+        return;
+    }
+
+    dropCues(tracks[id]);
+    const int firstCue = cues.size();
+    for (int i = 0; i < cueList.size(); i++) {
+        const QStringView text = cueList.cueText(i);
+        const QVector<int> terms = documentTerms(text);
+        const quint32 document = cues.size();
+        cues.append(Cue{ cueList.cues[i].startMs, id, int(cueText.size()), int(text.size()), 0 });
+        cueText.append(text);
+        addPostings(cuePostings, terms, document);
+    }
+
+    Track& track = tracks[id];
+    track.firstCue = firstCue;
+    track.cueEnd = cues.size();
+    track.hasTranscript = true;
+    liveCues += cueList.size();
+    changes++;
+
+    maybeCompactCues();
+}
+
+void SearchIndex::removeTrack(const QString& key)
+{
+    const int id = trackIds.value(key, -1);
+    if (id < 0) {
+        return;
+    }
+
+    // 曲目的空位保留，編號不重複使用，其餘曲目的清單不需要調整
+    Track& track = tracks[id];
+    removePostings(trackPostings, track.terms, id);
+    dropCues(track);
+    track = Track();
+    trackIds.remove(key);
+    changes++;
+
+    maybeCompactCues();
+}
+
+void SearchIndex::clear()
+{
+    termIds.clear();
+    trackPostings.clear();
+    cuePostings.clear();
+    trackIds.clear();
+    tracks.clear();
+    cues.clear();
+    cueText.clear();
+    liveCues = 0;
+    changes++;
+}
+
+quint64 SearchIndex::revision() const
+{
+    return changes;
+}
+
+int SearchIndex::trackCount() const
+{
+    return trackIds.size();
+}
+
+QStringList SearchIndex::trackKeys() const
+{
+    return trackIds.keys();
+}
+
+int SearchIndex::cueCount() const
+{
+    return liveCues;
+}
+
+QList<SearchHit> SearchIndex::search(QStringView query, int limit) const
+{
+    QList<SearchHit> hits;
+    if (limit <= 0) {
+        return hits;
+    }
+
+    // 任何一個詞沒有出現過就不可能命中
+    QVector<int> terms;
+    for (const QString& token : tokenize(query)) {
+        const int term = termIds.value(token, -1);
+        if (term < 0) {
+            return hits;
+        }
+        if (!terms.contains(term)) {
+            terms.append(term);
+        }
+    }
+    if (terms.isEmpty()) {
+        return hits;
+    }
+
+    // 排序依據：查詢去掉空白與標點後的完整片語
+    const QString phrase = compactText(query);
+
+    // 曲目資訊：移除的曲目已從清單刪除，交集中的都是有效的曲目；片語出現在標題或藝術家的優先
+    QVector<const QVector<quint32>*> lists;
+    for (int term : terms) {
+        lists.append(&trackPostings[term]);
+    }
+    const auto anyTrack = [](quint32) { return true; };
+    const auto trackText = [this](quint32 id) { return QString(tracks[id].title + ' ' + tracks[id].channelTitle); };
+    const QVector<quint32> rankedTracks = rank(intersect(lists, anyTrack), phrase, limit, trackText);
+
+    // 字幕段落：略過被取代的段落
+    lists.clear();
+    for (int term : terms) {
+        lists.append(&cuePostings[term]);
+    }
+    const auto liveCue = [this](quint32 document) { return cues[document].track >= 0; };
+    const auto cueTextOf = [this](quint32 document) {
+        return QStringView(cueText).mid(cues[document].textOffset, cues[document].textLength);
+    };
+    const QVector<quint32> rankedCues = rank(intersect(lists, liveCue), phrase, limit, cueTextOf);
+
+    // 兩種命中都多時各佔一半，曲目很多也不會把字幕段落擠出結果
+    const int trackHits = qMin<int>(rankedTracks.size(), qMax<int>(limit / 2, limit - rankedCues.size()));
+    const int cueHits = qMin<int>(rankedCues.size(), limit - trackHits);
+    for (int i = 0; i < trackHits; i++) {
+        const Track& track = tracks[rankedTracks[i]];
+        hits.append(SearchHit{ track.key, track.title, track.channelTitle, -1, QString() });
+    }
+    for (int i = 0; i < cueHits; i++) {
+        const Cue& cue = cues[rankedCues[i]];
+        const Track& track = tracks[cue.track];
+        hits.append(SearchHit{ track.key, track.title, track.channelTitle, cue.startMs,
+                               cueText.mid(cue.textOffset, cue.textLength) });
+    }
+    return hits;
+}
+
+QVector<int> SearchIndex::documentTerms(QStringView text)
+{
+    QStringList tokens;
+    tokenize(text, IndexTokens, tokens);
+
+    QVector<int> terms;
+    terms.reserve(tokens.size());
+    for (const QString& token : tokens) {
+        auto it = termIds.find(token);
+        if (it == termIds.end()) {
+            it = termIds.insert(token, trackPostings.size());
+            trackPostings.append(QVector<quint32>());
+            cuePostings.append(QVector<quint32>());
+        }
+        terms.append(it.value());
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+void SearchIndex::addPostings(QVector<QVector<quint32>>& postings, const QVector<int>& terms, quint32 document)
+{
+    for (int term : terms) {
+        QVector<quint32>& list = postings[term];
+        // 新文件的編號最大，直接附加；更新既有曲目時才需要插入
+        if (list.isEmpty() || list.last() < document) {
+            list.append(document);
+        } else {
+            const auto it = std::lower_bound(list.begin(), list.end(), document);
+            if (*it != document) {
+                list.insert(it, document);
+            }
+        }
+    }
+}
+
+void SearchIndex::removePostings(QVector<QVector<quint32>>& postings, const QVector<int>& terms, quint32 document)
+{
+    for (int term : terms) {
+        QVector<quint32>& list = postings[term];
+        const auto it = std::lower_bound(list.begin(), list.end(), document);
+        if (it != list.end() && *it == document) {
+            list.erase(it);
+        }
+    }
+}
+
+void SearchIndex::dropCues(Track& track)
+{
+    for (int i = track.firstCue; i < track.cueEnd; i++) {
+        cues[i].track = -1;
+    }
+    liveCues -= track.cueEnd - track.firstCue;
+    track.firstCue = 0;
+    track.cueEnd = 0;
+    track.hasTranscript = false;
+}
+
+void SearchIndex::maybeCompactCues()
+{
+    const int deadCues = cues.size() - liveCues;
+    if (deadCues < MIN_COMPACT_CUES || deadCues <= liveCues) {
+        return;
+    }
+
+    // 舊編號 → 新編號；有效段落的相對順序不變，清單重新編號後仍然是排序的
+    QVector<int> renumbered(cues.size(), -1);
+    QVector<Cue> kept;
+    kept.reserve(liveCues);
+    QString keptText;
+    for (int i = 0; i < cues.size(); i++) {
+        if (cues[i].track >= 0) {
+            Cue cue = cues[i];
+            renumbered[i] = kept.size();
+            cue.textOffset = keptText.size();
+            keptText.append(QStringView(cueText).mid(cues[i].textOffset, cues[i].textLength));
+            kept.append(cue);
+        }
+    }
+
+    for (QVector<quint32>& list : cuePostings) {
+        int size = 0;
+        for (int i = 0; i < list.size(); i++) {
+            const int value = renumbered[list[i]];
+            if (value >= 0) {
+                list[size++] = value;
+            }
+        }
+        list.resize(size);
+        list.squeeze();
+    }
+    // 沒有段落的範圍（包括收錄了空字幕的曲目）也要歸零，否則會超出清除後的段落數
+    for (Track& track : tracks) {
+        if (track.cueEnd > track.firstCue) {
+            const int count = track.cueEnd - track.firstCue;
+            track.firstCue = renumbered[track.firstCue];
+            track.cueEnd = track.firstCue + count;
+        } else {
+            track.firstCue = 0;
+            track.cueEnd = 0;
+        }
+    }
+    cues = kept;
+    cueText = keptText;
+}
+
+bool SearchIndex::save(const QString& path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.writeRawData(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    stream << INDEX_VERSION;
+
+    // 詞表依詞編號排列，讀回時編號不變
+    QVector<QString> terms(termIds.size());
+    for (auto it = termIds.cbegin(); it != termIds.cend(); ++it) {
+        terms[it.value()] = it.key();
+    }
+    stream << quint32(terms.size());
+    for (int term = 0; term < terms.size(); term++) {
+        stream << terms[term];
+        writeArray(stream, trackPostings[term]);
+        writeArray(stream, cuePostings[term]);
+    }
+
+    stream << quint32(tracks.size());
+    for (const Track& track : tracks) {
+        stream << track.key << track.title << track.channelTitle
+               << qint32(track.firstCue) << qint32(track.cueEnd)
+               << track.hasMetadata << track.hasTranscript;
+        writeArray(stream, track.terms);
+    }
+
+    writeArray(stream, cues);
+    stream << cueText << qint32(liveCues);
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool SearchIndex::load(const QString& path)
+{
+    clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    if (!read(stream)) {
+        clear();
+        return false;
+    }
+    changes = 0;
+    return true;
+}
+
+bool SearchIndex::read(QDataStream& stream)
+{
+    char magic[sizeof(INDEX_MAGIC)];
+    quint32 version = 0;
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic) ||
+        memcmp(magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        return false;
+    }
+    stream >> version;
+    if (version != INDEX_VERSION) {
+        return false;
+    }
+
+    quint32 termCount = 0;
+    stream >> termCount;
+    // 每個詞至少佔用數個位元組，數量超過剩餘的檔案大小表示檔案損毀
+    if (stream.status() != QDataStream::Ok || termCount > stream.device()->bytesAvailable()) {
+        return false;
+    }
+    trackPostings.resize(termCount);
+    cuePostings.resize(termCount);
+    termIds.reserve(termCount);
+    for (quint32 term = 0; term < termCount; term++) {
+        QString token;
+        stream >> token;
+        if (!readArray(stream, trackPostings[term]) || !readArray(stream, cuePostings[term])) {
+            return false;
+        }
+        termIds.insert(token, term);
+    }
+
+    quint32 trackCount = 0;
+    stream >> trackCount;
+    if (stream.status() != QDataStream::Ok || trackCount > stream.device()->bytesAvailable()) {
+        return false;
+    }
+    tracks.resize(trackCount);
+    for (quint32 id = 0; id < trackCount; id++) {
+        Track& track = tracks[id];
+        qint32 firstCue = 0;
+        qint32 cueEnd = 0;
+        stream >> track.key >> track.title >> track.channelTitle >> firstCue >> cueEnd
+               >> track.hasMetadata >> track.hasTranscript;
+        if (!readArray(stream, track.terms)) {
+            return false;
+        }
+        track.firstCue = firstCue;
+        track.cueEnd = cueEnd;
+        if (!track.key.isEmpty()) {
+            trackIds.insert(track.key, id);
+        }
+    }
+
+    qint32 live = 0;
+    if (!readArray(stream, cues)) {
+        return false;
+    }
+    stream >> cueText >> live;
+    liveCues = live;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // 檢查所有編號與文字範圍，損毀的檔案不會讓之後的查詢越界
+    for (const Track& track : tracks) {
+        if (track.firstCue < 0 || track.cueEnd < track.firstCue || track.cueEnd > cues.size()) {
+            return false;
+        }
+        for (int term : track.terms) {
+            if (term < 0 || quint32(term) >= termCount) {
+                return false;
+            }
+        }
+    }
+    for (Cue& cue : cues) {
+        if (cue.track < -1 || cue.track >= int(trackCount) || cue.textOffset < 0 || cue.textLength < 0 ||
+            qint64(cue.textOffset) + cue.textLength > cueText.size()) {
+            return false;
+        }
+        // 之前的版本寫出的是未初始化的補齊位元組，讀入後歸零，下次保存時不再寫出
+        cue.reserved = 0;
+    }
+    for (quint32 term = 0; term < termCount; term++) {
+        for (quint32 id : trackPostings[term]) {
+            if (id >= trackCount) {
+                return false;
+            }
+        }
+        for (quint32 document : cuePostings[term]) {
+            if (document >= quint32(cues.size())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,160 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+// 引入字幕段落結構
+#include "subtitleparser.h"
+// 引入 Qt 字串類別
+#include <QString>
+// 引入 Qt 字串檢視類別
+#include <QStringView>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+// 引入 Qt 動態陣列類別
+#include <QVector>
+// 引入 Qt 雜湊表類別
+#include <QHash>
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 前向宣告 Qt 資料串流類別
+class QDataStream;
+
+// 一筆搜尋結果
+struct SearchHit {
+    QString trackKey;         // 曲目鍵值
+    QString title;            // 曲目標題
+    QString channelTitle;     // 頻道名稱/藝術家
+    qint64 startMs = -1;      // 比對到的字幕段落開始時間（毫秒），-1 表示比對到曲目資訊
+    QString text;             // 比對到的字幕段落文字（比對到曲目資訊時為空）
+};
+
+// 曲目資訊與轉錄字幕的全文搜尋索引
+//
+// 倒排索引：詞 → 依編號排序的文件清單。曲目資訊（標題、藝術家、描述、檔名）每首曲目一份文件，
+// 字幕則是每個段落一份文件，兩者各有一組清單，查詢時先列出曲目再列出字幕段落。
+// 斷詞兼顧中日韓文字與拼音文字：
+//   - 先做 NFKC 正規化與大小寫摺疊，全形英數字視同半形、不分大小寫
+//   - 拼音文字與數字以連續的字母數字為一個詞
+//   - 中日韓文字沒有空白分詞，收錄時取每個字（單字）與相鄰兩字（二元詞）；
+//     查詢時兩字以上只用二元詞比對，單獨一個字才用單字，不需要詞典
+// 查詢的詞全部出現在同一份文件才算命中，從最短的清單開始以二分搜尋求出完整的交集；
+// 排序時含有完整片語（忽略空白與標點）的優先，其次是片語佔文件文字的比例。
+// 完整片語需要正規化文字才能判斷，因此先以不做正規化的近似比對與文字長度為整個交集做前置排序，
+// 再依序計算，已找到足夠的完整片語命中（或計算了兩千份）即停止；
+// 耗時取決於最短的清單與交集的大小，而不是索引的大小。
+//
+// 新增曲目與更新字幕都是增量的：新文件的編號遞增，直接附加在清單尾端；
+// 被取代的字幕段落只做標記，累積超過有效段落數時才一次清除並重新編號。
+// 字幕文字與 SubtitleCueList 一樣串接在同一個緩衝區，用於排序與顯示命中的段落。
+//
+// save()/load() 將整個索引（詞表、清單、曲目、段落與文字）寫成一個二進位檔案，
+// 啟動時直接讀回，不需要重新解析任何字幕檔案。檔案只在本機使用，數值陣列以原生位元組順序整塊寫入。
+class SearchIndex
+{
+public:
+    // 建構函式，索引為空
+    SearchIndex();
+
+    // 將查詢文字切成詞（中日韓文字兩字以上只取二元詞）
+    static QStringList tokenize(QStringView text);
+
+    // 是否已收錄曲目資訊
+    bool contains(const QString& key) const;
+    // 曲目是否已收錄字幕
+    bool hasTranscript(const QString& key) const;
+    // 收錄曲目資訊，已收錄時以新的資訊取代
+    void addTrack(const VideoInfo& video);
+    // 收錄曲目的字幕段落並取代之前的字幕；曲目尚未收錄時忽略
+    void setTranscript(const QString& key, const SubtitleCueList& cues);
+    // 移除曲目與其字幕
+    void removeTrack(const QString& key);
+    // 清空索引
+    void clear();
+    // 每次修改都會增加的版本號，用來判斷保存後是否又有變更
+    quint64 revision() const;
+
+    // 將索引寫入檔案（QSaveFile 原子性地覆寫），失敗時回傳 false
+    bool save(const QString& path) const;
+    // 從檔案讀取索引，檔案不存在、損毀或版本不符時回傳 false 並清空索引
+    bool load(const QString& path);
+
+    // 收錄的曲目數
+    int trackCount() const;
+    // 收錄的曲目鍵值（順序不固定）
+    QStringList trackKeys() const;
+    // 收錄的字幕段落數（不含被取代的段落）
+    int cueCount() const;
+
+    // 搜尋，最多回傳 limit 筆：先是曲目資訊命中的曲目，再是命中的字幕段落，各自依相關程度排序；
+    // 兩種命中都多時各佔一半
+    QList<SearchHit> search(QStringView query, int limit) const;
+
+private:
+    // 斷詞方式
+    enum TokenMode {
+        QueryTokens,   // 查詢：中日韓文字兩字以上只取二元詞
+        IndexTokens    // 收錄：中日韓文字取單字與二元詞
+    };
+
+    // 收錄的曲目
+    struct Track {
+        QString key;
+        QString title;
+        QString channelTitle;
+        QVector<int> terms;           // 曲目資訊的詞編號（更新或移除時從清單中刪除）
+        int firstCue = 0;             // 字幕段落的編號範圍 [firstCue, cueEnd)
+        int cueEnd = 0;
+        bool hasMetadata = false;
+        bool hasTranscript = false;
+    };
+
+    // 收錄的字幕段落（固定大小，保存時整塊寫入）
+    struct Cue {
+        qint64 startMs;               // 段落開始時間（毫秒）
+        int track;                    // 曲目編號，-1 表示已被取代
+        int textOffset;               // 文字在 cueText 中的起始位置
+        int textLength;               // 文字長度
+        int reserved;                 // 固定為 0，補齊對齊空間，整塊寫入時不會寫出未初始化的位元組
+    };
+    static_assert(sizeof(Cue) == 24, "Cue must have no padding bytes");
+
+    // 將文字切成詞，附加到 tokens
+    static void tokenize(QStringView text, TokenMode mode, QStringList& tokens);
+    // 將一份文件的文字轉為不重複的詞編號，新詞配發編號與空的清單
+    QVector<int> documentTerms(QStringView text);
+    // 將文件加入各詞的清單
+    static void addPostings(QVector<QVector<quint32>>& postings, const QVector<int>& terms, quint32 document);
+    // 從各詞的清單移除文件
+    static void removePostings(QVector<QVector<quint32>>& postings, const QVector<int>& terms, quint32 document);
+    // 標記曲目的字幕段落已被取代
+    void dropCues(Track& track);
+    // 被取代的段落多於有效段落時，清除並重新編號
+    void maybeCompactCues();
+    // 讀取檔案內容，失敗時回傳 false（由 load() 清空索引）
+    bool read(QDataStream& stream);
+
+    // 詞 → 詞編號
+    QHash<QString, int> termIds;
+    // 詞編號 → 含有該詞的曲目編號（遞增排序）
+    QVector<QVector<quint32>> trackPostings;
+    // 詞編號 → 含有該詞的字幕段落編號（遞增排序）
+    QVector<QVector<quint32>> cuePostings;
+    // 曲目鍵值 → 曲目編號
+    QHash<QString, int> trackIds;
+    // 曲目編號 → 曲目（移除的曲目留下空位，編號不重複使用）
+    QVector<Track> tracks;
+    // 段落編號 → 字幕段落
+    QVector<Cue> cues;
+    // 所有段落文字串接而成的緩衝區
+    QString cueText;
+    // 有效的字幕段落數
+    int liveCues;
+    // 修改版本號
+    quint64 changes;
+};
+
+// 結束標頭檔保護宏
+#endif // SEARCHINDEX_H
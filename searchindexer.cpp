@@ -0,0 +1,270 @@
+// 引入搜尋索引維護標頭檔
+#include "searchindexer.h"
+// 引入播放清單持久化引擎
+#include "playliststore.h"
+// 引入字幕解析器
+#include "subtitleparser.h"
+
+// 引入 Qt 計時器類別
+#include <QTimer>
+// 引入 Qt 並行執行函式
+#include <QtConcurrent/QtConcurrent>
+
+namespace {
+    // 每批收錄的曲目數（遇到需要解析的字幕時提前結束這一批）
+    const int SWEEP_BATCH = 2000;
+}
+
+SearchIndexer::SearchIndexer(QList<Playlist>* playlists, PlaylistStore* store, QObject* parent)
+    : QObject(parent)
+    , playlists(playlists)
+    , store(store)
+    , loader(new QFutureWatcher<SearchIndex>(this))
+    , parser(new QFutureWatcher<ParsedTranscript>(this))
+    , indexLoaded(false)
+    , savedRevision(0)
+    , sweepPlaylist(-1)
+    , sweepRow(0)
+    , sweeping(false)
+    , sweepTimer(new QTimer(this))
+{
+    sweepTimer->setInterval(0);
+    connect(sweepTimer, &QTimer::timeout, this, &SearchIndexer::indexNextTracks);
+    connect(loader, &QFutureWatcher<SearchIndex>::finished, this, &SearchIndexer::onLoadFinished);
+    connect(parser, &QFutureWatcher<ParsedTranscript>::finished, this, &SearchIndexer::onParseFinished);
+}
+
+SearchIndexer::~SearchIndexer()
+{
+    // 載入器會讀取播放清單持久化引擎的檔案
+    loader->waitForFinished();
+}
+
+void SearchIndexer::start()
+{
+    PlaylistStore* store = this->store;
+    loader->setFuture(QtConcurrent::run([store]() {
+        SearchIndex index;
+        store->loadSearchIndex(index);
+        return index;
+    }));
+}
+
+bool SearchIndexer::isLoaded() const
+{
+    return indexLoaded;
+}
+
+QList<SearchHit> SearchIndexer::search(QStringView query, int limit) const
+{
+    return index.search(query, limit);
+}
+
+void SearchIndexer::addTrack(const VideoInfo& video)
+{
+    index.addTrack(video);
+    if (sweeping) {
+        sweepKeys.insert(trackKey(video));
+    }
+}
+
+void SearchIndexer::indexTranscript(const QString& key, const QString& srtFilePath)
+{
+    parseQueue.append({ key, srtFilePath });
+    parseNextTranscript();
+}
+
+void SearchIndexer::parseNextTranscript()
+{
+    if (parser->isRunning() || parseQueue.isEmpty()) return;
+
+    const QPair<QString, QString> transcript = parseQueue.takeFirst();
+    const QString key = transcript.first;
+    const QString srtFilePath = transcript.second;
+    parser->setFuture(QtConcurrent::run([key, srtFilePath]() {
+        ParsedTranscript parsed;
+        parsed.key = key;
+        parsed.cues = SubtitleParser::parseFile(srtFilePath, &parsed.ok);
+        return parsed;
+    }));
+}
+
+void SearchIndexer::onParseFinished()
+{
+    // flush() 已取走並收錄的結果不再收錄
+    if (parser->future().isValid() && parser->future().resultCount() > 0) {
+        const ParsedTranscript parsed = parser->future().takeResult();
+        if (parsed.ok) {
+            // 保存的索引還在載入，載入完成後再收錄一次到完整的索引
+            if (!indexLoaded) {
+                pendingTranscripts.append({ parsed.key, parsed.cues });
+            }
+            applyTranscript(parsed.key, parsed.cues);
+        }
+    }
+
+    parseNextTranscript();
+    if (sweeping && !parser->isRunning()) {
+        sweepTimer->start();
+    }
+}
+
+void SearchIndexer::applyTranscript(const QString& key, const SubtitleCueList& cues)
+{
+    // 分批收錄還沒輪到這首曲目時，先收錄播放清單中的曲目資訊（不在 GUI 執行緒讀取檔案標籤）；
+    // 只在尚未展開的播放清單中時由分批收錄處理
+    if (!index.contains(key)) {
+        for (int i = 0; i < playlists->size(); i++) {
+            const Playlist& playlist = playlists->at(i);
+            if (playlist.cacheIndex >= 0) continue;
+            const int row = playlist.indexOf(key);
+            if (row >= 0) {
+                addTrack(playlist.videos[row]);
+                break;
+            }
+        }
+    }
+    index.setTranscript(key, cues);
+}
+
+void SearchIndexer::removeTracks(const QStringList& keys)
+{
+    // 先比對已展開的播放清單（雜湊索引），仍找不到的才讀取尚未展開的播放清單
+    QStringList removed;
+    for (const QString& key : keys) {
+        bool found = false;
+        for (int i = 0; i < playlists->size() && !found; i++) {
+            const Playlist& playlist = playlists->at(i);
+            found = playlist.cacheIndex < 0 && playlist.indexOf(key) >= 0;
+        }
+        if (!found && index.contains(key)) {
+            removed.append(key);
+        }
+    }
+    if (removed.isEmpty()) return;
+
+    QSet<QString> cachedKeys;
+    for (int i = 0; i < playlists->size(); i++) {
+        if (playlists->at(i).cacheIndex < 0) continue;
+        for (const VideoInfo& video : store->videos(playlists->at(i))) {
+            cachedKeys.insert(trackKey(video));
+        }
+    }
+    for (const QString& key : removed) {
+        if (!cachedKeys.contains(key)) {
+            index.removeTrack(key);
+        }
+    }
+}
+
+void SearchIndexer::flush()
+{
+    loader->waitForFinished();
+
+    // 解析中的字幕等待完成，尚未開始的直接在這裡解析（結束程式前佇列通常只剩一兩份）
+    parser->waitForFinished();
+    if (parser->future().isValid() && parser->future().resultCount() > 0) {
+        const ParsedTranscript parsed = parser->future().takeResult();
+        if (parsed.ok) {
+            applyTranscript(parsed.key, parsed.cues);
+        }
+    }
+    for (const auto& transcript : parseQueue) {
+        bool ok = false;
+        const SubtitleCueList cues = SubtitleParser::parseFile(transcript.second, &ok);
+        if (ok) {
+            applyTranscript(transcript.first, cues);
+        }
+    }
+    parseQueue.clear();
+    save();
+}
+
+void SearchIndexer::onLoadFinished()
+{
+    // 換成保存的索引；載入期間加入的曲目由接下來的分批收錄補上，完成的字幕在這裡重新收錄
+    index = loader->future().takeResult();
+    indexLoaded = true;
+    savedRevision = index.revision();
+    const QList<QPair<QString, SubtitleCueList>> transcripts = pendingTranscripts;
+    pendingTranscripts.clear();
+    for (const auto& transcript : transcripts) {
+        applyTranscript(transcript.first, transcript.second);
+    }
+
+    // 只收錄保存之後新增的曲目與字幕：已收錄的曲目直接略過，不會重新解析字幕檔案
+    for (int i = 0; i < playlists->size(); i++) {
+        sweepPlaylists.append(playlists->at(i).name);
+    }
+    sweeping = true;
+    if (!parser->isRunning()) {
+        sweepTimer->start();
+    }
+    emit loaded();
+}
+
+void SearchIndexer::indexNextTracks()
+{
+    // 有字幕正在解析時暫停，解析完成後由 onParseFinished() 繼續
+    if (parser->isRunning()) {
+        sweepTimer->stop();
+        return;
+    }
+
+    // 尚未展開的播放清單從快取讀取複本收錄，不為了搜尋而展開所有播放清單
+    int budget = SWEEP_BATCH;
+    while (budget > 0) {
+        if (sweepRow >= sweepVideos.size()) {
+            sweepPlaylist++;
+            sweepRow = 0;
+            sweepVideos.clear();
+            if (sweepPlaylist >= sweepPlaylists.size()) {
+                // 沒有看到的曲目可能已被刪除，由 removeTracks() 確認已不在任何播放清單中才移除
+                QStringList unseen;
+                for (const QString& key : index.trackKeys()) {
+                    if (!sweepKeys.contains(key)) {
+                        unseen.append(key);
+                    }
+                }
+                sweepPlaylists.clear();
+                sweepKeys.clear();
+                sweeping = false;
+                sweepTimer->stop();
+                removeTracks(unseen);
+                save();
+                return;
+            }
+            // 已被刪除的播放清單直接略過
+            for (int i = 0; i < playlists->size(); i++) {
+                if (playlists->at(i).name == sweepPlaylists.at(sweepPlaylist)) {
+                    sweepVideos = store->videos(playlists->at(i));
+                    break;
+                }
+            }
+            continue;
+        }
+
+        // 同一首曲目出現在多個播放清單時只收錄一次；之後新增或轉錄的曲目已由各自的事件收錄
+        const VideoInfo& video = sweepVideos.at(sweepRow++);
+        const QString key = trackKey(video);
+        sweepKeys.insert(key);
+        budget--;
+        if (!index.contains(key)) {
+            index.addTrack(video);
+        }
+        // 字幕在背景解析，解析完成後才繼續（同一首曲目的字幕不會重複解析）
+        if (!video.subtitlePath.isEmpty() && !index.hasTranscript(key)) {
+            indexTranscript(key, video.subtitlePath);
+            sweepTimer->stop();
+            return;
+        }
+    }
+}
+
+void SearchIndexer::save()
+{
+    // 載入完成前的索引並不完整，不能覆寫保存的索引
+    if (!indexLoaded || index.revision() == savedRevision) return;
+    savedRevision = index.revision();
+    store->saveSearchIndex(index);
+}
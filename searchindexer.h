@@ -0,0 +1,126 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef SEARCHINDEXER_H
+#define SEARCHINDEXER_H
+
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+// 引入曲目與字幕的全文搜尋索引
+#include "searchindex.h"
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt 非同步結果監看類別
+#include <QFutureWatcher>
+// 引入 Qt 清單容器類別
+#include <QList>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+// 引入 Qt 配對類別
+#include <QPair>
+// 引入 Qt 集合類別
+#include <QSet>
+
+// 前向宣告播放清單持久化引擎
+class PlaylistStore;
+// 前向宣告 Qt 計時器類別
+class QTimer;
+
+// 搜尋索引的維護：載入、收錄與保存
+//
+// start() 在背景讀回保存的索引，載入完成後以 loaded() 通知，並在事件迴圈空閒時分批收錄
+// 所有播放清單中尚未收錄的曲目與字幕（尚未展開的播放清單從快取讀取複本，不為了搜尋而展開）。
+// 分批收錄開始時記下所有播放清單的名稱並依名稱逐一收錄，期間新增、刪除播放清單不會跳過其他播放清單。
+// 之後新增的曲目與完成的字幕由呼叫端以 addTrack()/indexTranscript() 收錄，刪除曲目或播放清單後
+// 以 removeTracks() 移除已不在任何播放清單中的曲目；分批收錄結束時，沒有在任何播放清單中看到的曲目
+// （例如保存索引之後在其他地方刪除）也會移除。
+// 字幕檔案依提交順序在背景執行緒逐一解析，GUI 執行緒只把解析結果收錄到索引；
+// 分批收錄遇到需要收錄的字幕時先暫停，等到沒有解析中的字幕才繼續，因此結束時所有字幕都已收錄。
+// 載入完成前的索引並不完整，不會保存；只在分批收錄結束與 flush() 時，在 PlaylistStore 的背景寫入執行緒保存。
+// 保存的是隱式共用的複本，之後第一次修改會在 GUI 執行緒複製整個索引，因此不定期保存。
+class SearchIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 建構函式，playlists 為 Widget 擁有的播放清單列表，store 負責讀寫保存的索引
+    SearchIndexer(QList<Playlist>* playlists, PlaylistStore* store, QObject* parent = nullptr);
+    // 解構函式，等待背景載入完成
+    ~SearchIndexer() override;
+
+    // 在背景載入保存的索引，完成後開始分批收錄
+    void start();
+    // 保存的索引是否已載入
+    bool isLoaded() const;
+
+    // 搜尋，最多回傳 limit 筆（見 SearchIndex::search()）
+    QList<SearchHit> search(QStringView query, int limit) const;
+    // 收錄新增的曲目
+    void addTrack(const VideoInfo& video);
+    // 在背景解析曲目 key 的字幕檔案後收錄，曲目資訊尚未收錄時從已展開的播放清單取得；
+    // 索引還在載入時，載入完成後再收錄一次（不重新解析）
+    void indexTranscript(const QString& key, const QString& srtFilePath);
+    // 移除 keys 中已不在任何播放清單中的曲目與其字幕（尚未展開的播放清單從快取讀取複本比對）
+    void removeTracks(const QStringList& keys);
+
+    // 等待背景載入完成並收錄尚未完成的字幕，索引有變更時保存（結束程式前、PlaylistStore::flush() 之前呼叫）
+    void flush();
+
+signals:
+    // 保存的索引已載入，搜尋結果從此時起是完整的
+    void loaded();
+
+private:
+    // 在背景解析的字幕
+    struct ParsedTranscript {
+        QString key;              // 曲目鍵值
+        SubtitleCueList cues;     // 解析後的字幕段落
+        bool ok = false;          // 是否成功讀取字幕檔案
+    };
+
+    // 換成載入的索引並開始分批收錄
+    void onLoadFinished();
+    // 沒有解析中的字幕時，在背景解析佇列中的下一份
+    void parseNextTranscript();
+    // 收錄解析完成的字幕，再解析下一份或繼續分批收錄
+    void onParseFinished();
+    // 收錄曲目 key 的字幕段落
+    void applyTranscript(const QString& key, const SubtitleCueList& cues);
+    // 收錄下一批曲目，全部收錄後停止並保存
+    void indexNextTracks();
+    // 索引有變更時保存
+    void save();
+
+    // Widget 擁有的播放清單列表
+    QList<Playlist>* playlists;
+    // 播放清單持久化引擎
+    PlaylistStore* store;
+    // 曲目資訊與字幕的全文搜尋索引
+    SearchIndex index;
+    // 在背景載入保存的搜尋索引
+    QFutureWatcher<SearchIndex>* loader;
+    // 在背景解析字幕檔案（一次一份）
+    QFutureWatcher<ParsedTranscript>* parser;
+    // 等待解析的字幕（曲目鍵值與字幕檔案路徑），依提交順序解析
+    QList<QPair<QString, QString>> parseQueue;
+    // 保存的搜尋索引是否已載入（載入前的索引不完整，不能保存）
+    bool indexLoaded;
+    // 最後保存時的索引版本號
+    quint64 savedRevision;
+    // 分批收錄開始時所有播放清單的名稱
+    QStringList sweepPlaylists;
+    // 分批收錄的進度：sweepPlaylists 中的位置、列號與該播放清單曲目的複本
+    int sweepPlaylist;
+    int sweepRow;
+    QList<VideoInfo> sweepVideos;
+    // 是否正在分批收錄（等待字幕解析而暫停時也是）
+    bool sweeping;
+    // 分批收錄期間看到或新增的曲目鍵值
+    QSet<QString> sweepKeys;
+    // 索引載入期間解析完成的字幕（曲目鍵值與字幕段落），載入後收錄到完整的索引
+    QList<QPair<QString, SubtitleCueList>> pendingTranscripts;
+    // 分批收錄的計時器（每次事件迴圈空閒時收錄一批）
+    QTimer* sweepTimer;
+};
+
+// 結束標頭檔保護宏
+#endif // SEARCHINDEXER_H
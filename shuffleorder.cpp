@@ -0,0 +1,305 @@
+// 引入隨機播放順序標頭檔
+#include "shuffleorder.h"
+
+// 引入 Qt 亂數產生器類別
+#include <QRandomGenerator>
+// 引入 C++ 演算法函式庫
+#include <algorithm>
+
+ShuffleOrder::ShuffleOrder()
+    : count(0)
+    , cursor(-1)
+    , poolStart(0)
+    , poolEnd(0)
+{
+}
+
+void ShuffleOrder::reset(int trackCount, int first)
+{
+    count = qMax(0, trackCount);
+    history.clear();
+    historyIndex.clear();
+    cursor = -1;
+    poolStart = 0;
+    poolEnd = count;
+    displacedRows.clear();
+    displacedPositions.clear();
+
+    if (first >= 0 && first < count) {
+        play(first);
+    }
+}
+
+int ShuffleOrder::trackCount() const
+{
+    return count;
+}
+
+int ShuffleOrder::current() const
+{
+    return cursor >= 0 ? history[cursor] : -1;
+}
+
+int ShuffleOrder::peek(int offset)
+{
+    const int index = cursor + offset;
+    if (index < 0) {
+        return -1;
+    }
+    while (index >= history.size()) {
+        if (draw() < 0) {
+            return -1;
+        }
+    }
+    return history[index];
+}
+
+bool ShuffleOrder::isExhausted() const
+{
+    return poolStart == poolEnd && cursor == history.size() - 1;
+}
+
+int ShuffleOrder::next()
+{
+    const int row = peek(1);
+    if (row >= 0) {
+        cursor++;
+    }
+    return row;
+}
+
+int ShuffleOrder::previous()
+{
+    if (cursor <= 0) {
+        return -1;
+    }
+    return history[--cursor];
+}
+
+void ShuffleOrder::play(int row)
+{
+    if (row < 0 || row >= count || row == current()) {
+        return;
+    }
+
+    const int index = historyIndex.value(row, -1);
+    if (index < 0) {
+        // 尚未抽出：從抽選池取出，排在目前曲目之後
+        takeFromPool(row);
+        history.insert(cursor + 1, row);
+        cursor++;
+        reindexHistory(cursor);
+    } else if (index == cursor + 1) {
+        cursor++;
+    } else if (index == cursor - 1) {
+        cursor--;
+    } else if (index > cursor) {
+        // 預先抽出的曲目提前播放，其餘預先抽出的曲目順延
+        history.move(index, cursor + 1);
+        reindexHistory(cursor + 1);
+        cursor++;
+    } else {
+        // 本輪較早播放過的曲目再播一次，歷史維持實際的播放順序
+        history.move(index, cursor);
+        reindexHistory(index);
+    }
+}
+
+void ShuffleOrder::insert(int row)
+{
+    if (row < 0 || row > count) {
+        return;
+    }
+    if (row < count) {
+        renumber(row, 1);
+    }
+    // 新曲目放在抽選池尾端，之後的抽選機率與其他尚未抽出的曲目相同
+    setSlot(poolEnd, row);
+    poolEnd++;
+    count++;
+}
+
+void ShuffleOrder::remove(int row)
+{
+    if (row < 0 || row >= count) {
+        return;
+    }
+
+    const int index = historyIndex.value(row, -1);
+    if (index >= 0) {
+        history.removeAt(index);
+        historyIndex.remove(row);
+        // 移除的是目前曲目時，游標停在前一首，下一首仍是原本的下一首
+        if (index <= cursor) {
+            cursor--;
+        }
+        reindexHistory(index);
+    } else {
+        takeFromPool(row);
+    }
+    count--;
+    renumber(row, -1);
+}
+
+void ShuffleOrder::move(int from, int to)
+{
+    if (from == to || from < 0 || from >= count || to < 0 || to >= count) {
+        return;
+    }
+
+    const int index = historyIndex.value(from, -1);
+    const int savedCursor = cursor;
+    remove(from);
+    insert(to);
+    if (index >= 0) {
+        // 已抽出的曲目放回歷史中原本的位置
+        takeFromPool(to);
+        history.insert(index, to);
+        reindexHistory(index);
+        cursor = savedCursor;
+    }
+}
+
+int ShuffleOrder::slot(int position) const
+{
+    return displacedRows.value(position, position);
+}
+
+void ShuffleOrder::setSlot(int position, int row)
+{
+    const auto it = displacedRows.find(position);
+    if (it != displacedRows.end()) {
+        if (displacedPositions.value(it.value(), -1) == position) {
+            displacedPositions.remove(it.value());
+        }
+        displacedRows.erase(it);
+    }
+    if (row == position) {
+        displacedPositions.remove(row);
+    } else {
+        displacedRows.insert(position, row);
+        displacedPositions.insert(row, position);
+    }
+}
+
+void ShuffleOrder::clearSlot(int position)
+{
+    const auto it = displacedRows.find(position);
+    if (it == displacedRows.end()) {
+        return;
+    }
+    if (displacedPositions.value(it.value(), -1) == position) {
+        displacedPositions.remove(it.value());
+    }
+    displacedRows.erase(it);
+}
+
+int ShuffleOrder::positionOf(int row) const
+{
+    const auto it = displacedPositions.constFind(row);
+    if (it != displacedPositions.constEnd()) {
+        return it.value();
+    }
+    // 沒有被交換過的曲目就在與列號相同的位置
+    if (row >= poolStart && row < poolEnd && !displacedRows.contains(row)) {
+        return row;
+    }
+    return -1;
+}
+
+int ShuffleOrder::draw()
+{
+    if (poolStart >= poolEnd) {
+        return -1;
+    }
+
+    // Fisher–Yates：從 [poolStart, poolEnd) 隨機選一個位置，與 poolStart 交換後取出
+    const int position = poolStart + QRandomGenerator::global()->bounded(poolEnd - poolStart);
+    const int row = slot(position);
+    setSlot(position, slot(poolStart));
+    clearSlot(poolStart);
+    poolStart++;
+
+    history.append(row);
+    historyIndex.insert(row, history.size() - 1);
+    return row;
+}
+
+void ShuffleOrder::takeFromPool(int row)
+{
+    const int position = positionOf(row);
+    if (position < 0) {
+        return;
+    }
+    const int last = poolEnd - 1;
+    setSlot(position, slot(last));
+    clearSlot(last);
+    poolEnd--;
+}
+
+void ShuffleOrder::renumber(int row, int delta)
+{
+    const auto shifted = [row, delta](int value) {
+        const bool affected = delta > 0 ? value >= row : value > row;
+        return affected ? value + delta : value;
+    };
+
+    // 歷史
+    for (int& value : history) {
+        value = shifted(value);
+    }
+    historyIndex.clear();
+    reindexHistory(0);
+
+    // 抽選池中沒有交換過的位置代表「列號等於位置」，位移後整段連續的位置
+    // 應該代表的列號集合只差頭尾一個，只需修正每段的一個位置（抽選池的順序不影響抽選機率）
+    const int low = qMax(poolStart, delta > 0 ? row : row + 1);
+    QVector<int> explicitPositions;
+    explicitPositions.reserve(displacedRows.size());
+    for (auto it = displacedRows.cbegin(); it != displacedRows.cend(); ++it) {
+        if (it.key() >= low && it.key() < poolEnd) {
+            explicitPositions.append(it.key());
+        }
+    }
+    std::sort(explicitPositions.begin(), explicitPositions.end());
+    explicitPositions.append(poolEnd);
+
+    QVector<QPair<int, int>> fixes;
+    int runStart = low;
+    for (int boundary : explicitPositions) {
+        if (runStart < boundary) {
+            const int runEnd = boundary - 1;
+            if (delta > 0) {
+                // {a..b} 應為 {a+1..b+1}：位置 a 改為 b+1
+                fixes.append({ runStart, runEnd + 1 });
+            } else {
+                // {a..b} 應為 {a-1..b-1}：位置 b 改為 a-1
+                fixes.append({ runEnd, runStart - 1 });
+            }
+        }
+        runStart = boundary + 1;
+    }
+
+    // 重新編號交換過的位置，再套用修正
+    const QHash<int, int> previousRows = displacedRows;
+    displacedRows.clear();
+    displacedPositions.clear();
+    for (auto it = previousRows.cbegin(); it != previousRows.cend(); ++it) {
+        const int value = shifted(it.value());
+        if (value != it.key()) {
+            displacedRows.insert(it.key(), value);
+            displacedPositions.insert(value, it.key());
+        }
+    }
+    for (const QPair<int, int>& fix : fixes) {
+        displacedRows.insert(fix.first, fix.second);
+        displacedPositions.insert(fix.second, fix.first);
+    }
+}
+
+void ShuffleOrder::reindexHistory(int from)
+{
+    for (int i = qMax(0, from); i < history.size(); i++) {
+        historyIndex.insert(history[i], i);
+    }
+}
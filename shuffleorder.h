@@ -0,0 +1,91 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef SHUFFLEORDER_H
+#define SHUFFLEORDER_H
+
+// 引入 Qt 動態陣列類別
+#include <QVector>
+// 引入 Qt 雜湊表類別
+#include <QHash>
+
+// 隨機播放的一輪順序
+//
+// 以延遲展開的 Fisher–Yates 洗牌產生：尚未抽出的曲目放在一個虛擬陣列（抽選池）中，
+// 位置 i 預設就是第 i 列，只有被交換過的位置才記錄在雜湊表裡，
+// 因此開始新的一輪不需要配置或打亂整份播放清單，每次抽選都是 O(1)。
+// 抽出的曲目依序記錄在歷史中，上一首/下一首只是移動歷史中的游標，
+// 預先抽出的曲目（接下來要播放的）也在歷史中，位於游標之後。
+//
+// 成本（h 為歷史長度，即本輪已抽出與預先抽出的曲目數；d 為抽選池中被交換過的位置數）：
+//   - 抽選、上一首/下一首與在尾端加入曲目為 O(1)
+//   - play() 跳到不相鄰的曲目時要在歷史中移動或插入，並重建之後的歷史索引，為 O(h)
+//   - 刪除、在中間插入或移動曲目時列號會位移，renumber() 要重新編號整份歷史與所有被交換過的位置，
+//     另外排序落在位移範圍內的交換位置，為 O(h + d log d)
+// d 在每次抽選或插入時最多加一，每次位移時最多增加抽選池中連續未交換區段的數目，且不超過曲目數。
+// 成本與播放清單大小無關，但一輪接近結束時 h 接近曲目數，每次編輯的成本也就接近整份播放清單。
+class ShuffleOrder
+{
+public:
+    // 建構函式，沒有任何曲目
+    ShuffleOrder();
+
+    // 以 trackCount 首曲目開始新的一輪，first 為已在播放的曲目（排在第一個，-1 表示沒有）
+    void reset(int trackCount, int first = -1);
+    // 曲目數
+    int trackCount() const;
+    // 目前的曲目，沒有時回傳 -1
+    int current() const;
+    // 目前曲目之後第 offset 首（offset 為負數時往回看歷史），需要時才抽選；沒有時回傳 -1
+    int peek(int offset);
+    // 本輪的曲目都已抽出，且目前位於最後一首
+    bool isExhausted() const;
+
+    // 移到下一首，回傳新的目前曲目；沒有下一首時回傳 -1 且不移動
+    int next();
+    // 回到上一首，回傳新的目前曲目；已是本輪第一首時回傳 -1 且不移動
+    int previous();
+    // 直接播放指定的曲目：相鄰的曲目視為上一首/下一首，其餘曲目移到目前曲目之後
+    void play(int row);
+
+    // 在 row 插入一首曲目（原本 row 之後的列號加一）
+    void insert(int row);
+    // 移除 row（之後的列號減一）
+    void remove(int row);
+    // 將曲目從 from 列移到 to 列，保留它在本輪中的狀態
+    void move(int from, int to);
+
+private:
+    // 抽選池中位置 position 的曲目
+    int slot(int position) const;
+    // 設定抽選池中位置 position 的曲目
+    void setSlot(int position, int row);
+    // 清除位置 position 的交換紀錄（位置離開抽選池時）
+    void clearSlot(int position);
+    // 尚未抽出的曲目在抽選池中的位置，已抽出時回傳 -1
+    int positionOf(int row) const;
+    // 從抽選池隨機抽出一首加到歷史尾端，抽選池已空時回傳 -1
+    int draw();
+    // 從抽選池移除尚未抽出的曲目（與最後一個位置交換）
+    void takeFromPool(int row);
+    // 列號位移後重新編號：delta 為 1 時 row 以後的列號加一，為 -1 時 row 之後的列號減一
+    void renumber(int row, int delta);
+    // 從歷史的第 from 項開始重建「曲目 → 歷史位置」索引
+    void reindexHistory(int from);
+
+    // 曲目數
+    int count;
+    // 本輪已抽出的曲目，依播放順序排列
+    QVector<int> history;
+    // 曲目 → 在歷史中的位置
+    QHash<int, int> historyIndex;
+    // 目前曲目在歷史中的位置（-1 表示還沒有）
+    int cursor;
+    // 抽選池的位置範圍 [poolStart, poolEnd)
+    int poolStart;
+    int poolEnd;
+    // 被交換過的位置 → 曲目，以及反向的曲目 → 位置
+    QHash<int, int> displacedRows;
+    QHash<int, int> displacedPositions;
+};
+
+// 結束標頭檔保護宏
+#endif // SHUFFLEORDER_H
@@ -0,0 +1,78 @@
+// 引入字幕繪製代理標頭檔
+#include "subtitledelegate.h"
+// 引入字幕段落資料模型（自訂資料角色）
+#include "subtitlemodel.h"
+
+// 引入 Qt 繪圖類別
+#include <QPainter>
+// 引入 Qt 字型度量類別
+#include <QFontMetrics>
+
+namespace {
+    // 項目左右內邊距
+    const int ITEM_PADDING = 10;
+    // 項目上下內邊距
+    const int ITEM_VERTICAL_PADDING = 4;
+    // 時間範圍與文字之間的間距
+    const int TIMESTAMP_SPACING = 12;
+}
+
+SubtitleDelegate::SubtitleDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void SubtitleDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    painter->save();
+
+    const bool isActive = index.data(SubtitleModel::IsActiveRole).toBool();
+    const bool isHovered = option.state & QStyle::State_MouseOver;
+    const QRect rect = option.rect;
+
+    // 背景：正在播放 > 滑鼠懸停
+    if (isActive) {
+        painter->fillRect(rect, QColor("#282828"));
+    } else if (isHovered) {
+        painter->fillRect(rect, QColor("#181818"));
+    }
+
+    const QRect textRect = rect.adjusted(ITEM_PADDING, 0, -ITEM_PADDING, 0);
+    QFont font = option.font;
+    font.setBold(isActive);
+    const QFontMetrics metrics(font);
+    painter->setFont(font);
+
+    // 時間範圍（可點擊跳轉）
+    const QString timestamp = timestampText(index.data(SubtitleModel::StartMsRole).toLongLong(),
+                                            index.data(SubtitleModel::EndMsRole).toLongLong());
+    const int timestampWidth = metrics.horizontalAdvance(timestamp);
+    painter->setPen(isActive || isHovered ? QColor("#1ED760") : QColor("#1DB954"));
+    painter->drawText(QRect(textRect.left(), textRect.top(), timestampWidth, textRect.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter, timestamp);
+
+    // 字幕文字
+    const int textLeft = textRect.left() + timestampWidth + TIMESTAMP_SPACING;
+    const QRect cueRect(textLeft, textRect.top(), qMax(0, textRect.right() - textLeft), textRect.height());
+    const QString text = metrics.elidedText(index.data(Qt::DisplayRole).toString(), Qt::ElideRight, cueRect.width());
+    painter->setPen(isActive || isHovered ? QColor("#FFFFFF") : QColor("#B3B3B3"));
+    painter->drawText(cueRect, Qt::AlignLeft | Qt::AlignVCenter, text);
+
+    painter->restore();
+}
+
+QSize SubtitleDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(index);
+    // 一行文字加上下內邊距，與內容無關，所以所有項目同高（以粗體計算，正在播放的列不會被截切）
+    QFont boldFont = option.font;
+    boldFont.setBold(true);
+    return QSize(option.rect.width(), QFontMetrics(boldFont).height() + ITEM_VERTICAL_PADDING * 2);
+}
+
+QString SubtitleDelegate::timestampText(qint64 startMs, qint64 endMs)
+{
+    return QString("[%1s - %2s]")
+        .arg(startMs / 1000.0, 0, 'f', 2)
+        .arg(endMs / 1000.0, 0, 'f', 2);
+}
@@ -0,0 +1,31 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef SUBTITLEDELEGATE_H
+#define SUBTITLEDELEGATE_H
+
+// 引入 Qt 項目繪製代理基底類別
+#include <QStyledItemDelegate>
+
+// 字幕段落的繪製代理
+//
+// 每個段落一行：左側為綠色的時間範圍，右側為字幕文字（過長時以省略號截斷，
+// 完整內容在提示文字中），正在播放的段落以深色背景與粗體標示。
+// 所有項目高度相同，搭配 QListView::setUniformItemSizes 捲動數千個段落時也只需要繪製可見的幾列。
+class SubtitleDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    // 建構函式
+    explicit SubtitleDelegate(QObject* parent = nullptr);
+
+    // 繪製單一項目
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    // 項目尺寸（固定高度）
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    // 段落時間範圍的顯示文字，例如「[12.50s - 15.00s]」
+    static QString timestampText(qint64 startMs, qint64 endMs);
+};
+
+// 結束標頭檔保護宏
+#endif // SUBTITLEDELEGATE_H
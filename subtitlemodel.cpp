@@ -0,0 +1,180 @@
+// 引入字幕段落資料模型標頭檔
+#include "subtitlemodel.h"
+
+// 引入 C++ 演算法函式庫
+#include <algorithm>
+// 引入 C++ 數值函式庫
+#include <numeric>
+
+SubtitleModel::SubtitleModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , currentActiveRow(-1)
+{
+}
+
+void SubtitleModel::setCues(SubtitleCueList cues)
+{
+    beginResetModel();
+    cueList = std::move(cues);
+    currentActiveRow = -1;
+    sortedRows.clear();
+    updateSortedRows(0);
+    endResetModel();
+}
+
+void SubtitleModel::appendCue(qint64 startMs, qint64 endMs, QStringView text)
+{
+    const int row = cueList.size();
+    beginInsertRows(QModelIndex(), row, row);
+    const int offset = static_cast<int>(cueList.text.size());
+    cueList.text.append(text);
+    cueList.cues.append(SubtitleCue{ startMs, endMs, offset, static_cast<int>(text.size()) });
+    updateSortedRows(row);
+    endInsertRows();
+}
+
+void SubtitleModel::appendCues(const SubtitleCueList& cues)
+{
+    if (cues.isEmpty()) {
+        return;
+    }
+
+    const int first = cueList.size();
+    beginInsertRows(QModelIndex(), first, first + cues.size() - 1);
+    // 新段落的文字接在緩衝區尾端，位置依此平移
+    const int base = static_cast<int>(cueList.text.size());
+    cueList.text.append(cues.text);
+    cueList.cues.reserve(first + cues.size());
+    for (const SubtitleCue& cue : cues.cues) {
+        cueList.cues.append(SubtitleCue{ cue.startMs, cue.endMs, base + cue.textOffset, cue.textLength });
+    }
+    updateSortedRows(first);
+    endInsertRows();
+}
+
+void SubtitleModel::clear()
+{
+    if (cueList.isEmpty() && cueList.text.isEmpty()) {
+        return;
+    }
+    beginResetModel();
+    cueList.clear();
+    sortedRows.clear();
+    currentActiveRow = -1;
+    endResetModel();
+}
+
+const SubtitleCueList& SubtitleModel::cues() const
+{
+    return cueList;
+}
+
+int SubtitleModel::rowAt(qint64 positionMs) const
+{
+    // 找出最後一個開始時間不晚於播放位置的段落
+    int low = 0;
+    int high = cueList.size();
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (cueList.cues[sortedRow(mid)].startMs <= positionMs) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        return -1;
+    }
+
+    const int row = sortedRow(low - 1);
+    return positionMs < cueList.cues[row].endMs ? row : -1;
+}
+
+void SubtitleModel::setActiveRow(int row)
+{
+    if (row == currentActiveRow) {
+        return;
+    }
+
+    const int previousRow = currentActiveRow;
+    currentActiveRow = row;
+
+    const QVector<int> roles{ IsActiveRole };
+    if (previousRow >= 0 && previousRow < rowCount()) {
+        emit dataChanged(index(previousRow), index(previousRow), roles);
+    }
+    if (row >= 0 && row < rowCount()) {
+        emit dataChanged(index(row), index(row), roles);
+    }
+}
+
+int SubtitleModel::activeRow() const
+{
+    return currentActiveRow;
+}
+
+int SubtitleModel::sortedRow(int i) const
+{
+    return sortedRows.isEmpty() ? i : sortedRows[i];
+}
+
+void SubtitleModel::updateSortedRows(int firstNewRow)
+{
+    const auto startsBefore = [this](int a, int b) {
+        return cueList.cues[a].startMs < cueList.cues[b].startMs;
+    };
+
+    // 已有排序索引時，把新段落插入對應位置
+    if (!sortedRows.isEmpty()) {
+        for (int row = firstNewRow; row < cueList.size(); row++) {
+            sortedRows.insert(std::upper_bound(sortedRows.begin(), sortedRows.end(), row, startsBefore), row);
+        }
+        return;
+    }
+
+    // 只需檢查新段落是否仍依開始時間排列
+    bool sorted = true;
+    for (int row = qMax(1, firstNewRow); row < cueList.size(); row++) {
+        if (cueList.cues[row].startMs < cueList.cues[row - 1].startMs) {
+            sorted = false;
+            break;
+        }
+    }
+    if (sorted) {
+        return;
+    }
+
+    sortedRows.resize(cueList.size());
+    std::iota(sortedRows.begin(), sortedRows.end(), 0);
+    std::stable_sort(sortedRows.begin(), sortedRows.end(), startsBefore);
+}
+
+int SubtitleModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return cueList.size();
+}
+
+QVariant SubtitleModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= cueList.size()) {
+        return QVariant();
+    }
+
+    const SubtitleCue& cue = cueList.cues[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return cueList.cueText(index.row()).toString();
+    case StartMsRole:
+        return cue.startMs;
+    case EndMsRole:
+        return cue.endMs;
+    case IsActiveRole:
+        return index.row() == currentActiveRow;
+    default:
+        return QVariant();
+    }
+}
@@ -0,0 +1,71 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef SUBTITLEMODEL_H
+#define SUBTITLEMODEL_H
+
+// 引入字幕段落結構
+#include "subtitleparser.h"
+
+// 引入 Qt 清單模型基底類別
+#include <QAbstractListModel>
+
+// 字幕段落的資料模型
+//
+// 每一列對應 SubtitleCueList 中的一個段落，文字在 data() 被查詢時才從共用緩衝區複製，
+// 搭配 QListView 只有可見的列會被查詢與繪製。
+// 轉錄過程中新的段落以 appendCue()/appendCues() 加在尾端，只發出新增列的信號，
+// 不會重新排版已經顯示的內容。
+// 播放位置以 rowAt() 二分搜尋對應的段落；段落不是依開始時間排列時才另外建立排序索引。
+// 切換正在播放的段落只對新舊兩列發出 dataChanged。
+class SubtitleModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    // 自訂資料角色
+    enum Roles {
+        StartMsRole = Qt::UserRole + 1,  // 開始時間（毫秒）
+        EndMsRole,                       // 結束時間（毫秒）
+        IsActiveRole                     // 是否為正在播放的段落
+    };
+
+    // 建構函式
+    explicit SubtitleModel(QObject* parent = nullptr);
+
+    // 以新的段落取代全部內容（重設模型）
+    void setCues(SubtitleCueList cues);
+    // 在尾端加入一個段落
+    void appendCue(qint64 startMs, qint64 endMs, QStringView text);
+    // 在尾端加入多個段落
+    void appendCues(const SubtitleCueList& cues);
+    // 清除所有段落
+    void clear();
+    // 目前的所有段落
+    const SubtitleCueList& cues() const;
+
+    // 播放位置所在的段落列號，位於段落之間或沒有段落時回傳 -1（O(log n)）
+    int rowAt(qint64 positionMs) const;
+    // 設定正在播放的段落（只更新新舊兩列）
+    void setActiveRow(int row);
+    // 正在播放的段落，沒有時為 -1
+    int activeRow() const;
+
+    // QAbstractListModel 介面
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+    // 依開始時間排序後第 i 個段落的列號
+    int sortedRow(int i) const;
+    // 檢查從 firstNewRow 開始的新段落順序，必要時建立或更新排序索引
+    void updateSortedRows(int firstNewRow);
+
+    // 所有段落與共用的文字緩衝區
+    SubtitleCueList cueList;
+    // 依開始時間排序的列號；段落本身已依時間排列時為空（一般情況）
+    QVector<int> sortedRows;
+    // 正在播放的列
+    int currentActiveRow;
+};
+
+// 結束標頭檔保護宏
+#endif // SUBTITLEMODEL_H
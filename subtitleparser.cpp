@@ -0,0 +1,378 @@
+// 引入字幕解析器標頭檔
+#include "subtitleparser.h"
+
+// 引入 Qt 檔案處理類別
+#include <QFile>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+// 引入 Qt 字串解碼類別
+#include <QStringDecoder>
+#endif
+
+namespace {
+    // 讀檔時每次解碼的位元組數
+    const qint64 READ_CHUNK_BYTES = 256 * 1024;
+
+    bool isDigit(QChar ch)
+    {
+        return ch.unicode() >= '0' && ch.unicode() <= '9';
+    }
+
+    // 整行都是數字（SRT 的序號行）
+    bool isAllDigits(QStringView text)
+    {
+        if (text.isEmpty()) {
+            return false;
+        }
+        for (QChar ch : text) {
+            if (!isDigit(ch)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 解析「開始 --> 結束 [WebVTT 段落設定]」格式的時間行
+    bool parseTiming(QStringView line, qint64& startMs, qint64& endMs)
+    {
+        const qsizetype arrow = line.indexOf(u"-->");
+        if (arrow < 0) {
+            return false;
+        }
+
+        QStringView end = line.mid(arrow + 3).trimmed();
+        for (qsizetype i = 0; i < end.size(); i++) {
+            if (end[i].isSpace()) {
+                end = end.left(i);
+                break;
+            }
+        }
+
+        startMs = SubtitleParser::parseTimestamp(line.left(arrow).trimmed());
+        endMs = SubtitleParser::parseTimestamp(end);
+        return startMs >= 0 && endMs >= 0;
+    }
+}
+
+SubtitleParser::SubtitleParser()
+    : state(BetweenCues)
+    , atFirstLine(true)
+    , isWebVtt(false)
+    , openCue{ 0, 0, 0, 0 }
+    , hasOpenCue(false)
+    , hasPendingNumberLine(false)
+{
+}
+
+void SubtitleParser::feed(QStringView chunk)
+{
+    qsizetype lineStart = 0;
+    for (qsizetype i = 0; i < chunk.size(); i++) {
+        if (chunk[i].unicode() != '\n') {
+            continue;
+        }
+        if (partialLine.isEmpty()) {
+            processLine(chunk.mid(lineStart, i - lineStart));
+        } else {
+            // 上一段的最後一行在這一段才結束
+            partialLine.append(chunk.mid(lineStart, i - lineStart));
+            processLine(partialLine);
+            partialLine.clear();
+        }
+        lineStart = i + 1;
+    }
+    partialLine.append(chunk.mid(lineStart));
+}
+
+void SubtitleParser::finish()
+{
+    if (!partialLine.isEmpty()) {
+        const QString line = partialLine;
+        partialLine.clear();
+        processLine(line);
+    }
+    if (state == InCueText) {
+        if (hasPendingNumberLine) {
+            appendText(pendingNumberLine);
+            hasPendingNumberLine = false;
+        }
+        endCue();
+    }
+    state = BetweenCues;
+}
+
+int SubtitleParser::cueCount() const
+{
+    return result.cues.size();
+}
+
+SubtitleCueList SubtitleParser::takeCues()
+{
+    SubtitleCueList cues = std::move(result);
+    *this = SubtitleParser();
+    return cues;
+}
+
+SubtitleCueList SubtitleParser::parse(QStringView content)
+{
+    SubtitleParser parser;
+    parser.feed(content);
+    parser.finish();
+    return parser.takeCues();
+}
+
+SubtitleCueList SubtitleParser::parseFile(const QString& filePath, bool* ok)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (ok) {
+            *ok = false;
+        }
+        return SubtitleCueList();
+    }
+
+    SubtitleParser parser;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    // 分段讀取並解碼，解碼器會保留跨段落的不完整 UTF-8 字元
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    while (!file.atEnd()) {
+        const QString chunk = decoder(file.read(READ_CHUNK_BYTES));
+        parser.feed(chunk);
+    }
+#else
+    parser.feed(QString::fromUtf8(file.readAll()));
+#endif
+    parser.finish();
+
+    if (ok) {
+        *ok = true;
+    }
+    return parser.takeCues();
+}
+
+qint64 SubtitleParser::parseTimestamp(QStringView text)
+{
+    // 以冒號分隔的欄位：最多「時:分:秒」，至少「分:秒」
+    qint64 fields[2] = { 0, 0 };
+    int fieldCount = 0;
+    qint64 value = 0;
+    int digits = 0;
+    qsizetype i = 0;
+    for (; i < text.size(); i++) {
+        const QChar ch = text[i];
+        if (isDigit(ch)) {
+            if (++digits > 9) {
+                return -1;
+            }
+            value = value * 10 + (ch.unicode() - '0');
+        } else if (ch.unicode() == ':') {
+            if (digits == 0 || fieldCount >= 2) {
+                return -1;
+            }
+            fields[fieldCount++] = value;
+            value = 0;
+            digits = 0;
+        } else if (ch.unicode() == ',' || ch.unicode() == '.') {
+            break;
+        } else {
+            return -1;
+        }
+    }
+    if (digits == 0 || fieldCount == 0) {
+        return -1;
+    }
+    const qint64 seconds = value;
+
+    // 小數部分取前三位，不足三位補零
+    qint64 milliseconds = 0;
+    if (i < text.size()) {
+        i++;
+        int fractionDigits = 0;
+        for (; i < text.size(); i++) {
+            if (!isDigit(text[i])) {
+                return -1;
+            }
+            if (fractionDigits < 3) {
+                milliseconds = milliseconds * 10 + (text[i].unicode() - '0');
+                fractionDigits++;
+            }
+        }
+        if (fractionDigits == 0) {
+            return -1;
+        }
+        for (; fractionDigits < 3; fractionDigits++) {
+            milliseconds *= 10;
+        }
+    }
+
+    const qint64 hours = fieldCount == 2 ? fields[0] : 0;
+    const qint64 minutes = fieldCount == 2 ? fields[1] : fields[0];
+    return ((hours * 60 + minutes) * 60 + seconds) * 1000 + milliseconds;
+}
+
+bool SubtitleParser::parseSegmentLine(QStringView line, qint64* startMs, qint64* endMs, QStringView* text)
+{
+    line = line.trimmed();
+    if (!line.startsWith(u'[')) {
+        return false;
+    }
+    const qsizetype close = line.indexOf(u']');
+    if (close < 0) {
+        return false;
+    }
+
+    // 方括號內為「開始s - 結束s」，秒數可帶小數
+    const QStringView range = line.mid(1, close - 1);
+    const qsizetype dash = range.indexOf(u" - ");
+    if (dash < 0) {
+        return false;
+    }
+    QStringView start = range.left(dash).trimmed();
+    QStringView end = range.mid(dash + 3).trimmed();
+    if (!start.endsWith(u's') || !end.endsWith(u's')) {
+        return false;
+    }
+    start.chop(1);
+    end.chop(1);
+
+    bool startOk = false;
+    bool endOk = false;
+    const double startSeconds = start.toDouble(&startOk);
+    const double endSeconds = end.toDouble(&endOk);
+    if (!startOk || !endOk || startSeconds < 0 || endSeconds < startSeconds) {
+        return false;
+    }
+
+    *startMs = qRound64(startSeconds * 1000);
+    *endMs = qRound64(endSeconds * 1000);
+    *text = line.mid(close + 1).trimmed();
+    return true;
+}
+
+void SubtitleParser::processLine(QStringView line)
+{
+    if (line.endsWith(u'\r')) {
+        line.chop(1);
+    }
+
+    if (atFirstLine) {
+        atFirstLine = false;
+        // 略過 UTF-8 BOM 解碼後留下的 U+FEFF
+        if (line.startsWith(QChar(0xFEFF))) {
+            line = line.mid(1);
+        }
+        if (line.startsWith(u"WEBVTT")) {
+            isWebVtt = true;
+            state = SkippingBlock;
+            return;
+        }
+    }
+
+    const QStringView trimmed = line.trimmed();
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+
+    switch (state) {
+    case SkippingBlock:
+        if (trimmed.isEmpty()) {
+            state = BetweenCues;
+        }
+        return;
+
+    case BetweenCues:
+        if (trimmed.isEmpty()) {
+            return;
+        }
+        if (parseTiming(trimmed, startMs, endMs)) {
+            break;
+        }
+        if (isWebVtt && (trimmed.startsWith(u"NOTE") || trimmed.startsWith(u"STYLE") ||
+                         trimmed.startsWith(u"REGION"))) {
+            state = SkippingBlock;
+        }
+        // 其餘為序號或段落識別碼
+        return;
+
+    case InCueText:
+        if (trimmed.isEmpty()) {
+            if (hasPendingNumberLine) {
+                appendText(pendingNumberLine);
+                hasPendingNumberLine = false;
+            }
+            endCue();
+            state = BetweenCues;
+            return;
+        }
+        if (parseTiming(trimmed, startMs, endMs)) {
+            // 沒有空行分隔的下一個段落；前一行的數字是它的序號
+            hasPendingNumberLine = false;
+            endCue();
+            break;
+        }
+        if (isAllDigits(trimmed)) {
+            if (hasPendingNumberLine) {
+                appendText(pendingNumberLine);
+            }
+            pendingNumberLine = trimmed.toString();
+            hasPendingNumberLine = true;
+            return;
+        }
+        if (hasPendingNumberLine) {
+            appendText(pendingNumberLine);
+            hasPendingNumberLine = false;
+        }
+        appendText(trimmed);
+        return;
+    }
+
+    // 時間行：開始新的段落
+    startCue(startMs, endMs);
+}
+
+void SubtitleParser::startCue(qint64 startMs, qint64 endMs)
+{
+    openCue = SubtitleCue{ startMs, endMs, static_cast<int>(result.text.size()), 0 };
+    hasOpenCue = true;
+    state = InCueText;
+}
+
+void SubtitleParser::appendText(QStringView line)
+{
+    if (!hasOpenCue) {
+        return;
+    }
+    if (result.text.size() > openCue.textOffset) {
+        result.text.append(QChar(' '));
+    }
+
+    if (!isWebVtt) {
+        result.text.append(line);
+        return;
+    }
+
+    // WebVTT 的 <i>、<c.x>、<00:00:01.000> 等標記只影響樣式，直接略過
+    qsizetype runStart = 0;
+    bool inTag = false;
+    for (qsizetype i = 0; i < line.size(); i++) {
+        const ushort ch = line[i].unicode();
+        if (!inTag && ch == '<') {
+            result.text.append(line.mid(runStart, i - runStart));
+            inTag = true;
+        } else if (inTag && ch == '>') {
+            inTag = false;
+            runStart = i + 1;
+        }
+    }
+    if (!inTag) {
+        result.text.append(line.mid(runStart));
+    }
+}
+
+void SubtitleParser::endCue()
+{
+    if (!hasOpenCue) {
+        return;
+    }
+    openCue.textLength = static_cast<int>(result.text.size()) - openCue.textOffset;
+    result.cues.append(openCue);
+    hasOpenCue = false;
+}
@@ -0,0 +1,115 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef SUBTITLEPARSER_H
+#define SUBTITLEPARSER_H
+
+// 引入 Qt 字串類別
+#include <QString>
+// 引入 Qt 字串檢視類別
+#include <QStringView>
+// 引入 Qt 動態陣列類別
+#include <QVector>
+
+// 單一字幕段落
+//
+// 文字不個別配置 QString，而是記錄在 SubtitleCueList::text 中的位置，
+// 每個段落固定 24 位元組，數萬個段落也只需要一次配置。
+struct SubtitleCue {
+    qint64 startMs;      // 開始時間（毫秒）
+    qint64 endMs;        // 結束時間（毫秒）
+    int textOffset;      // 文字在 SubtitleCueList::text 中的起始位置
+    int textLength;      // 文字長度（多行文字以空白連接）
+};
+
+// 解析後的字幕：依出現順序排列的段落與共用的文字緩衝區
+struct SubtitleCueList {
+    QVector<SubtitleCue> cues;   // 所有段落
+    QString text;                // 所有段落文字串接而成的緩衝區
+
+    // 段落數量
+    int size() const { return cues.size(); }
+    // 是否沒有任何段落
+    bool isEmpty() const { return cues.isEmpty(); }
+    // 取得指定段落的文字（指向 text，不複製）
+    QStringView cueText(int index) const
+    {
+        const SubtitleCue& cue = cues[index];
+        return QStringView(text).mid(cue.textOffset, cue.textLength);
+    }
+    // 清空所有段落
+    void clear()
+    {
+        cues.clear();
+        text.clear();
+    }
+};
+
+// SRT/WebVTT 字幕的串流解析器
+//
+// 以 feed() 逐段餵入文字，每個字元只掃描一次，不使用正規表達式；
+// 不完整的最後一行會保留到下一次 feed()，因此可以邊讀檔（或邊接收轉錄輸出）邊解析。
+//   - 時間戳同時接受 SRT（00:01:02,500）與 WebVTT（01:02.500、00:01:02.500）格式
+//   - 序號行與 WebVTT 的段落識別碼會被略過；沒有空行分隔的段落也能正確切開
+//   - 純數字的文字行只有在下一行是時間戳時才視為序號，不會誤刪數字字幕
+//   - WebVTT 的檔頭、NOTE/STYLE/REGION 區塊與 <i>、<c.x> 等標記都會被略過
+class SubtitleParser
+{
+public:
+    // 建構函式
+    SubtitleParser();
+
+    // 餵入一段文字（可以在任意位置切開）
+    void feed(QStringView chunk);
+    // 輸入結束，處理最後一行與最後一個段落
+    void finish();
+    // 目前已完成的段落數
+    int cueCount() const;
+    // 取出解析結果並重設解析器
+    SubtitleCueList takeCues();
+
+    // 解析完整的字幕文字
+    static SubtitleCueList parse(QStringView content);
+    // 讀取並解析 UTF-8 字幕檔案，無法開啟時 ok 設為 false
+    static SubtitleCueList parseFile(const QString& filePath, bool* ok = nullptr);
+    // 解析單一時間戳（時:分:秒,毫秒 或 分:秒.毫秒），格式錯誤時回傳 -1
+    static qint64 parseTimestamp(QStringView text);
+    // 解析轉錄程序輸出的分段行「[12.34s - 15.67s] 文字」，text 指向 line 中的文字部分
+    static bool parseSegmentLine(QStringView line, qint64* startMs, qint64* endMs, QStringView* text);
+
+private:
+    // 解析器狀態
+    enum State {
+        BetweenCues,   // 段落之間（可能是序號、識別碼或空行）
+        InCueText,     // 正在讀取段落文字
+        SkippingBlock  // 略過 WebVTT 的檔頭或 NOTE/STYLE/REGION 區塊，直到空行
+    };
+
+    // 處理一行完整的文字（不含換行字元）
+    void processLine(QStringView line);
+    // 開始新的段落
+    void startCue(qint64 startMs, qint64 endMs);
+    // 將一行文字加入目前的段落
+    void appendText(QStringView line);
+    // 結束目前的段落
+    void endCue();
+
+    // 解析結果
+    SubtitleCueList result;
+    // 上一次 feed() 未結束的行
+    QString partialLine;
+    // 目前狀態
+    State state;
+    // 是否為輸入的第一行（用於偵測 BOM 與 WEBVTT 檔頭）
+    bool atFirstLine;
+    // 是否為 WebVTT 格式
+    bool isWebVtt;
+    // 目前正在讀取文字的段落
+    SubtitleCue openCue;
+    // 目前段落是否已開始
+    bool hasOpenCue;
+    // 暫存的純數字行（可能是下一個段落的序號，也可能是字幕文字）
+    QString pendingNumberLine;
+    bool hasPendingNumberLine;
+};
+
+// 結束標頭檔保護宏
+#endif // SUBTITLEPARSER_H
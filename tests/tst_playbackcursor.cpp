@@ -0,0 +1,260 @@
+// 播放位置的單元測試
+//
+// 待播佇列優先於播放順序；曲目增減、移動後正在播放的列號跟著調整，查詢不會改動佇列。
+
+// 引入播放位置
+#include "../playbackcursor.h"
+// 引入播放清單持久化引擎
+#include "../playliststore.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+// 引入 Qt 暫存目錄類別
+#include <QTemporaryDir>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+
+namespace {
+    VideoInfo makeTrack(const QString& filePath)
+    {
+        VideoInfo video;
+        video.filePath = filePath;
+        video.title = QFileInfo(filePath).fileName();
+        video.isFavorite = false;
+        video.isLocalFile = true;
+        return video;
+    }
+
+    Playlist makePlaylist(const QString& name, int tracks)
+    {
+        Playlist playlist;
+        playlist.name = name;
+        for (int i = 0; i < tracks; i++) {
+            playlist.append(makeTrack(QString("/music/%1/%2.mp3").arg(name).arg(i)));
+        }
+        return playlist;
+    }
+
+    // 接下來 count 首的列號
+    QList<int> upcomingRows(PlaybackCursor& cursor, int count)
+    {
+        QList<int> rows;
+        for (const TrackLocation& track : cursor.upcoming(count)) {
+            rows.append(track.row);
+        }
+        return rows;
+    }
+}
+
+class TestPlaybackCursor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void sequentialOrder();
+    void repeatWrapsAround();
+    void queueComesFirst();
+    void upcomingDoesNotChangeQueue();
+    void pruneDropsRemovedTracks();
+    void trackEditsFollowCurrentRow();
+    void playlistRemoved();
+    void checkpointRoundTrip();
+
+private:
+    QTemporaryDir* directory;
+    PlaylistStore* store;
+    QList<Playlist> playlists;
+};
+
+void TestPlaybackCursor::init()
+{
+    directory = new QTemporaryDir();
+    QVERIFY(directory->isValid());
+    store = new PlaylistStore(directory->path());
+    playlists = { makePlaylist("A", 5), makePlaylist("B", 3) };
+}
+
+void TestPlaybackCursor::cleanup()
+{
+    delete store;
+    delete directory;
+    playlists.clear();
+}
+
+void TestPlaybackCursor::sequentialOrder()
+{
+    PlaybackCursor cursor(&playlists, store);
+    QVERIFY(!cursor.currentVideo());
+    QCOMPARE(cursor.next().row, -1);
+
+    cursor.play(0, 1);
+    QCOMPARE(cursor.playlistIndex(), 0);
+    QCOMPARE(cursor.row(), 1);
+    QCOMPARE(cursor.currentVideo()->filePath, QString("/music/A/1.mp3"));
+    QCOMPARE(upcomingRows(cursor, 10), QList<int>({ 2, 3, 4 }));
+
+    // next() 只是查詢，play() 之後才前進
+    QCOMPARE(cursor.next().row, 2);
+    QCOMPARE(cursor.row(), 1);
+    cursor.play(0, 2);
+    QCOMPARE(cursor.previous(), 1);
+
+    cursor.play(0, 4);
+    QCOMPARE(cursor.next().row, -1);
+}
+
+void TestPlaybackCursor::repeatWrapsAround()
+{
+    PlaybackCursor cursor(&playlists, store);
+    cursor.setRepeat(true);
+    cursor.play(1, 2);
+    // 繞回目前曲目即停止
+    QCOMPARE(upcomingRows(cursor, 4), QList<int>({ 0, 1 }));
+    cursor.play(1, 1);
+    QCOMPARE(upcomingRows(cursor, 4), QList<int>({ 2, 0 }));
+}
+
+void TestPlaybackCursor::queueComesFirst()
+{
+    PlaybackCursor cursor(&playlists, store);
+    cursor.play(0, 0);
+    cursor.enqueue(1, 2, false);
+    cursor.enqueue(1, 0, true);
+
+    const QList<TrackLocation> tracks = cursor.upcoming(4);
+    QCOMPARE(tracks.size(), 4);
+    QCOMPARE(tracks[0].playlistIndex, 1);
+    QCOMPARE(tracks[0].row, 0);
+    QVERIFY(tracks[0].queueHandle != 0);
+    QCOMPARE(tracks[1].playlistIndex, 1);
+    QCOMPARE(tracks[1].row, 2);
+    QCOMPARE(tracks[2].playlistIndex, 0);
+    QCOMPARE(tracks[2].row, 1);
+    QCOMPARE(tracks[2].queueHandle, quint64(0));
+
+    // 播放佇列項目時由呼叫端移除
+    cursor.dequeue(tracks[0].queueHandle);
+    QCOMPARE(cursor.next().row, 2);
+    QCOMPARE(cursor.next().playlistIndex, 1);
+    cursor.clearQueue();
+    QVERIFY(cursor.queue().isEmpty());
+    QCOMPARE(cursor.next().playlistIndex, 0);
+}
+
+void TestPlaybackCursor::upcomingDoesNotChangeQueue()
+{
+    PlaybackCursor cursor(&playlists, store);
+    cursor.play(0, 0);
+    cursor.enqueue(1, 1, false);
+    cursor.enqueue(0, 3, false);
+
+    // 已刪除的曲目只在查詢時略過，不會被移出佇列
+    playlists[1].removeAt(1);
+    QCOMPARE(cursor.next().playlistIndex, 0);
+    QCOMPARE(cursor.next().row, 3);
+    QCOMPARE(cursor.queue().size(), 2);
+    cursor.upcoming(10);
+    QCOMPARE(cursor.queue().size(), 2);
+}
+
+void TestPlaybackCursor::pruneDropsRemovedTracks()
+{
+    PlaybackCursor cursor(&playlists, store);
+    cursor.play(0, 0);
+    cursor.enqueue(1, 1, false);
+    cursor.enqueue(0, 3, false);
+    playlists[1].removeAt(1);
+
+    cursor.play(0, 1);
+    QCOMPARE(cursor.queue().size(), 1);
+    QCOMPARE(cursor.queue().first().trackKey, trackKey(playlists[0].videos[3]));
+}
+
+void TestPlaybackCursor::trackEditsFollowCurrentRow()
+{
+    PlaybackCursor cursor(&playlists, store);
+    cursor.play(0, 2);
+
+    // 在目前曲目之前插入：列號加一，下一首仍是原本的下一首
+    playlists[0].append(makeTrack("/music/A/new.mp3"));
+    playlists[0].move(5, 0);
+    cursor.trackInserted(0, 0);
+    QCOMPARE(cursor.row(), 3);
+    QCOMPARE(cursor.currentVideo()->filePath, QString("/music/A/2.mp3"));
+    QCOMPARE(cursor.next().row, 4);
+
+    // 移除目前曲目之前的曲目
+    playlists[0].removeAt(1);
+    cursor.trackRemoved(0, 1);
+    QCOMPARE(cursor.row(), 2);
+    QCOMPARE(cursor.currentVideo()->filePath, QString("/music/A/2.mp3"));
+
+    // 移動目前曲目
+    playlists[0].move(2, 4);
+    cursor.trackMoved(0, 2, 4);
+    QCOMPARE(cursor.row(), 4);
+    QCOMPARE(cursor.currentVideo()->filePath, QString("/music/A/2.mp3"));
+
+    // 其他播放清單的變更不影響目前曲目
+    playlists[1].removeAt(0);
+    cursor.trackRemoved(1, 0);
+    QCOMPARE(cursor.row(), 4);
+}
+
+void TestPlaybackCursor::playlistRemoved()
+{
+    PlaybackCursor cursor(&playlists, store);
+    cursor.play(1, 1);
+    cursor.enqueue(1, 2, false);
+
+    // 刪除之前的播放清單：索引跟著位移，佇列項目仍有效
+    playlists.removeAt(0);
+    QVERIFY(!cursor.playlistRemoved(0));
+    QCOMPARE(cursor.playlistIndex(), 0);
+    QCOMPARE(cursor.findPlaylist("B"), 0);
+    QCOMPARE(cursor.currentVideo()->filePath, QString("/music/B/1.mp3"));
+    QCOMPARE(cursor.queue().size(), 1);
+
+    // 刪除正在播放的播放清單：停止播放，佇列項目失效
+    playlists.removeAt(0);
+    QVERIFY(cursor.playlistRemoved(0));
+    QCOMPARE(cursor.playlistIndex(), -1);
+    QVERIFY(!cursor.currentVideo());
+    QVERIFY(cursor.queue().isEmpty());
+}
+
+void TestPlaybackCursor::checkpointRoundTrip()
+{
+    // 只恢復仍存在的本地檔案
+    const QString filePath = directory->filePath("song.mp3");
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("audio");
+    file.close();
+    playlists[1].append(makeTrack(filePath));
+
+    PlaybackCursor cursor(&playlists, store);
+    QVERIFY(cursor.checkpoint(0).trackKey.isEmpty());
+    cursor.play(1, 3);
+    const PlaybackState state = cursor.checkpoint(42000);
+    QCOMPARE(state.playlistName, QString("B"));
+    QCOMPARE(state.positionMs, qint64(42000));
+
+    PlaybackCursor restored(&playlists, store);
+    const TrackLocation track = restored.locate(state);
+    QCOMPARE(track.playlistIndex, 1);
+    QCOMPARE(track.row, 3);
+
+    QVERIFY(QFile::remove(filePath));
+    QCOMPARE(restored.locate(state).row, -1);
+}
+
+QTEST_GUILESS_MAIN(TestPlaybackCursor)
+
+// 引入 moc 產生的程式碼
+#include "tst_playbackcursor.moc"
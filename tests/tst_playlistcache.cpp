@@ -0,0 +1,199 @@
+// 播放清單二進位快取的單元測試
+//
+// 寫入後重新開啟必須得到相同的播放清單；來源快照不符或檔案損毀時拒絕開啟。
+
+// 引入播放清單二進位快取
+#include "../playlistcache.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+// 引入 Qt 暫存目錄類別
+#include <QTemporaryDir>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+
+namespace {
+    const qint64 SOURCE_SIZE = 1234;
+    const qint64 SOURCE_MODIFIED = 1700000000000;
+
+    VideoInfo makeTrack(const QString& title, bool local)
+    {
+        VideoInfo video;
+        if (local) {
+            video.filePath = "/music/" + title + ".flac";
+        } else {
+            video.videoId = "id-" + title;
+            video.thumbnailUrl = "https://example.com/" + title + ".jpg";
+        }
+        video.title = title;
+        video.channelTitle = "artist";
+        video.description = "描述 " + title;
+        video.isFavorite = !local;
+        video.isLocalFile = local;
+        return video;
+    }
+
+    // 兩首曲目的所有欄位是否相同
+    bool sameVideo(const VideoInfo& a, const VideoInfo& b)
+    {
+        return a.videoId == b.videoId && a.filePath == b.filePath && a.title == b.title &&
+               a.channelTitle == b.channelTitle && a.thumbnailUrl == b.thumbnailUrl &&
+               a.description == b.description && a.subtitlePath == b.subtitlePath &&
+               a.isFavorite == b.isFavorite && a.isLocalFile == b.isLocalFile &&
+               a.hasLoudness == b.hasLoudness && a.loudness == b.loudness && a.peak == b.peak;
+    }
+
+    bool sameVideos(const QList<VideoInfo>& a, const QList<VideoInfo>& b)
+    {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (int i = 0; i < a.size(); i++) {
+            if (!sameVideo(a.at(i), b.at(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+class TestPlaylistCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void roundTrip();
+    void copyFromSource();
+    void rejectStaleSource();
+    void rejectCorruptFile();
+
+private:
+    QTemporaryDir* directory;
+    QList<Playlist> playlists;
+};
+
+void TestPlaylistCache::init()
+{
+    directory = new QTemporaryDir();
+    QVERIFY(directory->isValid());
+
+    Playlist local;
+    local.name = "本地";
+    VideoInfo analyzed = makeTrack("song", true);
+    analyzed.hasLoudness = true;
+    analyzed.loudness = -9.25f;
+    analyzed.peak = 0.875f;
+    analyzed.subtitlePath = "/music/song.srt";
+    local.append(analyzed);
+    local.append(makeTrack("other", true));
+
+    Playlist online;
+    online.name = "YouTube";
+    online.append(makeTrack("clip", false));
+
+    playlists = { local, Playlist(), online };
+    playlists[1].name = "empty";
+}
+
+void TestPlaylistCache::cleanup()
+{
+    delete directory;
+    playlists.clear();
+}
+
+void TestPlaylistCache::roundTrip()
+{
+    const QString path = directory->filePath("playlists.cache");
+    QVERIFY(PlaylistCache::write(path, playlists, "YouTube", 42, SOURCE_SIZE, SOURCE_MODIFIED));
+
+    const QSharedPointer<PlaylistCache> cache = PlaylistCache::open(path, SOURCE_SIZE, SOURCE_MODIFIED);
+    QVERIFY(cache);
+    QCOMPARE(cache->fileName(), path);
+    QCOMPARE(cache->sourceSequence(), qint64(42));
+    QCOMPARE(cache->lastPlaylistName(), QString("YouTube"));
+    QCOMPARE(cache->playlistCount(), 3);
+    for (int i = 0; i < playlists.size(); i++) {
+        QCOMPARE(cache->playlistName(i), playlists[i].name);
+        QCOMPARE(cache->trackCount(i), int(playlists[i].videos.size()));
+        QVERIFY(sameVideos(cache->videos(i), playlists[i].videos));
+    }
+}
+
+void TestPlaylistCache::copyFromSource()
+{
+    const QString sourcePath = directory->filePath("source.cache");
+    QVERIFY(PlaylistCache::write(sourcePath, playlists, "本地", 1, SOURCE_SIZE, SOURCE_MODIFIED));
+    const QSharedPointer<PlaylistCache> source = PlaylistCache::open(sourcePath, SOURCE_SIZE, SOURCE_MODIFIED);
+    QVERIFY(source);
+
+    // 尚未展開的播放清單只帶快取索引，曲目從來源快取複製
+    QList<Playlist> unexpanded;
+    for (int i = 0; i < source->playlistCount(); i++) {
+        Playlist playlist;
+        playlist.name = source->playlistName(i);
+        playlist.cacheIndex = i;
+        unexpanded.append(playlist);
+    }
+    unexpanded[1].cacheIndex = -1;
+    unexpanded[1].append(makeTrack("added", true));
+
+    const QString path = directory->filePath("copy.cache");
+    QVERIFY(PlaylistCache::write(path, unexpanded, "本地", 2, SOURCE_SIZE + 1, SOURCE_MODIFIED, source.data()));
+    const QSharedPointer<PlaylistCache> cache = PlaylistCache::open(path, SOURCE_SIZE + 1, SOURCE_MODIFIED);
+    QVERIFY(cache);
+    QVERIFY(sameVideos(cache->videos(0), playlists[0].videos));
+    QVERIFY(sameVideos(cache->videos(1), unexpanded[1].videos));
+    QVERIFY(sameVideos(cache->videos(2), playlists[2].videos));
+}
+
+void TestPlaylistCache::rejectStaleSource()
+{
+    const QString path = directory->filePath("playlists.cache");
+    QVERIFY(PlaylistCache::write(path, playlists, QString(), 1, SOURCE_SIZE, SOURCE_MODIFIED));
+
+    QVERIFY(!PlaylistCache::open(path, SOURCE_SIZE + 1, SOURCE_MODIFIED));
+    QVERIFY(!PlaylistCache::open(path, SOURCE_SIZE, SOURCE_MODIFIED + 1));
+    QVERIFY(!PlaylistCache::open(directory->filePath("missing.cache"), SOURCE_SIZE, SOURCE_MODIFIED));
+}
+
+void TestPlaylistCache::rejectCorruptFile()
+{
+    const QString path = directory->filePath("playlists.cache");
+    QVERIFY(PlaylistCache::write(path, playlists, QString(), 1, SOURCE_SIZE, SOURCE_MODIFIED));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    file.close();
+
+    const auto writeData = [&path](const QByteArray& bytes) {
+        QFile corrupt(path);
+        if (corrupt.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            corrupt.write(bytes);
+            corrupt.close();
+        }
+    };
+
+    // 截斷的檔案：區段超出檔案範圍
+    for (int size : { 0, 16, int(data.size() / 2), int(data.size() - 1) }) {
+        writeData(data.left(size));
+        QVERIFY2(!PlaylistCache::open(path, SOURCE_SIZE, SOURCE_MODIFIED), qPrintable(QString::number(size)));
+    }
+
+    // 魔術字錯誤
+    QByteArray badMagic = data;
+    badMagic[0] = 'X';
+    writeData(badMagic);
+    QVERIFY(!PlaylistCache::open(path, SOURCE_SIZE, SOURCE_MODIFIED));
+
+    // 原樣寫回仍可開啟
+    writeData(data);
+    QVERIFY(PlaylistCache::open(path, SOURCE_SIZE, SOURCE_MODIFIED));
+}
+
+QTEST_APPLESS_MAIN(TestPlaylistCache)
+
+// 引入 moc 產生的程式碼
+#include "tst_playlistcache.moc"
@@ -0,0 +1,247 @@
+// 播放清單編輯的單元測試
+//
+// 每項編輯都要同步到模型、播放位置、持久化日誌與搜尋索引：重新開啟日誌得到相同的播放清單，
+// 重複的曲目不會加入，刪除後已不在任何播放清單中的曲目從搜尋索引移除。
+
+// 引入播放清單的編輯
+#include "../playlistlibrary.h"
+// 引入播放清單資料模型
+#include "../playlistmodel.h"
+// 引入播放位置
+#include "../playbackcursor.h"
+// 引入搜尋索引的維護
+#include "../searchindexer.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+// 引入 Qt 暫存目錄類別
+#include <QTemporaryDir>
+
+namespace {
+    VideoInfo makeTrack(const QString& name)
+    {
+        VideoInfo video;
+        video.filePath = "/music/" + name + ".mp3";
+        video.title = name;
+        video.channelTitle = "artist";
+        video.isFavorite = false;
+        video.isLocalFile = true;
+        return video;
+    }
+
+    QStringList titles(const QList<VideoInfo>& videos)
+    {
+        QStringList result;
+        for (const VideoInfo& video : videos) {
+            result.append(video.title);
+        }
+        return result;
+    }
+}
+
+class TestPlaylistLibrary : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void loadCreatesDefaults();
+    void addTrackSkipsDuplicates();
+    void addTracksSkipsBatchDuplicates();
+    void removeTrackUpdatesSearch();
+    void removePlayingPlaylist();
+    void saveToEveryPlaylist();
+
+private:
+    // 關閉並在 directory 重新開啟所有物件，回傳載入後顯示的播放清單索引
+    int reopen();
+    // 在 directory 開啟所有物件
+    void open();
+    // 關閉所有物件
+    void close();
+    // 搜尋 query 命中的曲目鍵值
+    QStringList searchKeys(const QString& query) const;
+
+    QTemporaryDir* directory;
+    QList<Playlist> playlists;
+    PlaylistStore* store;
+    PlaylistModel* model;
+    PlaybackCursor* cursor;
+    SearchIndexer* indexer;
+    PlaylistLibrary* library;
+};
+
+void TestPlaylistLibrary::init()
+{
+    directory = new QTemporaryDir();
+    QVERIFY(directory->isValid());
+    open();
+    model->setPlaylistIndex(library->load());
+}
+
+void TestPlaylistLibrary::cleanup()
+{
+    close();
+    delete directory;
+}
+
+void TestPlaylistLibrary::open()
+{
+    playlists.clear();
+    store = new PlaylistStore(directory->path());
+    model = new PlaylistModel(&playlists);
+    cursor = new PlaybackCursor(&playlists, store);
+    indexer = new SearchIndexer(&playlists, store);
+    library = new PlaylistLibrary(&playlists, model, cursor, store, indexer);
+}
+
+void TestPlaylistLibrary::close()
+{
+    indexer->flush();
+    store->flush();
+    delete library;
+    delete indexer;
+    delete cursor;
+    delete model;
+    delete store;
+}
+
+int TestPlaylistLibrary::reopen()
+{
+    close();
+    open();
+    const int index = library->load();
+    model->setPlaylistIndex(index);
+    return index;
+}
+
+QStringList TestPlaylistLibrary::searchKeys(const QString& query) const
+{
+    QStringList keys;
+    for (const SearchHit& hit : indexer->search(query, 10)) {
+        keys.append(hit.trackKey);
+    }
+    return keys;
+}
+
+void TestPlaylistLibrary::loadCreatesDefaults()
+{
+    QCOMPARE(playlists.size(), 2);
+    QCOMPARE(library->snapshot().lastPlaylistName, playlists[0].name);
+
+    // 預設的播放清單已記錄，重新開啟時不再建立
+    QVERIFY(library->addPlaylist("C"));
+    QVERIFY(!library->addPlaylist("C"));
+    library->select(2);
+    QCOMPARE(reopen(), 2);
+    QCOMPARE(playlists.size(), 3);
+    QCOMPARE(library->indexOf("C"), 2);
+    QCOMPARE(library->indexOf("missing"), -1);
+}
+
+void TestPlaylistLibrary::addTrackSkipsDuplicates()
+{
+    bool added = false;
+    QCOMPARE(library->addTrack(0, makeTrack("alpha"), &added), 0);
+    QVERIFY(added);
+    QCOMPARE(library->addTrack(0, makeTrack("beta"), &added), 1);
+    QCOMPARE(library->addTrack(0, makeTrack("alpha"), &added), 0);
+    QVERIFY(!added);
+    // 顯示中的播放清單透過模型插入
+    QCOMPARE(model->rowCount(), 2);
+
+    // 其餘播放清單直接加入，模型不受影響
+    QCOMPARE(library->addTrack(1, makeTrack("alpha"), &added), 0);
+    QVERIFY(added);
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(searchKeys("beta"), QStringList({ trackKey(makeTrack("beta")) }));
+
+    reopen();
+    QCOMPARE(titles(playlists[0].videos), QStringList({ "alpha", "beta" }));
+    library->select(1);
+    QCOMPARE(titles(playlists[1].videos), QStringList({ "alpha" }));
+}
+
+void TestPlaylistLibrary::addTracksSkipsBatchDuplicates()
+{
+    library->addTrack(1, makeTrack("a"));
+    const QList<VideoInfo> batch = { makeTrack("a"), makeTrack("b"), makeTrack("c"), makeTrack("b") };
+    QCOMPARE(library->addTracks(1, batch), 2);
+    QCOMPARE(library->addTracks(1, batch), 0);
+    QCOMPARE(titles(playlists[1].videos), QStringList({ "a", "b", "c" }));
+
+    // 正在播放的播放清單新增曲目時播放順序跟著調整
+    cursor->setPlaylist(1);
+    cursor->play(1, 2);
+    QCOMPARE(library->addTracks(1, { makeTrack("d") }), 1);
+    QCOMPARE(cursor->row(), 2);
+    QCOMPARE(cursor->upcoming(1).size(), 1);
+}
+
+void TestPlaylistLibrary::removeTrackUpdatesSearch()
+{
+    library->addTrack(0, makeTrack("shared"));
+    library->addTrack(0, makeTrack("only"));
+    library->addTrack(1, makeTrack("shared"));
+
+    library->removeTrack(0, 1);
+    library->removeTrack(0, 0);
+    QCOMPARE(model->rowCount(), 0);
+    // 仍在其他播放清單中的曲目保留在搜尋索引
+    QVERIFY(searchKeys("only").isEmpty());
+    QCOMPARE(searchKeys("shared"), QStringList({ trackKey(makeTrack("shared")) }));
+
+    library->removeTrack(1, 0);
+    QVERIFY(searchKeys("shared").isEmpty());
+
+    reopen();
+    QVERIFY(playlists[0].videos.isEmpty());
+}
+
+void TestPlaylistLibrary::removePlayingPlaylist()
+{
+    library->addTrack(1, makeTrack("alpha"));
+    QVERIFY(!library->removePlaylist(0));
+    QCOMPARE(model->playlistIndex(), -1);
+    QCOMPARE(playlists.size(), 1);
+
+    cursor->setPlaylist(0);
+    cursor->play(0, 0);
+    QVERIFY(library->addPlaylist("B"));
+    QVERIFY(library->removePlaylist(0));
+    QVERIFY(searchKeys("alpha").isEmpty());
+
+    reopen();
+    QCOMPARE(playlists.size(), 1);
+    QCOMPARE(playlists[0].name, QString("B"));
+}
+
+void TestPlaylistLibrary::saveToEveryPlaylist()
+{
+    const VideoInfo track = makeTrack("a");
+    library->addTrack(0, track);
+    library->addTrack(1, track);
+    library->addTrack(1, makeTrack("b"));
+    QCOMPARE(library->unanalyzedFiles(1), QStringList({ track.filePath, makeTrack("b").filePath }));
+
+    library->saveLoudness(track.filePath, -12.5, 0.5f);
+    library->saveTranscript(track.filePath, directory->filePath("a.srt"));
+    QCOMPARE(library->unanalyzedFiles(1), QStringList({ makeTrack("b").filePath }));
+
+    reopen();
+    for (int i = 0; i < playlists.size(); i++) {
+        library->select(i);
+        const VideoInfo& video = playlists[i].videos[0];
+        QVERIFY(video.hasLoudness);
+        QCOMPARE(video.loudness, -12.5f);
+        QCOMPARE(video.peak, 0.5f);
+        QCOMPARE(video.subtitlePath, directory->filePath("a.srt"));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestPlaylistLibrary)
+
+// 引入 moc 產生的程式碼
+#include "tst_playlistlibrary.moc"
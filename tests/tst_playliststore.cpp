@@ -0,0 +1,288 @@
+// 播放清單持久化引擎的單元測試
+//
+// 重新開啟後重播日誌必須得到相同的播放清單與待播佇列；寫到一半的尾端紀錄被捨棄；
+// 壓縮之後從二進位快取載入，壓縮之後的紀錄仍照常重播。
+
+// 引入播放清單持久化引擎
+#include "../playliststore.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+// 引入 Qt 暫存目錄類別
+#include <QTemporaryDir>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+
+namespace {
+    VideoInfo makeTrack(const QString& name)
+    {
+        VideoInfo video;
+        video.filePath = "/music/" + name + ".mp3";
+        video.title = name;
+        video.channelTitle = "artist";
+        video.isFavorite = false;
+        video.isLocalFile = true;
+        return video;
+    }
+
+    // 依序列出播放清單中的曲目標題
+    QStringList titles(const QList<VideoInfo>& videos)
+    {
+        QStringList result;
+        for (const VideoInfo& video : videos) {
+            result.append(video.title);
+        }
+        return result;
+    }
+
+    QStringList names(const QList<Playlist>& playlists)
+    {
+        QStringList result;
+        for (const Playlist& playlist : playlists) {
+            result.append(playlist.name);
+        }
+        return result;
+    }
+
+    QStringList queueKeys(const PlayQueue& queue)
+    {
+        QStringList result;
+        for (const QueueEntry& entry : queue.entries()) {
+            result.append(entry.trackKey);
+        }
+        return result;
+    }
+}
+
+class TestPlaylistStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void emptyDirectory();
+    void replayLog();
+    void discardTruncatedRecord();
+    void compactToCache();
+    void compactFromCache();
+    void playbackStateRoundTrip();
+
+private:
+    // 在 directory 開啟新的引擎並載入
+    PlaylistSnapshot reload();
+
+    QTemporaryDir* directory;
+    PlaylistStore* store;
+};
+
+void TestPlaylistStore::init()
+{
+    directory = new QTemporaryDir();
+    QVERIFY(directory->isValid());
+    store = new PlaylistStore(directory->path());
+}
+
+void TestPlaylistStore::cleanup()
+{
+    delete store;
+    delete directory;
+}
+
+PlaylistSnapshot TestPlaylistStore::reload()
+{
+    store->flush();
+    delete store;
+    store = new PlaylistStore(directory->path());
+    PlaylistSnapshot snapshot;
+    store->load(snapshot);
+    return snapshot;
+}
+
+void TestPlaylistStore::emptyDirectory()
+{
+    PlaylistSnapshot snapshot;
+    QVERIFY(!store->load(snapshot));
+    QVERIFY(snapshot.playlists.isEmpty());
+    QVERIFY(snapshot.queue.isEmpty());
+}
+
+void TestPlaylistStore::replayLog()
+{
+    PlaylistSnapshot empty;
+    store->load(empty);
+
+    store->recordPlaylistAdded("A");
+    store->recordVideoAdded(0, makeTrack("a0"));
+    store->recordVideoAdded(0, makeTrack("a1"));
+    store->recordVideoAdded(0, makeTrack("a2"));
+    store->recordVideoMoved(0, 2, 0);
+    store->recordVideoRemoved(0, 1);
+    store->recordPlaylistAdded("B");
+    store->recordVideoAdded(1, makeTrack("b0"));
+    VideoInfo updated = makeTrack("b0");
+    updated.isFavorite = true;
+    updated.hasLoudness = true;
+    updated.loudness = -14.5f;
+    store->recordVideoUpdated(1, 0, updated);
+    store->recordPlaylistAdded("C");
+    store->recordPlaylistRemoved(2);
+    store->recordLastPlaylist("B");
+    store->recordQueued(QueueEntry{ 1, "A", trackKey(makeTrack("a1")) }, false);
+    store->recordQueued(QueueEntry{ 2, "B", trackKey(makeTrack("b0")) }, true);
+    store->recordQueued(QueueEntry{ 3, "A", trackKey(makeTrack("a2")) }, false);
+    store->recordUnqueued(1);
+
+    PlaylistSnapshot snapshot = reload();
+    QCOMPARE(names(snapshot.playlists), QStringList({ "A", "B" }));
+    QCOMPARE(titles(store->videos(snapshot.playlists[0])), QStringList({ "a2", "a1" }));
+    const QList<VideoInfo> b = store->videos(snapshot.playlists[1]);
+    QCOMPARE(titles(b), QStringList({ "b0" }));
+    QVERIFY(b[0].isFavorite);
+    QVERIFY(b[0].hasLoudness);
+    QCOMPARE(b[0].loudness, -14.5f);
+    QCOMPARE(snapshot.lastPlaylistName, QString("B"));
+    QCOMPARE(queueKeys(snapshot.queue), QStringList({ trackKey(makeTrack("b0")), trackKey(makeTrack("a2")) }));
+
+    // 清空佇列也會重播
+    store->recordQueueCleared();
+    snapshot = reload();
+    QVERIFY(snapshot.queue.isEmpty());
+    QCOMPARE(names(snapshot.playlists), QStringList({ "A", "B" }));
+}
+
+void TestPlaylistStore::discardTruncatedRecord()
+{
+    PlaylistSnapshot empty;
+    store->load(empty);
+    store->recordPlaylistAdded("A");
+    store->recordVideoAdded(0, makeTrack("a0"));
+    store->flush();
+
+    // 模擬寫到一半時當機
+    const QString logPath = directory->filePath("youtube_playlists.log");
+    const qint64 validSize = QFileInfo(logPath).size();
+    QFile log(logPath);
+    QVERIFY(log.open(QIODevice::WriteOnly | QIODevice::Append));
+    log.write("{\"op\":\"addPlaylist\",\"name\":\"broken\",\"se");
+    log.close();
+
+    PlaylistSnapshot snapshot = reload();
+    QCOMPARE(names(snapshot.playlists), QStringList({ "A" }));
+    QCOMPARE(QFileInfo(logPath).size(), validSize);
+
+    // 之後追加的紀錄不會接在殘缺資料後面
+    store->recordPlaylistAdded("B");
+    snapshot = reload();
+    QCOMPARE(names(snapshot.playlists), QStringList({ "A", "B" }));
+    QCOMPARE(titles(store->videos(snapshot.playlists[0])), QStringList({ "a0" }));
+}
+
+void TestPlaylistStore::compactToCache()
+{
+    PlaylistSnapshot state;
+    store->load(state);
+
+    // 測試端維護與紀錄相同的狀態，交給壓縮使用
+    state.playlists.append(Playlist());
+    state.playlists[0].name = "A";
+    store->recordPlaylistAdded("A");
+    state.playlists.append(Playlist());
+    state.playlists[1].name = "B";
+    store->recordPlaylistAdded("B");
+    for (int i = 0; i < 3; i++) {
+        const VideoInfo video = makeTrack(QString("b%1").arg(i));
+        state.playlists[1].append(video);
+        store->recordVideoAdded(1, video);
+    }
+    const QueueEntry entry = state.queue.enqueue("B", trackKey(makeTrack("b1")));
+    store->recordQueued(entry, false);
+    state.lastPlaylistName = "B";
+    store->recordLastPlaylist("B");
+
+    store->setSnapshotProvider([&state]() { return state; });
+    store->compact();
+    store->flush();
+    QCOMPARE(QFileInfo(directory->filePath("youtube_playlists.log")).size(), qint64(0));
+
+    // 壓縮之後的紀錄寫在日誌中
+    store->recordVideoAdded(0, makeTrack("a0"));
+
+    PlaylistSnapshot snapshot = reload();
+    QVERIFY(snapshot.cache);
+    QCOMPARE(names(snapshot.playlists), QStringList({ "A", "B" }));
+    // 日誌修改過的播放清單已展開，其餘仍在快取中
+    QCOMPARE(snapshot.playlists[0].cacheIndex, -1);
+    QVERIFY(snapshot.playlists[1].cacheIndex >= 0);
+    QCOMPARE(titles(snapshot.playlists[0].videos), QStringList({ "a0" }));
+    QCOMPARE(titles(store->videos(snapshot.playlists[1])), QStringList({ "b0", "b1", "b2" }));
+    QCOMPARE(snapshot.lastPlaylistName, QString("B"));
+    QCOMPARE(queueKeys(snapshot.queue), QStringList({ trackKey(makeTrack("b1")) }));
+
+    store->materialize(snapshot.playlists[1]);
+    QCOMPARE(snapshot.playlists[1].cacheIndex, -1);
+    QCOMPARE(snapshot.playlists[1].indexOf(trackKey(makeTrack("b2"))), 2);
+}
+
+void TestPlaylistStore::compactFromCache()
+{
+    {
+        PlaylistSnapshot state;
+        store->load(state);
+        state.playlists.append(Playlist());
+        state.playlists[0].name = "A";
+        store->recordPlaylistAdded("A");
+        for (int i = 0; i < 4; i++) {
+            const VideoInfo video = makeTrack(QString("a%1").arg(i));
+            state.playlists[0].append(video);
+            store->recordVideoAdded(0, video);
+        }
+        store->setSnapshotProvider([&state]() { return state; });
+        store->compact();
+        store->flush();
+        store->setSnapshotProvider(nullptr);
+    }
+
+    // 從快取載入的播放清單不展開，再次壓縮時直接從舊快取複製曲目
+    PlaylistSnapshot state = reload();
+    QVERIFY(state.playlists[0].cacheIndex >= 0);
+    state.playlists.append(Playlist());
+    state.playlists[1].name = "B";
+    store->recordPlaylistAdded("B");
+    store->setSnapshotProvider([&state]() { return state; });
+    store->compact();
+    store->flush();
+    store->setSnapshotProvider(nullptr);
+
+    const PlaylistSnapshot snapshot = reload();
+    QVERIFY(snapshot.cache);
+    QCOMPARE(names(snapshot.playlists), QStringList({ "A", "B" }));
+    QCOMPARE(titles(store->videos(snapshot.playlists[0])), QStringList({ "a0", "a1", "a2", "a3" }));
+    QVERIFY(store->videos(snapshot.playlists[1]).isEmpty());
+}
+
+void TestPlaylistStore::playbackStateRoundTrip()
+{
+    PlaybackState state;
+    QVERIFY(!store->loadPlaybackState(state));
+
+    state.playlistName = "A";
+    state.trackKey = trackKey(makeTrack("a0"));
+    state.positionMs = 123456;
+    store->savePlaybackState(state);
+    reload();
+
+    PlaybackState loaded;
+    QVERIFY(store->loadPlaybackState(loaded));
+    QCOMPARE(loaded.playlistName, state.playlistName);
+    QCOMPARE(loaded.trackKey, state.trackKey);
+    QCOMPARE(loaded.positionMs, state.positionMs);
+}
+
+QTEST_GUILESS_MAIN(TestPlaylistStore)
+
+// 引入 moc 產生的程式碼
+#include "tst_playliststore.moc"
@@ -0,0 +1,136 @@
+// 待播佇列的單元測試
+//
+// 加到開頭或尾端、依代號移除之後，依序走訪的結果與項目數必須一致。
+
+// 引入待播佇列
+#include "../playqueue.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+
+namespace {
+    // 依序列出佇列中的曲目鍵值
+    QStringList keys(const PlayQueue& queue)
+    {
+        QStringList result;
+        for (const QueueEntry& entry : queue.entries()) {
+            result.append(entry.trackKey);
+        }
+        return result;
+    }
+
+    // 以 first()/after() 走訪，結果必須與 entries() 相同
+    QStringList walk(const PlayQueue& queue)
+    {
+        QStringList result;
+        for (QueueEntry entry = queue.first(); entry.handle != 0; entry = queue.after(entry.handle)) {
+            result.append(entry.trackKey);
+        }
+        return result;
+    }
+}
+
+class TestPlayQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptyQueue();
+    void enqueueAndPlayNext();
+    void removeKeepsLinks();
+    void handlesAreNotReused();
+    void insertWithExistingHandle();
+    void clearResetsQueue();
+};
+
+void TestPlayQueue::emptyQueue()
+{
+    PlayQueue queue;
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(queue.size(), 0);
+    QCOMPARE(queue.first().handle, quint64(0));
+    QVERIFY(!queue.remove(1));
+}
+
+void TestPlayQueue::enqueueAndPlayNext()
+{
+    PlayQueue queue;
+    queue.enqueue("A", "b");
+    queue.enqueue("A", "c");
+    queue.playNext("B", "a");
+    const QueueEntry last = queue.enqueue("A", "d");
+
+    QCOMPARE(keys(queue), QStringList({ "a", "b", "c", "d" }));
+    QCOMPARE(walk(queue), keys(queue));
+    QCOMPARE(queue.size(), 4);
+    QCOMPARE(queue.first().playlistName, QString("B"));
+    QCOMPARE(queue.after(last.handle).handle, quint64(0));
+}
+
+void TestPlayQueue::removeKeepsLinks()
+{
+    PlayQueue queue;
+    const QueueEntry a = queue.enqueue("P", "a");
+    const QueueEntry b = queue.enqueue("P", "b");
+    const QueueEntry c = queue.enqueue("P", "c");
+    const QueueEntry d = queue.enqueue("P", "d");
+
+    // 中間、開頭、結尾各移除一次
+    QVERIFY(queue.remove(b.handle));
+    QCOMPARE(walk(queue), QStringList({ "a", "c", "d" }));
+    QVERIFY(queue.remove(a.handle));
+    QCOMPARE(walk(queue), QStringList({ "c", "d" }));
+    QVERIFY(queue.remove(d.handle));
+    QCOMPARE(walk(queue), QStringList({ "c" }));
+    QVERIFY(!queue.remove(d.handle));
+    QVERIFY(!queue.contains(a.handle));
+    QCOMPARE(queue.entry(c.handle).trackKey, QString("c"));
+
+    // 移除後仍可在兩端加入
+    queue.playNext("P", "front");
+    queue.enqueue("P", "back");
+    QCOMPARE(walk(queue), QStringList({ "front", "c", "back" }));
+    QCOMPARE(queue.size(), 3);
+}
+
+void TestPlayQueue::handlesAreNotReused()
+{
+    PlayQueue queue;
+    const QueueEntry first = queue.enqueue("P", "a");
+    queue.remove(first.handle);
+    const QueueEntry second = queue.enqueue("P", "a");
+    QVERIFY(second.handle != 0);
+    QVERIFY(second.handle != first.handle);
+}
+
+void TestPlayQueue::insertWithExistingHandle()
+{
+    // 重播變更日誌時以紀錄中的代號加入，之後配發的代號不會重複
+    PlayQueue queue;
+    queue.insert(QueueEntry{ 5, "P", "a" }, false);
+    queue.insert(QueueEntry{ 9, "P", "b" }, true);
+    queue.insert(QueueEntry{ 5, "P", "duplicate" }, false);
+    QCOMPARE(walk(queue), QStringList({ "b", "a" }));
+
+    const QueueEntry added = queue.enqueue("P", "c");
+    QVERIFY(added.handle != 5 && added.handle != 9);
+    QCOMPARE(walk(queue), QStringList({ "b", "a", "c" }));
+}
+
+void TestPlayQueue::clearResetsQueue()
+{
+    PlayQueue queue;
+    queue.enqueue("P", "a");
+    queue.enqueue("P", "b");
+    queue.clear();
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(walk(queue), QStringList());
+
+    queue.enqueue("P", "c");
+    QCOMPARE(walk(queue), QStringList({ "c" }));
+}
+
+QTEST_APPLESS_MAIN(TestPlayQueue)
+
+// 引入 moc 產生的程式碼
+#include "tst_playqueue.moc"
@@ -0,0 +1,331 @@
+// 全文搜尋索引的單元測試
+//
+// 中日韓文字與拼音文字的斷詞、曲目與字幕的增量更新，以及保存後讀回得到相同的搜尋結果。
+
+// 引入全文搜尋索引
+#include "../searchindex.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+// 引入 Qt 暫存目錄類別
+#include <QTemporaryDir>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+
+namespace {
+    VideoInfo makeTrack(const QString& name, const QString& title, const QString& artist)
+    {
+        VideoInfo video;
+        video.filePath = "/music/" + name + ".mp3";
+        video.title = title;
+        video.channelTitle = artist;
+        video.isFavorite = false;
+        video.isLocalFile = true;
+        return video;
+    }
+
+    // 每段一秒的字幕
+    SubtitleCueList makeCues(const QStringList& texts)
+    {
+        SubtitleCueList cues;
+        for (int i = 0; i < texts.size(); i++) {
+            cues.cues.append(SubtitleCue{ i * 1000, (i + 1) * 1000, int(cues.text.size()), int(texts.at(i).size()) });
+            cues.text.append(texts.at(i));
+        }
+        return cues;
+    }
+
+    // 搜尋結果的簡短描述：曲目資訊命中為曲目鍵值，字幕命中為段落文字
+    QStringList describe(const QList<SearchHit>& hits)
+    {
+        QStringList result;
+        for (const SearchHit& hit : hits) {
+            result.append(hit.startMs < 0 ? hit.trackKey : hit.text);
+        }
+        return result;
+    }
+}
+
+class TestSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tokenize_data();
+    void tokenize();
+    void searchMetadata();
+    void searchTranscript();
+    void exactPhraseRanksFirst();
+    void rankBeyondFirstCandidates();
+    void replaceTranscript();
+    void removeTrack();
+    void saveLoadRoundTrip();
+    void compactCuesRoundTrip();
+    void rejectCorruptFile();
+};
+
+void TestSearchIndex::tokenize_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QStringList>("tokens");
+
+    QTest::newRow("latin") << "Hello, World 42" << QStringList({ "hello", "world", "42" });
+    QTest::newRow("fullwidth") << "ＡＢＣ１２" << QStringList({ "abc12" });
+    QTest::newRow("cjk-single") << "愛" << QStringList({ "愛" });
+    QTest::newRow("cjk-bigrams") << "我愛你" << QStringList({ "我愛", "愛你" });
+    QTest::newRow("mixed") << "周杰倫Jay的歌" << QStringList({ "周杰", "杰倫", "jay", "的歌" });
+    QTest::newRow("punctuation") << "——！？" << QStringList();
+}
+
+void TestSearchIndex::tokenize()
+{
+    QFETCH(QString, text);
+    QFETCH(QStringList, tokens);
+    QCOMPARE(SearchIndex::tokenize(text), tokens);
+}
+
+void TestSearchIndex::searchMetadata()
+{
+    SearchIndex index;
+    index.addTrack(makeTrack("a", "晴天", "周杰倫"));
+    index.addTrack(makeTrack("b", "Yellow", "Coldplay"));
+    index.addTrack(makeTrack("summer_night", "夏夜", "unknown"));
+
+    QCOMPARE(index.trackCount(), 3);
+    QVERIFY(index.contains("file:/music/a.mp3"));
+    QCOMPARE(describe(index.search(u"周杰倫", 10)), QStringList({ "file:/music/a.mp3" }));
+    QCOMPARE(describe(index.search(u"coldplay YELLOW", 10)), QStringList({ "file:/music/b.mp3" }));
+    // 本地檔案的檔名也會收錄
+    QCOMPARE(describe(index.search(u"summer", 10)), QStringList({ "file:/music/summer_night.mp3" }));
+    QVERIFY(index.search(u"周杰倫 Coldplay", 10).isEmpty());
+    QVERIFY(index.search(u"nothing", 10).isEmpty());
+    QVERIFY(index.search(u"周杰倫", 0).isEmpty());
+}
+
+void TestSearchIndex::searchTranscript()
+{
+    SearchIndex index;
+    const VideoInfo video = makeTrack("a", "Song", "Artist");
+    const QString key = trackKey(video);
+
+    // 尚未收錄曲目資訊時忽略字幕
+    index.setTranscript(key, makeCues({ "ignored" }));
+    QVERIFY(!index.hasTranscript(key));
+
+    index.addTrack(video);
+    index.setTranscript(key, makeCues({ "故事的小黃花", "從出生那年就飄著", "童年的盪鞦韆" }));
+    QVERIFY(index.hasTranscript(key));
+    QCOMPARE(index.cueCount(), 3);
+
+    const QList<SearchHit> hits = index.search(u"出生", 10);
+    QCOMPARE(hits.size(), 1);
+    QCOMPARE(hits[0].trackKey, key);
+    QCOMPARE(hits[0].title, QString("Song"));
+    QCOMPARE(hits[0].startMs, qint64(1000));
+    QCOMPARE(hits[0].text, QString("從出生那年就飄著"));
+}
+
+void TestSearchIndex::exactPhraseRanksFirst()
+{
+    SearchIndex index;
+    const VideoInfo video = makeTrack("a", "Song", "Artist");
+    index.addTrack(video);
+    index.setTranscript(trackKey(video), makeCues({ "world hello and more words here", "hello world" }));
+
+    // 兩個段落都有兩個詞，含有完整片語的排在前面
+    QCOMPARE(describe(index.search(u"hello world", 10)),
+             QStringList({ "hello world", "world hello and more words here" }));
+}
+
+void TestSearchIndex::rankBeyondFirstCandidates()
+{
+    // 大量較早收錄的段落只含有查詢的詞，含有完整片語的段落最後才收錄，仍要排在最前面
+    SearchIndex index;
+    const VideoInfo old = makeTrack("old", "Old", "Artist");
+    index.addTrack(old);
+    QStringList texts;
+    for (int i = 0; i < 5000; i++) {
+        texts.append(QString("world %1 hello").arg(i));
+    }
+    index.setTranscript(trackKey(old), makeCues(texts));
+
+    const VideoInfo latest = makeTrack("latest", "Latest", "Artist");
+    index.addTrack(latest);
+    index.setTranscript(trackKey(latest), makeCues({ "intro", "and then Hello, World!" }));
+
+    const QList<SearchHit> hits = index.search(u"hello world", 5);
+    QCOMPARE(hits.size(), 5);
+    QCOMPARE(hits.first().trackKey, trackKey(latest));
+    QCOMPARE(hits.first().startMs, qint64(1000));
+}
+
+void TestSearchIndex::replaceTranscript()
+{
+    SearchIndex index;
+    const VideoInfo video = makeTrack("a", "Song", "Artist");
+    const QString key = trackKey(video);
+    index.addTrack(video);
+    index.setTranscript(key, makeCues({ "old words" }));
+    index.setTranscript(key, makeCues({ "new words", "more new words" }));
+
+    QCOMPARE(index.cueCount(), 2);
+    QVERIFY(index.search(u"old", 10).isEmpty());
+    QCOMPARE(index.search(u"words", 10).size(), 2);
+
+    // 更新曲目資訊不影響字幕
+    VideoInfo renamed = video;
+    renamed.title = "Renamed";
+    index.addTrack(renamed);
+    QCOMPARE(index.trackCount(), 1);
+    QVERIFY(index.search(u"Song", 10).isEmpty());
+    QCOMPARE(describe(index.search(u"renamed", 10)), QStringList({ key }));
+    QCOMPARE(index.search(u"new", 10).first().title, QString("Renamed"));
+}
+
+void TestSearchIndex::removeTrack()
+{
+    SearchIndex index;
+    const VideoInfo a = makeTrack("a", "Shared title", "A");
+    const VideoInfo b = makeTrack("b", "Shared title", "B");
+    index.addTrack(a);
+    index.addTrack(b);
+    index.setTranscript(trackKey(a), makeCues({ "shared lyric" }));
+    index.setTranscript(trackKey(b), makeCues({ "shared lyric" }));
+
+    const quint64 revision = index.revision();
+    index.removeTrack(trackKey(a));
+    QVERIFY(index.revision() != revision);
+    QVERIFY(!index.contains(trackKey(a)));
+    QCOMPARE(index.trackCount(), 1);
+    QCOMPARE(index.cueCount(), 1);
+    QCOMPARE(index.trackKeys(), QStringList({ trackKey(b) }));
+
+    const QList<SearchHit> hits = index.search(u"shared", 10);
+    QCOMPARE(hits.size(), 2);
+    for (const SearchHit& hit : hits) {
+        QCOMPARE(hit.trackKey, trackKey(b));
+    }
+
+    // 移除後可以再加入
+    index.addTrack(a);
+    QCOMPARE(index.trackCount(), 2);
+    QVERIFY(!index.hasTranscript(trackKey(a)));
+}
+
+void TestSearchIndex::saveLoadRoundTrip()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("search_index.bin");
+
+    SearchIndex index;
+    for (int i = 0; i < 20; i++) {
+        const VideoInfo video = makeTrack(QString("track%1").arg(i), QString("標題 %1").arg(i), "歌手");
+        index.addTrack(video);
+        index.setTranscript(trackKey(video), makeCues({ QString("第 %1 首的歌詞").arg(i), "共同的副歌" }));
+    }
+    index.removeTrack(trackKey(makeTrack("track3", QString(), QString())));
+    QVERIFY(index.save(path));
+
+    SearchIndex loaded;
+    QVERIFY(loaded.load(path));
+    QCOMPARE(loaded.revision(), quint64(0));
+    QCOMPARE(loaded.trackCount(), index.trackCount());
+    QCOMPARE(loaded.cueCount(), index.cueCount());
+    for (const QString query : { "歌手", "副歌", "第 7 首", "track12", "標題" }) {
+        const QList<SearchHit> expected = index.search(query, 50);
+        const QList<SearchHit> actual = loaded.search(query, 50);
+        QVERIFY2(!expected.isEmpty(), qPrintable(query));
+        QCOMPARE(describe(actual), describe(expected));
+        for (int i = 0; i < actual.size(); i++) {
+            QCOMPARE(actual[i].trackKey, expected[i].trackKey);
+            QCOMPARE(actual[i].startMs, expected[i].startMs);
+        }
+    }
+
+    // 讀回的索引可以繼續增量更新
+    const VideoInfo added = makeTrack("added", "新歌", "歌手");
+    loaded.addTrack(added);
+    loaded.setTranscript(trackKey(added), makeCues({ "新的副歌" }));
+    QCOMPARE(loaded.search(u"副歌", 100).size(), index.search(u"副歌", 100).size() + 1);
+}
+
+void TestSearchIndex::compactCuesRoundTrip()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("search_index.bin");
+
+    SearchIndex index;
+    const VideoInfo a = makeTrack("a", "A", "Artist");
+    const VideoInfo empty = makeTrack("empty", "Empty", "Artist");
+    const VideoInfo b = makeTrack("b", "B", "Artist");
+    index.addTrack(a);
+    index.addTrack(empty);
+    index.addTrack(b);
+
+    QStringList texts;
+    for (int i = 0; i < 5000; i++) {
+        texts.append(QString("line %1").arg(i));
+    }
+    index.setTranscript(trackKey(a), makeCues(texts));
+    // 空字幕的範圍落在目前段落數的位置
+    index.setTranscript(trackKey(empty), SubtitleCueList());
+    index.setTranscript(trackKey(b), makeCues({ "before compaction" }));
+
+    // 取代大量段落後觸發清除與重新編號
+    index.setTranscript(trackKey(a), makeCues({ "after compaction" }));
+    QCOMPARE(index.cueCount(), 2);
+    QVERIFY(index.hasTranscript(trackKey(empty)));
+    QVERIFY(index.search(u"line", 10).isEmpty());
+    // 片語佔比較高的段落在前
+    QCOMPARE(describe(index.search(u"compaction", 10)), QStringList({ "after compaction", "before compaction" }));
+    QVERIFY(index.save(path));
+
+    SearchIndex loaded;
+    QVERIFY(loaded.load(path));
+    QCOMPARE(loaded.cueCount(), 2);
+    QVERIFY(loaded.hasTranscript(trackKey(empty)));
+    QCOMPARE(describe(loaded.search(u"compaction", 10)), describe(index.search(u"compaction", 10)));
+
+    // 清除後的索引可以繼續更新字幕
+    loaded.setTranscript(trackKey(empty), makeCues({ "no longer empty" }));
+    loaded.setTranscript(trackKey(b), SubtitleCueList());
+    QCOMPARE(describe(loaded.search(u"empty", 10)), QStringList({ trackKey(empty), "no longer empty" }));
+    QCOMPARE(describe(loaded.search(u"compaction", 10)), QStringList({ "after compaction" }));
+    QVERIFY(loaded.save(path));
+    QVERIFY(SearchIndex().load(path));
+}
+
+void TestSearchIndex::rejectCorruptFile()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("search_index.bin");
+
+    SearchIndex index;
+    const VideoInfo video = makeTrack("a", "Song", "Artist");
+    index.addTrack(video);
+    index.setTranscript(trackKey(video), makeCues({ "some words" }));
+    QVERIFY(index.save(path));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    file.close();
+
+    SearchIndex loaded;
+    QVERIFY(!loaded.load(directory.filePath("missing.bin")));
+    for (int size : { 0, 8, int(data.size() / 2), int(data.size() - 1) }) {
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(data.left(size));
+        file.close();
+        QVERIFY2(!loaded.load(path), qPrintable(QString::number(size)));
+        QCOMPARE(loaded.trackCount(), 0);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestSearchIndex)
+
+// 引入 moc 產生的程式碼
+#include "tst_searchindex.moc"
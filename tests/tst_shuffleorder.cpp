@@ -0,0 +1,307 @@
+// 隨機播放順序的單元測試
+//
+// 每一輪的每首曲目恰好抽出一次，上一首/下一首只是移動歷史中的游標。
+
+// 引入隨機播放順序
+#include "../shuffleorder.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+// 引入 Qt 集合類別
+#include <QSet>
+// 引入 Qt 亂數產生器類別
+#include <QRandomGenerator>
+
+namespace {
+    // 一路前進到本輪結束，回傳依序抽出的曲目
+    QList<int> drainRound(ShuffleOrder& order)
+    {
+        QList<int> rows;
+        for (int row = order.next(); row >= 0; row = order.next()) {
+            rows.append(row);
+        }
+        return rows;
+    }
+
+    // rows 是否恰好包含 0 ~ count-1 各一次
+    bool isPermutation(const QList<int>& rows, int count)
+    {
+        if (rows.size() != count) {
+            return false;
+        }
+        QSet<int> seen;
+        for (int row : rows) {
+            if (row < 0 || row >= count || seen.contains(row)) {
+                return false;
+            }
+            seen.insert(row);
+        }
+        return true;
+    }
+}
+
+class TestShuffleOrder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptyOrder();
+    void roundVisitsEveryTrackOnce();
+    void resetStartsWithFirst();
+    void peekDoesNotAdvance();
+    void previousReplaysHistory();
+    void playUpcomingTrack();
+    void playUndrawnTrack();
+    void removeDuringRound();
+    void insertDuringRound();
+    void moveDuringRound();
+    void randomEditsKeepRound();
+};
+
+void TestShuffleOrder::emptyOrder()
+{
+    ShuffleOrder order;
+    QCOMPARE(order.trackCount(), 0);
+    QCOMPARE(order.current(), -1);
+    QCOMPARE(order.next(), -1);
+    QCOMPARE(order.previous(), -1);
+    QCOMPARE(order.peek(1), -1);
+}
+
+void TestShuffleOrder::roundVisitsEveryTrackOnce()
+{
+    for (int count : { 1, 2, 7, 100, 1000 }) {
+        ShuffleOrder order;
+        order.reset(count);
+        const QList<int> rows = drainRound(order);
+        QVERIFY(isPermutation(rows, count));
+        QVERIFY(order.isExhausted());
+        QCOMPARE(order.current(), rows.last());
+    }
+}
+
+void TestShuffleOrder::resetStartsWithFirst()
+{
+    ShuffleOrder order;
+    order.reset(50, 17);
+    QCOMPARE(order.current(), 17);
+
+    QList<int> rows = { 17 };
+    rows += drainRound(order);
+    QVERIFY(isPermutation(rows, 50));
+}
+
+void TestShuffleOrder::peekDoesNotAdvance()
+{
+    ShuffleOrder order;
+    order.reset(20, 0);
+    const int second = order.peek(1);
+    const int third = order.peek(2);
+    QCOMPARE(order.current(), 0);
+    QCOMPARE(order.peek(1), second);
+    QCOMPARE(order.next(), second);
+    QCOMPARE(order.next(), third);
+    QCOMPARE(order.peek(-2), 0);
+}
+
+void TestShuffleOrder::previousReplaysHistory()
+{
+    ShuffleOrder order;
+    order.reset(30);
+    QList<int> played;
+    for (int i = 0; i < 10; i++) {
+        played.append(order.next());
+    }
+
+    for (int i = 8; i >= 0; i--) {
+        QCOMPARE(order.previous(), played[i]);
+    }
+    QCOMPARE(order.previous(), -1);
+    QCOMPARE(order.current(), played[0]);
+
+    // 往回之後再前進，順序與第一次相同
+    for (int i = 1; i < played.size(); i++) {
+        QCOMPARE(order.next(), played[i]);
+    }
+}
+
+void TestShuffleOrder::playUpcomingTrack()
+{
+    ShuffleOrder order;
+    order.reset(40, 0);
+    const int skipped = order.peek(1);
+    const int chosen = order.peek(3);
+
+    // 預先抽出的曲目提前播放，跳過的曲目仍在本輪中
+    order.play(chosen);
+    QCOMPARE(order.current(), chosen);
+    QCOMPARE(order.peek(1), skipped);
+    QCOMPARE(order.peek(-1), 0);
+
+    QList<int> rows = { 0, chosen };
+    rows += drainRound(order);
+    QVERIFY(isPermutation(rows, 40));
+}
+
+void TestShuffleOrder::playUndrawnTrack()
+{
+    ShuffleOrder order;
+    order.reset(40, 0);
+    const int upcoming = order.peek(1);
+    int undrawn = 1;
+    while (undrawn == upcoming) {
+        undrawn++;
+    }
+
+    // 尚未抽出的曲目從抽選池取出，原本預先抽出的下一首仍是下一首
+    order.play(undrawn);
+    QCOMPARE(order.current(), undrawn);
+    QCOMPARE(order.peek(1), upcoming);
+
+    QList<int> rows = { 0, undrawn };
+    rows += drainRound(order);
+    QVERIFY(isPermutation(rows, 40));
+}
+
+void TestShuffleOrder::removeDuringRound()
+{
+    ShuffleOrder order;
+    order.reset(20, 5);
+    const int following = order.peek(1);
+
+    // 移除目前曲目：游標停在前一首（本輪第一首之前），下一首仍是原本的下一首
+    order.remove(5);
+    QCOMPARE(order.trackCount(), 19);
+    QCOMPARE(order.current(), -1);
+    const int expected = following > 5 ? following - 1 : following;
+    QCOMPARE(order.next(), expected);
+
+    // 移除尚未抽出的曲目：本輪不再抽到它，其餘列號往前位移
+    const int undrawn = expected == 0 ? 1 : 0;
+    order.remove(undrawn);
+    QList<int> rows = { expected > undrawn ? expected - 1 : expected };
+    QCOMPARE(order.current(), rows.first());
+    rows += drainRound(order);
+    QVERIFY(isPermutation(rows, 18));
+}
+
+void TestShuffleOrder::insertDuringRound()
+{
+    ShuffleOrder order;
+    order.reset(10, 3);
+    const int following = order.peek(1);
+
+    // 在目前曲目之前插入：目前曲目與預先抽出的下一首都跟著位移
+    order.insert(0);
+    QCOMPARE(order.trackCount(), 11);
+    QCOMPARE(order.current(), 4);
+    QCOMPARE(order.peek(1), following + 1);
+
+    // 新曲目在本輪之後的抽選中出現一次
+    order.insert(11);
+    QList<int> rows = { 4 };
+    rows += drainRound(order);
+    QVERIFY(isPermutation(rows, 12));
+    QVERIFY(rows.contains(0));
+    QVERIFY(rows.contains(11));
+}
+
+void TestShuffleOrder::moveDuringRound()
+{
+    ShuffleOrder order;
+    order.reset(15, 2);
+    const int following = order.peek(1);
+
+    // 移動目前曲目：仍是目前曲目，下一首不變（依列號位移）
+    order.move(2, 10);
+    QCOMPARE(order.current(), 10);
+    const int shifted = (following > 2 && following <= 10) ? following - 1 : following;
+    QCOMPARE(order.peek(1), shifted);
+
+    // 移動尚未抽出的曲目不影響本輪
+    QList<int> rows = { 10 };
+    rows.append(order.next());
+    int undrawn = 0;
+    while (rows.contains(undrawn)) {
+        undrawn++;
+    }
+    order.move(undrawn, 14);
+    for (int& row : rows) {
+        if (row > undrawn) {
+            row--;
+        }
+    }
+    QCOMPARE(order.current(), rows.last());
+    QCOMPARE(order.peek(-1), rows.first());
+    rows += drainRound(order);
+    QVERIFY(isPermutation(rows, 15));
+}
+
+void TestShuffleOrder::randomEditsKeepRound()
+{
+    // 以曲目代號追蹤每首曲目：刪除、插入與移動穿插在抽選之間，
+    // 本輪仍然每首曲目恰好播放一次，往回走的歷史就是實際的播放順序
+    QRandomGenerator random(12345);
+    for (int round = 0; round < 50; round++) {
+        QList<int> ids;
+        for (int i = 0; i < 40; i++) {
+            ids.append(i);
+        }
+        int nextId = ids.size();
+        QList<int> played;
+        QSet<int> removed;
+
+        ShuffleOrder order;
+        order.reset(ids.size(), 0);
+        played.append(ids.first());
+
+        for (;;) {
+            const int action = random.bounded(4);
+            if (action == 0 && ids.size() > 1) {
+                const int row = random.bounded(int(ids.size()));
+                removed.insert(ids.takeAt(row));
+                order.remove(row);
+            } else if (action == 1) {
+                const int row = random.bounded(int(ids.size()) + 1);
+                ids.insert(row, nextId++);
+                order.insert(row);
+            } else if (action == 2) {
+                const int from = random.bounded(int(ids.size()));
+                const int to = random.bounded(int(ids.size()));
+                ids.move(from, to);
+                order.move(from, to);
+            } else {
+                const int row = order.next();
+                if (row < 0) {
+                    break;
+                }
+                played.append(ids.at(row));
+            }
+            QCOMPARE(order.trackCount(), int(ids.size()));
+            // 目前曲目（未被刪除時）仍是最後播放的那一首
+            if (order.current() >= 0 && !removed.contains(played.last())) {
+                QCOMPARE(ids.at(order.current()), played.last());
+            }
+        }
+
+        QList<int> expected;
+        for (int id : played) {
+            if (!removed.contains(id)) {
+                expected.append(id);
+            }
+        }
+        QCOMPARE(int(expected.size()), int(ids.size()));
+        QCOMPARE(QSet<int>(expected.begin(), expected.end()), QSet<int>(ids.begin(), ids.end()));
+
+        QList<int> history = { ids.at(order.current()) };
+        for (int row = order.previous(); row >= 0; row = order.previous()) {
+            history.prepend(ids.at(row));
+        }
+        QCOMPARE(history, expected);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestShuffleOrder)
+
+// 引入 moc 產生的程式碼
+#include "tst_shuffleorder.moc"
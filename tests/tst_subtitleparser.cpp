@@ -0,0 +1,228 @@
+// 字幕解析器的單元測試
+//
+// SRT/WebVTT 的邊界情況，以及在任意位置切開餵入時結果與一次解析相同。
+
+// 引入字幕解析器
+#include "../subtitleparser.h"
+
+// 引入 Qt 單元測試框架
+#include <QtTest>
+// 引入 Qt 暫存目錄類別
+#include <QTemporaryDir>
+// 引入 Qt 檔案處理類別
+#include <QFile>
+
+namespace {
+    // 所有段落的文字
+    QStringList texts(const SubtitleCueList& cues)
+    {
+        QStringList result;
+        for (int i = 0; i < cues.size(); i++) {
+            result.append(cues.cueText(i).toString());
+        }
+        return result;
+    }
+
+    const char* const SAMPLE_SRT =
+        "1\n"
+        "00:00:01,000 --> 00:00:02,500\n"
+        "第一行\n"
+        "second line\n"
+        "\n"
+        "2\n"
+        "00:00:03,000 --> 00:00:04,000\n"
+        "42\n"
+        "\n"
+        "3\n"
+        "00:01:05,120 --> 01:00:00,000\n"
+        "最後一段\n";
+}
+
+class TestSubtitleParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseSrt();
+    void chunkedFeedMatchesWholeParse();
+    void crlfAndBom();
+    void cuesWithoutBlankLines();
+    void numericTextBeforeNextCue();
+    void webVtt();
+    void emptyAndMalformedInput();
+    void parseTimestamp_data();
+    void parseTimestamp();
+    void parseSegmentLine();
+    void parseFile();
+};
+
+void TestSubtitleParser::parseSrt()
+{
+    const SubtitleCueList cues = SubtitleParser::parse(QString::fromUtf8(SAMPLE_SRT));
+    QCOMPARE(cues.size(), 3);
+    QCOMPARE(texts(cues), QStringList({ "第一行 second line", "42", "最後一段" }));
+    QCOMPARE(cues.cues[0].startMs, qint64(1000));
+    QCOMPARE(cues.cues[0].endMs, qint64(2500));
+    QCOMPARE(cues.cues[2].startMs, qint64(65120));
+    QCOMPARE(cues.cues[2].endMs, qint64(3600000));
+}
+
+void TestSubtitleParser::chunkedFeedMatchesWholeParse()
+{
+    const QString content = QString::fromUtf8(SAMPLE_SRT);
+    const SubtitleCueList whole = SubtitleParser::parse(content);
+
+    // 每一種切點（包含換行字元的前後與多位元組文字中間）都要得到相同的結果
+    for (int split = 0; split <= content.size(); split++) {
+        SubtitleParser parser;
+        parser.feed(QStringView(content).left(split));
+        parser.feed(QStringView(content).mid(split));
+        parser.finish();
+        const SubtitleCueList cues = parser.takeCues();
+        QCOMPARE(texts(cues), texts(whole));
+        QCOMPARE(cues.cues.last().startMs, whole.cues.last().startMs);
+    }
+
+    // 一次一個字元
+    SubtitleParser parser;
+    for (int i = 0; i < content.size(); i++) {
+        parser.feed(QStringView(content).mid(i, 1));
+    }
+    parser.finish();
+    QCOMPARE(texts(parser.takeCues()), texts(whole));
+}
+
+void TestSubtitleParser::crlfAndBom()
+{
+    const QString content = QChar(0xFEFF) + QString::fromUtf8(SAMPLE_SRT).replace("\n", "\r\n");
+    const SubtitleCueList cues = SubtitleParser::parse(content);
+    QCOMPARE(texts(cues), QStringList({ "第一行 second line", "42", "最後一段" }));
+}
+
+void TestSubtitleParser::cuesWithoutBlankLines()
+{
+    const SubtitleCueList cues = SubtitleParser::parse(
+        u"1\n00:00:01,000 --> 00:00:02,000\nfirst\n2\n00:00:02,000 --> 00:00:03,000\nsecond\n");
+    QCOMPARE(texts(cues), QStringList({ "first", "second" }));
+    QCOMPARE(cues.cues[1].startMs, qint64(2000));
+}
+
+void TestSubtitleParser::numericTextBeforeNextCue()
+{
+    // 數字行後面接著數字行與時間行：前一個是字幕，後一個是序號
+    const SubtitleCueList cues = SubtitleParser::parse(
+        u"00:00:01,000 --> 00:00:02,000\n2024\n7\n00:00:02,000 --> 00:00:03,000\n100\n");
+    QCOMPARE(texts(cues), QStringList({ "2024", "100" }));
+}
+
+void TestSubtitleParser::webVtt()
+{
+    const SubtitleCueList cues = SubtitleParser::parse(
+        u"WEBVTT - 標題\n"
+        "Kind: captions\n"
+        "\n"
+        "NOTE 這是註解\n"
+        "00:00:00.000 --> 00:00:01.000 不是段落\n"
+        "\n"
+        "STYLE\n"
+        "::cue { color: red }\n"
+        "\n"
+        "intro\n"
+        "00:01.500 --> 00:02.000 align:start position:10%\n"
+        "<v Speaker>Hello <i>world</i><00:00:01.800>!\n"
+        "\n"
+        "01:00:00.000 --> 01:00:01.250\n"
+        "<c.yellow>結束</c>\n");
+    QCOMPARE(texts(cues), QStringList({ "Hello world!", "結束" }));
+    QCOMPARE(cues.cues[0].startMs, qint64(1500));
+    QCOMPARE(cues.cues[0].endMs, qint64(2000));
+    QCOMPARE(cues.cues[1].endMs, qint64(3601250));
+}
+
+void TestSubtitleParser::emptyAndMalformedInput()
+{
+    QVERIFY(SubtitleParser::parse(u"").isEmpty());
+    QVERIFY(SubtitleParser::parse(u"\n\n\n").isEmpty());
+    QVERIFY(SubtitleParser::parse(u"just some text\nwithout timing\n").isEmpty());
+
+    // 時間行格式錯誤的段落被略過，不影響之後的段落
+    const SubtitleCueList cues = SubtitleParser::parse(
+        u"1\n00:00:aa,000 --> 00:00:02,000\nbad\n\n2\n00:00:03,000 --> 00:00:04,000\ngood\n");
+    QCOMPARE(texts(cues), QStringList({ "good" }));
+
+    // 沒有文字的段落仍保留時間
+    const SubtitleCueList empty = SubtitleParser::parse(u"00:00:01,000 --> 00:00:02,000\n\n");
+    QCOMPARE(empty.size(), 1);
+    QVERIFY(empty.cueText(0).isEmpty());
+}
+
+void TestSubtitleParser::parseTimestamp_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<qint64>("expected");
+
+    QTest::newRow("srt") << "01:02:03,456" << qint64(3723456);
+    QTest::newRow("vtt-hours") << "01:02:03.456" << qint64(3723456);
+    QTest::newRow("vtt-minutes") << "02:03.456" << qint64(123456);
+    QTest::newRow("short-fraction") << "00:00:01,5" << qint64(1500);
+    QTest::newRow("long-fraction") << "00:00:01,23456" << qint64(1234);
+    QTest::newRow("no-fraction") << "00:01:02" << qint64(62000);
+    QTest::newRow("large-hours") << "100:00:00,000" << qint64(360000000);
+    QTest::newRow("seconds-only") << "12,000" << qint64(-1);
+    QTest::newRow("empty-fraction") << "00:00:01," << qint64(-1);
+    QTest::newRow("letters") << "00:0a:01,000" << qint64(-1);
+    QTest::newRow("too-many-fields") << "1:02:03:04,000" << qint64(-1);
+    QTest::newRow("empty-field") << "00::01,000" << qint64(-1);
+    QTest::newRow("empty") << "" << qint64(-1);
+}
+
+void TestSubtitleParser::parseTimestamp()
+{
+    QFETCH(QString, text);
+    QFETCH(qint64, expected);
+    QCOMPARE(SubtitleParser::parseTimestamp(text), expected);
+}
+
+void TestSubtitleParser::parseSegmentLine()
+{
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    QStringView text;
+
+    const QString line = "  [12.34s - 15.5s]  你好 world ";
+    QVERIFY(SubtitleParser::parseSegmentLine(line, &startMs, &endMs, &text));
+    QCOMPARE(startMs, qint64(12340));
+    QCOMPARE(endMs, qint64(15500));
+    QCOMPARE(text.toString(), QString("你好 world"));
+
+    QVERIFY(!SubtitleParser::parseSegmentLine(u"[15s - 12s] backwards", &startMs, &endMs, &text));
+    QVERIFY(!SubtitleParser::parseSegmentLine(u"[1.0 - 2.0] no unit", &startMs, &endMs, &text));
+    QVERIFY(!SubtitleParser::parseSegmentLine(u"progress 50%", &startMs, &endMs, &text));
+    QVERIFY(!SubtitleParser::parseSegmentLine(u"[1s - 2s", &startMs, &endMs, &text));
+}
+
+void TestSubtitleParser::parseFile()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    bool ok = true;
+    SubtitleParser::parseFile(directory.filePath("missing.srt"), &ok);
+    QVERIFY(!ok);
+
+    const QString path = directory.filePath("sample.srt");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("\xEF\xBB\xBF");
+    file.write(SAMPLE_SRT);
+    file.close();
+
+    const SubtitleCueList cues = SubtitleParser::parseFile(path, &ok);
+    QVERIFY(ok);
+    QCOMPARE(texts(cues), QStringList({ "第一行 second line", "42", "最後一段" }));
+}
+
+QTEST_APPLESS_MAIN(TestSubtitleParser)
+
+// 引入 moc 產生的程式碼
+#include "tst_subtitleparser.moc"
@@ -0,0 +1,209 @@
+// 引入字幕快取標頭檔
+#include "transcriptcache.h"
+
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+// 引入 Qt 目錄處理類別
+#include <QDir>
+// 引入 Qt 日期時間類別
+#include <QDateTime>
+// 引入 Qt 雜湊演算法類別
+#include <QCryptographicHash>
+// 引入 Qt 位元組序轉換函式
+#include <QtEndian>
+
+namespace {
+    // 每個取樣區段的大小
+    const qint64 SAMPLE_BYTES = 64 * 1024;
+    // 指紋格式版本，演算法變更時遞增使舊的快取失效
+    const char FINGERPRINT_VERSION = 1;
+
+    // 讀取 FLAC 的 metadata block，回傳音訊 frame 的起點；不是合法的 FLAC 結構時回傳 begin
+    qint64 flacAudioBegin(QFile& file, qint64 begin, qint64 end)
+    {
+        // 每個 block 有 4 位元組的檔頭：最高位元表示最後一個 block，之後是 24 位元的長度
+        qint64 pos = begin + 4;
+        while (pos + 4 <= end && file.seek(pos)) {
+            const QByteArray header = file.read(4);
+            if (header.size() != 4) {
+                break;
+            }
+            const uchar* h = reinterpret_cast<const uchar*>(header.constData());
+            pos += 4 + ((qint64(h[1]) << 16) | (qint64(h[2]) << 8) | qint64(h[3]));
+            if (h[0] & 0x80) {
+                return qMin(pos, end);
+            }
+        }
+        return begin;
+    }
+
+    // 在 MP4 最上層的 box 中找出 mdat 的內容範圍，找不到時不修改 begin 與 end
+    void mp4MediaRange(QFile& file, qint64& begin, qint64& end)
+    {
+        qint64 pos = begin;
+        while (pos + 8 <= end && file.seek(pos)) {
+            const QByteArray header = file.read(16);
+            if (header.size() < 8) {
+                return;
+            }
+            qint64 size = qFromBigEndian<quint32>(header.constData());
+            qint64 headerSize = 8;
+            if (size == 1 && header.size() == 16) {
+                // 64 位元的 largesize
+                size = qint64(qFromBigEndian<quint64>(header.constData() + 8));
+                headerSize = 16;
+            } else if (size == 0) {
+                // 延伸到檔案結尾
+                size = end - pos;
+            }
+            if (size < headerSize) {
+                return;
+            }
+            if (header.mid(4, 4) == "mdat") {
+                begin = pos + headerSize;
+                end = qMin(end, pos + size);
+                return;
+            }
+            pos += size;
+        }
+    }
+
+    // 模型名稱只保留檔名安全的字元
+    QString sanitizeModelName(const QString& model)
+    {
+        QString result;
+        result.reserve(model.size());
+        for (const QChar ch : model) {
+            const bool safe = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+                              (ch >= '0' && ch <= '9') || ch == '-' || ch == '_';
+            result.append(safe ? ch : QChar('_'));
+        }
+        return result.isEmpty() ? QString("default") : result;
+    }
+}
+
+TranscriptCache::TranscriptCache(const QString& directory)
+    : directory(directory)
+{
+}
+
+QString TranscriptCache::computeFingerprint(const QString& audioFilePath)
+{
+    QFile file(audioFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    // 找出音訊資料的範圍，排除檔頭的 ID3v2 與檔尾的 ID3v1 標籤、FLAC 與 MP4 的 metadata
+    qint64 begin = 0;
+    qint64 end = file.size();
+    const QByteArray header = file.read(10);
+    if (header.size() == 10 && header.startsWith("ID3")) {
+        const uchar* h = reinterpret_cast<const uchar*>(header.constData());
+        const qint64 tagSize = (qint64(h[6] & 0x7f) << 21) | (qint64(h[7] & 0x7f) << 14) |
+                               (qint64(h[8] & 0x7f) << 7) | qint64(h[9] & 0x7f);
+        const bool hasFooter = h[3] == 4 && (h[5] & 0x10);
+        begin = qMin(end, 10 + tagSize + (hasFooter ? 10 : 0));
+    }
+    file.seek(begin);
+    const QByteArray magic = file.read(8);
+    if (magic.startsWith("fLaC")) {
+        begin = flacAudioBegin(file, begin, end);
+    } else if (magic.size() == 8 && magic.mid(4, 4) == "ftyp") {
+        mp4MediaRange(file, begin, end);
+    } else if (end - begin >= 128 && file.seek(end - 128) && file.read(3) == "TAG") {
+        end -= 128;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(1, FINGERPRINT_VERSION));
+    const quint64 length = qToLittleEndian<quint64>(static_cast<quint64>(end - begin));
+    hash.addData(QByteArray(reinterpret_cast<const char*>(&length), sizeof(length)));
+
+    auto addRange = [&](qint64 offset, qint64 bytes) {
+        if (bytes > 0 && file.seek(offset)) {
+            hash.addData(file.read(bytes));
+        }
+    };
+
+    const qint64 payload = end - begin;
+    if (payload <= SAMPLE_BYTES * 3) {
+        addRange(begin, payload);
+    } else {
+        addRange(begin, SAMPLE_BYTES);
+        addRange(begin + (payload - SAMPLE_BYTES) / 2, SAMPLE_BYTES);
+        addRange(end - SAMPLE_BYTES, SAMPLE_BYTES);
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString TranscriptCache::fingerprint(const QString& audioFilePath)
+{
+    const QFileInfo fileInfo(audioFilePath);
+    if (!fileInfo.exists()) {
+        return QString();
+    }
+
+    const QString path = fileInfo.absoluteFilePath();
+    const qint64 size = fileInfo.size();
+    const qint64 modified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    auto it = fingerprints.constFind(path);
+    if (it != fingerprints.constEnd() && it->size == size && it->modified == modified) {
+        return it->fingerprint;
+    }
+
+    const QString result = computeFingerprint(path);
+    if (!result.isEmpty()) {
+        fingerprints.insert(path, FingerprintEntry{ size, modified, result });
+    }
+    return result;
+}
+
+QString TranscriptCache::lookup(const QString& fingerprint, const QString& model) const
+{
+    if (fingerprint.isEmpty()) {
+        return QString();
+    }
+    const QString path = transcriptPath(fingerprint, model);
+    return QFile::exists(path) ? path : QString();
+}
+
+QString TranscriptCache::pendingPath(const QString& fingerprint, const QString& model) const
+{
+    const QString path = transcriptPath(fingerprint, model);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    // 保留 .srt 副檔名，轉錄工具依副檔名決定輸出格式
+    return transcriptPath(fingerprint, model, ".part.srt");
+}
+
+QString TranscriptCache::commit(const QString& fingerprint, const QString& model) const
+{
+    const QString path = transcriptPath(fingerprint, model);
+    const QString pending = transcriptPath(fingerprint, model, ".part.srt");
+    if (!QFile::exists(pending)) {
+        return QString();
+    }
+
+    // 同一首曲目可能已由其他轉錄完成，以新的結果取代
+    QFile::remove(path);
+    if (!QFile::rename(pending, path)) {
+        return QString();
+    }
+    return path;
+}
+
+void TranscriptCache::discard(const QString& fingerprint, const QString& model) const
+{
+    QFile::remove(transcriptPath(fingerprint, model, ".part.srt"));
+}
+
+QString TranscriptCache::transcriptPath(const QString& fingerprint, const QString& model,
+                                       const QString& suffix) const
+{
+    return QDir(directory).filePath(fingerprint.left(2) + "/" + fingerprint + "." +
+                                    sanitizeModelName(model) + suffix);
+}
@@ -0,0 +1,65 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef TRANSCRIPTCACHE_H
+#define TRANSCRIPTCACHE_H
+
+// 引入 Qt 字串類別
+#include <QString>
+// 引入 Qt 雜湊表類別
+#include <QHash>
+
+// 以音訊內容為鍵值的字幕快取
+//
+// 字幕存放在應用程式資料目錄下的 transcripts/，檔名由音訊指紋與轉錄模型名稱組成：
+//   transcripts/<指紋前兩碼>/<指紋>.<模型>.srt
+// 指紋只取決於音訊內容，與檔名和所在位置無關，因此檔案改名、搬移、
+// 出現在不同播放清單，或位於唯讀的媒體上，都能直接取得之前的轉錄結果。
+//
+// 轉錄程序先寫入 pendingPath() 的暫存檔，成功後以 commit() 改名為正式檔案，
+// 中途失敗或被取消的轉錄不會留下不完整的字幕。
+class TranscriptCache
+{
+public:
+    // 建構函式，directory 為快取根目錄
+    explicit TranscriptCache(const QString& directory);
+
+    // 計算音訊檔案的內容指紋（十六進位字串），無法讀取時回傳空字串
+    //
+    // 只取音訊資料的長度與開頭、中間、結尾各 64 KiB 計算 SHA-1，與檔案大小無關地只需讀取固定的資料量。
+    // 音訊資料的範圍排除下列標籤，修改這些標籤不會改變指紋：
+    //   - MP3：檔頭的 ID3v2 與檔尾的 ID3v1
+    //   - FLAC：所有 metadata block（Vorbis comment、封面、padding 等）
+    //   - MP4/M4A：只取 mdat box，標籤所在的 moov box 大小改變也不影響
+    // 其他格式（例如 Ogg/Opus 的標籤位於頁面結構中）以整個檔案計算，修改標籤會使快取失效。
+    static QString computeFingerprint(const QString& audioFilePath);
+
+    // 取得音訊檔案的指紋；路徑、大小與修改時間都沒變時直接使用上次的結果
+    QString fingerprint(const QString& audioFilePath);
+    // 查詢快取中的字幕，不存在時回傳空字串
+    QString lookup(const QString& fingerprint, const QString& model) const;
+    // 轉錄程序輸出用的暫存檔路徑（會先建立所需的子目錄）
+    QString pendingPath(const QString& fingerprint, const QString& model) const;
+    // 將暫存檔改名為正式的快取檔案，回傳快取檔案路徑，失敗時回傳空字串
+    QString commit(const QString& fingerprint, const QString& model) const;
+    // 刪除尚未完成的暫存檔
+    void discard(const QString& fingerprint, const QString& model) const;
+
+private:
+    // 快取檔案的路徑，suffix 為 ".srt"（正式檔案）或 ".part.srt"（暫存檔）
+    QString transcriptPath(const QString& fingerprint, const QString& model,
+                           const QString& suffix = ".srt") const;
+
+    // 已計算過的指紋，用於避免重複讀取檔案
+    struct FingerprintEntry {
+        qint64 size;
+        qint64 modified;
+        QString fingerprint;
+    };
+
+    // 快取根目錄
+    QString directory;
+    // 絕對路徑 → 指紋
+    QHash<QString, FingerprintEntry> fingerprints;
+};
+
+// 結束標頭檔保護宏
+#endif // TRANSCRIPTCACHE_H
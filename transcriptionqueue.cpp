@@ -0,0 +1,429 @@
+// 引入背景轉錄排程器標頭檔
+#include "transcriptionqueue.h"
+// 引入字幕解析器（解析分段輸出）
+#include "subtitleparser.h"
+
+TranscriptionQueue::TranscriptionQueue(TranscriptCache* cache, const QString& model, QObject* parent)
+    : QObject(parent)
+    , cache(cache)
+    , model(model)
+    , server(nullptr)
+    , workerLimit(1)
+{
+}
+
+TranscriptionQueue::~TranscriptionQueue()
+{
+    // 程式結束時不再發出信號，直接中止所有轉錄程序並清除暫存檔
+    const QList<Job> jobs = running + stopping;
+    for (const Job& job : jobs) {
+        if (job.process) {
+            disconnect(job.process, nullptr, this, nullptr);
+            job.process->kill();
+            job.process->waitForFinished(1000);
+        }
+        cache->discard(job.fingerprint, job.model);
+    }
+}
+
+void TranscriptionQueue::setMaxWorkers(int count)
+{
+    workerLimit = qMax(1, count);
+    startPendingJobs();
+}
+
+int TranscriptionQueue::maxWorkers() const
+{
+    return workerLimit;
+}
+
+void TranscriptionQueue::setServer(WhisperServer* whisperServer)
+{
+    if (server) {
+        disconnect(server, nullptr, this, nullptr);
+    }
+    server = whisperServer;
+    if (!server) {
+        return;
+    }
+
+    connect(server, &WhisperServer::jobFinished, this, &TranscriptionQueue::onServerJobFinished);
+    connect(server, &WhisperServer::unavailable, this, &TranscriptionQueue::onServerUnavailable);
+    connect(server, &WhisperServer::jobProgress, this, [this](int jobId, const QString& text) {
+        for (const Job& job : running) {
+            if (job.serverJobId == jobId) {
+                for (const QString& path : job.audioFilePaths) {
+                    emit outputReceived(path, text);
+                }
+                break;
+            }
+        }
+    });
+    connect(server, &WhisperServer::jobSegment, this,
+            [this](int jobId, qint64 startMs, qint64 endMs, const QString& text) {
+        for (const Job& job : running) {
+            if (job.serverJobId == jobId) {
+                for (const QString& path : job.audioFilePaths) {
+                    emit segmentReceived(path, startMs, endMs, text);
+                }
+                break;
+            }
+        }
+    });
+}
+
+QString TranscriptionQueue::lookup(const QString& audioFilePath)
+{
+    return lookupFingerprint(cache->fingerprint(audioFilePath));
+}
+
+void TranscriptionQueue::setPriorities(const QStringList& audioFilePaths)
+{
+    wanted.clear();
+    pending.clear();
+    for (const QString& path : audioFilePaths) {
+        if (path.isEmpty() || wanted.contains(path)) {
+            continue;
+        }
+        wanted.append(path);
+        if (isRunning(path)) {
+            continue;
+        }
+        // 已經轉錄過的檔案不需要排入佇列
+        if (!lookup(path).isEmpty()) {
+            continue;
+        }
+        pending.append(path);
+    }
+
+    preemptUnwantedJobs();
+    startPendingJobs();
+}
+
+bool TranscriptionQueue::isRunning(const QString& audioFilePath) const
+{
+    for (const Job& job : running) {
+        if (job.audioFilePaths.contains(audioFilePath)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString TranscriptionQueue::engineName(const QString& audioFilePath) const
+{
+    for (const Job& job : running) {
+        if (job.audioFilePaths.contains(audioFilePath)) {
+            return job.process ? QString("Vibe") : QString("Whisper");
+        }
+    }
+    return usesServer() ? QString("Whisper") : QString("Vibe");
+}
+
+bool TranscriptionQueue::usesServer() const
+{
+    return server && server->isAvailable();
+}
+
+int TranscriptionQueue::freeSlots() const
+{
+    // 常駐服務一次只轉錄一個工作；一次性程序受 maxWorkers() 限制
+    int serverJobs = 0;
+    for (const Job& job : running) {
+        if (!job.process) {
+            serverJobs++;
+        }
+    }
+    if (usesServer()) {
+        return serverJobs == 0 ? 1 : 0;
+    }
+    return workerLimit - (running.size() - serverJobs);
+}
+
+QString TranscriptionQueue::lookupFingerprint(const QString& fingerprint) const
+{
+    if (fingerprint.isEmpty()) {
+        return QString();
+    }
+    if (server) {
+        const QString srtFilePath = cache->lookup(fingerprint, server->model());
+        if (!srtFilePath.isEmpty()) {
+            return srtFilePath;
+        }
+    }
+    return cache->lookup(fingerprint, model);
+}
+
+void TranscriptionQueue::startPendingJobs()
+{
+    while (freeSlots() > 0 && !pending.isEmpty()) {
+        const QString path = pending.takeFirst();
+        const QString fingerprint = cache->fingerprint(path);
+        if (fingerprint.isEmpty()) {
+            emit transcriptFailed(path, "無法讀取音訊檔案", QString());
+            continue;
+        }
+
+        // 轉錄期間快取可能已由其他工作寫入
+        const QString cachedSrtPath = lookupFingerprint(fingerprint);
+        if (!cachedSrtPath.isEmpty()) {
+            emit transcriptReady(path, cachedSrtPath);
+            continue;
+        }
+
+        // 內容相同的另一個檔案正在轉錄，完成時一併通知，不重複執行
+        bool merged = false;
+        for (Job& job : running) {
+            if (job.fingerprint == fingerprint) {
+                job.audioFilePaths.append(path);
+                merged = true;
+                break;
+            }
+        }
+        if (merged) {
+            continue;
+        }
+
+        if (usesServer()) {
+            startServerJob(path, fingerprint);
+        } else {
+            startProcessJob(path, fingerprint);
+        }
+    }
+}
+
+void TranscriptionQueue::startProcessJob(const QString& path, const QString& fingerprint)
+{
+    QProcess* process = new QProcess(this);
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
+        onProcessFinished(process, exitCode, exitStatus);
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error) {
+        onProcessError(process, error);
+    });
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, process]() {
+        readProcessOutput(process, false);
+    });
+
+    running.append(Job{ QStringList{ path }, fingerprint, model, process, -1 });
+    emit transcriptionStarted(path);
+
+    // vibe <audioFilePath> --output <output.srt>
+    QStringList arguments;
+    arguments << path << "--output" << cache->pendingPath(fingerprint, model);
+    process->start("vibe", arguments);
+}
+
+void TranscriptionQueue::startServerJob(const QString& path, const QString& fingerprint)
+{
+    const QString serverModel = server->model();
+    const int jobId = server->submit(path, cache->pendingPath(fingerprint, serverModel));
+    running.append(Job{ QStringList{ path }, fingerprint, serverModel, nullptr, jobId });
+    emit transcriptionStarted(path);
+}
+
+void TranscriptionQueue::preemptUnwantedJobs()
+{
+    int needed = pending.size() - freeSlots();
+    for (int i = running.size() - 1; i >= 0 && needed > 0; i--) {
+        bool isWanted = false;
+        for (const QString& path : running[i].audioFilePaths) {
+            if (wanted.contains(path)) {
+                isWanted = true;
+                break;
+            }
+        }
+        if (isWanted) {
+            continue;
+        }
+
+        // 只送出中止要求，程序或服務工作結束後才清理
+        Job job = running.takeAt(i);
+        if (job.process) {
+            job.process->kill();
+        } else {
+            server->cancel(job.serverJobId);
+        }
+        stopping.append(job);
+        needed--;
+    }
+}
+
+void TranscriptionQueue::onProcessFinished(QProcess* process, int exitCode, QProcess::ExitStatus exitStatus)
+{
+    // 先處理最後一段輸出（可能沒有換行結尾）
+    readProcessOutput(process, true);
+
+    bool wasRunning = false;
+    const Job job = takeJob(process, -1, &wasRunning);
+    process->deleteLater();
+
+    if (!wasRunning) {
+        // 被中止的工作
+        discardPending(job.fingerprint, job.model);
+        return;
+    }
+
+    if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+        const QString srtFilePath = cache->commit(job.fingerprint, job.model);
+        for (const QString& path : job.audioFilePaths) {
+            if (srtFilePath.isEmpty()) {
+                emit transcriptFailed(path, "找不到 Vibe 輸出的字幕檔案", QString());
+            } else {
+                emit transcriptReady(path, srtFilePath);
+            }
+        }
+    } else {
+        discardPending(job.fingerprint, job.model);
+        const QString message = exitStatus == QProcess::CrashExit
+            ? QString("Vibe 轉錄處理程序異常終止")
+            : QString("Vibe 轉錄處理程序結束，退出碼: %1").arg(exitCode);
+        const QString errorOutput = QString::fromUtf8(process->readAllStandardError());
+        for (const QString& path : job.audioFilePaths) {
+            emit transcriptFailed(path, message, errorOutput);
+        }
+    }
+
+    startPendingJobs();
+}
+
+void TranscriptionQueue::onProcessError(QProcess* process, QProcess::ProcessError error)
+{
+    // 其他錯誤之後仍會收到 finished()，只有無法啟動時需要在這裡清理
+    if (error != QProcess::FailedToStart) {
+        return;
+    }
+
+    bool wasRunning = false;
+    const Job job = takeJob(process, -1, &wasRunning);
+    process->deleteLater();
+    discardPending(job.fingerprint, job.model);
+
+    if (wasRunning) {
+        for (const QString& path : job.audioFilePaths) {
+            emit transcriptFailed(path, "無法啟動 Vibe CLI", QString());
+        }
+    }
+
+    // 可能在 start() 內同步發生，延後啟動下一個工作以免重入
+    QMetaObject::invokeMethod(this, [this]() { startPendingJobs(); }, Qt::QueuedConnection);
+}
+
+void TranscriptionQueue::readProcessOutput(QProcess* process, bool flush)
+{
+    // 被中止的工作不再轉發輸出
+    QStringList audioFilePaths;
+    for (const Job& job : running) {
+        if (job.process == process) {
+            audioFilePaths = job.audioFilePaths;
+            break;
+        }
+    }
+
+    // 只取完整的行，不完整的行留在程序的緩衝區等下一次讀取，避免一行被拆成兩則訊息
+    while (process->canReadLine() || (flush && process->bytesAvailable() > 0)) {
+        const QString line = QString::fromUtf8(process->readLine()).trimmed();
+        if (audioFilePaths.isEmpty() || line.isEmpty()) {
+            continue;
+        }
+
+        // 「[開始s - 結束s] 文字」為轉錄出的分段，其他為進度訊息
+        qint64 startMs = 0;
+        qint64 endMs = 0;
+        QStringView text;
+        const bool isSegment = SubtitleParser::parseSegmentLine(line, &startMs, &endMs, &text);
+        for (const QString& path : audioFilePaths) {
+            if (isSegment) {
+                emit segmentReceived(path, startMs, endMs, text.toString());
+            } else {
+                emit outputReceived(path, line);
+            }
+        }
+    }
+}
+
+void TranscriptionQueue::onServerJobFinished(int jobId, bool ok, const QString& message)
+{
+    bool wasRunning = false;
+    const Job job = takeJob(nullptr, jobId, &wasRunning);
+    if (job.fingerprint.isEmpty()) {
+        return;
+    }
+
+    if (!wasRunning) {
+        // 被中止的工作
+        discardPending(job.fingerprint, job.model);
+    } else if (ok) {
+        const QString srtFilePath = cache->commit(job.fingerprint, job.model);
+        for (const QString& path : job.audioFilePaths) {
+            if (srtFilePath.isEmpty()) {
+                emit transcriptFailed(path, "找不到 Whisper 輸出的字幕檔案", QString());
+            } else {
+                emit transcriptReady(path, srtFilePath);
+            }
+        }
+    } else {
+        discardPending(job.fingerprint, job.model);
+        for (const QString& path : job.audioFilePaths) {
+            emit transcriptFailed(path, message, QString());
+        }
+    }
+
+    startPendingJobs();
+}
+
+void TranscriptionQueue::onServerUnavailable()
+{
+    // 服務已清除所有工作，不會再回報結果；執行中的工作依原順序排回等待清單最前面
+    QStringList requeued;
+    for (int i = running.size() - 1; i >= 0; i--) {
+        if (running[i].process) {
+            continue;
+        }
+        const Job job = running.takeAt(i);
+        cache->discard(job.fingerprint, job.model);
+        requeued = job.audioFilePaths + requeued;
+    }
+    for (int i = stopping.size() - 1; i >= 0; i--) {
+        if (!stopping[i].process) {
+            const Job job = stopping.takeAt(i);
+            cache->discard(job.fingerprint, job.model);
+        }
+    }
+    pending = requeued + pending;
+
+    startPendingJobs();
+}
+
+TranscriptionQueue::Job TranscriptionQueue::takeJob(QProcess* process, int serverJobId, bool* wasRunning)
+{
+    for (int i = 0; i < running.size(); i++) {
+        if (running[i].process == process && running[i].serverJobId == serverJobId) {
+            *wasRunning = true;
+            return running.takeAt(i);
+        }
+    }
+    for (int i = 0; i < stopping.size(); i++) {
+        if (stopping[i].process == process && stopping[i].serverJobId == serverJobId) {
+            *wasRunning = false;
+            return stopping.takeAt(i);
+        }
+    }
+    *wasRunning = false;
+    return Job{ QStringList(), QString(), QString(), process, serverJobId };
+}
+
+void TranscriptionQueue::discardPending(const QString& fingerprint, const QString& jobModel)
+{
+    if (fingerprint.isEmpty()) {
+        return;
+    }
+    // 同一內容已重新排入並正在轉錄時，暫存檔屬於新的工作
+    for (const Job& job : running) {
+        if (job.fingerprint == fingerprint && job.model == jobModel) {
+            return;
+        }
+    }
+    cache->discard(fingerprint, jobModel);
+}
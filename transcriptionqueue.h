@@ -0,0 +1,133 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef TRANSCRIPTIONQUEUE_H
+#define TRANSCRIPTIONQUEUE_H
+
+// 引入以音訊內容為鍵值的字幕快取
+#include "transcriptcache.h"
+// 引入常駐轉錄服務
+#include "whisperserver.h"
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt 外部程序類別
+#include <QProcess>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 背景轉錄排程器
+//
+// 最多同時執行 maxWorkers() 個 Vibe 轉錄程序，等待中的工作依 setPriorities()
+// 給定的順序啟動：第一個通常是正在播放的曲目，其後是即將播放的曲目。
+// 切換曲目時只需以新的順序呼叫 setPriorities()：
+//   - 已在執行的工作會繼續完成，不會浪費已經轉錄的部分
+//   - 只有在沒有空閒名額、而更優先的曲目正在等待時，才中止不再需要的工作
+//   - 中止只對程序送出 kill()、對常駐服務送出取消要求，不等待結束，GUI 執行緒不會被阻塞；
+//     常駐服務與載入的模型不會因此重新啟動
+// 轉錄結果寫入 TranscriptCache 後以 transcriptReady() 通知，附上音訊檔案路徑，
+// 由接收端決定字幕要顯示在哪一首曲目。轉錄途中的分段以 segmentReceived() 逐一通知。
+//
+// 以 setServer() 設定常駐轉錄服務後，服務可用時工作一律交給服務依序轉錄，
+// 不再為每首曲目啟動程序與載入模型；服務無法使用時，已交給服務的工作重新排入，
+// 改用一次性的 Vibe 程序。
+class TranscriptionQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 建構函式，cache 為存放轉錄結果的字幕快取，model 為快取鍵值中的模型名稱
+    TranscriptionQueue(TranscriptCache* cache, const QString& model, QObject* parent = nullptr);
+    // 解構函式，中止所有轉錄程序
+    ~TranscriptionQueue() override;
+
+    // 設定同時執行的轉錄程序數量上限（至少為 1）
+    void setMaxWorkers(int count);
+    // 同時執行的轉錄程序數量上限
+    int maxWorkers() const;
+    // 設定常駐轉錄服務（不取得擁有權），nullptr 表示只使用一次性程序
+    void setServer(WhisperServer* server);
+
+    // 查詢快取中的字幕（常駐服務與一次性程序的結果皆可），不存在時回傳空字串
+    QString lookup(const QString& audioFilePath);
+
+    // 以新的優先順序取代所有等待中的工作，越前面越優先；已有快取的檔案會被略過
+    void setPriorities(const QStringList& audioFilePaths);
+    // 指定的檔案是否正在轉錄
+    bool isRunning(const QString& audioFilePath) const;
+    // 轉錄指定檔案的工具名稱：正在轉錄時為執行該工作的工具，否則為接下來會使用的工具
+    QString engineName(const QString& audioFilePath) const;
+
+signals:
+    // 轉錄程序已啟動
+    void transcriptionStarted(const QString& audioFilePath);
+    // 轉錄程序輸出的進度訊息（一次一行）
+    void outputReceived(const QString& audioFilePath, const QString& text);
+    // 轉錄出一個字幕分段（時間為毫秒），轉錄完成前即可顯示
+    void segmentReceived(const QString& audioFilePath, qint64 startMs, qint64 endMs, const QString& text);
+    // 轉錄完成，srtFilePath 為快取中的字幕檔案
+    void transcriptReady(const QString& audioFilePath, const QString& srtFilePath);
+    // 轉錄失敗，errorOutput 為轉錄程序的錯誤輸出
+    void transcriptFailed(const QString& audioFilePath, const QString& message, const QString& errorOutput);
+
+private:
+    // 一個轉錄工作（內容相同的多個檔案共用一個工作）
+    //
+    // 由一次性程序執行時 process 不為 nullptr；交給常駐服務時 serverJobId 為服務的工作編號。
+    struct Job {
+        QStringList audioFilePaths;
+        QString fingerprint;
+        QString model;
+        QProcess* process;
+        int serverJobId;
+    };
+
+    // 是否使用常駐服務轉錄
+    bool usesServer() const;
+    // 目前可以再啟動的工作數
+    int freeSlots() const;
+    // 依指紋查詢快取中的字幕
+    QString lookupFingerprint(const QString& fingerprint) const;
+    // 在名額內依序啟動等待中的工作
+    void startPendingJobs();
+    // 以一次性的 Vibe 程序轉錄
+    void startProcessJob(const QString& path, const QString& fingerprint);
+    // 交給常駐服務轉錄
+    void startServerJob(const QString& path, const QString& fingerprint);
+    // 中止不在優先清單中的執行中工作，為等待中的工作騰出名額
+    void preemptUnwantedJobs();
+    // 轉錄程序結束的處理
+    void onProcessFinished(QProcess* process, int exitCode, QProcess::ExitStatus exitStatus);
+    // 轉錄程序無法啟動的處理
+    void onProcessError(QProcess* process, QProcess::ProcessError error);
+    // 逐行讀取轉錄程序的輸出，flush 為 true 時連同最後不完整的一行
+    void readProcessOutput(QProcess* process, bool flush);
+    // 常駐服務工作結束的處理
+    void onServerJobFinished(int jobId, bool ok, const QString& message);
+    // 常駐服務無法使用的處理：已交給服務的工作重新排入
+    void onServerUnavailable();
+    // 從執行中或中止中的清單移除工作（以程序或服務工作編號比對），回傳該工作
+    Job takeJob(QProcess* process, int serverJobId, bool* wasRunning);
+    // 刪除暫存檔（沒有其他工作正在寫入同一個檔案時）
+    void discardPending(const QString& fingerprint, const QString& jobModel);
+
+    // 字幕快取
+    TranscriptCache* cache;
+    // 一次性程序的模型名稱
+    QString model;
+    // 常駐轉錄服務，沒有時為 nullptr
+    WhisperServer* server;
+    // 同時執行的轉錄程序數量上限
+    int workerLimit;
+    // 優先清單（第一個最優先）
+    QStringList wanted;
+    // 等待中的檔案，依優先順序排列
+    QStringList pending;
+    // 執行中的工作
+    QList<Job> running;
+    // 已送出 kill() 或取消要求、等待結束的工作（不佔名額）
+    QList<Job> stopping;
+};
+
+// 結束標頭檔保護宏
+#endif // TRANSCRIPTIONQUEUE_H
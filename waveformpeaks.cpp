@@ -0,0 +1,364 @@
+// 引入波形峰值標頭檔
+#include "waveformpeaks.h"
+// 引入以音訊內容為鍵值的快取（檔案指紋）
+#include "transcriptcache.h"
+
+// 引入 Qt 檔案處理類別
+#include <QFile>
+// 引入 Qt 原子性存檔類別
+#include <QSaveFile>
+// 引入 Qt 檔案資訊類別
+#include <QFileInfo>
+// 引入 Qt 目錄處理類別
+#include <QDir>
+// 引入 C 字串函式（memcmp/memcpy）
+#include <cstring>
+// 引入 C++ 數學函式
+#include <cmath>
+
+// 依編譯目標選擇 SIMD 指令集
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WAVEFORM_USE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define WAVEFORM_USE_NEON
+#endif
+
+namespace {
+    // 檔案開頭的魔術字
+    const char PEAKS_MAGIC[8] = { 'L', 'R', 'W', 'A', 'V', 'P', 'K', 'S' };
+    // 格式版本，結構變更時遞增
+    const quint32 PEAKS_VERSION = 1;
+    // 位元組順序標記，與本機不符時視為損毀
+    const quint32 BYTE_ORDER_MARK = 0x01020304;
+
+    // 檔頭
+    struct PeaksHeader {
+        char magic[8];
+        quint32 version;
+        quint32 byteOrderMark;
+        quint32 sampleRate;
+        quint32 levelCount;
+        qint64 frameCount;
+    };
+
+    // 層級表的一項，峰值資料依層級順序緊接在層級表之後
+    struct LevelEntry {
+        qint64 framesPerPeak;
+        quint32 peakCount;
+        quint32 reserved;
+    };
+
+    // 將 -1.0 ~ 1.0 的樣本值量化為 qint8，最小值向下、最大值向上取整，細小的起伏不會消失
+    qint8 quantizeMinimum(float value)
+    {
+        return static_cast<qint8>(qBound(-127.0f, std::floor(value * 127.0f), 127.0f));
+    }
+
+    qint8 quantizeMaximum(float value)
+    {
+        return static_cast<qint8>(qBound(-127.0f, std::ceil(value * 127.0f), 127.0f));
+    }
+}
+
+bool WaveformPeaks::isEmpty() const
+{
+    return levelList.isEmpty() || levelList.first().count() == 0;
+}
+
+int WaveformPeaks::sampleRate() const
+{
+    return rate;
+}
+
+qint64 WaveformPeaks::frameCount() const
+{
+    return frames;
+}
+
+const QList<WaveformPeaks::Level>& WaveformPeaks::levels() const
+{
+    return levelList;
+}
+
+const WaveformPeaks::Level& WaveformPeaks::levelFor(int columns) const
+{
+    for (int i = levelList.size() - 1; i > 0; i--) {
+        if (levelList[i].count() >= columns) {
+            return levelList[i];
+        }
+    }
+    return levelList.first();
+}
+
+void WaveformPeaks::clear()
+{
+    rate = 0;
+    frames = 0;
+    levelList.clear();
+}
+
+QString WaveformPeaks::cachePath(const QString& directory, const QString& fingerprint)
+{
+    const QString path = QDir(directory).filePath(fingerprint.left(2) + "/" + fingerprint + ".peaks");
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    return path;
+}
+
+bool WaveformPeaks::load(const QString& path)
+{
+    clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    if (data.size() < static_cast<qsizetype>(sizeof(PeaksHeader))) {
+        return false;
+    }
+
+    PeaksHeader header;
+    memcpy(&header, data.constData(), sizeof(PeaksHeader));
+    if (memcmp(header.magic, PEAKS_MAGIC, sizeof(PEAKS_MAGIC)) != 0 ||
+        header.version != PEAKS_VERSION ||
+        header.byteOrderMark != BYTE_ORDER_MARK ||
+        header.levelCount == 0) {
+        return false;
+    }
+
+    // 驗證層級表與峰值資料都落在檔案範圍內
+    qint64 offset = sizeof(PeaksHeader);
+    const qint64 tableEnd = offset + qint64(header.levelCount) * qint64(sizeof(LevelEntry));
+    if (tableEnd > data.size()) {
+        return false;
+    }
+    qint64 dataOffset = tableEnd;
+    QList<Level> loaded;
+    for (quint32 i = 0; i < header.levelCount; i++) {
+        LevelEntry entry;
+        memcpy(&entry, data.constData() + offset, sizeof(LevelEntry));
+        offset += sizeof(LevelEntry);
+
+        const qint64 length = qint64(entry.peakCount) * 2;
+        if (entry.framesPerPeak <= 0 || dataOffset + length > data.size()) {
+            return false;
+        }
+        loaded.append(Level{ entry.framesPerPeak, data.mid(dataOffset, length) });
+        dataOffset += length;
+    }
+
+    rate = static_cast<int>(header.sampleRate);
+    frames = header.frameCount;
+    levelList = loaded;
+    return true;
+}
+
+bool WaveformPeaks::save(const QString& path) const
+{
+    PeaksHeader header;
+    memcpy(header.magic, PEAKS_MAGIC, sizeof(PEAKS_MAGIC));
+    header.version = PEAKS_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.sampleRate = static_cast<quint32>(rate);
+    header.levelCount = static_cast<quint32>(levelList.size());
+    header.frameCount = frames;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(PeaksHeader));
+    for (const Level& level : levelList) {
+        LevelEntry entry;
+        entry.framesPerPeak = level.framesPerPeak;
+        entry.peakCount = static_cast<quint32>(level.count());
+        entry.reserved = 0;
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(LevelEntry));
+    }
+    for (const Level& level : levelList) {
+        file.write(level.peaks);
+    }
+    return file.commit();
+}
+
+void WaveformPeaks::minMax(const float* samples, qsizetype count, float* minimum, float* maximum)
+{
+    float low = *minimum;
+    float high = *maximum;
+    qsizetype i = 0;
+
+#if defined(WAVEFORM_USE_SSE2)
+    if (count >= 16) {
+        // 四組暫存器各自比較，減少相鄰指令之間的相依
+        __m128 low0 = _mm_set1_ps(low), low1 = low0, low2 = low0, low3 = low0;
+        __m128 high0 = _mm_set1_ps(high), high1 = high0, high2 = high0, high3 = high0;
+        for (; i + 16 <= count; i += 16) {
+            const __m128 a = _mm_loadu_ps(samples + i);
+            const __m128 b = _mm_loadu_ps(samples + i + 4);
+            const __m128 c = _mm_loadu_ps(samples + i + 8);
+            const __m128 d = _mm_loadu_ps(samples + i + 12);
+            low0 = _mm_min_ps(low0, a);
+            low1 = _mm_min_ps(low1, b);
+            low2 = _mm_min_ps(low2, c);
+            low3 = _mm_min_ps(low3, d);
+            high0 = _mm_max_ps(high0, a);
+            high1 = _mm_max_ps(high1, b);
+            high2 = _mm_max_ps(high2, c);
+            high3 = _mm_max_ps(high3, d);
+        }
+        __m128 lows = _mm_min_ps(_mm_min_ps(low0, low1), _mm_min_ps(low2, low3));
+        __m128 highs = _mm_max_ps(_mm_max_ps(high0, high1), _mm_max_ps(high2, high3));
+        // 水平合併四個通道
+        lows = _mm_min_ps(lows, _mm_shuffle_ps(lows, lows, _MM_SHUFFLE(2, 3, 0, 1)));
+        lows = _mm_min_ps(lows, _mm_shuffle_ps(lows, lows, _MM_SHUFFLE(1, 0, 3, 2)));
+        highs = _mm_max_ps(highs, _mm_shuffle_ps(highs, highs, _MM_SHUFFLE(2, 3, 0, 1)));
+        highs = _mm_max_ps(highs, _mm_shuffle_ps(highs, highs, _MM_SHUFFLE(1, 0, 3, 2)));
+        low = _mm_cvtss_f32(lows);
+        high = _mm_cvtss_f32(highs);
+    }
+#elif defined(WAVEFORM_USE_NEON)
+    if (count >= 8) {
+        float32x4_t low0 = vdupq_n_f32(low), low1 = low0;
+        float32x4_t high0 = vdupq_n_f32(high), high1 = high0;
+        for (; i + 8 <= count; i += 8) {
+            const float32x4_t a = vld1q_f32(samples + i);
+            const float32x4_t b = vld1q_f32(samples + i + 4);
+            low0 = vminq_f32(low0, a);
+            low1 = vminq_f32(low1, b);
+            high0 = vmaxq_f32(high0, a);
+            high1 = vmaxq_f32(high1, b);
+        }
+        low = vminvq_f32(vminq_f32(low0, low1));
+        high = vmaxvq_f32(vmaxq_f32(high0, high1));
+    }
+#endif
+
+    // 剩餘的樣本（或沒有 SIMD 指令集時的全部樣本）
+    for (; i < count; i++) {
+        low = qMin(low, samples[i]);
+        high = qMax(high, samples[i]);
+    }
+    *minimum = low;
+    *maximum = high;
+}
+
+void WaveformPeaks::buildLevels()
+{
+    // 每層由上一層每 LEVEL_FACTOR 個峰值合併而成
+    while (!levelList.isEmpty() && levelList.last().count() >= MIN_LEVEL_PEAKS * LEVEL_FACTOR) {
+        const Level& previous = levelList.last();
+        Level level{ previous.framesPerPeak * LEVEL_FACTOR, QByteArray() };
+        const int count = (previous.count() + LEVEL_FACTOR - 1) / LEVEL_FACTOR;
+        level.peaks.resize(count * 2);
+        for (int i = 0; i < count; i++) {
+            qint8 low = 127;
+            qint8 high = -127;
+            const int end = qMin(previous.count(), (i + 1) * LEVEL_FACTOR);
+            for (int j = i * LEVEL_FACTOR; j < end; j++) {
+                low = qMin(low, previous.minimum(j));
+                high = qMax(high, previous.maximum(j));
+            }
+            level.peaks[i * 2] = static_cast<char>(low);
+            level.peaks[i * 2 + 1] = static_cast<char>(high);
+        }
+        levelList.append(level);
+    }
+}
+
+WaveformPeaksPass::WaveformPeaksPass(const QString& outputPath)
+    : outputPath(outputPath)
+    , pendingFrames(0)
+    , pendingMinimum(0.0f)
+    , pendingMaximum(0.0f)
+{
+    result.levelList.append(WaveformPeaks::Level{ WaveformPeaks::FRAMES_PER_PEAK, QByteArray() });
+}
+
+void WaveformPeaksPass::process(const float* samples, qsizetype frames, int sampleRate)
+{
+    result.rate = sampleRate;
+    result.frames += frames;
+
+    // 緩衝區與峰值的邊界不一定對齊，未滿一個峰值的部分留到下一個緩衝區
+    while (frames > 0) {
+        const qint64 take = qMin<qint64>(frames, WaveformPeaks::FRAMES_PER_PEAK - pendingFrames);
+        if (pendingFrames == 0) {
+            pendingMinimum = samples[0];
+            pendingMaximum = samples[0];
+        }
+        WaveformPeaks::minMax(samples, take * AudioAnalyzer::CHANNELS, &pendingMinimum, &pendingMaximum);
+        pendingFrames += take;
+        samples += take * AudioAnalyzer::CHANNELS;
+        frames -= take;
+
+        if (pendingFrames == WaveformPeaks::FRAMES_PER_PEAK) {
+            appendPeak();
+        }
+    }
+}
+
+void WaveformPeaksPass::finish(bool ok)
+{
+    if (!ok) {
+        result.clear();
+        return;
+    }
+    if (pendingFrames > 0) {
+        appendPeak();
+    }
+    result.buildLevels();
+    if (!outputPath.isEmpty() && !result.isEmpty()) {
+        result.save(outputPath);
+    }
+}
+
+const WaveformPeaks& WaveformPeaksPass::peaks() const
+{
+    return result;
+}
+
+void WaveformPeaksPass::appendPeak()
+{
+    QByteArray& peaks = result.levelList.first().peaks;
+    peaks.append(static_cast<char>(quantizeMinimum(pendingMinimum)));
+    peaks.append(static_cast<char>(quantizeMaximum(pendingMaximum)));
+    pendingFrames = 0;
+}
+
+CachedWaveformPass::CachedWaveformPass(const QString& directory)
+    : directory(directory)
+{
+}
+
+bool CachedWaveformPass::prepare(const QString& audioFilePath)
+{
+    const QString fingerprint = TranscriptCache::computeFingerprint(audioFilePath);
+    if (fingerprint.isEmpty()) {
+        return false;
+    }
+    const QString peaksPath = WaveformPeaks::cachePath(directory, fingerprint);
+    if (cached.load(peaksPath)) {
+        return false;
+    }
+    pass.reset(new WaveformPeaksPass(peaksPath));
+    return true;
+}
+
+void CachedWaveformPass::process(const float* samples, qsizetype frames, int sampleRate)
+{
+    pass->process(samples, frames, sampleRate);
+}
+
+void CachedWaveformPass::finish(bool ok)
+{
+    if (pass) {
+        pass->finish(ok);
+    }
+}
+
+const WaveformPeaks& CachedWaveformPass::peaks() const
+{
+    return pass ? pass->peaks() : cached;
+}
@@ -0,0 +1,139 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef WAVEFORMPEAKS_H
+#define WAVEFORMPEAKS_H
+
+// 引入背景音訊分析器（分析步驟介面）
+#include "audioanalyzer.h"
+
+// 引入 Qt 位元組陣列類別
+#include <QByteArray>
+// 引入 Qt 字串類別
+#include <QString>
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 音訊波形的峰值概覽（多層解析度）
+//
+// 每個峰值是一段樣本的最小值與最大值，量化為 qint8（-127 ~ 127）。
+// 第 0 層每 FRAMES_PER_PEAK 個樣本框一個峰值，之後每層合併 LEVEL_FACTOR 個峰值，
+// 直到峰值數少於 MIN_LEVEL_PEAKS；繪製時依寬度選擇最接近的層級，不需要再讀取音訊。
+//
+// 峰值存放在快取目錄下，檔名由音訊指紋組成（見 TranscriptCache::fingerprint）：
+//   <目錄>/<指紋前兩碼>/<指紋>.peaks
+// 檔案為固定的檔頭、層級表，接著依序是各層的峰值資料。
+class WaveformPeaks
+{
+public:
+    // 第 0 層每個峰值涵蓋的樣本框數
+    static const int FRAMES_PER_PEAK = 1024;
+    // 相鄰層級的倍率
+    static const int LEVEL_FACTOR = 4;
+    // 峰值數少於這個數量時不再建立更粗的層級
+    static const int MIN_LEVEL_PEAKS = 512;
+
+    // 一層峰值
+    struct Level {
+        // 每個峰值涵蓋的樣本框數
+        qint64 framesPerPeak;
+        // 交錯的最小值、最大值（qint8）
+        QByteArray peaks;
+
+        // 峰值數
+        int count() const { return peaks.size() / 2; }
+        // 第 index 個峰值的最小值與最大值
+        qint8 minimum(int index) const { return static_cast<qint8>(peaks[index * 2]); }
+        qint8 maximum(int index) const { return static_cast<qint8>(peaks[index * 2 + 1]); }
+    };
+
+    // 是否沒有任何峰值
+    bool isEmpty() const;
+    // 取樣率
+    int sampleRate() const;
+    // 總樣本框數
+    qint64 frameCount() const;
+    // 所有層級（第 0 層最精細）
+    const QList<Level>& levels() const;
+    // 繪製 columns 欄時使用的層級：峰值數不少於欄數的最粗層級，都不夠時使用第 0 層
+    const Level& levelFor(int columns) const;
+    // 清除所有峰值
+    void clear();
+
+    // 指紋對應的峰值檔案路徑（會先建立所需的子目錄）
+    static QString cachePath(const QString& directory, const QString& fingerprint);
+    // 讀取峰值檔案，檔案不存在或損毀時回傳 false
+    bool load(const QString& path);
+    // 寫入峰值檔案
+    bool save(const QString& path) const;
+
+    // 計算樣本的最小值與最大值（以 SIMD 指令平行比較），結果與 *minimum/*maximum 的初始值合併
+    static void minMax(const float* samples, qsizetype count, float* minimum, float* maximum);
+
+private:
+    friend class WaveformPeaksPass;
+
+    // 由第 0 層建立其餘層級
+    void buildLevels();
+
+    // 取樣率
+    int rate = 0;
+    // 總樣本框數
+    qint64 frames = 0;
+    // 各層峰值
+    QList<Level> levelList;
+};
+
+// 計算波形峰值的分析步驟，完成時寫入 outputPath（不為空時）
+class WaveformPeaksPass : public AudioAnalysisPass
+{
+public:
+    // 建構函式
+    explicit WaveformPeaksPass(const QString& outputPath = QString());
+
+    void process(const float* samples, qsizetype frames, int sampleRate) override;
+    void finish(bool ok) override;
+
+    // 計算結果（finish() 之後才完整）
+    const WaveformPeaks& peaks() const;
+
+private:
+    // 將目前累積的峰值加入第 0 層
+    void appendPeak();
+
+    // 完成時寫入的檔案路徑
+    QString outputPath;
+    // 計算結果
+    WaveformPeaks result;
+    // 目前峰值已累積的樣本框數與最小、最大值
+    qint64 pendingFrames;
+    float pendingMinimum;
+    float pendingMaximum;
+};
+
+// 以快取為優先的波形峰值分析步驟
+//
+// prepare() 在分析器的背景執行緒中計算音訊指紋（需要讀取檔案），快取中已有峰值時直接讀取、
+// 不需要樣本；否則與 WaveformPeaksPass 相同地計算，完成時寫入 directory 下的快取。
+class CachedWaveformPass : public AudioAnalysisPass
+{
+public:
+    // 建構函式，directory 為波形峰值快取目錄
+    explicit CachedWaveformPass(const QString& directory);
+
+    bool prepare(const QString& audioFilePath) override;
+    void process(const float* samples, qsizetype frames, int sampleRate) override;
+    void finish(bool ok) override;
+
+    // 讀取或計算的結果（finish() 之後才完整），無法取得指紋或解碼失敗時為空
+    const WaveformPeaks& peaks() const;
+
+private:
+    // 波形峰值快取目錄
+    QString directory;
+    // 從快取讀取的結果
+    WaveformPeaks cached;
+    // 快取中沒有時計算峰值的分析步驟
+    QSharedPointer<WaveformPeaksPass> pass;
+};
+
+// 結束標頭檔保護宏
+#endif // WAVEFORMPEAKS_H
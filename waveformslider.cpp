@@ -0,0 +1,138 @@
+// 引入波形進度條標頭檔
+#include "waveformslider.h"
+
+// 引入 Qt 繪圖類別
+#include <QPainter>
+// 引入 Qt 滑鼠事件類別
+#include <QMouseEvent>
+// 引入 Qt 樣式類別
+#include <QStyle>
+
+WaveformSlider::WaveformSlider(QWidget* parent)
+    : QSlider(Qt::Horizontal, parent)
+{
+}
+
+void WaveformSlider::setPeaks(const WaveformPeaks& newPeaks)
+{
+    peaks = newPeaks;
+    updateColumns();
+    update();
+}
+
+void WaveformSlider::clearPeaks()
+{
+    if (peaks.isEmpty()) {
+        return;
+    }
+    peaks.clear();
+    columnMinimums.clear();
+    columnMaximums.clear();
+    update();
+}
+
+void WaveformSlider::updateColumns()
+{
+    columnMinimums.clear();
+    columnMaximums.clear();
+    const int columns = width();
+    if (peaks.isEmpty() || columns <= 0) {
+        return;
+    }
+
+    // 每欄合併落在該欄範圍內的峰值；峰值比欄數少時，相鄰幾欄共用同一個峰值
+    const WaveformPeaks::Level& level = peaks.levelFor(columns);
+    const int count = level.count();
+    columnMinimums.resize(columns);
+    columnMaximums.resize(columns);
+    for (int x = 0; x < columns; x++) {
+        const int begin = static_cast<int>(qint64(x) * count / columns);
+        const int end = qMax(begin + 1, static_cast<int>(qint64(x + 1) * count / columns));
+        qint8 low = 127;
+        qint8 high = -127;
+        for (int i = begin; i < end && i < count; i++) {
+            low = qMin(low, level.minimum(i));
+            high = qMax(high, level.maximum(i));
+        }
+        columnMinimums[x] = low;
+        columnMaximums[x] = high;
+    }
+}
+
+void WaveformSlider::paintEvent(QPaintEvent* event)
+{
+    if (columnMinimums.isEmpty()) {
+        QSlider::paintEvent(event);
+        return;
+    }
+
+    QPainter painter(this);
+    const int columns = columnMinimums.size();
+    const int centerY = height() / 2;
+    const float scale = (height() / 2 - 1) / 127.0f;
+    const int playedX = maximum() > minimum()
+        ? static_cast<int>(qint64(value() - minimum()) * columns / (maximum() - minimum()))
+        : 0;
+
+    // 已播放與未播放的部分以不同顏色繪製，每欄一條垂直線
+    const QColor playedColor = isEnabled() ? QColor("#1DB954") : QColor("#535353");
+    const QColor remainingColor("#404040");
+    for (int x = 0; x < columns; x++) {
+        painter.setPen(x < playedX ? playedColor : remainingColor);
+        const int top = centerY - qRound(columnMaximums[x] * scale);
+        const int bottom = centerY - qRound(columnMinimums[x] * scale);
+        painter.drawLine(x, top, x, qMax(top, bottom));
+    }
+
+    // 播放位置
+    if (isEnabled()) {
+        painter.setPen(underMouse() || isSliderDown() ? QColor("#FFFFFF") : QColor("#1ED760"));
+        painter.drawLine(playedX, 0, playedX, height() - 1);
+    }
+}
+
+void WaveformSlider::resizeEvent(QResizeEvent* event)
+{
+    QSlider::resizeEvent(event);
+    if (!peaks.isEmpty()) {
+        updateColumns();
+    }
+}
+
+int WaveformSlider::valueAt(int x) const
+{
+    return QStyle::sliderValueFromPosition(minimum(), maximum(), x, width());
+}
+
+void WaveformSlider::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || !isEnabled()) {
+        QSlider::mousePressEvent(event);
+        return;
+    }
+    // 直接跳到點擊的位置，並開始拖動（發出 sliderPressed 與 sliderMoved）
+    setSliderDown(true);
+    setSliderPosition(valueAt(event->position().toPoint().x()));
+    event->accept();
+}
+
+void WaveformSlider::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!isSliderDown()) {
+        QSlider::mouseMoveEvent(event);
+        return;
+    }
+    setSliderPosition(valueAt(event->position().toPoint().x()));
+    event->accept();
+}
+
+void WaveformSlider::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || !isSliderDown()) {
+        QSlider::mouseReleaseEvent(event);
+        return;
+    }
+    setSliderPosition(valueAt(event->position().toPoint().x()));
+    setSliderDown(false);
+    event->accept();
+}
@@ -0,0 +1,53 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef WAVEFORMSLIDER_H
+#define WAVEFORMSLIDER_H
+
+// 引入波形峰值
+#include "waveformpeaks.h"
+
+// 引入 Qt 滑桿元件類別
+#include <QSlider>
+// 引入 Qt 動態陣列類別
+#include <QVector>
+
+// 顯示波形概覽的播放進度條
+//
+// 設定峰值後以每個像素一欄的最小/最大值繪製波形，已播放的部分以綠色標示；
+// 每欄的值只在寬度或峰值改變時重新計算，播放位置改變時只需重繪。
+// 沒有峰值時（尚未分析完成或不是本地檔案）與一般的 QSlider 相同。
+// 點擊或拖動波形任何位置都會直接跳到該位置。
+class WaveformSlider : public QSlider
+{
+    Q_OBJECT
+
+public:
+    // 建構函式
+    explicit WaveformSlider(QWidget* parent = nullptr);
+
+    // 設定要顯示的峰值
+    void setPeaks(const WaveformPeaks& peaks);
+    // 清除峰值，恢復為一般的進度條
+    void clearPeaks();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+private:
+    // 依目前寬度重新計算每欄的最小/最大值
+    void updateColumns();
+    // 橫座標對應的滑桿值
+    int valueAt(int x) const;
+
+    // 顯示中的峰值
+    WaveformPeaks peaks;
+    // 每個像素一欄的最小值與最大值（qint8 範圍）
+    QVector<qint8> columnMinimums;
+    QVector<qint8> columnMaximums;
+};
+
+// 結束標頭檔保護宏
+#endif // WAVEFORMSLIDER_H
@@ -3,12 +3,52 @@
 Whisper 語音轉錄腳本
 此腳本使用 OpenAI Whisper 模型將音頻文件轉錄為文字
 並即時輸出轉錄結果以供 Qt 應用程式讀取
+
+使用 --server 參數時以常駐服務模式執行：模型只載入一次，
+從標準輸入逐行讀取 JSON 工作，並以 JSON 行回報結果（見 run_server）。
+加上 --workers N 時，長音頻會在靜音處切成互相重疊的片段，
+由 N 個工作程序並行轉錄後再接回同一條時間軸（見 ChunkPool）
 """
 
 # 引入 Python 系統相關模組
 import sys
 # 引入 Python 作業系統相關模組
 import os
+# 引入 Python JSON 模組
+import json
+# 引入 Python 正規表達式模組
+import re
+# 引入 Python 子程序模組（呼叫 ffmpeg/ffprobe）
+import subprocess
+# 引入 Python 多程序模組（並行轉錄片段）
+import multiprocessing
+# 引入 Python 執行緒模組（轉錄時仍可讀取取消要求）
+import threading
+# 引入 Python 佇列模組（讀取執行緒交給主迴圈的工作）
+import queue
+
+# 預設使用的 Whisper 模型（使用 base 模型以獲得速度和精度的平衡）
+# 可選模型: tiny, base, small, medium, large
+DEFAULT_MODEL = "base"
+
+# Whisper 模型使用的取樣率
+SAMPLE_RATE = 16000
+# 超過這個長度（秒）的音頻才切成片段並行轉錄
+CHUNK_MIN_DURATION = 900
+# 每個片段的目標長度（秒）
+CHUNK_SECONDS = 600
+# 在目標切點前後這個範圍（秒）內尋找最安靜的位置作為切點
+SILENCE_SEARCH_SECONDS = 30
+# 尋找靜音時計算音量的視窗長度（秒）
+SILENCE_WINDOW_SECONDS = 0.4
+# 片段在切點兩側多轉錄的長度（秒），切點附近的語句不會被截斷
+CHUNK_OVERLAP_SECONDS = 3
+# 並行轉錄時等待片段結果的間隔（秒），期間檢查工作是否被取消
+CANCEL_POLL_SECONDS = 0.5
+
+
+class JobCanceled(Exception):
+    """工作在轉錄途中被取消（在分段或片段之間檢查）"""
 
 def transcribe_audio(audio_file_path):
     """
@@ -38,9 +78,8 @@ def transcribe_audio(audio_file_path):
         # 強制清空輸出緩衝區
         sys.stdout.flush()
         
-        # 載入 Whisper 模型（使用 base 模型以獲得速度和精度的平衡）
-        # 可選模型: tiny, base, small, medium, large
-        model = whisper.load_model("base")
+        # 載入 Whisper 模型
+        model = whisper.load_model(DEFAULT_MODEL)
         
         # 輸出開始轉錄的訊息
         print("開始轉錄...")
@@ -96,12 +135,519 @@ def transcribe_audio(audio_file_path):
         # 強制清空輸出緩衝區
         sys.stdout.flush()
 
+def format_srt_timestamp(seconds):
+    """
+    將秒數格式化為 SRT 時間戳（時:分:秒,毫秒）
+    
+    Args:
+        seconds: 以秒為單位的時間
+    """
+    # 轉換為整數毫秒，避免浮點數誤差
+    total_ms = int(round(seconds * 1000))
+    # 拆分為時、分、秒、毫秒
+    hours, remainder = divmod(total_ms, 3600000)
+    minutes, remainder = divmod(remainder, 60000)
+    secs, ms = divmod(remainder, 1000)
+    # 回傳固定寬度的時間戳字串
+    return f"{hours:02d}:{minutes:02d}:{secs:02d},{ms:03d}"
+
+def write_srt(segments, output_path):
+    """
+    將轉錄分段寫入 SRT 檔案
+    
+    Args:
+        segments: Whisper 回傳的分段清單
+        output_path: 輸出的 SRT 檔案路徑
+    """
+    # 以 UTF-8 編碼開啟輸出檔案
+    with open(output_path, "w", encoding="utf-8") as srt_file:
+        # 依序寫入每個分段（序號從 1 開始）
+        for index, segment in enumerate(segments, start=1):
+            # 寫入序號行
+            srt_file.write(f"{index}\n")
+            # 寫入時間行
+            srt_file.write(f"{format_srt_timestamp(segment['start'])} --> {format_srt_timestamp(segment['end'])}\n")
+            # 寫入文字行與分隔空行
+            srt_file.write(f"{segment['text'].strip()}\n\n")
+
+def parse_clock(text):
+    """
+    將 Whisper 的時間戳（分:秒.毫秒 或 時:分:秒.毫秒）轉換為秒數
+    
+    Args:
+        text: 時間戳字串
+    """
+    # 由右至左依序為秒、分、時
+    seconds = 0.0
+    for part in text.split(":"):
+        seconds = seconds * 60 + float(part)
+    return seconds
+
+class SegmentWriter:
+    """
+    攔截 Whisper 在 verbose=True 時逐段輸出的「[開始 --> 結束] 文字」，
+    每解碼完一段就轉成 segment 事件送出，其他輸出則轉到標準錯誤輸出
+    """
+    
+    # Whisper 分段輸出的格式，例如 [00:01.000 --> 00:04.500] 文字
+    SEGMENT_PATTERN = re.compile(r"^\[((?:\d+:)?\d+:\d+\.\d+) --> ((?:\d+:)?\d+:\d+\.\d+)\]\s*(.*)$")
+    
+    def __init__(self, job_id, send, is_canceled):
+        # 目前工作的編號
+        self.job_id = job_id
+        # 送出協定訊息的函式
+        self.send = send
+        # 查詢工作是否已被取消的函式
+        self.is_canceled = is_canceled
+        # 尚未結束的行
+        self.buffer = ""
+    
+    def write(self, text):
+        # 累積輸出直到遇到換行，再逐行處理
+        self.buffer += text
+        while "\n" in self.buffer:
+            line, self.buffer = self.buffer.split("\n", 1)
+            self.handle_line(line)
+        return len(text)
+    
+    def flush(self):
+        # 其他輸出已直接寫入標準錯誤輸出
+        sys.stderr.flush()
+    
+    def handle_line(self, line):
+        # 分段輸出轉為 segment 事件；每解碼完一段檢查一次是否被取消，
+        # 例外會從 Whisper 的 print 一路傳出 transcribe()
+        match = self.SEGMENT_PATTERN.match(line.strip())
+        if match:
+            if self.is_canceled():
+                raise JobCanceled()
+            self.send({
+                "id": self.job_id,
+                "event": "segment",
+                "start": parse_clock(match.group(1)),
+                "end": parse_clock(match.group(2)),
+                "text": match.group(3).strip(),
+            })
+        elif line.strip():
+            # 其他訊息（例如語言偵測結果）不屬於協定內容
+            print(line, file=sys.stderr)
+
+def probe_duration(audio_file_path):
+    """
+    以 ffprobe 取得音頻長度（秒），無法取得時回傳 None
+    
+    Args:
+        audio_file_path: 音頻文件的完整路徑
+    """
+    try:
+        output = subprocess.run(
+            ["ffprobe", "-v", "error", "-show_entries", "format=duration",
+             "-of", "default=noprint_wrappers=1:nokey=1", audio_file_path],
+            capture_output=True, check=True, text=True).stdout
+        return float(output.strip())
+    except (OSError, ValueError, subprocess.CalledProcessError):
+        return None
+
+def load_audio_range(audio_file_path, start, duration):
+    """
+    以 ffmpeg 只解碼音頻的一段，轉為 Whisper 使用的 16 kHz 單聲道浮點數陣列
+    
+    Args:
+        audio_file_path: 音頻文件的完整路徑
+        start: 開始時間（秒）
+        duration: 長度（秒）
+    """
+    import numpy as np
+    
+    # -ss 放在 -i 之前，ffmpeg 直接跳到開始位置，不必解碼前面的部分
+    command = [
+        "ffmpeg", "-nostdin", "-threads", "0",
+        "-ss", f"{start:.3f}", "-t", f"{duration:.3f}", "-i", audio_file_path,
+        "-f", "s16le", "-ac", "1", "-acodec", "pcm_s16le", "-ar", str(SAMPLE_RATE), "-",
+    ]
+    output = subprocess.run(command, capture_output=True, check=True).stdout
+    return np.frombuffer(output, np.int16).flatten().astype(np.float32) / 32768.0
+
+def find_silence(audio_file_path, target):
+    """
+    在 target 前後 SILENCE_SEARCH_SECONDS 內找出平均音量最低的位置（秒）
+    
+    Args:
+        audio_file_path: 音頻文件的完整路徑
+        target: 目標切點（秒）
+    """
+    import numpy as np
+    
+    start = max(0.0, target - SILENCE_SEARCH_SECONDS)
+    samples = load_audio_range(audio_file_path, start, SILENCE_SEARCH_SECONDS * 2)
+    window = int(SILENCE_WINDOW_SECONDS * SAMPLE_RATE)
+    if len(samples) < window:
+        return target
+    
+    # 以累加和計算每個視窗的平均能量，取能量最低的視窗中心
+    energy = np.concatenate(([0.0], np.cumsum(samples.astype(np.float64) ** 2)))
+    window_energy = energy[window:] - energy[:-window]
+    quietest = int(np.argmin(window_energy))
+    return start + (quietest + window / 2) / SAMPLE_RATE
+
+def plan_chunks(audio_file_path, duration):
+    """
+    規劃片段：回傳 (轉錄開始, 轉錄結束, 保留開始, 保留結束) 清單（秒）
+    
+    相鄰片段的保留範圍在靜音切點相接，轉錄範圍則各自向外多延伸
+    CHUNK_OVERLAP_SECONDS，切點附近的語句在兩個片段中都是完整的。
+    
+    Args:
+        audio_file_path: 音頻文件的完整路徑
+        duration: 音頻長度（秒）
+    """
+    # 切點：每 CHUNK_SECONDS 一個目標位置，移到附近最安靜的地方；最後一段太短時併入前一段
+    cuts = [0.0]
+    target = CHUNK_SECONDS
+    while duration - target > CHUNK_SECONDS / 2:
+        cut = find_silence(audio_file_path, target)
+        if cut > cuts[-1] + SILENCE_SEARCH_SECONDS:
+            cuts.append(cut)
+        target = cuts[-1] + CHUNK_SECONDS
+    cuts.append(duration)
+    
+    chunks = []
+    for keep_start, keep_end in zip(cuts, cuts[1:]):
+        chunks.append((max(0.0, keep_start - CHUNK_OVERLAP_SECONDS),
+                       min(duration, keep_end + CHUNK_OVERLAP_SECONDS),
+                       keep_start, keep_end))
+    return chunks
+
+# 片段工作程序中載入的模型
+_chunk_model = None
+# 片段工作程序共用的「已取消的工作編號」
+_canceled_job = None
+
+class ChunkCancelCheck:
+    """
+    片段工作程序中 Whisper 的 verbose 輸出：每解碼完一段檢查工作是否已被取消，
+    文字本身捨棄（分段由主程序接好後才送出）
+    """
+    
+    def __init__(self, job_id):
+        # 片段所屬的工作編號
+        self.job_id = job_id
+    
+    def write(self, text):
+        if _canceled_job.value == self.job_id:
+            raise JobCanceled()
+        return len(text)
+    
+    def flush(self):
+        pass
+
+def init_chunk_worker(model_name, threads, canceled_job):
+    """
+    片段工作程序的初始化：限制運算執行緒數並載入模型
+    
+    Args:
+        model_name: 要載入的 Whisper 模型名稱
+        threads: 每個工作程序使用的執行緒數
+        canceled_job: 與主程序共用的已取消工作編號（multiprocessing.Value）
+    """
+    global _chunk_model, _canceled_job
+    _canceled_job = canceled_job
+    # 工作程序的輸出不屬於協定內容
+    sys.stdout = sys.stderr
+    import torch
+    import whisper
+    # 多個工作程序共用 CPU，各自只使用分配到的核心
+    torch.set_num_threads(threads)
+    _chunk_model = whisper.load_model(model_name)
+
+def transcribe_chunk(task):
+    """
+    在工作程序中轉錄一個片段，回傳以整個音頻為準的 (開始, 結束, 文字) 清單
+    
+    Args:
+        task: (工作編號, 音頻路徑, 轉錄開始, 轉錄結束, 語言)
+    """
+    job_id, audio_file_path, start, end, language = task
+    if _canceled_job.value == job_id:
+        raise JobCanceled()
+    samples = load_audio_range(audio_file_path, start, end - start)
+    # verbose=True 讓每個分段都經過 ChunkCancelCheck，工作被取消時在下一段結束
+    sys.stdout = ChunkCancelCheck(job_id)
+    try:
+        result = _chunk_model.transcribe(samples, language=language, verbose=True)
+    finally:
+        sys.stdout = sys.stderr
+    # Whisper 的時間以片段開頭為 0，加上片段的開始時間
+    return [(start + segment["start"], start + segment["end"], segment["text"].strip())
+            for segment in result["segments"]]
+
+def stitch_chunk(stitched, segments, keep_start, keep_end):
+    """
+    將一個片段的分段接到時間軸後面，回傳新加入的分段
+    
+    以時間而非文字去除重複：保留範圍在重疊區的中點（靜音切點）相接，分段依其時間中點
+    歸屬其中一個片段，因此切點前的語句取自前一個片段、切點後的取自後一個片段。
+    兩個片段對同一句話的斷句或用字不同時，後一個片段中大半落在前一句時間內的分段
+    視為重複捨去，其餘與前一句重疊的部分從前一句結束處開始。
+    
+    Args:
+        stitched: 已接好的分段清單（會被修改）
+        segments: 片段的 (開始, 結束, 文字) 清單
+        keep_start: 保留範圍的開始（秒）
+        keep_end: 保留範圍的結束（秒）
+    """
+    added = []
+    for start, end, text in segments:
+        middle = (start + end) / 2
+        if not text or middle < keep_start or middle >= keep_end:
+            continue
+        previous = stitched[-1] if stitched else None
+        if previous and start < previous["end"]:
+            if middle < previous["end"]:
+                continue
+            start = previous["end"]
+        segment = {"start": start, "end": end, "text": text}
+        stitched.append(segment)
+        added.append(segment)
+    return added
+
+class ChunkPool:
+    """
+    並行轉錄長音頻的工作程序池
+    
+    每個工作程序各自載入一份模型，第一次需要時才啟動，之後重複使用。
+    """
+    
+    def __init__(self, model_name, workers):
+        # 要載入的模型名稱
+        self.model_name = model_name
+        # 工作程序數
+        self.workers = workers
+        # 工作程序池（第一次使用時建立）
+        self.pool = None
+        # 與工作程序共用的已取消工作編號
+        self.canceled_job = None
+    
+    def transcribe(self, job_id, audio_file_path, language, on_progress, on_segment, is_canceled):
+        """
+        轉錄長音頻；音頻不夠長、無法取得長度或只有一個工作程序時回傳 None，
+        由呼叫端以單一模型轉錄
+        
+        工作被取消時通知工作程序在下一個分段停止，並引發 JobCanceled。
+        
+        Args:
+            job_id: 工作編號
+            audio_file_path: 音頻文件的完整路徑
+            language: 語言代碼
+            on_progress: 回報進度訊息的函式
+            on_segment: 每接好一個分段時呼叫的函式
+            is_canceled: 查詢工作是否已被取消的函式
+        """
+        if self.workers < 2:
+            return None
+        duration = probe_duration(audio_file_path)
+        if duration is None or duration < CHUNK_MIN_DURATION:
+            return None
+        
+        chunks = plan_chunks(audio_file_path, duration)
+        if len(chunks) < 2:
+            return None
+        
+        if self.pool is None:
+            # 使用 spawn 避免在已載入模型的程序中 fork
+            threads = max(1, (os.cpu_count() or 1) // self.workers)
+            context = multiprocessing.get_context("spawn")
+            self.canceled_job = context.Value("q", -1)
+            self.pool = context.Pool(self.workers, initializer=init_chunk_worker,
+                                     initargs=(self.model_name, threads, self.canceled_job))
+        
+        on_progress(f"分成 {len(chunks)} 段，以 {self.workers} 個程序並行轉錄...")
+        tasks = [(job_id, audio_file_path, start, end, language) for start, end, _, _ in chunks]
+        stitched = []
+        # imap 依片段順序回傳結果，但所有片段同時在工作程序中轉錄；
+        # 等待結果時定期檢查取消，被取消時工作程序在下一個分段停止，不需要重新載入模型
+        results = self.pool.imap(transcribe_chunk, tasks)
+        for index in range(len(chunks)):
+            while True:
+                if is_canceled():
+                    self.canceled_job.value = job_id
+                    raise JobCanceled()
+                try:
+                    segments = results.next(CANCEL_POLL_SECONDS)
+                    break
+                except multiprocessing.TimeoutError:
+                    continue
+            _, _, keep_start, keep_end = chunks[index]
+            for segment in stitch_chunk(stitched, segments, keep_start, keep_end):
+                on_segment(segment)
+            on_progress(f"已完成 {index + 1}/{len(chunks)} 段")
+        return stitched
+    
+    def close(self):
+        """結束所有工作程序"""
+        if self.pool is not None:
+            self.pool.terminate()
+            self.pool = None
+
+def run_server(model_name, workers=1):
+    """
+    常駐轉錄服務：載入模型一次後重複處理工作，省去每首曲目重新載入模型的時間
+    
+    協定（每行一個 JSON 物件，UTF-8）：
+      標準輸入  {"id": 1, "audio": "音頻路徑", "output": "SRT 輸出路徑", "language": "zh"}
+                {"cancel": 1}                                         取消排隊中或正在轉錄的工作
+      標準輸出  {"event": "ready", "model": "base"}                     模型載入完成
+                {"id": 1, "event": "progress", "message": "..."}     進度訊息
+                {"id": 1, "event": "segment", "start": 0.0, "end": 2.5, "text": "..."}
+                                                                      每解碼完一段即送出（秒）
+                {"id": 1, "event": "done", "output": "SRT 輸出路徑"}  轉錄完成
+                {"id": 1, "event": "error", "message": "..."}        轉錄失敗
+                {"id": 1, "event": "canceled"}                        工作已取消（不會再有其他事件）
+                {"event": "error", "message": "..."}                 無法啟動（之後結束程式）
+    標準輸入關閉時結束程式。取消要求由讀取執行緒隨時收下，正在轉錄的工作在下一個分段（或片段）
+    結束時停止，服務與載入的模型不受影響；取消要求到達前已完成的工作照常回報 done。
+    
+    workers 大於 1 時，長音頻改由 ChunkPool 切段並行轉錄，segment 事件依時間順序送出。
+    
+    Args:
+        model_name: 要載入的 Whisper 模型名稱
+        workers: 並行轉錄長音頻的工作程序數
+    """
+    # 保留真正的標準輸出作為協定通道，其他函式庫的輸出一律導向標準錯誤輸出
+    protocol = sys.stdout
+    sys.stdout = sys.stderr
+    
+    def send(message):
+        # 每個訊息寫成一行 JSON 並立即送出
+        protocol.write(json.dumps(message, ensure_ascii=False) + "\n")
+        protocol.flush()
+    
+    try:
+        # 嘗試導入 Whisper 模組並載入模型
+        import whisper
+        model = whisper.load_model(model_name)
+    except ImportError:
+        # 未安裝 Whisper 模組，通知呼叫端改用其他轉錄方式
+        send({"event": "error", "message": "未安裝 Whisper 模組 (pip install openai-whisper)"})
+        sys.exit(1)
+    except Exception as e:
+        # 模型載入失敗
+        send({"event": "error", "message": f"無法載入 Whisper 模型: {str(e)}"})
+        sys.exit(1)
+    
+    # 通知呼叫端模型已就緒
+    send({"event": "ready", "model": model_name})
+    chunk_pool = ChunkPool(model_name, workers)
+    
+    # 已取消的工作編號；由讀取執行緒加入，主迴圈在工作開始前與轉錄途中檢查
+    canceled = set()
+    # 讀取執行緒交給主迴圈的工作（None 表示標準輸入已關閉）
+    jobs = queue.Queue()
+    
+    def read_requests():
+        # 逐行讀取要求，直到標準輸入關閉；取消要求立即記下，不必等正在轉錄的工作結束
+        for line in sys.stdin:
+            # 略過空行
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                message = json.loads(line)
+            except ValueError:
+                message = None
+            if isinstance(message, dict) and "cancel" in message:
+                canceled.add(message["cancel"])
+            else:
+                jobs.put(line)
+        jobs.put(None)
+    
+    threading.Thread(target=read_requests, daemon=True).start()
+    
+    # 逐一處理工作，直到標準輸入關閉
+    while True:
+        line = jobs.get()
+        if line is None:
+            break
+        
+        # 解析工作內容
+        try:
+            job = json.loads(line)
+            job_id = job["id"]
+            audio_file_path = job["audio"]
+            output_path = job["output"]
+        except (ValueError, KeyError, TypeError) as e:
+            # 格式錯誤的工作無法回報 id，只輸出到標準錯誤輸出
+            print(f"無效的工作: {line} ({str(e)})", file=sys.stderr)
+            continue
+        
+        # 排隊期間已被取消的工作不必開始
+        if job_id in canceled:
+            canceled.discard(job_id)
+            send({"id": job_id, "event": "canceled"})
+            continue
+        
+        # 檢查音頻文件是否存在
+        if not os.path.exists(audio_file_path):
+            send({"id": job_id, "event": "error", "message": f"找不到音頻文件: {audio_file_path}"})
+            continue
+        
+        try:
+            # 回報開始轉錄
+            send({"id": job_id, "event": "progress", "message": "開始轉錄..."})
+            language = job.get("language", "zh")
+            # 長音頻切段並行轉錄
+            is_canceled = lambda: job_id in canceled
+            segments = chunk_pool.transcribe(
+                job_id, audio_file_path, language,
+                lambda message: send({"id": job_id, "event": "progress", "message": message}),
+                lambda segment: send({"id": job_id, "event": "segment", **segment}),
+                is_canceled)
+            if segments is None:
+                # 轉錄音頻文件，預設語言為中文；verbose=True 讓 Whisper 逐段輸出，
+                # 由 SegmentWriter 轉為 segment 事件，呼叫端不必等整個檔案轉錄完成
+                sys.stdout = SegmentWriter(job_id, send, is_canceled)
+                try:
+                    segments = model.transcribe(audio_file_path, language=language, verbose=True)["segments"]
+                finally:
+                    sys.stdout = sys.stderr
+            # 寫入 SRT 檔案並回報完成
+            write_srt(segments, output_path)
+            send({"id": job_id, "event": "done", "output": output_path})
+        except JobCanceled:
+            # 在分段之間停止，不寫入 SRT 檔案
+            send({"id": job_id, "event": "canceled"})
+        except Exception as e:
+            # 單一工作失敗不影響服務，繼續處理下一個工作
+            send({"id": job_id, "event": "error", "message": f"轉錄時發生錯誤: {str(e)}"})
+        finally:
+            # 完成後才到達的取消要求不再需要
+            canceled.discard(job_id)
+    
+    chunk_pool.close()
+
 def main():
     """主函數，程式進入點"""
+    # 常駐服務模式：whisper_transcribe.py --server [--model 模型名稱] [--workers 程序數]
+    if len(sys.argv) >= 2 and sys.argv[1] == "--server":
+        # 取得指定的模型名稱與工作程序數，未指定時使用預設值
+        model_name = DEFAULT_MODEL
+        workers = 1
+        options = sys.argv[2:]
+        for name, value in zip(options[::2], options[1::2]):
+            if name == "--model":
+                model_name = value
+            elif name == "--workers":
+                workers = max(1, int(value))
+        # 執行常駐服務
+        run_server(model_name, workers)
+        return
+    
     # 檢查命令列參數數量是否少於 2（程式名稱 + 音頻文件路徑）
     if len(sys.argv) < 2:
         # 輸出使用方法說明
         print("使用方法: python3 whisper_transcribe.py <音頻文件路徑>")
+        # 輸出常駐服務模式的使用方法
+        print("          python3 whisper_transcribe.py --server [--model 模型名稱] [--workers 程序數]")
         # 輸出支援的音頻格式清單
         print("\n支援的音頻格式: mp3, wav, flac, m4a, ogg, aac")
         # 以錯誤狀態碼 1 結束程式
@@ -0,0 +1,280 @@
+// 引入常駐轉錄服務標頭檔
+#include "whisperserver.h"
+
+// 引入 Qt JSON 文件類別
+#include <QJsonDocument>
+// 引入 Qt JSON 物件類別
+#include <QJsonObject>
+
+namespace {
+    // 就緒後連續異常結束超過這個次數即視為無法使用
+    const int MAX_CRASH_RESTARTS = 3;
+    // 關閉服務時等待程序結束的時間（毫秒）
+    const int SHUTDOWN_TIMEOUT_MS = 1000;
+}
+
+WhisperServer::WhisperServer(const QString& program, const QStringList& arguments, const QString& model,
+                             QObject* parent)
+    : QObject(parent)
+    , program(program)
+    , arguments(arguments)
+    , modelName(model)
+    , process(nullptr)
+    , currentState(NotRunning)
+    , writtenCount(0)
+    , nextJobId(1)
+    , crashCount(0)
+{
+}
+
+WhisperServer::~WhisperServer()
+{
+    if (!process || process->state() == QProcess::NotRunning) {
+        return;
+    }
+
+    // 程式結束時不再發出信號；關閉標準輸入讓服務自行結束，逾時才強制中止
+    disconnect(process, nullptr, this, nullptr);
+    process->closeWriteChannel();
+    if (!process->waitForFinished(SHUTDOWN_TIMEOUT_MS)) {
+        process->kill();
+        process->waitForFinished(SHUTDOWN_TIMEOUT_MS);
+    }
+}
+
+void WhisperServer::start()
+{
+    if (process && process->state() != QProcess::NotRunning) {
+        return;
+    }
+
+    if (!process) {
+        process = new QProcess(this);
+        connect(process, &QProcess::readyReadStandardOutput, this, &WhisperServer::onReadyRead);
+        connect(process, &QProcess::readyReadStandardError, this, [this]() {
+            const QString text = QString::fromUtf8(process->readAllStandardError()).trimmed();
+            if (!text.isEmpty()) {
+                lastErrorOutput = text;
+            }
+        });
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                this, &WhisperServer::onProcessFinished);
+        connect(process, &QProcess::errorOccurred, this, &WhisperServer::onProcessError);
+    }
+
+    currentState = Starting;
+    readBuffer.clear();
+    lastErrorOutput.clear();
+    writtenCount = 0;
+    process->start(program, arguments);
+}
+
+WhisperServer::State WhisperServer::state() const
+{
+    return currentState;
+}
+
+bool WhisperServer::isAvailable() const
+{
+    return currentState == Starting || currentState == Ready;
+}
+
+QString WhisperServer::model() const
+{
+    return modelName;
+}
+
+int WhisperServer::submit(const QString& audioFilePath, const QString& outputPath)
+{
+    if (!isAvailable()) {
+        return -1;
+    }
+
+    const Request request{ nextJobId++, audioFilePath, outputPath };
+    requests.append(request);
+    if (currentState == Ready) {
+        writeRequest(request);
+        writtenCount++;
+    }
+    return request.id;
+}
+
+void WhisperServer::cancel(int jobId)
+{
+    int index = -1;
+    for (int i = 0; i < requests.size(); i++) {
+        if (requests[i].id == jobId) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        return;
+    }
+
+    if (index >= writtenCount) {
+        // 尚未送出的工作直接移除；延後通知，避免在呼叫端的迴圈中重入
+        requests.removeAt(index);
+        QMetaObject::invokeMethod(this, [this, jobId]() {
+            emit jobFinished(jobId, false, "已取消");
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    // 已送出的工作由服務在開始前或下一個分段結束時停止，回覆 canceled 事件
+    if (canceledJobIds.contains(jobId)) {
+        return;
+    }
+    canceledJobIds.append(jobId);
+    QJsonObject message;
+    message.insert("cancel", jobId);
+    process->write(QJsonDocument(message).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void WhisperServer::onReadyRead()
+{
+    readBuffer.append(process->readAllStandardOutput());
+    qsizetype lineStart = 0;
+    for (qsizetype newline = readBuffer.indexOf('\n'); newline >= 0;
+         newline = readBuffer.indexOf('\n', lineStart)) {
+        const QByteArray line = readBuffer.mid(lineStart, newline - lineStart).trimmed();
+        lineStart = newline + 1;
+        if (!line.isEmpty()) {
+            handleMessage(line);
+        }
+    }
+    readBuffer.remove(0, lineStart);
+}
+
+void WhisperServer::handleMessage(const QByteArray& line)
+{
+    const QJsonDocument document = QJsonDocument::fromJson(line);
+    if (!document.isObject()) {
+        return;
+    }
+
+    const QJsonObject message = document.object();
+    const QString event = message.value("event").toString();
+
+    if (!message.contains("id")) {
+        if (event == "ready") {
+            // 模型就緒，送出等待中的工作
+            currentState = Ready;
+            for (int i = writtenCount; i < requests.size(); i++) {
+                writeRequest(requests[i]);
+            }
+            writtenCount = requests.size();
+            emit ready();
+        } else if (event == "error") {
+            // 服務即將結束，訊息在程序結束時一併回報
+            lastErrorOutput = message.value("message").toString();
+        }
+        return;
+    }
+
+    const int jobId = message.value("id").toInt();
+    if (event == "progress") {
+        emit jobProgress(jobId, message.value("message").toString());
+        return;
+    }
+    if (event == "segment") {
+        // 時間以秒為單位
+        emit jobSegment(jobId,
+                        qRound64(message.value("start").toDouble() * 1000),
+                        qRound64(message.value("end").toDouble() * 1000),
+                        message.value("text").toString());
+        return;
+    }
+    if (event != "done" && event != "error" && event != "canceled") {
+        return;
+    }
+
+    for (int i = 0; i < requests.size(); i++) {
+        if (requests[i].id == jobId) {
+            requests.removeAt(i);
+            if (i < writtenCount) {
+                writtenCount--;
+            }
+            break;
+        }
+    }
+    canceledJobIds.removeOne(jobId);
+    if (event == "done") {
+        crashCount = 0;
+        emit jobFinished(jobId, true, QString());
+    } else if (event == "canceled") {
+        emit jobFinished(jobId, false, "已取消");
+    } else {
+        emit jobFinished(jobId, false, message.value("message").toString());
+    }
+}
+
+void WhisperServer::writeRequest(const Request& request)
+{
+    QJsonObject job;
+    job.insert("id", request.id);
+    job.insert("audio", request.audioFilePath);
+    job.insert("output", request.outputPath);
+    process->write(QJsonDocument(job).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void WhisperServer::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (currentState == Starting) {
+        // 模型還沒就緒就結束：Python 或 Whisper 無法使用
+        QString message = lastErrorOutput.isEmpty()
+            ? QString("Whisper 轉錄服務結束，退出碼: %1").arg(exitCode)
+            : lastErrorOutput;
+        markUnavailable(message);
+        return;
+    }
+
+    // 已送出的工作：正在轉錄與已要求取消的以失敗結束，其餘的工作保留，重新啟動後重送
+    QList<Request> written = requests.mid(0, writtenCount);
+    requests = requests.mid(writtenCount);
+    writtenCount = 0;
+
+    QList<int> failedJobIds;
+    QString failureMessage = exitStatus == QProcess::CrashExit
+        ? QString("Whisper 轉錄服務異常終止")
+        : QString("Whisper 轉錄服務結束，退出碼: %1").arg(exitCode);
+    for (int i = written.size() - 1; i >= 0; i--) {
+        const int jobId = written[i].id;
+        if (canceledJobIds.contains(jobId) || i == 0) {
+            failedJobIds.prepend(jobId);
+        } else {
+            requests.prepend(written[i]);
+        }
+    }
+    const QList<int> canceled = canceledJobIds;
+    canceledJobIds.clear();
+
+    if (++crashCount > MAX_CRASH_RESTARTS) {
+        markUnavailable(failureMessage);
+    } else {
+        // 在 finished() 信號之外重新啟動程序
+        currentState = Starting;
+        QMetaObject::invokeMethod(this, [this]() { start(); }, Qt::QueuedConnection);
+    }
+
+    for (int jobId : failedJobIds) {
+        emit jobFinished(jobId, false, canceled.contains(jobId) ? QString("已取消") : failureMessage);
+    }
+}
+
+void WhisperServer::onProcessError(QProcess::ProcessError error)
+{
+    // 其他錯誤之後仍會收到 finished()，只有無法啟動時需要在這裡處理
+    if (error == QProcess::FailedToStart) {
+        markUnavailable(QString("無法啟動 Whisper 轉錄服務: %1").arg(program));
+    }
+}
+
+void WhisperServer::markUnavailable(const QString& message)
+{
+    currentState = Unavailable;
+    requests.clear();
+    writtenCount = 0;
+    canceledJobIds.clear();
+    emit unavailable(message);
+}
@@ -0,0 +1,118 @@
+// 防止標頭檔重複引入的保護宏
+#ifndef WHISPERSERVER_H
+#define WHISPERSERVER_H
+
+// 引入 Qt 物件基底類別
+#include <QObject>
+// 引入 Qt 外部程序類別
+#include <QProcess>
+// 引入 Qt 字串清單類別
+#include <QStringList>
+// 引入 Qt 清單容器類別
+#include <QList>
+
+// 常駐的 Whisper 轉錄服務（whisper_transcribe.py --server）
+//
+// 模型只在服務啟動時載入一次，之後每首曲目只需透過標準輸入送出一行 JSON 工作，
+// 省去每次啟動程序與載入模型的時間。服務一次只轉錄一個工作，送出的工作依序處理。
+// 每解碼完一個分段就以 jobSegment() 通知，字幕可以邊轉錄邊顯示。
+// 以 --workers 啟動時，服務會把長音頻在靜音處切段並行轉錄，分段仍依時間順序送出。
+//   - 服務無法啟動（找不到 Python、未安裝 Whisper、模型載入失敗）時發出 unavailable()，
+//     尚未完成的工作不會收到 jobFinished()，由呼叫端改用一次性的轉錄程序
+//   - cancel() 以 {"cancel": id} 通知服務，正在轉錄的工作在下一個分段結束時停止，
+//     服務程序與載入的模型不受影響
+//   - 服務在就緒後異常結束時，未完成的工作以 jobFinished(false) 結束，
+//     服務會自動重新啟動（連續失敗過多次後視為無法使用）
+class WhisperServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 服務狀態
+    enum State {
+        NotRunning,   // 尚未啟動
+        Starting,     // 程序已啟動，正在載入模型
+        Ready,        // 模型已就緒，可以處理工作
+        Unavailable   // 無法使用
+    };
+
+    // 建構函式，program/arguments 為啟動服務的命令，model 為快取鍵值中的模型名稱
+    WhisperServer(const QString& program, const QStringList& arguments, const QString& model,
+                  QObject* parent = nullptr);
+    // 解構函式，關閉服務程序
+    ~WhisperServer() override;
+
+    // 啟動服務（模型載入完成時發出 ready()）
+    void start();
+    // 目前狀態
+    State state() const;
+    // 服務是否可以接受工作（正在啟動或已就緒）
+    bool isAvailable() const;
+    // 快取鍵值中的模型名稱
+    QString model() const;
+
+    // 送出轉錄工作，結果寫入 outputPath；回傳工作編號，服務無法使用時回傳 -1
+    int submit(const QString& audioFilePath, const QString& outputPath);
+    // 取消工作，以 jobFinished(false, "已取消") 結束；取消要求到達前已完成的工作仍以 jobFinished(true) 結束
+    void cancel(int jobId);
+
+signals:
+    // 模型載入完成
+    void ready();
+    // 服務無法使用
+    void unavailable(const QString& message);
+    // 工作的進度訊息
+    void jobProgress(int jobId, const QString& text);
+    // 工作解碼完成的一個分段（不必等整個檔案轉錄完成）
+    void jobSegment(int jobId, qint64 startMs, qint64 endMs, const QString& text);
+    // 工作結束，ok 為 false 時 message 為失敗原因
+    void jobFinished(int jobId, bool ok, const QString& message);
+
+private:
+    // 一個已送出的工作
+    struct Request {
+        int id;
+        QString audioFilePath;
+        QString outputPath;
+    };
+
+    // 讀取並處理標準輸出中完整的 JSON 行
+    void onReadyRead();
+    // 處理一行 JSON 訊息
+    void handleMessage(const QByteArray& line);
+    // 將工作寫入服務程序的標準輸入
+    void writeRequest(const Request& request);
+    // 服務程序結束的處理
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    // 服務程序無法啟動的處理
+    void onProcessError(QProcess::ProcessError error);
+    // 標記為無法使用並通知呼叫端
+    void markUnavailable(const QString& message);
+
+    // 啟動服務的命令
+    QString program;
+    QStringList arguments;
+    // 模型名稱
+    QString modelName;
+    // 服務程序
+    QProcess* process;
+    // 目前狀態
+    State currentState;
+    // 標準輸出中尚未結束的行
+    QByteArray readBuffer;
+    // 最近一次的錯誤輸出（無法啟動時附在訊息中）
+    QString lastErrorOutput;
+    // 已送出、尚未結束的工作（第一個為正在轉錄的工作）
+    QList<Request> requests;
+    // requests 前段已寫入服務程序的工作數（模型就緒前送出的工作先暫存）
+    int writtenCount;
+    // 下一個工作編號
+    int nextJobId;
+    // 已送出取消要求、等待服務回覆的工作編號
+    QList<int> canceledJobIds;
+    // 就緒後連續異常結束的次數
+    int crashCount;
+};
+
+// 結束標頭檔保護宏
+#endif // WHISPERSERVER_H
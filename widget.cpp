@@ -16,14 +16,10 @@
 #include <QFileInfo>
 // 引入 Qt 目錄處理類別
 #include <QDir>
-// 引入 Qt 隨機數產生器類別
-#include <QRandomGenerator>
 // 引入 Qt 標準路徑取得類別
 #include <QStandardPaths>
 // 引入 Qt 分割視窗類別
 #include <QSplitter>
-// 引入 Qt 正則表達式類別
-#include <QRegularExpression>
 // 引入 Qt 文字瀏覽器類別
 #include <QTextBrowser>
 // 引入 Qt 文字串流類別
@@ -38,6 +34,20 @@
 #include <QMenu>
 // 引入 Qt 滑鼠事件類別
 #include <QMouseEvent>
+// 引入 Qt 信號阻擋器類別
+#include <QSignalBlocker>
+// 引入 Qt 核心應用程式類別
+#include <QCoreApplication>
+// 引入 Qt 執行緒類別（取得 CPU 核心數）
+#include <QThread>
+// 引入 Qt 捲軸類別
+#include <QScrollBar>
+// 引入播放清單項目繪製代理
+#include "playlistdelegate.h"
+// 引入字幕段落繪製代理
+#include "subtitledelegate.h"
+// 引入顯示區域的 HTML 內容
+#include "displayhtml.h"
 // 引入 C++ 數學函式庫
 #include <cmath>
 
@@ -68,44 +78,113 @@ namespace {
         // 儲存旗標的參考
         bool& m_flag;
     };
+    
+    // 轉錄使用的模型名稱，作為字幕快取鍵值的一部分（更換模型後會重新轉錄）
+    const QString TRANSCRIPTION_MODEL = "vibe";
+    // 常駐轉錄服務的腳本（與執行檔放在同一目錄）與使用的 Whisper 模型
+    const QString WHISPER_SERVER_SCRIPT = "whisper_transcribe.py";
+    const QString WHISPER_SERVER_MODEL = "base";
+    // 長音頻切段並行轉錄時，每個工作程序使用的 CPU 核心數
+    const int WHISPER_CORES_PER_CHUNK_WORKER = 2;
+#ifdef Q_OS_WIN
+    // 執行轉錄服務腳本的 Python 直譯器
+    const QString PYTHON_PROGRAM = "python";
+#else
+    // 執行轉錄服務腳本的 Python 直譯器
+    const QString PYTHON_PROGRAM = "python3";
+#endif
+    // 同時執行的轉錄程序數量（每個 Whisper 程序都會佔用大量 CPU 與記憶體）
+    const int TRANSCRIPTION_WORKERS = 2;
+    // 預設預先轉錄接下來的曲目數
+    const int TRANSCRIPTION_LOOKAHEAD = 3;
+    // 曲目之間交叉淡入淡出的長度（毫秒），0 表示直接無縫接上下一首
+    const int PLAYBACK_CROSSFADE_MS = 0;
+    // 波形進度條的高度（像素）
+    const int WAVEFORM_HEIGHT = 32;
+    // 響度正規化的目標響度（LUFS，與 ReplayGain 2.0 的參考響度相同）
+    const double LOUDNESS_TARGET_LUFS = -18.0;
+    // 使用者捲動字幕清單後暫停自動捲動的時間（毫秒）
+    const int SUBTITLE_SCROLL_HOLD_MS = 3000;
+    // 寫入播放狀態檢查點的間隔（毫秒），當機時最多損失這段時間的播放進度
+    const int PLAYBACK_CHECKPOINT_INTERVAL_MS = 5000;
+    // 搜尋結果最多顯示的筆數
+    const int SEARCH_RESULT_LIMIT = 200;
 }
 
 // Widget 類別的建構函式，初始化所有成員變數
 Widget::Widget(QWidget *parent)
     : QWidget(parent)  // 呼叫父類別的建構函式
     , ui(new Ui::Widget)  // 創建 UI 物件
-    , mediaPlayer(new QMediaPlayer(this))  // 創建媒體播放器物件
-    , audioOutput(new QAudioOutput(this))  // 創建音訊輸出物件
+    , mediaPlayer(new GaplessPlayer(this))  // 創建媒體播放器物件
     , videoDisplayArea(nullptr)  // 初始化影片顯示區域為 null
-    , whisperProcess(new QProcess(this))  // 創建 Whisper 外部程序物件
+    , subtitleView(nullptr)  // 初始化字幕清單視圖為 null
+    , subtitleModel(new SubtitleModel(this))  // 創建字幕段落資料模型
+    , playlistStore(new PlaylistStore(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation), this))  // 創建播放清單持久化引擎
+    , folderImporter(new FolderImporter(this))  // 創建資料夾匯入器
+    , transcriptCache(QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("transcripts"))  // 初始化字幕快取目錄
+    , transcriptionQueue(new TranscriptionQueue(&transcriptCache, TRANSCRIPTION_MODEL, this))  // 創建背景轉錄排程器
+    , peaksDirectory(QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("peaks"))  // 初始化波形峰值快取目錄
+    , loudnessScanner(new LoudnessScanner(peaksDirectory, this))  // 創建背景響度掃描器
+    , playlistModel(new PlaylistModel(&playlists, this))  // 創建播放清單資料模型
     , currentPlaylistIndex(-1)  // 初始化當前播放清單索引為 -1（無選擇）
-    , currentVideoIndex(-1)  // 初始化當前影片索引為 -1（無選擇）
-    , isShuffleMode(false)  // 初始化隨機播放模式為關閉
-    , isRepeatMode(false)  // 初始化循環播放模式為關閉
+    , playbackCursor(&playlists, playlistStore)  // 初始化播放位置（沒有正在播放的曲目）
+    , searchIndexer(new SearchIndexer(&playlists, playlistStore, this))  // 創建搜尋索引維護物件
+    , playlistLibrary(&playlists, playlistModel, &playbackCursor, playlistStore, searchIndexer)  // 初始化播放清單的編輯
     , isPlaying(false)  // 初始化播放狀態為停止
     , isProgressSliderPressed(false)  // 初始化進度條按下狀態為否
     , isMuted(false)  // 初始化靜音狀態為否
     , previousVolume(50)  // 初始化先前音量為 50%
     , isSwitchingSongs(false)  // 初始化切換歌曲旗標為否
-    , subtitleTimestampRegex(R"(\[(\d+\.?\d*)s\s*-\s*(\d+\.?\d*)s\])")  // 初始化字幕時間戳正則表達式
-    , srtTimestampRegex(R"((\d{2}):(\d{2}):(\d{2}),(\d{3})\s*-->\s*(\d{2}):(\d{2}):(\d{2}),(\d{3}))")  // 初始化 SRT 時間戳正則表達式
-    , sequenceNumberRegex(R"(^\d+$)")  // 初始化序號正則表達式
+    , transcriptionLookahead(TRANSCRIPTION_LOOKAHEAD)  // 初始化預先轉錄的曲目數
     , currentSubtitles("")  // 初始化當前字幕為空字串
     , titleRestoreTimer(new QTimer(this))  // 創建標題恢復計時器物件
+    , subtitleScrollHoldTimer(new QTimer(this))  // 創建字幕自動捲動暫停計時器物件
+    , checkpointTimer(new QTimer(this))  // 創建播放狀態檢查點計時器物件
 {
     // 設定 UI 元件
     ui->setupUi(this);
     
-    // 設置媒體播放器，將音訊輸出連接到播放器
-    mediaPlayer->setAudioOutput(audioOutput);
-    // 設定音訊輸出音量為 50%（0.5）
-    audioOutput->setVolume(0.5);
+    // 設定播放音量為 50%（0.5）
+    mediaPlayer->setVolume(0.5);
+    // 設定曲目之間的交叉淡入淡出長度
+    mediaPlayer->setCrossfadeDuration(PLAYBACK_CROSSFADE_MS);
+    
+    // 設定同時轉錄的程序數量
+    transcriptionQueue->setMaxWorkers(TRANSCRIPTION_WORKERS);
+    // 響度掃描在低優先權執行緒中解碼，使用一半的 CPU 核心平行分析
+    loudnessScanner->setMaxWorkers(QThread::idealThreadCount() / 2);
+    
+    // 啟動常駐轉錄服務，模型只載入一次並在各曲目間重複使用；
+    // 找不到腳本或服務無法啟動時，轉錄佇列改用一次性的 Vibe 程序
+    const QString serverScript = QDir(QCoreApplication::applicationDirPath()).filePath(WHISPER_SERVER_SCRIPT);
+    if (QFile::exists(serverScript)) {
+        // 長音頻在靜音處切段，依 CPU 核心數分給多個工作程序並行轉錄
+        const int chunkWorkers = qMax(1, QThread::idealThreadCount() / WHISPER_CORES_PER_CHUNK_WORKER);
+        WhisperServer* whisperServer = new WhisperServer(
+            PYTHON_PROGRAM,
+            { serverScript, "--server", "--model", WHISPER_SERVER_MODEL,
+              "--workers", QString::number(chunkWorkers) },
+            "whisper-" + WHISPER_SERVER_MODEL, this);
+        transcriptionQueue->setServer(whisperServer);
+        whisperServer->start();
+    }
     
     // 設置標題恢復計時器為單次觸發
     titleRestoreTimer->setSingleShot(true);
     // 連接計時器逾時信號到恢復標題的槽函式
     connect(titleRestoreTimer, &QTimer::timeout, this, &Widget::restoreCurrentVideoTitle);
     
+    // 設置字幕自動捲動暫停計時器為單次觸發
+    subtitleScrollHoldTimer->setSingleShot(true);
+    subtitleScrollHoldTimer->setInterval(SUBTITLE_SCROLL_HOLD_MS);
+    
+    // 定期寫入播放狀態檢查點；不在 positionChanged 中寫入，播放時不產生額外的磁碟 I/O
+    checkpointTimer->setInterval(PLAYBACK_CHECKPOINT_INTERVAL_MS);
+    connect(checkpointTimer, &QTimer::timeout, this, &Widget::checkpointPlayback);
+    
+    // 搜尋索引在事件迴圈空閒時分批收錄，曲庫再大也不會延遲啟動或讓介面停頓
+    connect(searchIndexer, &SearchIndexer::loaded, this, &Widget::onSearchIndexLoaded);
+    
     // 設置主視窗標題
     setWindowTitle("音樂播放器");
     // 設置主視窗最小尺寸為 1000x700
@@ -117,72 +196,46 @@ Widget::Widget(QWidget *parent)
     // 呼叫函式建立信號與槽的連接
     createConnections();
     
-    // 從檔案載入已保存的播放清單
-    loadPlaylistsFromFile();
-    
-    // 檢查是否沒有任何播放清單
-    if (playlists.isEmpty()) {
-        // 創建預設播放清單物件
-        Playlist defaultPlaylist;
-        // 設定播放清單名稱
-        defaultPlaylist.name = "我的播放清單";
-        // 將播放清單加入清單中
-        playlists.append(defaultPlaylist);
-        
-        // 創建我的最愛播放清單物件
-        Playlist favoritesPlaylist;
-        // 設定播放清單名稱
-        favoritesPlaylist.name = "我的最愛";
-        // 將播放清單加入清單中
-        playlists.append(favoritesPlaylist);
-        
-        // 將預設播放清單名稱加入到下拉選單
-        playlistComboBox->addItem(defaultPlaylist.name);
-        // 將我的最愛播放清單名稱加入到下拉選單
-        playlistComboBox->addItem(favoritesPlaylist.name);
-        // 設定當前播放清單索引為 0（第一個播放清單）
-        currentPlaylistIndex = 0;
-    } else {
-        // 如果已有播放清單，恢復播放清單到下拉選單
-        // 遍歷所有播放清單
+    // 載入已保存的播放清單（第一次啟動時建立預設的播放清單），只展開上次使用的播放清單
+    currentPlaylistIndex = playlistLibrary.load();
+    {
+        // 填入名稱時暫停信號，避免第一個項目觸發切換而展開錯誤的播放清單
+        QSignalBlocker blocker(playlistComboBox);
         for (const Playlist& playlist : playlists) {
-            // 將播放清單名稱加入到下拉選單
             playlistComboBox->addItem(playlist.name);
         }
-        
-        // 恢復上次使用的播放清單
-        // 初始化上次使用的索引為 0
-        int lastIndex = 0;
-        // 遍歷所有播放清單尋找上次使用的播放清單
-        for (int i = 0; i < playlists.size(); i++) {
-            // 如果播放清單名稱與上次使用的名稱相符
-            if (playlists[i].name == lastPlaylistName) {
-                // 記錄索引
-                lastIndex = i;
-                // 跳出迴圈
-                break;
-            }
-        }
-        // 設定下拉選單的當前索引為上次使用的索引
-        playlistComboBox->setCurrentIndex(lastIndex);
-        // 更新當前播放清單索引
-        currentPlaylistIndex = lastIndex;
-        // 更新播放清單顯示
-        updatePlaylistDisplay();
+        playlistComboBox->setCurrentIndex(currentPlaylistIndex);
     }
+    updatePlaylistDisplay();
     
     // 更新目標播放清單下拉選單（用於加入歌曲到其他播放清單）
     updateTargetPlaylistComboBox();
     
     // 更新所有按鈕的啟用/停用狀態
     updateButtonStates();
+    
+    // 提供壓縮日誌時所需的完整狀態快照
+    playlistStore->setSnapshotProvider([this]() { return playlistLibrary.snapshot(); });
+    
+    // 從上次停止的曲目與位置繼續
+    restorePlayback();
+    // 展開待播佇列用到的播放清單並移除已失效的項目，之後查詢下一首時不再需要展開
+    playbackCursor.prune();
+    checkpointTimer->start();
+    
+    // 在背景讀回保存的搜尋索引，完成後再補上之後新增的曲目與字幕
+    searchIndexer->start();
 }
 
 // Widget 類別的解構函式，負責清理資源
 Widget::~Widget()
 {
-    // 將播放清單儲存到檔案
-    savePlaylistsToFile();
+    // 記錄最後的播放位置與搜尋索引（等待載入中的索引），再寫出尚在緩衝區的變更紀錄，並等待背景寫入執行緒完成
+    checkpointPlayback();
+    searchIndexer->flush();
+    playlistStore->flush();
+    // 轉錄排程器會使用字幕快取，必須在字幕快取成員解構前先刪除
+    delete transcriptionQueue;
     // 刪除 UI 物件，釋放記憶體
     delete ui;
 }
@@ -226,8 +279,8 @@ void Widget::setupUI()
         // 設定邊框顏色為 Spotify 綠色
         "   border: 1px solid #1DB954;"
         "}"
-        // QListWidget（清單視窗）的樣式
-        "QListWidget {"
+        // QListView（播放清單視圖）的樣式，項目由 PlaylistDelegate 繪製
+        "QListView {"
         // 設定背景顏色為深灰色
         "   background-color: #181818;"
         // 移除邊框
@@ -235,29 +288,6 @@ void Widget::setupUI()
         // 移除選取框
         "   outline: none;"
         "}"
-        // QListWidget 項目的樣式
-        "QListWidget::item {"
-        // 設定內邊距為 10px
-        "   padding: 10px;"
-        // 設定底部邊框為 1px 實線深灰色
-        "   border-bottom: 1px solid #282828;"
-        // 設定文字顏色為淺灰色
-        "   color: #B3B3B3;"
-        "}"
-        // QListWidget 項目滑鼠懸停時的樣式
-        "QListWidget::item:hover {"
-        // 設定背景顏色為較深的灰色
-        "   background-color: #282828;"
-        // 設定文字顏色為白色
-        "   color: #FFFFFF;"
-        "}"
-        // QListWidget 項目被選取時的樣式
-        "QListWidget::item:selected {"
-        // 設定背景顏色為 Spotify 綠色
-        "   background-color: #1DB954;"
-        // 設定文字顏色為白色
-        "   color: #FFFFFF;"
-        "}"
         // QComboBox（下拉選單）的樣式
         "QComboBox {"
         // 設定背景顏色為深灰色
@@ -316,6 +346,23 @@ void Widget::setupUI()
     );
     topLayout->addWidget(loadLocalFileButton);
     
+    importFolderButton = new QPushButton("📂 匯入資料夾", topBar);
+    importFolderButton->setStyleSheet(
+        "QPushButton {"
+        "   background-color: #282828;"
+        "   color: white;"
+        "   border: none;"
+        "   border-radius: 20px;"
+        "   padding: 8px 24px;"
+        "   font-size: 14px;"
+        "   font-weight: bold;"
+        "}"
+        "QPushButton:hover { background-color: #404040; }"
+        "QPushButton:pressed { background-color: #505050; }"
+    );
+    importFolderButton->setToolTip("匯入資料夾（含子資料夾）中的所有音樂檔案");
+    topLayout->addWidget(importFolderButton);
+    
     loadSubtitleButton = new QPushButton("📝 載入字幕檔案", topBar);
     loadSubtitleButton->setStyleSheet(
         "QPushButton {"
@@ -389,11 +436,39 @@ void Widget::setupUI()
     
     leftLayout->addLayout(playlistButtonLayout);
     
-    playlistWidget = new QListWidget(leftPanel);
-    playlistWidget->setDragDropMode(QAbstractItemView::InternalMove);
-    playlistWidget->setDefaultDropAction(Qt::MoveAction);
-    playlistWidget->setContextMenuPolicy(Qt::CustomContextMenu);
-    leftLayout->addWidget(playlistWidget);
+    // 搜尋框：即時搜尋所有播放清單的曲目資訊與字幕
+    searchEdit = new QLineEdit(leftPanel);
+    searchEdit->setPlaceholderText("🔍 搜尋曲目、藝術家或字幕");
+    searchEdit->setClearButtonEnabled(true);
+    leftLayout->addWidget(searchEdit);
+    
+    // 播放清單以模型/視圖呈現：視圖只繪製可見的列，所有列同高以免逐列計算尺寸
+    playlistView = new QListView(leftPanel);
+    playlistView->setModel(playlistModel);
+    playlistView->setItemDelegate(new PlaylistDelegate(playlistView));
+    playlistView->setUniformItemSizes(true);
+    playlistView->setSelectionMode(QAbstractItemView::SingleSelection);
+    playlistView->setMouseTracking(true);
+    playlistView->setDragDropMode(QAbstractItemView::InternalMove);
+    playlistView->setDefaultDropAction(Qt::MoveAction);
+    playlistView->setContextMenuPolicy(Qt::CustomContextMenu);
+    leftLayout->addWidget(playlistView);
+    
+    // 搜尋結果清單，有搜尋文字時取代播放清單視圖
+    searchResultsView = new QListWidget(leftPanel);
+    searchResultsView->setUniformItemSizes(true);
+    searchResultsView->setStyleSheet(
+        "QListWidget::item { color: #B3B3B3; padding: 6px 4px; }"
+        "QListWidget::item:selected { background-color: #282828; color: #FFFFFF; }"
+    );
+    searchResultsView->hide();
+    leftLayout->addWidget(searchResultsView);
+    
+    // 響度掃描進度，只在掃描時顯示
+    loudnessStatusLabel = new QLabel(leftPanel);
+    loudnessStatusLabel->setStyleSheet("font-size: 12px; color: #B3B3B3;");
+    loudnessStatusLabel->hide();
+    leftLayout->addWidget(loudnessStatusLabel);
     
     contentSplitter->addWidget(leftPanel);
     
@@ -415,9 +490,9 @@ void Widget::setupUI()
     centerLayout->addWidget(channelLabel);
     
     // 影片顯示區域 - 使用 QTextBrowser 支援 HTML 顯示和連結點擊
-    // 這個區域現在同時顯示歌曲資訊和字幕
+    // 這個區域顯示歌曲資訊和字幕狀態，字幕段落顯示在下方的清單中
     videoDisplayArea = new QTextBrowser(centerPanel);
-    videoDisplayArea->setMinimumHeight(400);
+    videoDisplayArea->setMinimumHeight(160);
     videoDisplayArea->setOpenExternalLinks(false);  // 由我們自己處理連結點擊
     videoDisplayArea->setStyleSheet(
         "QTextBrowser {"
@@ -436,9 +511,30 @@ void Widget::setupUI()
         "   text-decoration: underline;"
         "}"
     );
-    videoDisplayArea->setHtml(generateWelcomeHTML());
+    videoDisplayArea->setHtml(welcomeHtml());
     centerLayout->addWidget(videoDisplayArea, 1);
     
+    // 字幕段落清單 - 只繪製可見的段落，新段落直接加在尾端，不重新排版整份字幕
+    subtitleView = new QListView(centerPanel);
+    subtitleView->setModel(subtitleModel);
+    subtitleView->setItemDelegate(new SubtitleDelegate(subtitleView));
+    subtitleView->setUniformItemSizes(true);
+    subtitleView->setSelectionMode(QAbstractItemView::NoSelection);
+    subtitleView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    subtitleView->setMouseTracking(true);
+    subtitleView->setMinimumHeight(240);
+    subtitleView->setStyleSheet(
+        "QListView {"
+        "   background-color: #000000;"
+        "   border-radius: 8px;"
+        "   color: #B3B3B3;"
+        "   font-size: 14px;"
+        "   padding: 8px 10px;"
+        "}"
+    );
+    subtitleView->hide();
+    centerLayout->addWidget(subtitleView, 3);
+    
     // 播放進度條區域
     QWidget* progressWidget = new QWidget(centerPanel);
     progressWidget->setStyleSheet("background-color: transparent;");
@@ -450,7 +546,8 @@ void Widget::setupUI()
     currentTimeLabel->setStyleSheet("color: #B3B3B3; font-size: 12px; min-width: 45px;");
     progressLayout->addWidget(currentTimeLabel);
     
-    progressSlider = new QSlider(Qt::Horizontal, progressWidget);
+    progressSlider = new WaveformSlider(progressWidget);
+    progressSlider->setMinimumHeight(WAVEFORM_HEIGHT);
     progressSlider->setStyleSheet(
         "QSlider::groove:horizontal {"
         "   border: none;"
@@ -635,6 +732,10 @@ void Widget::createConnections()
 {
     // 本地檔案載入
     connect(loadLocalFileButton, &QPushButton::clicked, this, &Widget::onLoadLocalFileClicked);
+    connect(importFolderButton, &QPushButton::clicked, this, &Widget::onImportFolderClicked);
+    connect(folderImporter, &FolderImporter::tracksReady, this, &Widget::onImportedTracksReady);
+    connect(folderImporter, &FolderImporter::progressChanged, this, &Widget::onImportProgressChanged);
+    connect(folderImporter, &FolderImporter::finished, this, &Widget::onImportFinished);
     connect(loadSubtitleButton, &QPushButton::clicked, this, &Widget::onLoadSubtitleFileClicked);
     
     // 播放控制按鈕
@@ -645,9 +746,16 @@ void Widget::createConnections()
     connect(repeatButton, &QPushButton::clicked, this, &Widget::onRepeatClicked);
     
     // 播放清單管理
-    connect(playlistWidget, &QListWidget::itemDoubleClicked, this, &Widget::onVideoDoubleClicked);
-    connect(playlistWidget, &QListWidget::itemSelectionChanged, this, &Widget::updateButtonStates);
-    connect(playlistWidget, &QListWidget::customContextMenuRequested, this, &Widget::onPlaylistContextMenu);
+    connect(playlistView, &QListView::doubleClicked, this, &Widget::onVideoDoubleClicked);
+    connect(playlistView->selectionModel(), &QItemSelectionModel::currentChanged, this, &Widget::updateButtonStates);
+    connect(playlistView, &QListView::customContextMenuRequested, this, &Widget::onPlaylistContextMenu);
+    
+    // 全文搜尋：按 Enter 播放第一筆結果
+    connect(searchEdit, &QLineEdit::textChanged, this, &Widget::onSearchTextChanged);
+    connect(searchEdit, &QLineEdit::returnPressed, this, [this]() {
+        onSearchResultActivated(searchResultsView->item(0));
+    });
+    connect(searchResultsView, &QListWidget::itemActivated, this, &Widget::onSearchResultActivated);
     
     // 加入播放清單按鈕
     connect(addToPlaylistButton, &QPushButton::clicked, this, &Widget::onAddToPlaylistClicked);
@@ -658,9 +766,10 @@ void Widget::createConnections()
     connect(playlistComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &Widget::onPlaylistChanged);
     
     // 媒體播放器
-    connect(mediaPlayer, &QMediaPlayer::playbackStateChanged, this, &Widget::onMediaPlayerStateChanged);
-    connect(mediaPlayer, &QMediaPlayer::positionChanged, this, &Widget::onMediaPlayerPositionChanged);
-    connect(mediaPlayer, &QMediaPlayer::durationChanged, this, &Widget::onMediaPlayerDurationChanged);
+    connect(mediaPlayer, &GaplessPlayer::playbackStateChanged, this, &Widget::onMediaPlayerStateChanged);
+    connect(mediaPlayer, &GaplessPlayer::positionChanged, this, &Widget::onMediaPlayerPositionChanged);
+    connect(mediaPlayer, &GaplessPlayer::durationChanged, this, &Widget::onMediaPlayerDurationChanged);
+    connect(mediaPlayer, &GaplessPlayer::advancedToNextSource, this, &Widget::onMediaPlayerAdvanced);
     
     // 進度條控制
     connect(progressSlider, &QSlider::sliderPressed, this, &Widget::onProgressSliderPressed);
@@ -670,36 +779,46 @@ void Widget::createConnections()
     // 音量控制
     connect(volumeSlider, &QSlider::valueChanged, this, &Widget::onVolumeSliderChanged);
     
-    // Whisper 轉錄
-    connect(whisperProcess, &QProcess::readyReadStandardOutput, this, &Widget::onWhisperOutputReady);
-    connect(whisperProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), 
-            this, &Widget::onWhisperFinished);
+    // 背景轉錄
+    connect(transcriptionQueue, &TranscriptionQueue::transcriptionStarted, this, &Widget::onTranscriptionStarted);
+    connect(transcriptionQueue, &TranscriptionQueue::outputReceived, this, &Widget::onTranscriptionOutput);
+    connect(transcriptionQueue, &TranscriptionQueue::segmentReceived, this, &Widget::onTranscriptSegment);
+    connect(transcriptionQueue, &TranscriptionQueue::transcriptReady, this, &Widget::onTranscriptReady);
+    connect(transcriptionQueue, &TranscriptionQueue::transcriptFailed, this, &Widget::onTranscriptFailed);
+    
+    // 背景音訊分析
+    connect(loudnessScanner, &LoudnessScanner::waveformReady, this, &Widget::onWaveformReady);
+    connect(loudnessScanner, &LoudnessScanner::trackAnalyzed, this, &Widget::onTrackLoudnessAnalyzed);
+    connect(loudnessScanner, &LoudnessScanner::progressChanged, this, &Widget::onLoudnessScanProgress);
+    connect(loudnessScanner, &LoudnessScanner::finished, loudnessStatusLabel, &QLabel::hide);
     
     // 字幕連結點擊 - 跳轉到指定時間
     connect(videoDisplayArea, &QTextBrowser::anchorClicked, this, &Widget::onSubtitleLinkClicked);
-    
-    // 播放清單拖放重排
-    connect(playlistWidget->model(), &QAbstractItemModel::rowsMoved, 
-            [this](const QModelIndex &, int, int, const QModelIndex &, int) {
-                // 當項目被移動時，更新內部資料結構
-                if (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
-                    Playlist& playlist = playlists[currentPlaylistIndex];
-                    QList<VideoInfo> newVideos;
-                    for (int i = 0; i < playlistWidget->count(); i++) {
-                        QListWidgetItem* item = playlistWidget->item(i);
-                        int oldIndex = item->data(Qt::UserRole).toInt();
-                        if (oldIndex >= 0 && oldIndex < playlist.videos.size()) {
-                            newVideos.append(playlist.videos[oldIndex]);
-                        }
-                    }
-                    playlist.videos = newVideos;
-                    // 重新分配索引
-                    for (int i = 0; i < playlistWidget->count(); i++) {
-                        playlistWidget->item(i)->setData(Qt::UserRole, i);
-                    }
-                    savePlaylistsToFile();
-                }
-            });
+    connect(subtitleView, &QListView::clicked, this, &Widget::onSubtitleCueClicked);
+    // 使用者捲動字幕清單（滾輪、拖動捲軸）時暫停自動捲動；scrollTo() 不會觸發這個信號
+    connect(subtitleView->verticalScrollBar(), &QScrollBar::actionTriggered, this, [this]() {
+        subtitleScrollHoldTimer->start();
+    });
+    
+    // 顯示中的就是正在播放的播放清單時，播放順序跟隨模型的列號變化：
+    // 新增、刪除曲目時只調整隨機播放的順序，不重新洗牌；正在播放的列號也由播放順序維護
+    connect(playlistModel, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex&, int first, int last) {
+        for (int row = first; row <= last; row++) {
+            playbackCursor.trackInserted(playlistModel->playlistIndex(), row);
+        }
+    });
+    connect(playlistModel, &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex&, int first, int last) {
+        for (int row = last; row >= first; row--) {
+            playbackCursor.trackRemoved(playlistModel->playlistIndex(), row);
+        }
+    });
+    
+    // 播放清單拖放重排：模型已移動資料，只需同步播放順序並記錄變更
+    connect(playlistModel, &PlaylistModel::trackMoved, this, [this](int from, int to) {
+        playlistStore->recordVideoMoved(currentPlaylistIndex, from, to);
+        playbackCursor.trackMoved(playlistModel->playlistIndex(), from, to);
+        updateTranscriptionQueue();
+    });
 }
 
 void Widget::onLoadLocalFileClicked()
@@ -707,51 +826,16 @@ void Widget::onLoadLocalFileClicked()
     QString filePath = QFileDialog::getOpenFileName(this, 
         "選擇音樂檔案", 
         QDir::homePath(),
-        "音樂檔案 (*.mp3 *.wav *.flac *.m4a *.ogg *.aac);;所有檔案 (*.*)");
+        "音樂檔案 (*.mp3 *.wav *.flac *.m4a *.ogg *.opus *.aac);;所有檔案 (*.*)");
     
     if (!filePath.isEmpty()) {
-        // 創建影片資訊
-        VideoInfo video;
-        video.filePath = filePath;
-        video.videoId = "";
-        
-        // 從檔案名提取標題
-        QFileInfo fileInfo(filePath);
-        video.title = fileInfo.baseName();
-        video.channelTitle = "本地音樂";
-        video.isFavorite = false;
-        video.isLocalFile = true;
+        // 創建影片資訊，標題與藝術家優先使用檔案內嵌的標籤
+        VideoInfo video = FolderImporter::readTrack(filePath);
         
         // 添加到當前播放清單
         if (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
-            // 檢查是否已存在
-            bool alreadyExists = false;
-            for (const VideoInfo& existingVideo : playlists[currentPlaylistIndex].videos) {
-                if (existingVideo.isLocalFile && existingVideo.filePath == filePath) {
-                    alreadyExists = true;
-                    break;
-                }
-            }
-            
-            if (!alreadyExists) {
-                playlists[currentPlaylistIndex].videos.append(video);
-                updatePlaylistDisplay();
-                savePlaylistsToFile();
-            }
-            
             // 播放新添加的歌曲（或已存在的歌曲）
-            int targetIndex = -1;
-            for (int i = 0; i < playlists[currentPlaylistIndex].videos.size(); i++) {
-                if (playlists[currentPlaylistIndex].videos[i].isLocalFile &&
-                    playlists[currentPlaylistIndex].videos[i].filePath == filePath) {
-                    targetIndex = i;
-                    break;
-                }
-            }
-            
-            if (targetIndex >= 0) {
-                playVideo(targetIndex);
-            }
+            playVideo(currentPlaylistIndex, playlistLibrary.addTrack(currentPlaylistIndex, video));
         } else {
             // 如果沒有播放清單，直接播放
             playLocalFile(filePath);
@@ -759,6 +843,48 @@ void Widget::onLoadLocalFileClicked()
     }
 }
 
+void Widget::onImportFolderClicked()
+{
+    // 匯入中再次點擊按鈕即取消
+    if (folderImporter->isRunning()) {
+        folderImporter->cancel();
+        return;
+    }
+    
+    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return;
+    
+    QString directory = QFileDialog::getExistingDirectory(this, "選擇音樂資料夾", QDir::homePath());
+    if (directory.isEmpty()) return;
+    
+    importPlaylistName = playlists[currentPlaylistIndex].name;
+    importFolderButton->setText("⏹ 取消匯入");
+    folderImporter->start(directory);
+}
+
+void Widget::onImportedTracksReady(const QList<VideoInfo>& tracks)
+{
+    // 目標播放清單已被刪除時略過
+    const int playlistIndex = playlistLibrary.indexOf(importPlaylistName);
+    if (playlistIndex >= 0 && playlistLibrary.addTracks(playlistIndex, tracks) > 0) {
+        updateButtonStates();
+    }
+}
+
+void Widget::onImportProgressChanged(int done, int total)
+{
+    if (total <= 0) {
+        importFolderButton->setText("⏹ 取消匯入（掃描中…）");
+    } else {
+        importFolderButton->setText(QString("⏹ 取消匯入（%1/%2）").arg(done).arg(total));
+    }
+}
+
+void Widget::onImportFinished(bool canceled)
+{
+    Q_UNUSED(canceled);
+    importFolderButton->setText("📂 匯入資料夾");
+}
+
 void Widget::onLoadSubtitleFileClicked()
 {
     // 確保正在播放音樂
@@ -771,57 +897,22 @@ void Widget::onLoadSubtitleFileClicked()
     QString filePath = QFileDialog::getOpenFileName(this, 
         "選擇字幕檔案", 
         QDir::homePath(),
-        "字幕檔案 (*.srt);;所有檔案 (*.*)");
+        "字幕檔案 (*.srt *.vtt);;所有檔案 (*.*)");
     
     if (!filePath.isEmpty()) {
         // 直接載入 SRT 檔案
         loadSrt(filePath);
         
         // 保存字幕路徑到當前播放的歌曲
-        if (currentVideoIndex >= 0 && currentPlaylistIndex >= 0 && 
-            currentPlaylistIndex < playlists.size() &&
-            currentVideoIndex < playlists[currentPlaylistIndex].videos.size()) {
-            playlists[currentPlaylistIndex].videos[currentVideoIndex].subtitlePath = filePath;
-            savePlaylistsToFile();
-        }
-    }
-}
-
-QString Widget::extractYouTubeVideoId(const QString& url)
-{
-    // 支援多種 YouTube URL 格式
-    // https://www.youtube.com/watch?v=VIDEO_ID
-    // https://youtu.be/VIDEO_ID
-    // https://www.youtube.com/embed/VIDEO_ID
-    
-    QString videoId;
-    
-    if (url.contains("youtube.com/watch")) {
-        QRegularExpression rx("v=([a-zA-Z0-9_-]+)");
-        QRegularExpressionMatch match = rx.match(url);
-        if (match.hasMatch()) {
-            videoId = match.captured(1);
-        }
-    } else if (url.contains("youtu.be/")) {
-        QRegularExpression rx("youtu\\.be/([a-zA-Z0-9_-]+)");
-        QRegularExpressionMatch match = rx.match(url);
-        if (match.hasMatch()) {
-            videoId = match.captured(1);
-        }
-    } else if (url.contains("youtube.com/embed/")) {
-        QRegularExpression rx("embed/([a-zA-Z0-9_-]+)");
-        QRegularExpressionMatch match = rx.match(url);
-        if (match.hasMatch()) {
-            videoId = match.captured(1);
+        if (currentVideo()) {
+            playlistLibrary.setSubtitlePath(playbackCursor.playlistIndex(), playbackCursor.row(), filePath);
         }
     }
-    
-    return videoId;
 }
 
 void Widget::playYouTubeLink(const QString& link)
 {
-    QString videoId = extractYouTubeVideoId(link);
+    QString videoId = youTubeVideoId(link);
     
     if (videoId.isEmpty()) {
         QMessageBox::warning(this, "錯誤", "無法識別 YouTube 連結格式！\n\n支援的格式：\n- https://www.youtube.com/watch?v=VIDEO_ID\n- https://youtu.be/VIDEO_ID\n- https://www.youtube.com/embed/VIDEO_ID");
@@ -830,6 +921,7 @@ void Widget::playYouTubeLink(const QString& link)
     
     // 停止當前播放
     mediaPlayer->stop();
+    loadWaveform(QString());
     
     // 創建影片資訊
     VideoInfo video;
@@ -841,7 +933,7 @@ void Widget::playYouTubeLink(const QString& link)
     video.filePath = "";
     
     // 使用 QTextBrowser 顯示 YouTube 影片連結
-    videoDisplayArea->setHtml(generateYouTubeDisplayHTML(video.title, video.channelTitle, videoId));
+    videoDisplayArea->setHtml(youTubeHtml(video.title, video.channelTitle, videoId));
     
     // 顯示影片資訊
     updateVideoLabels(video);
@@ -849,21 +941,27 @@ void Widget::playYouTubeLink(const QString& link)
     // 更新狀態
     isPlaying = true;
     playPauseButton->setText("⏸");
-    currentVideoIndex = -1;  // 不屬於播放清單
+    playbackCursor.stop();  // 不屬於播放清單
+    playlistModel->setCurrentRow(-1);
     
     updateButtonStates();
     
     // 清空字幕顯示
-    currentSubtitles = "";
+    clearSubtitles();
+    
+    // YouTube 影片不需要轉錄，讓出名額給其他曲目
+    currentTranscriptAudioPath.clear();
+    updateTranscriptionQueue();
 }
 
 void Widget::playLocalFile(const QString& filePath)
 {
     // 停止當前播放
     mediaPlayer->stop();
+    currentTranscriptAudioPath.clear();
     
     // 清空字幕顯示
-    currentSubtitles = "";
+    clearSubtitles();
     
     // 創建影片資訊
     VideoInfo video;
@@ -879,33 +977,18 @@ void Widget::playLocalFile(const QString& filePath)
     
     // 檢查當前播放清單是否有效
     if (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
-        Playlist& playlist = playlists[currentPlaylistIndex];
-        
-        // 檢查檔案是否已存在於播放清單中
-        int existingIndex = -1;
-        for (int i = 0; i < playlist.videos.size(); i++) {
-            if (playlist.videos[i].filePath == filePath) {
-                existingIndex = i;
-                break;
-            }
-        }
-        
-        if (existingIndex >= 0) {
-            // 檔案已存在，直接播放
-            currentVideoIndex = existingIndex;
-            video = playlist.videos[existingIndex];
-        } else {
-            // 檔案不存在，加入播放清單
-            playlist.videos.append(video);
-            currentVideoIndex = playlist.videos.size() - 1;
-            savePlaylistsToFile();
-            updatePlaylistDisplay();
-        }
+        // 播放的曲目屬於顯示中的播放清單；檔案已存在時直接播放，否則加入播放清單
+        setPlayingPlaylist(currentPlaylistIndex);
+        const int row = playlistLibrary.addTrack(currentPlaylistIndex, video);
+        video = playlists[currentPlaylistIndex].videos[row];
+        playbackCursor.play(currentPlaylistIndex, row);
+        playlistModel->setCurrentRow(row);
     }
     
     // 設置媒體播放器
-    mediaPlayer->setSource(QUrl::fromLocalFile(filePath));
+    mediaPlayer->setSource(QUrl::fromLocalFile(filePath), loudnessGain(video, LOUDNESS_TARGET_LUFS));
     mediaPlayer->play();
+    loadWaveform(filePath, !video.hasLoudness);
     
     // 更新顯示
     updateLocalMusicDisplay(video.title, fileInfo.fileName(), "");
@@ -926,44 +1009,42 @@ void Widget::playLocalFile(const QString& filePath)
         // 啟動 Whisper 轉錄
         startWhisperTranscription(filePath);
     }
+    
+    // 依新的播放位置調整背景轉錄的優先順序
+    updateTranscriptionQueue();
 }
 
 void Widget::onPlayPauseClicked()
 {
-    if (currentVideoIndex >= 0) {
+    if (playbackCursor.row() >= 0) {
         // 有正在播放的影片
-        if (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
-            const Playlist& playlist = playlists[currentPlaylistIndex];
-            if (currentVideoIndex < playlist.videos.size()) {
-                const VideoInfo& video = playlist.videos[currentVideoIndex];
-                
-                if (video.isLocalFile) {
-                    // 本地檔案，控制媒體播放器
-                    if (mediaPlayer->playbackState() == QMediaPlayer::PlayingState) {
-                        mediaPlayer->pause();
-                        isPlaying = false;
-                        playPauseButton->setText("▶");
-                    } else {
-                        mediaPlayer->play();
-                        isPlaying = true;
-                        playPauseButton->setText("⏸");
-                    }
+        if (const VideoInfo* video = currentVideo()) {
+            if (video->isLocalFile) {
+                // 本地檔案，控制媒體播放器
+                if (mediaPlayer->playbackState() == QMediaPlayer::PlayingState) {
+                    mediaPlayer->pause();
+                    isPlaying = false;
+                    playPauseButton->setText("▶");
                 } else {
-                    // YouTube 影片，無法直接控制播放
-                    // 顯示提示訊息
-                    isPlaying = !isPlaying;
-                    playPauseButton->setText(isPlaying ? "⏸" : "▶");
-                    QMessageBox::information(this, "提示", 
-                        "YouTube 影片播放需要在瀏覽器中操作。\n請點擊顯示區域的連結在瀏覽器中播放。");
+                    mediaPlayer->play();
+                    isPlaying = true;
+                    playPauseButton->setText("⏸");
                 }
+            } else {
+                // YouTube 影片，無法直接控制播放
+                // 顯示提示訊息
+                isPlaying = !isPlaying;
+                playPauseButton->setText(isPlaying ? "⏸" : "▶");
+                QMessageBox::information(this, "提示", 
+                    "YouTube 影片播放需要在瀏覽器中操作。\n請點擊顯示區域的連結在瀏覽器中播放。");
             }
         }
     } else {
-        // 沒有影片，嘗試播放播放清單第一首
+        // 沒有影片，嘗試播放顯示中播放清單的第一首
         if (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
             Playlist& playlist = playlists[currentPlaylistIndex];
             if (!playlist.videos.isEmpty()) {
-                playVideo(0);
+                playVideo(currentPlaylistIndex, 0);
             } else {
                 QMessageBox::information(this, "提示", "播放清單是空的，請先載入音樂檔案。");
             }
@@ -986,20 +1067,31 @@ void Widget::onMediaPlayerStateChanged()
         // 本地檔案播放結束，自動播放下一首（如果有）
         // 只有當前正在播放本地檔案時才自動播放下一首
         // 不在手動切換歌曲時觸發自動播放
-        if (!isSwitchingSongs && currentVideoIndex >= 0 && currentPlaylistIndex >= 0 && 
-            currentPlaylistIndex < playlists.size()) {
-            const Playlist& playlist = playlists[currentPlaylistIndex];
-            if (currentVideoIndex < playlist.videos.size() &&
-                playlist.videos[currentVideoIndex].isLocalFile) {
-                int nextIndex = getNextVideoIndex();
-                if (nextIndex >= 0) {
-                    playVideo(nextIndex);
-                }
+        const VideoInfo* video = currentVideo();
+        if (!isSwitchingSongs && video && video->isLocalFile) {
+            const TrackLocation next = playbackCursor.next();
+            if (next.row >= 0) {
+                playTrack(next);
             }
         }
     }
 }
 
+void Widget::onMediaPlayerAdvanced(const QUrl& source)
+{
+    // 播放器已自行接上預先開啟的曲目，這裡只需要推進播放順序並更新畫面
+    const TrackLocation next = playbackCursor.next();
+    if (next.row < 0) {
+        mediaPlayer->stop();
+        return;
+    }
+    
+    // 預先開啟之後播放清單或待播佇列可能已改變，接上的不是下一首時改為正常切換
+    const VideoInfo& video = playlists[next.playlistIndex].videos[next.row];
+    const bool sourceStarted = video.isLocalFile && QUrl::fromLocalFile(video.filePath) == source;
+    playTrack(next, sourceStarted);
+}
+
 void Widget::onMediaPlayerPositionChanged(qint64 position)
 {
     // 更新進度條位置（當使用者沒有拖動時）
@@ -1014,6 +1106,9 @@ void Widget::onMediaPlayerPositionChanged(qint64 position)
             .arg(minutes, 2, 10, QChar('0'))
             .arg(seconds, 2, 10, QChar('0')));
     }
+    
+    // 標示正在播放的字幕段落
+    updateActiveSubtitle(position);
 }
 
 void Widget::onMediaPlayerDurationChanged(qint64 duration)
@@ -1033,45 +1128,38 @@ void Widget::onMediaPlayerDurationChanged(qint64 duration)
 
 void Widget::onPreviousClicked()
 {
-    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return;
+    const int playlistIndex = playbackCursor.playlistIndex();
+    if (playlistIndex < 0 || playlistIndex >= playlists.size()) return;
+    if (playlists[playlistIndex].videos.isEmpty()) return;
     
-    Playlist& playlist = playlists[currentPlaylistIndex];
-    if (playlist.videos.isEmpty()) return;
-    
-    if (isShuffleMode) {
-        int newIndex = getRandomVideoIndex(true);
-        if (newIndex >= 0) {
-            playVideo(newIndex);
-        }
-    } else {
-        int newIndex = currentVideoIndex - 1;
-        if (newIndex < 0) {
-            newIndex = playlist.videos.size() - 1;
-        }
-        playVideo(newIndex);
+    int newIndex = playbackCursor.previous();
+    if (newIndex >= 0) {
+        playVideo(playlistIndex, newIndex);
+    } else if (playbackCursor.row() >= 0) {
+        // 隨機播放已回到本輪第一首：從頭播放目前曲目
+        mediaPlayer->setPosition(0);
     }
 }
 
 void Widget::onNextClicked()
 {
-    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return;
-    
-    Playlist& playlist = playlists[currentPlaylistIndex];
-    if (playlist.videos.isEmpty()) return;
+    // 尚未播放任何曲目時，從顯示中的播放清單開始
+    if (playbackCursor.playlistIndex() < 0 && currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
+        setPlayingPlaylist(currentPlaylistIndex);
+    }
     
-    int newIndex = getNextVideoIndex();
-    if (newIndex >= 0) {
-        playVideo(newIndex);
+    const TrackLocation next = playbackCursor.next();
+    if (next.row >= 0) {
+        playTrack(next);
     }
 }
 
 void Widget::onShuffleClicked()
 {
-    isShuffleMode = !isShuffleMode;
-    shuffleButton->setChecked(isShuffleMode);
+    playbackCursor.setShuffle(!playbackCursor.isShuffle());
+    shuffleButton->setChecked(playbackCursor.isShuffle());
     
-    if (isShuffleMode) {
-        playedVideosInCurrentSession.clear();
+    if (playbackCursor.isShuffle()) {
         shuffleButton->setStyleSheet(
             "QPushButton {"
             "   background-color: #1DB954;"
@@ -1098,14 +1186,17 @@ void Widget::onShuffleClicked()
             "QPushButton:hover { background-color: #404040; }"
         );
     }
+    
+    // 下一首可能改變，重新安排背景轉錄
+    updateTranscriptionQueue();
 }
 
 void Widget::onRepeatClicked()
 {
-    isRepeatMode = !isRepeatMode;
-    repeatButton->setChecked(isRepeatMode);
+    playbackCursor.setRepeat(!playbackCursor.isRepeat());
+    repeatButton->setChecked(playbackCursor.isRepeat());
     
-    if (isRepeatMode) {
+    if (playbackCursor.isRepeat()) {
         repeatButton->setStyleSheet(
             "QPushButton {"
             "   background-color: #1DB954;"
@@ -1132,33 +1223,34 @@ void Widget::onRepeatClicked()
             "QPushButton:hover { background-color: #404040; }"
         );
     }
+    
+    // 下一首可能改變，重新安排背景轉錄
+    updateTranscriptionQueue();
 }
 
-void Widget::onVideoDoubleClicked(QListWidgetItem* item)
+void Widget::onVideoDoubleClicked(const QModelIndex& index)
 {
-    int index = playlistWidget->row(item);
-    playVideo(index);
+    if (index.isValid()) {
+        playVideo(currentPlaylistIndex, index.row());
+    }
 }
 
 void Widget::onAddToPlaylistClicked()
 {
-    if (currentVideoIndex < 0 || currentPlaylistIndex < 0) return;
-    if (currentPlaylistIndex >= playlists.size()) return;
-    
-    Playlist& currentPlaylist = playlists[currentPlaylistIndex];
-    if (currentVideoIndex >= currentPlaylist.videos.size()) return;
+    if (!currentVideo()) return;
     
-    VideoInfo& video = currentPlaylist.videos[currentVideoIndex];
+    // 複製一份，加入顯示中的播放清單時模型可能重新配置曲目列表
+    const VideoInfo video = *currentVideo();
     
     // 獲取目標播放清單索引
     int targetComboIndex = targetPlaylistComboBox->currentIndex();
     if (targetComboIndex < 0) return;
     
-    // 找到目標播放清單的實際索引（跳過當前播放清單）
+    // 找到目標播放清單的實際索引（跳過正在播放的播放清單）
     int targetPlaylistIndex = -1;
     int comboCounter = 0;
     for (int i = 0; i < playlists.size(); i++) {
-        if (i != currentPlaylistIndex) {
+        if (i != playbackCursor.playlistIndex()) {
             if (comboCounter == targetComboIndex) {
                 targetPlaylistIndex = i;
                 break;
@@ -1169,38 +1261,13 @@ void Widget::onAddToPlaylistClicked()
     
     if (targetPlaylistIndex < 0 || targetPlaylistIndex >= playlists.size()) return;
     
-    Playlist& targetPlaylist = playlists[targetPlaylistIndex];
-    
-    // 檢查是否已存在於目標播放清單中
-    bool alreadyExists = false;
-    for (const VideoInfo& existingVideo : targetPlaylist.videos) {
-        bool isSameVideo = false;
-        if (video.isLocalFile && existingVideo.isLocalFile) {
-            isSameVideo = (existingVideo.filePath == video.filePath);
-        } else if (!video.isLocalFile && !existingVideo.isLocalFile) {
-            isSameVideo = (existingVideo.videoId == video.videoId);
-        }
-        
-        if (isSameVideo) {
-            alreadyExists = true;
-            break;
-        }
-    }
-    
-    if (alreadyExists) {
-        QMessageBox::information(this, "加入播放清單", 
-            QString("「%1」已存在於播放清單「%2」中！")
-            .arg(video.title)
-            .arg(targetPlaylist.name));
-    } else {
-        // 加入目標播放清單
-        targetPlaylist.videos.append(video);
-        savePlaylistsToFile();
-        QMessageBox::information(this, "加入播放清單", 
-            QString("已將「%1」加入到播放清單「%2」！")
-            .arg(video.title)
-            .arg(targetPlaylist.name));
-    }
+    // 加入目標播放清單，已存在時不重複加入
+    bool added = false;
+    playlistLibrary.addTrack(targetPlaylistIndex, video, &added);
+    QMessageBox::information(this, "加入播放清單", 
+        QString(added ? "已將「%1」加入到播放清單「%2」！" : "「%1」已存在於播放清單「%2」中！")
+        .arg(video.title)
+        .arg(playlists[targetPlaylistIndex].name));
 }
 
 void Widget::onNewPlaylistClicked()
@@ -1210,26 +1277,14 @@ void Widget::onNewPlaylistClicked()
                                          "請輸入播放清單名稱:", 
                                          QLineEdit::Normal, "", &ok);
     if (ok && !name.isEmpty()) {
-        // 檢查是否重複
-        for (const Playlist& p : playlists) {
-            if (p.name == name) {
-                QMessageBox::warning(this, "新增播放清單", "播放清單名稱已存在！");
-                return;
-            }
+        if (!playlistLibrary.addPlaylist(name)) {
+            QMessageBox::warning(this, "新增播放清單", "播放清單名稱已存在！");
+            return;
         }
         
-        Playlist newPlaylist;
-        newPlaylist.name = name;
-        playlists.append(newPlaylist);
+        // 切換到新的播放清單（由 onPlaylistChanged() 更新顯示）
         playlistComboBox->addItem(name);
-        
-        int newIndex = playlists.size() - 1;
-        playlistComboBox->setCurrentIndex(newIndex);
-        currentPlaylistIndex = newIndex;
-        lastPlaylistName = name;
-        updatePlaylistDisplay();
-        updateTargetPlaylistComboBox();
-        updateButtonStates();
+        playlistComboBox->setCurrentIndex(playlists.size() - 1);
     }
 }
 
@@ -1247,10 +1302,16 @@ void Widget::onDeletePlaylistClicked()
                                     .arg(playlists[currentPlaylistIndex].name),
                                     QMessageBox::Yes | QMessageBox::No);
     if (ret == QMessageBox::Yes) {
-        videoDisplayArea->setHtml(generateWelcomeHTML());
-        currentVideoIndex = -1;
-        isPlaying = false;
-        playlists.removeAt(currentPlaylistIndex);
+        if (playlistLibrary.removePlaylist(currentPlaylistIndex)) {
+            // 刪除的是正在播放的播放清單
+            mediaPlayer->stop();
+            loadWaveform(QString());
+            currentTranscriptAudioPath.clear();
+            videoDisplayArea->setHtml(welcomeHtml());
+            clearSubtitles();
+            isPlaying = false;
+        }
+        updateTargetPlaylistComboBox();
         playlistComboBox->removeItem(currentPlaylistIndex);
     }
 }
@@ -1259,9 +1320,9 @@ void Widget::onPlaylistChanged(int index)
 {
     if (index < 0 || index >= playlists.size()) return;
     
+    // 只切換顯示中的播放清單，正在播放的曲目與播放順序不受影響
+    playlistLibrary.select(index);
     currentPlaylistIndex = index;
-    currentVideoIndex = -1;
-    playedVideosInCurrentSession.clear();
     updatePlaylistDisplay();
     updateTargetPlaylistComboBox();
     updateButtonStates();
@@ -1271,54 +1332,36 @@ void Widget::updateTargetPlaylistComboBox()
 {
     targetPlaylistComboBox->clear();
     
-    // 添加所有播放清單，除了當前播放清單
+    // 添加所有播放清單，除了正在播放的曲目所在的播放清單
     for (int i = 0; i < playlists.size(); i++) {
-        if (i != currentPlaylistIndex) {
+        if (i != playbackCursor.playlistIndex()) {
             targetPlaylistComboBox->addItem(playlists[i].name);
         }
     }
     
     // 如果有可選的播放清單，啟用按鈕和下拉選單
     bool hasTargetPlaylists = (targetPlaylistComboBox->count() > 0);
-    targetPlaylistComboBox->setEnabled(hasTargetPlaylists && currentVideoIndex >= 0);
-    addToPlaylistButton->setEnabled(hasTargetPlaylists && currentVideoIndex >= 0);
+    targetPlaylistComboBox->setEnabled(hasTargetPlaylists && playbackCursor.row() >= 0);
+    addToPlaylistButton->setEnabled(hasTargetPlaylists && playbackCursor.row() >= 0);
 }
 
 void Widget::updatePlaylistDisplay()
 {
-    playlistWidget->clear();
-    
-    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return;
-    
-    const Playlist& playlist = playlists[currentPlaylistIndex];
-    for (int i = 0; i < playlist.videos.size(); i++) {
-        const VideoInfo& video = playlist.videos[i];
-        QString displayText = QString("%1\n   %2")
-                                .arg(video.title)
-                                .arg(video.channelTitle);
-        
-        QListWidgetItem* item = new QListWidgetItem(displayText);
-        item->setData(Qt::UserRole, i);
-        
-        // 高亮當前播放的影片
-        if (i == currentVideoIndex) {
-            item->setBackground(QColor("#1DB954"));
-            item->setForeground(QColor("#FFFFFF"));
-            QFont font = item->font();
-            font.setBold(true);
-            item->setFont(font);
-        }
-        
-        playlistWidget->addItem(item);
+    // 切換到目前的播放清單（重設模型），並標示正在播放的曲目
+    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) {
+        playlistModel->setPlaylistIndex(-1);
+        return;
     }
+    
+    playlistModel->setPlaylistIndex(currentPlaylistIndex);
+    playlistModel->setCurrentRow(currentPlaylistIndex == playbackCursor.playlistIndex() ? playbackCursor.row() : -1);
 }
 
-void Widget::playVideo(int index)
+void Widget::playVideo(int playlistIndex, int index, bool sourceStarted, qint64 startPositionMs, bool paused)
 {
-    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return;
+    if (playlistIndex < 0 || playlistIndex >= playlists.size()) return;
     
-    Playlist& playlist = playlists[currentPlaylistIndex];
-    if (index < 0 || index >= playlist.videos.size()) return;
+    if (index < 0 || index >= playlists[playlistIndex].videos.size()) return;
     
     // 停止標題恢復計時器，確保切換歌曲時立即顯示新歌曲標題
     titleRestoreTimer->stop();
@@ -1326,27 +1369,41 @@ void Widget::playVideo(int index)
     // 使用 RAII guard 確保 isSwitchingSongs 標誌總是被正確重置
     SongSwitchGuard guard(isSwitchingSongs);
     
-    currentVideoIndex = index;
-    const VideoInfo& video = playlist.videos[index];
+    setPlayingPlaylist(playlistIndex);
+    // 開始播放時才移除待播佇列中已失效的項目（可能展開播放清單）
+    playbackCursor.play(playlistIndex, index);
+    const VideoInfo video = playlists[playlistIndex].videos[index];
     
-    playedVideosInCurrentSession.insert(index);
+    // 之前曲目的轉錄結果不再顯示在字幕區
+    currentTranscriptAudioPath.clear();
     
-    // 停止當前播放
-    mediaPlayer->stop();
+    if (!sourceStarted) {
+        // 停止當前播放
+        mediaPlayer->stop();
+    }
     
     if (video.isLocalFile) {
-        // 播放本地檔案
-        mediaPlayer->setSource(QUrl::fromLocalFile(video.filePath));
-        mediaPlayer->play();
+        // 播放本地檔案；預先開啟的下一首已由播放器無縫接上時不需要重新開啟
+        if (!sourceStarted) {
+            mediaPlayer->setSource(QUrl::fromLocalFile(video.filePath), loudnessGain(video, LOUDNESS_TARGET_LUFS));
+            if (startPositionMs >= 0) {
+                // 開啟完成後才定位；暫停時解碼器在背景完成初始化，之後按下播放立即從該位置開始
+                mediaPlayer->setPosition(startPositionMs);
+            }
+            if (!paused) {
+                mediaPlayer->play();
+            }
+        }
+        loadWaveform(video.filePath, !video.hasLoudness);
         
         // 清空字幕顯示
-        currentSubtitles = "";
+        clearSubtitles();
         
         QFileInfo fileInfo(video.filePath);
         updateLocalMusicDisplay(video.title, fileInfo.fileName(), "");
         
-        isPlaying = true;
-        playPauseButton->setText("⏸");
+        isPlaying = !paused;
+        playPauseButton->setText(isPlaying ? "⏸" : "▶");
         
         // 檢查是否有保存的字幕
         if (!video.subtitlePath.isEmpty() && QFile::exists(video.subtitlePath)) {
@@ -1358,30 +1415,40 @@ void Widget::playVideo(int index)
         }
     } else {
         // 播放 YouTube 影片 - 顯示連結供用戶在瀏覽器中播放
-        videoDisplayArea->setHtml(generateYouTubeDisplayHTML(video.title, video.channelTitle, video.videoId));
+        videoDisplayArea->setHtml(youTubeHtml(video.title, video.channelTitle, video.videoId));
+        loadWaveform(QString());
         isPlaying = true;
         playPauseButton->setText("⏸");
         
         // 清空字幕顯示
-        currentSubtitles = "";
+        clearSubtitles();
     }
     
     // 更新顯示
     updateVideoLabels(video);
     
-    updatePlaylistDisplay();
+    // 只重繪新舊兩列的高亮；正在播放的播放清單不在顯示中時不標示
+    if (playlistModel->playlistIndex() == playlistIndex) {
+        playlistModel->setCurrentRow(index);
+        playlistView->setCurrentIndex(playlistModel->index(index));
+    } else {
+        playlistModel->setCurrentRow(-1);
+    }
     updateButtonStates();
     
-    playlistWidget->setCurrentRow(index);
+    // 依新的播放位置調整背景轉錄的優先順序
+    updateTranscriptionQueue();
 }
 
 void Widget::updateButtonStates()
 {
     bool hasPlaylist = (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size());
-    bool hasVideos = hasPlaylist && !playlists[currentPlaylistIndex].videos.isEmpty();
-    int selectedRow = playlistWidget->currentRow();
+    bool hasVideos = (hasPlaylist && !playlists[currentPlaylistIndex].videos.isEmpty()) ||
+                     (playbackCursor.playlistIndex() >= 0 && playbackCursor.playlistIndex() < playlists.size() &&
+                      !playlists[playbackCursor.playlistIndex()].videos.isEmpty());
+    int selectedRow = playlistView->currentIndex().row();
     bool hasSelection = selectedRow >= 0;
-    bool hasMediaPlaying = currentVideoIndex >= 0;
+    bool hasMediaPlaying = playbackCursor.row() >= 0;
     
     playPauseButton->setEnabled(hasVideos || hasMediaPlaying);
     previousButton->setEnabled(hasVideos);
@@ -1397,369 +1464,289 @@ void Widget::updateButtonStates()
     loadSubtitleButton->setEnabled(isPlaying);
 }
 
-void Widget::savePlaylistsToFile()
+void Widget::playTrack(const TrackLocation& track, bool sourceStarted)
 {
-    QString configDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir dir;
-    if (!dir.exists(configDir)) {
-        dir.mkpath(configDir);
-    }
-    
-    QString configFile = configDir + "/youtube_playlists.json";
+    playbackCursor.dequeue(track.queueHandle);
+    playVideo(track.playlistIndex, track.row, sourceStarted);
+}
+
+void Widget::setPlayingPlaylist(int index)
+{
+    if (index == playbackCursor.playlistIndex()) return;
     
-    QJsonObject rootObj;
-    QJsonArray playlistsArray;
+    playbackCursor.setPlaylist(index);
+    updateTargetPlaylistComboBox();
+}
+
+const VideoInfo* Widget::currentVideo() const
+{
+    return playbackCursor.currentVideo();
+}
+
+void Widget::checkpointPlayback()
+{
+    // 沒有正在播放的曲目時寫入空的狀態，下次啟動不恢復
+    const PlaybackState state = playbackCursor.checkpoint(mediaPlayer->position());
     
-    for (const Playlist& playlist : playlists) {
-        QJsonObject playlistObj;
-        playlistObj["name"] = playlist.name;
-        
-        QJsonArray videosArray;
-        for (const VideoInfo& video : playlist.videos) {
-            QJsonObject videoObj;
-            videoObj["videoId"] = video.videoId;
-            videoObj["filePath"] = video.filePath;
-            videoObj["title"] = video.title;
-            videoObj["channelTitle"] = video.channelTitle;
-            videoObj["thumbnailUrl"] = video.thumbnailUrl;
-            videoObj["description"] = video.description;
-            videoObj["subtitlePath"] = video.subtitlePath;
-            videoObj["isFavorite"] = video.isFavorite;
-            videoObj["isLocalFile"] = video.isLocalFile;
-            videosArray.append(videoObj);
-        }
-        playlistObj["videos"] = videosArray;
-        playlistsArray.append(playlistObj);
+    if (state.playlistName == lastCheckpoint.playlistName && state.trackKey == lastCheckpoint.trackKey &&
+        state.positionMs == lastCheckpoint.positionMs) {
+        return;
     }
+    lastCheckpoint = state;
+    playlistStore->savePlaybackState(state);
+}
+
+void Widget::restorePlayback()
+{
+    PlaybackState state;
+    if (!playlistStore->loadPlaybackState(state) || state.trackKey.isEmpty()) return;
+    lastCheckpoint = state;
     
-    rootObj["playlists"] = playlistsArray;
-    if (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
-        rootObj["lastPlaylist"] = playlists[currentPlaylistIndex].name;
+    const TrackLocation track = playbackCursor.locate(state);
+    if (track.row < 0) return;
+    playVideo(track.playlistIndex, track.row, false, state.positionMs, true);
+}
+
+void Widget::queueTrack(int row, bool playNext)
+{
+    playbackCursor.enqueue(currentPlaylistIndex, row, playNext);
+    
+    // 接下來的曲目改變，調整預先轉錄與預先開啟的下一首
+    updateTranscriptionQueue();
+}
+
+void Widget::onSearchTextChanged(const QString& text)
+{
+    // 沒有搜尋文字時回到播放清單
+    const QString query = text.trimmed();
+    searchResultsView->clear();
+    searchResultsView->setVisible(!query.isEmpty());
+    playlistView->setVisible(query.isEmpty());
+    if (query.isEmpty()) return;
+    
+    const QList<SearchHit> hits = searchIndexer->search(query, SEARCH_RESULT_LIMIT);
+    for (const SearchHit& hit : hits) {
+        QString label = hit.title;
+        if (!hit.channelTitle.isEmpty()) {
+            label += " — " + hit.channelTitle;
+        }
+        if (hit.startMs >= 0) {
+            // 字幕段落命中：顯示段落的開始時間與文字
+            const qint64 totalSeconds = hit.startMs / 1000;
+            label = QString("💬 %1:%2  %3\n      %4")
+                .arg(totalSeconds / 60, 2, 10, QChar('0'))
+                .arg(totalSeconds % 60, 2, 10, QChar('0'))
+                .arg(hit.text, label);
+        } else {
+            label = "🎵 " + label;
+        }
+        
+        QListWidgetItem* item = new QListWidgetItem(label, searchResultsView);
+        item->setData(Qt::UserRole, hit.trackKey);
+        item->setData(Qt::UserRole + 1, hit.startMs);
     }
     
-    QJsonDocument doc(rootObj);
-    QFile file(configFile);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
+    if (hits.isEmpty()) {
+        QListWidgetItem* item = new QListWidgetItem("找不到符合的曲目或字幕", searchResultsView);
+        item->setFlags(Qt::NoItemFlags);
     }
 }
 
-void Widget::loadPlaylistsFromFile()
+void Widget::onSearchResultActivated(QListWidgetItem* item)
 {
-    QString configDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QString configFile = configDir + "/youtube_playlists.json";
-    
-    QFile file(configFile);
-    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+    if (!item) return;
+    const QString key = item->data(Qt::UserRole).toString();
+    if (key.isEmpty()) return;
+    
+    const TrackLocation track = playbackCursor.locate(key, currentPlaylistIndex);
+    if (track.row < 0) {
+        // 曲目已從所有播放清單刪除，索引中的資料也一併移除
+        searchIndexer->removeTracks({ key });
+        onSearchTextChanged(searchEdit->text());
+        QMessageBox::information(this, "搜尋", "這首曲目已不在任何播放清單中。");
         return;
     }
     
-    QByteArray data = file.readAll();
-    file.close();
-    
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (!doc.isObject()) {
+    // 字幕段落命中時跳到該段落：正在播放的就是這首曲目時直接跳轉，否則載入曲目並從該段落開始播放
+    const qint64 startMs = item->data(Qt::UserRole + 1).toLongLong();
+    if (startMs >= 0 && track.playlistIndex == playbackCursor.playlistIndex() && track.row == playbackCursor.row() &&
+        mediaPlayer->playbackState() != QMediaPlayer::StoppedState) {
+        seekToSubtitle(startMs);
+        if (mediaPlayer->playbackState() != QMediaPlayer::PlayingState) {
+            onPlayPauseClicked();
+        }
         return;
     }
-    
-    QJsonObject rootObj = doc.object();
-    lastPlaylistName = rootObj["lastPlaylist"].toString();
-    
-    QJsonArray playlistsArray = rootObj["playlists"].toArray();
-    playlists.clear();
-    
-    for (const QJsonValue& value : playlistsArray) {
-        QJsonObject playlistObj = value.toObject();
-        Playlist playlist;
-        playlist.name = playlistObj["name"].toString();
-        
-        QJsonArray videosArray = playlistObj["videos"].toArray();
-        for (const QJsonValue& videoValue : videosArray) {
-            QJsonObject videoObj = videoValue.toObject();
-            VideoInfo video;
-            video.videoId = videoObj["videoId"].toString();
-            video.filePath = videoObj["filePath"].toString();
-            video.title = videoObj["title"].toString();
-            video.channelTitle = videoObj["channelTitle"].toString();
-            video.thumbnailUrl = videoObj["thumbnailUrl"].toString();
-            video.description = videoObj["description"].toString();
-            video.subtitlePath = videoObj["subtitlePath"].toString();
-            video.isFavorite = videoObj["isFavorite"].toBool();
-            video.isLocalFile = videoObj["isLocalFile"].toBool();
-            
-            playlist.videos.append(video);
-        }
-        playlists.append(playlist);
+    playVideo(track.playlistIndex, track.row, false, startMs);
+}
+
+void Widget::onSearchIndexLoaded()
+{
+    // 已經輸入搜尋文字時，以完整的索引重新搜尋
+    if (!searchEdit->text().trimmed().isEmpty()) {
+        onSearchTextChanged(searchEdit->text());
     }
 }
 
-int Widget::getNextVideoIndex()
+void Widget::updateVideoLabels(const VideoInfo& video)
 {
-    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return -1;
+    videoTitleLabel->setText(video.title);
+    channelLabel->setText(video.channelTitle);
+}
+
+void Widget::startWhisperTranscription(const QString& audioFilePath)
+{
+    // 清空字幕內容
+    currentSubtitles = "";
     
-    Playlist& playlist = playlists[currentPlaylistIndex];
-    if (playlist.videos.isEmpty()) return -1;
+    // 相同內容的音訊曾經轉錄過（即使檔名或位置不同），直接載入快取的字幕
+    const QString cachedSrtPath = transcriptionQueue->lookup(audioFilePath);
+    if (!cachedSrtPath.isEmpty()) {
+        loadSrt(cachedSrtPath);
+        playlistLibrary.saveTranscript(audioFilePath, cachedSrtPath);
+        return;
+    }
     
-    if (isShuffleMode) {
-        return getRandomVideoIndex(true);
+    // 排入背景轉錄佇列，完成後由 onTranscriptReady() 載入字幕
+    currentTranscriptAudioPath = audioFilePath;
+    if (transcriptionQueue->isRunning(audioFilePath)) {
+        currentSubtitles = "<p style='color: #1DB954;'>正在使用 " + transcriptionQueue->engineName(audioFilePath) + " 進行語音轉錄...</p>"
+                          "<p style='color: #888;'>請稍候，轉錄完成後字幕將自動顯示</p>";
     } else {
-        int newIndex = currentVideoIndex + 1;
-        if (newIndex >= playlist.videos.size()) {
-            if (isRepeatMode) {
-                return 0;
-            } else {
-                return -1;
-            }
-        }
-        return newIndex;
+        currentSubtitles = "<p style='color: #1DB954;'>已排入語音轉錄佇列...</p>"
+                          "<p style='color: #888;'>請稍候，轉錄完成後字幕將自動顯示</p>";
     }
+    updateSubtitleDisplay();
 }
 
-int Widget::getRandomVideoIndex(bool excludeCurrent)
+void Widget::updateTranscriptionQueue()
 {
-    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return -1;
-    
-    Playlist& playlist = playlists[currentPlaylistIndex];
-    if (playlist.videos.isEmpty()) return -1;
+    // 正在播放的曲目最優先
+    QStringList priorities;
+    if (!currentTranscriptAudioPath.isEmpty()) {
+        priorities.append(currentTranscriptAudioPath);
+    }
     
-    if (playlist.videos.size() == 1) {
-        if (excludeCurrent && currentVideoIndex == 0) {
-            return -1;
+    // 接著依待播佇列與播放順序預先轉錄接下來的曲目，隨機播放時使用預先抽好的順序
+    for (const TrackLocation& track : playbackCursor.upcoming(transcriptionLookahead)) {
+        const VideoInfo& video = playlists[track.playlistIndex].videos[track.row];
+        if (needsTranscription(video)) {
+            priorities.append(video.filePath);
         }
-        return 0;
     }
     
-    QList<int> unplayedVideos = getUnplayedVideoIndices(excludeCurrent);
+    transcriptionQueue->setPriorities(priorities);
     
-    if (unplayedVideos.isEmpty() && isRepeatMode) {
-        playedVideosInCurrentSession.clear();
-        unplayedVideos = getUnplayedVideoIndices(excludeCurrent);
-    }
-    
-    if (unplayedVideos.isEmpty()) {
-        return -1;
-    }
-    
-    int randomIndex = QRandomGenerator::global()->bounded(unplayedVideos.size());
-    return unplayedVideos[randomIndex];
+    // 接下來的曲目改變時，預先開啟的下一首也要跟著改變
+    preloadNextTrack();
 }
 
-QList<int> Widget::getUnplayedVideoIndices(bool excludeCurrent)
+void Widget::preloadNextTrack()
 {
-    QList<int> unplayedVideos;
-    
-    if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) {
-        return unplayedVideos;
-    }
-    
-    Playlist& playlist = playlists[currentPlaylistIndex];
-    
-    for (int i = 0; i < playlist.videos.size(); i++) {
-        if (!playedVideosInCurrentSession.contains(i)) {
-            if (!excludeCurrent || i != currentVideoIndex) {
-                unplayedVideos.append(i);
+    // 與預先轉錄相同，取接下來的第一首：待播佇列的第一項，或隨機播放預先抽好的那一首
+    QUrl nextSource;
+    float nextGain = 1.0f;
+    const TrackLocation next = playbackCursor.next();
+    if (next.row >= 0) {
+        const VideoInfo& video = playlists[next.playlistIndex].videos[next.row];
+        if (video.isLocalFile) {
+            nextSource = QUrl::fromLocalFile(video.filePath);
+            nextGain = loudnessGain(video, LOUDNESS_TARGET_LUFS);
+            // 下一首還沒有響度時優先分析，開始播放前就能套用增益
+            if (!video.hasLoudness) {
+                loudnessScanner->prioritize({ video.filePath });
             }
         }
     }
-    
-    return unplayedVideos;
-}
-
-// 通用 HTML 基礎樣式
-static const QString BASE_HTML_STYLE = 
-    "body { background-color: #000000; color: #FFFFFF; font-family: Arial, sans-serif; text-align: center; padding: 50px; }"
-    "h2 { color: #1DB954; font-size: 32px; margin-bottom: 20px; }"
-    "p { font-size: 18px; margin: 20px 0; color: #B3B3B3; }";
-
-QString Widget::generateWelcomeHTML()
-{
-    return QString(
-        "<!DOCTYPE html>"
-        "<html>"
-        "<head>"
-        "<style>%1</style>"
-        "</head>"
-        "<body>"
-        "<h2>🎵 音樂播放器</h2>"
-        "<p>選擇一首歌曲開始播放</p>"
-        "</body>"
-        "</html>"
-    ).arg(BASE_HTML_STYLE);
-}
-
-QString Widget::generateYouTubeDisplayHTML(const QString& title, const QString& channel, const QString& videoId)
-{
-    QString watchUrl = QString("https://www.youtube.com/watch?v=%1").arg(videoId);
-    return QString(
-        "<!DOCTYPE html>"
-        "<html>"
-        "<head>"
-        "<style>"
-        "%1"
-        "a { color: #1DB954; text-decoration: none; font-size: 20px; font-weight: bold; }"
-        "a:hover { color: #1ED760; text-decoration: underline; }"
-        ".info { font-size: 14px; color: #888; margin: 30px 0; }"
-        "</style>"
-        "</head>"
-        "<body>"
-        "<h2>🎵 %2</h2>"
-        "<p>%3</p>"
-        "<div style='margin: 40px 0;'>"
-        "<a href='%4'>🔗 點擊此處在瀏覽器中播放</a>"
-        "</div>"
-        "<p class='info'>由於不使用 WebEngine，YouTube 影片將在瀏覽器中播放</p>"
-        "</body>"
-        "</html>"
-    ).arg(BASE_HTML_STYLE)
-     .arg(title.toHtmlEscaped())
-     .arg(channel.toHtmlEscaped())
-     .arg(watchUrl);
-}
-
-QString Widget::generateLocalMusicHTML(const QString& title, const QString& fileName)
-{
-    return QString(
-        "<!DOCTYPE html>"
-        "<html>"
-        "<head>"
-        "<style>"
-        "%1"
-        ".subtitle-section { margin-top: 30px; padding-top: 20px; border-top: 1px solid #282828; }"
-        ".subtitle-title { font-size: 16px; color: #1DB954; margin-bottom: 10px; font-weight: bold; }"
-        ".subtitle-content { font-size: 14px; color: #B3B3B3; line-height: 1.6; }"
-        "</style>"
-        "</head>"
-        "<body>"
-        "<h2>🎵 %2</h2>"
-        "<p style='font-size: 14px; color: #888;'>本地音樂</p>"
-        "<div class='subtitle-section' id='subtitle-area'>"
-        "<div class='subtitle-title'>📝 字幕</div>"
-        "<div class='subtitle-content' id='subtitle-content'>正在載入字幕，點擊時間戳可跳轉到該位置...</div>"
-        "</div>"
-        "</body>"
-        "</html>"
-    ).arg(BASE_HTML_STYLE)
-     .arg(title.toHtmlEscaped());
+    mediaPlayer->setNextSource(nextSource, nextGain);
 }
 
-void Widget::updateVideoLabels(const VideoInfo& video)
+void Widget::loadWaveform(const QString& audioFilePath, bool measureLoudness)
 {
-    videoTitleLabel->setText(video.title);
-    channelLabel->setText(video.channelTitle);
+    // 不再需要之前曲目的波形；快取、解碼與響度都交給掃描器，背景已在分析的檔案不會再解碼一次
+    progressSlider->clearPeaks();
+    waveformAudioPath = audioFilePath;
+    loudnessScanner->analyzePlaying(audioFilePath, measureLoudness);
 }
 
-QString Widget::createVideoDisplayHTML(const VideoInfo& video)
+void Widget::onWaveformReady(const QString& audioFilePath, const WaveformPeaks& peaks)
 {
-    QString watchUrl = QString("https://www.youtube.com/watch?v=%1").arg(video.videoId);
-    QString escapedTitle = video.title.toHtmlEscaped();
-    QString escapedChannel = video.channelTitle.toHtmlEscaped();
+    // 只顯示正在播放曲目的波形
+    if (audioFilePath != waveformAudioPath || peaks.isEmpty()) return;
+    progressSlider->setPeaks(peaks);
+}
+
+void Widget::onTrackLoudnessAnalyzed(const QString& audioFilePath, double loudness, float peak)
+{
+    // 寫回各播放清單中的同一首曲目；尚未展開的播放清單之後播放時再分析
+    playlistLibrary.saveLoudness(audioFilePath, loudness, peak);
     
-    return QString(
-        "<div style='text-align: center;'>"
-        "<h2 style='color: #1DB954;'>🎵 YouTube 影片</h2>"
-        "<p style='font-size: 18px; margin: 20px 0;'>%1</p>"
-        "<p style='font-size: 14px; color: #888; margin: 10px 0;'>頻道: %2</p>"
-        "<p style='margin: 30px 0;'><a href='%3' style='color: #1DB954; text-decoration: none; font-size: 16px;'>🔗 在瀏覽器中播放</a></p>"
-        "<p style='color: #666; font-size: 12px;'>點擊上方連結在您的瀏覽器中觀看此影片</p>"
-        "</div>"
-    ).arg(escapedTitle).arg(escapedChannel).arg(watchUrl);
+    // 預先開啟的下一首更新增益；正在播放的曲目不在途中改變音量，下次播放時才套用
+    if (mediaPlayer->nextSource() == QUrl::fromLocalFile(audioFilePath)) {
+        preloadNextTrack();
+    }
 }
 
-void Widget::startWhisperTranscription(const QString& audioFilePath)
+void Widget::onLoudnessScanProgress(int done, int total)
 {
-    // 停止現有的 Whisper/Vibe 處理程序
-    if (whisperProcess->state() != QProcess::NotRunning) {
-        whisperProcess->kill();
-        whisperProcess->waitForFinished();
+    if (total > 0) {
+        loudnessStatusLabel->setText(QString("🔊 分析響度 %1/%2").arg(done).arg(total));
+        loudnessStatusLabel->show();
     }
+}
+
+void Widget::onTranscriptionStarted(const QString& audioFilePath)
+{
+    if (audioFilePath != currentTranscriptAudioPath) return;
     
-    // 清空字幕內容
-    currentSubtitles = "";
-    
-    // 生成 SRT 輸出檔案路徑（使用跨平台路徑構建）
-    QFileInfo audioFileInfo(audioFilePath);
-    QString baseName = audioFileInfo.completeBaseName();
-    QDir outputDir(audioFileInfo.absolutePath());
-    currentSrtFilePath = outputDir.filePath(baseName + ".srt");
-    
-    // 準備 Vibe CLI 參數
-    // vibe <audioFilePath> --output <output.srt>
-    QStringList arguments;
-    arguments << audioFilePath << "--output" << currentSrtFilePath;
+    // 轉錄重新開始（例如服務重新啟動後重送）時，先前收到的分段會再送一次
+    clearSubtitles();
+    currentSubtitles = "<p style='color: #1DB954;'>正在使用 " + transcriptionQueue->engineName(audioFilePath) + " 進行語音轉錄...</p>"
+                      "<p style='color: #888;'>請稍候，字幕會隨轉錄進度陸續顯示</p>";
+    updateSubtitleDisplay();
+}
+
+void Widget::onTranscriptionOutput(const QString& audioFilePath, const QString& text)
+{
+    // 只顯示正在播放曲目的進度訊息
+    if (audioFilePath != currentTranscriptAudioPath) return;
     
-    // 啟動 Vibe 處理程序
-    whisperProcess->start("vibe", arguments);
+    // 轉錄工具可能輸出進度訊息，只顯示最新的一則，避免訊息越積越多
+    // 主要的字幕內容會在完成後從 SRT 檔案載入
+    currentSubtitles = "<p style='color: #1DB954;'>正在使用 " + transcriptionQueue->engineName(audioFilePath) + " 進行語音轉錄...</p>"
+                      "<p style='color: #B3B3B3;'>" + text.toHtmlEscaped() + "</p>";
     
-    if (!whisperProcess->waitForStarted(3000)) {
-        currentSubtitles = "<p style='color: #888;'>錯誤: 無法啟動 Vibe CLI</p>"
-                          "<p style='color: #888;'>請確保已安裝 Vibe (Whisper CLI)</p>"
-                          "<p style='color: #888;'>提示: 可使用 pip install whisper-ctranslate2 或其他 Whisper CLI 工具</p>";
-    } else {
-        currentSubtitles = "<p style='color: #1DB954;'>正在使用 Vibe 進行語音轉錄...</p>"
-                          "<p style='color: #888;'>請稍候，轉錄完成後字幕將自動顯示</p>";
-        // 更新顯示
-        if (currentVideoIndex >= 0 && currentPlaylistIndex >= 0 && 
-            currentPlaylistIndex < playlists.size()) {
-            const Playlist& playlist = playlists[currentPlaylistIndex];
-            if (currentVideoIndex < playlist.videos.size()) {
-                const VideoInfo& video = playlist.videos[currentVideoIndex];
-                if (video.isLocalFile) {
-                    QFileInfo fileInfo(video.filePath);
-                    updateLocalMusicDisplay(video.title, fileInfo.fileName(), currentSubtitles);
-                }
-            }
-        }
-    }
+    // 更新顯示（如果當前正在播放本地檔案）
+    updateSubtitleDisplay();
 }
 
-void Widget::onWhisperOutputReady()
+void Widget::onTranscriptSegment(const QString& audioFilePath, qint64 startMs, qint64 endMs, const QString& text)
 {
-    // 讀取 Vibe CLI 的標準輸出（進度訊息等）
-    QByteArray output = whisperProcess->readAllStandardOutput();
-    QString text = QString::fromUtf8(output).trimmed();
+    if (audioFilePath != currentTranscriptAudioPath) return;
     
-    if (!text.isEmpty()) {
-        // Vibe 可能輸出進度訊息，我們可以顯示它們
-        // 但主要的字幕內容會在完成後從 SRT 檔案載入
-        QString htmlText = "<p style='color: #B3B3B3;'>" + text.toHtmlEscaped() + "</p>";
-        currentSubtitles += htmlText;
-        
-        // 更新顯示（如果當前正在播放本地檔案）
+    // 分段直接加入字幕清單，完成後再由 SRT 檔案取代
+    const bool wasEmpty = subtitleModel->rowCount() == 0;
+    subtitleModel->appendCue(startMs, endMs, text);
+    updateActiveSubtitle(mediaPlayer->position());
+    
+    if (wasEmpty) {
+        // 第一個分段：顯示字幕清單
+        subtitleView->show();
         updateSubtitleDisplay();
     }
 }
 
 void Widget::updateLocalMusicDisplay(const QString& title, const QString& fileName, const QString& subtitles)
 {
-    QString subtitleContent = subtitles.isEmpty() ? 
-        "正在載入字幕，點擊時間戳可跳轉到該位置..." : subtitles;
-    
-    QString html = QString(
-        "<!DOCTYPE html>"
-        "<html>"
-        "<head>"
-        "<style>"
-        "%1"
-        ".subtitle-section { margin-top: 30px; padding-top: 20px; border-top: 1px solid #282828; }"
-        ".subtitle-title { font-size: 16px; color: #1DB954; margin-bottom: 10px; font-weight: bold; }"
-        ".subtitle-content { font-size: 14px; color: #B3B3B3; line-height: 1.6; }"
-        "</style>"
-        "</head>"
-        "<body>"
-        "<h2>🎵 %2</h2>"
-        "<p style='font-size: 14px; color: #888;'>本地音樂</p>"
-        "<div class='subtitle-section'>"
-        "<div class='subtitle-title'>📝 字幕</div>"
-        "<div class='subtitle-content'>%3</div>"
-        "</div>"
-        "</body>"
-        "</html>"
-    ).arg(BASE_HTML_STYLE)
-     .arg(title.toHtmlEscaped())
-     .arg(subtitleContent);
-    
-    videoDisplayArea->setHtml(html);
+    // 字幕段落顯示在下方的清單中，這裡只放狀態訊息
+    const bool hasCues = subtitleModel->rowCount() > 0;
+    QString subtitleContent = subtitles;
+    if (subtitleContent.isEmpty()) {
+        subtitleContent = hasCues ? "點擊下方時間戳可跳轉到該位置" : "正在載入字幕，點擊時間戳可跳轉到該位置...";
+    }
+    subtitleView->setVisible(hasCues);
+    
+    videoDisplayArea->setHtml(localMusicHtml(title, subtitleContent));
 }
 
 void Widget::onSubtitleLinkClicked(const QUrl& url)
@@ -1770,33 +1757,46 @@ void Widget::onSubtitleLinkClicked(const QUrl& url)
     double seconds = timeStr.toDouble(&ok);
     
     if (ok && std::isfinite(seconds) && seconds >= 0) {
-        // 檢查是否超出媒體時長
-        qint64 duration = mediaPlayer->duration();
-        qint64 positionMs = static_cast<qint64>(seconds * 1000);
+        seekToSubtitle(static_cast<qint64>(seconds * 1000));
+    }
+}
+
+void Widget::onSubtitleCueClicked(const QModelIndex& index)
+{
+    if (!index.isValid()) return;
+    seekToSubtitle(index.data(SubtitleModel::StartMsRole).toLongLong());
+}
+
+void Widget::seekToSubtitle(qint64 positionMs)
+{
+    // 檢查是否超出媒體時長
+    qint64 duration = mediaPlayer->duration();
+    if (duration > 0 && positionMs > duration) {
+        QMessageBox::warning(this, "提示", "時間戳超出音樂總長度。");
+        return;
+    }
+    
+    // 跳轉到指定位置
+    if (mediaPlayer->playbackState() != QMediaPlayer::StoppedState) {
+        mediaPlayer->setPosition(positionMs);
         
-        if (duration > 0 && positionMs > duration) {
-            QMessageBox::warning(this, "提示", "時間戳超出音樂總長度。");
-            return;
-        }
+        // 主動跳轉時恢復自動捲動，並立即標示跳轉後的段落
+        subtitleScrollHoldTimer->stop();
+        updateActiveSubtitle(positionMs);
         
-        // 跳轉到指定位置
-        if (mediaPlayer->playbackState() != QMediaPlayer::StoppedState) {
-            mediaPlayer->setPosition(positionMs);
-            
-            // 顯示提示訊息（使用四捨五入確保準確顯示）
-            int totalSeconds = qRound(seconds);
-            QString timeDisplay = QString("%1:%2")
-                .arg(totalSeconds / 60, 2, 10, QChar('0'))
-                .arg(totalSeconds % 60, 2, 10, QChar('0'));
-            
-            videoTitleLabel->setText(QString("跳轉到 %1").arg(timeDisplay));
-            
-            // 停止任何正在進行的標題恢復計時器，然後啟動新的
-            titleRestoreTimer->stop();
-            titleRestoreTimer->start(2000);  // 2 秒後恢復原標題
-        } else {
-            QMessageBox::information(this, "提示", "請先播放音樂後再跳轉到字幕位置。");
-        }
+        // 顯示提示訊息（使用四捨五入確保準確顯示）
+        int totalSeconds = qRound(positionMs / 1000.0);
+        QString timeDisplay = QString("%1:%2")
+            .arg(totalSeconds / 60, 2, 10, QChar('0'))
+            .arg(totalSeconds % 60, 2, 10, QChar('0'));
+        
+        videoTitleLabel->setText(QString("跳轉到 %1").arg(timeDisplay));
+        
+        // 停止任何正在進行的標題恢復計時器，然後啟動新的
+        titleRestoreTimer->stop();
+        titleRestoreTimer->start(2000);  // 2 秒後恢復原標題
+    } else {
+        QMessageBox::information(this, "提示", "請先播放音樂後再跳轉到字幕位置。");
     }
 }
 
@@ -1837,7 +1837,7 @@ void Widget::onVolumeSliderChanged(int value)
     
     // 設置音量（value/100，範圍 1% 到 100%）
     qreal volume = value / 100.0;
-    audioOutput->setVolume(volume);
+    mediaPlayer->setVolume(volume);
     
     // 更新音量圖標
     updateVolumeIcon(value);
@@ -1858,31 +1858,43 @@ void Widget::updateVolumeIcon(int volume)
 
 void Widget::restoreCurrentVideoTitle()
 {
-    if (currentVideoIndex >= 0 && currentPlaylistIndex >= 0 && 
-        currentPlaylistIndex < playlists.size()) {
-        const Playlist& playlist = playlists[currentPlaylistIndex];
-        if (currentVideoIndex < playlist.videos.size()) {
-            videoTitleLabel->setText(playlist.videos[currentVideoIndex].title);
-        }
+    if (const VideoInfo* video = currentVideo()) {
+        videoTitleLabel->setText(video->title);
     }
 }
 
 void Widget::updateSubtitleDisplay()
 {
     // Helper function to update subtitle display for current playing video
-    if (currentVideoIndex >= 0 && currentPlaylistIndex >= 0 && 
-        currentPlaylistIndex < playlists.size()) {
-        const Playlist& playlist = playlists[currentPlaylistIndex];
-        if (currentVideoIndex < playlist.videos.size()) {
-            const VideoInfo& video = playlist.videos[currentVideoIndex];
-            if (video.isLocalFile) {
-                QFileInfo fileInfo(video.filePath);
-                updateLocalMusicDisplay(video.title, fileInfo.fileName(), currentSubtitles);
-            }
-        }
+    const VideoInfo* video = currentVideo();
+    if (video && video->isLocalFile) {
+        QFileInfo fileInfo(video->filePath);
+        updateLocalMusicDisplay(video->title, fileInfo.fileName(), currentSubtitles);
+    }
+}
+
+void Widget::updateActiveSubtitle(qint64 positionMs)
+{
+    // 二分搜尋播放位置所在的段落，沒有改變時不做任何事
+    const int row = subtitleModel->rowAt(positionMs);
+    if (row == subtitleModel->activeRow()) return;
+    
+    // 只重繪新舊兩列
+    subtitleModel->setActiveRow(row);
+    
+    // 使用者剛捲動過字幕清單時不搶回捲動位置
+    if (row >= 0 && subtitleView->isVisible() && !subtitleScrollHoldTimer->isActive()) {
+        subtitleView->scrollTo(subtitleModel->index(row), QAbstractItemView::PositionAtCenter);
     }
 }
 
+void Widget::clearSubtitles()
+{
+    currentSubtitles = "";
+    subtitleModel->clear();
+    subtitleView->hide();
+}
+
 void Widget::loadSrt(const QString& srtFilePath)
 {
     // 檢查 SRT 檔案是否存在
@@ -1893,185 +1905,98 @@ void Widget::loadSrt(const QString& srtFilePath)
         return;
     }
     
-    // 讀取 SRT 檔案
-    QFile srtFile(srtFilePath);
-    if (!srtFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    // 以串流解析器單次掃描讀取 SRT/WebVTT，得到緊湊的段落陣列
+    bool ok = false;
+    SubtitleCueList cues = SubtitleParser::parseFile(srtFilePath, &ok);
+    if (!ok) {
         currentSubtitles += "<p style='color: #888;'>錯誤: 無法開啟 SRT 檔案</p>";
         updateSubtitleDisplay();
         return;
     }
     
-    QTextStream in(&srtFile);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    in.setEncoding(QStringConverter::Utf8);
-#else
-    in.setCodec("UTF-8");
-#endif
-    
-    QString srtContent = in.readAll();
-    srtFile.close();
-    
-    // 解析 SRT 格式並轉換為可點擊的 HTML
-    // SRT 格式：
-    // 1
-    // 00:00:00,000 --> 00:00:05,230
-    // 這是一段文字
-    //
-    // 2
-    // 00:00:05,230 --> 00:00:10,000
-    // 這是另一段文字
-    
-    QString htmlSubtitles;
-    QTextStream stream(&htmlSubtitles);
-    
-    // 使用類別成員的正則表達式解析 SRT（避免重複編譯）
-    QStringList lines = srtContent.split('\n');
-    int i = 0;
-    
-    while (i < lines.size()) {
-        QString line = lines[i].trimmed();
-        
-        // 跳過空行
-        if (line.isEmpty()) {
-            i++;
-            continue;
-        }
-        
-        // 跳過序號行（純數字）- 使用類別成員 regex
-        if (sequenceNumberRegex.match(line).hasMatch()) {
-            i++;
-            continue;
-        }
-        
-        // 檢查是否為時間戳行 - 使用類別成員 regex
-        QRegularExpressionMatch match = srtTimestampRegex.match(line);
-        if (match.hasMatch()) {
-            // 提取開始時間
-            int startHour = match.captured(1).toInt();
-            int startMin = match.captured(2).toInt();
-            int startSec = match.captured(3).toInt();
-            int startMs = match.captured(4).toInt();
-            
-            // 提取結束時間
-            int endHour = match.captured(5).toInt();
-            int endMin = match.captured(6).toInt();
-            int endSec = match.captured(7).toInt();
-            int endMs = match.captured(8).toInt();
-            
-            // 計算以秒為單位的時間
-            double startTime = startHour * 3600 + startMin * 60 + startSec + startMs / 1000.0;
-            double endTime = endHour * 3600 + endMin * 60 + endSec + endMs / 1000.0;
-            
-            // 格式化時間戳顯示
-            QString timestamp = QString("[%1s - %2s]")
-                .arg(startTime, 0, 'f', 2)
-                .arg(endTime, 0, 'f', 2);
-            
-            // 讀取字幕文字（可能有多行）
-            i++;
-            QString subtitleText;
-            while (i < lines.size()) {
-                QString textLine = lines[i].trimmed();
-                
-                // 遇到空行，字幕文字結束
-                if (textLine.isEmpty()) {
-                    break;
-                }
-                
-                // 遇到序號行，字幕文字結束（緩存匹配結果）
-                QRegularExpressionMatch seqMatch = sequenceNumberRegex.match(textLine);
-                if (seqMatch.hasMatch()) {
-                    break;
-                }
-                
-                // 遇到時間戳行，字幕文字結束（異常情況，緩存匹配結果）
-                QRegularExpressionMatch tsMatch = srtTimestampRegex.match(textLine);
-                if (tsMatch.hasMatch()) {
-                    break;
-                }
-                
-                if (!subtitleText.isEmpty()) {
-                    subtitleText += " ";
-                }
-                subtitleText += textLine;
-                i++;
-            }
-            
-            // 創建可點擊的連結
-            QString clickableTimestamp = QString("<a href=\"#%1\">%2</a>")
-                .arg(startTime)
-                .arg(timestamp);
-            
-            stream << "<p>" << clickableTimestamp << " " << subtitleText.toHtmlEscaped() << "</p>";
-        } else {
-            i++;
-        }
-    }
-    
-    // 清空之前的字幕並設置新的字幕
-    currentSubtitles = htmlSubtitles;
+    // 段落交給字幕清單顯示，清除之前的狀態訊息
+    subtitleModel->setCues(std::move(cues));
+    subtitleView->setVisible(subtitleModel->rowCount() > 0);
+    currentSubtitles = "";
     
     // 更新顯示
     updateSubtitleDisplay();
 }
 
-void Widget::onWhisperFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void Widget::onTranscriptReady(const QString& audioFilePath, const QString& srtFilePath)
 {
-    QString finishMessage;
-    if (exitStatus == QProcess::CrashExit) {
-        finishMessage = "<p style='color: #888;'>[Vibe 轉錄處理程序異常終止]</p>";
-    } else if (exitCode != 0) {
-        finishMessage = QString("<p style='color: #888;'>[Vibe 轉錄處理程序結束，退出碼: %1]</p>").arg(exitCode);
-        
-        // 讀取錯誤輸出
-        QByteArray errorOutput = whisperProcess->readAllStandardError();
-        if (!errorOutput.isEmpty()) {
-            finishMessage += "<p style='color: #888;'>錯誤信息: " + QString::fromUtf8(errorOutput).toHtmlEscaped() + "</p>";
-        }
-        
-        currentSubtitles += finishMessage;
-        
-        // 更新顯示錯誤信息
-        updateSubtitleDisplay();
-    } else {
-        // 轉錄成功完成，載入 SRT 檔案
-        finishMessage = "<p style='color: #1DB954;'>[Vibe 轉錄完成，正在載入字幕...]</p>";
-        currentSubtitles += finishMessage;
-        
-        // 載入生成的 SRT 檔案
-        loadSrt(currentSrtFilePath);
-        
-        // 保存字幕路徑到當前播放的歌曲
-        if (currentVideoIndex >= 0 && currentPlaylistIndex >= 0 && 
-            currentPlaylistIndex < playlists.size() &&
-            currentVideoIndex < playlists[currentPlaylistIndex].videos.size()) {
-            playlists[currentPlaylistIndex].videos[currentVideoIndex].subtitlePath = currentSrtFilePath;
-            savePlaylistsToFile();
-        }
+    // 保存字幕路徑到所有包含這個檔案的曲目，新的字幕立即可以搜尋
+    playlistLibrary.saveTranscript(audioFilePath, srtFilePath);
+    
+    // 結果屬於正在播放的曲目時才載入字幕
+    if (audioFilePath == currentTranscriptAudioPath) {
+        currentTranscriptAudioPath.clear();
+        currentSubtitles = "<p style='color: #1DB954;'>[語音轉錄完成，正在載入字幕...]</p>";
+        loadSrt(srtFilePath);
     }
 }
 
+void Widget::onTranscriptFailed(const QString& audioFilePath, const QString& message, const QString& errorOutput)
+{
+    if (audioFilePath != currentTranscriptAudioPath) return;
+    currentTranscriptAudioPath.clear();
+    
+    QString finishMessage = "<p style='color: #888;'>[" + message.toHtmlEscaped() + "]</p>";
+    if (!errorOutput.isEmpty()) {
+        finishMessage += "<p style='color: #888;'>錯誤信息: " + errorOutput.toHtmlEscaped() + "</p>";
+    }
+    if (message.contains("無法啟動")) {
+        finishMessage += "<p style='color: #888;'>請確保已安裝 Vibe (Whisper CLI)</p>"
+                         "<p style='color: #888;'>提示: 可使用 pip install whisper-ctranslate2 或其他 Whisper CLI 工具</p>";
+    }
+    
+    currentSubtitles += finishMessage;
+    
+    // 更新顯示錯誤信息
+    updateSubtitleDisplay();
+}
 
 void Widget::onPlaylistContextMenu(const QPoint& pos)
 {
-    QListWidgetItem* item = playlistWidget->itemAt(pos);
-    if (!item) return;
+    QModelIndex index = playlistView->indexAt(pos);
+    if (!index.isValid()) return;
     
-    int itemRow = playlistWidget->row(item);
+    int itemRow = index.row();
     
     QMenu contextMenu(this);
     
     QAction* playAction = contextMenu.addAction("▶ 播放");
+    QAction* playNextAction = contextMenu.addAction("⏭ 下一首播放");
+    QAction* enqueueAction = contextMenu.addAction("➕ 加入待播佇列");
+    QAction* clearQueueAction = contextMenu.addAction(QString("✖ 清空待播佇列（%1 首）").arg(playbackCursor.queue().size()));
+    clearQueueAction->setEnabled(!playbackCursor.queue().isEmpty());
     QAction* deleteAction = contextMenu.addAction("🗑️ 從播放清單移除");
+    contextMenu.addSeparator();
+    QAction* loudnessAction = contextMenu.addAction(
+        loudnessScanner->isScanning() ? "⏹ 停止分析響度" : "🔊 分析此播放清單的響度");
     
-    QAction* selectedAction = contextMenu.exec(playlistWidget->mapToGlobal(pos));
+    QAction* selectedAction = contextMenu.exec(playlistView->viewport()->mapToGlobal(pos));
     
     if (selectedAction == playAction) {
-        playVideo(itemRow);
+        playVideo(currentPlaylistIndex, itemRow);
+    } else if (selectedAction == playNextAction) {
+        queueTrack(itemRow, true);
+    } else if (selectedAction == enqueueAction) {
+        queueTrack(itemRow, false);
+    } else if (selectedAction == clearQueueAction) {
+        playbackCursor.clearQueue();
+        updateTranscriptionQueue();
     } else if (selectedAction == deleteAction) {
         // 確保選中要刪除的項目
-        playlistWidget->setCurrentRow(itemRow);
+        playlistView->setCurrentIndex(index);
         onDeleteFromPlaylist();
+    } else if (selectedAction == loudnessAction) {
+        if (loudnessScanner->isScanning()) {
+            loudnessScanner->cancel();
+        } else if (currentPlaylistIndex >= 0 && currentPlaylistIndex < playlists.size()) {
+            // 只分析還沒有響度的本地檔案
+            loudnessScanner->enqueue(playlistLibrary.unanalyzedFiles(currentPlaylistIndex));
+        }
     }
 }
 
@@ -2079,35 +2004,33 @@ void Widget::onDeleteFromPlaylist()
 {
     if (currentPlaylistIndex < 0 || currentPlaylistIndex >= playlists.size()) return;
     
-    int selectedRow = playlistWidget->currentRow();
+    int selectedRow = playlistView->currentIndex().row();
     if (selectedRow < 0) return;
     
-    Playlist& playlist = playlists[currentPlaylistIndex];
-    if (selectedRow >= playlist.videos.size()) return;
+    if (selectedRow >= playlists[currentPlaylistIndex].videos.size()) return;
     
-    // 如果刪除的是正在播放的歌曲，停止播放
-    if (selectedRow == currentVideoIndex) {
+    // 如果刪除的是正在播放的歌曲，停止播放；其餘曲目的列號由播放順序跟著模型調整
+    if (currentPlaylistIndex == playbackCursor.playlistIndex() && selectedRow == playbackCursor.row()) {
+        playbackCursor.stop();
         mediaPlayer->stop();
-        currentVideoIndex = -1;
-        videoDisplayArea->setHtml(generateWelcomeHTML());
+        loadWaveform(QString());
+        currentTranscriptAudioPath.clear();
+        videoDisplayArea->setHtml(welcomeHtml());
+        clearSubtitles();
         videoTitleLabel->setText("選擇一首歌曲開始播放");
         channelLabel->setText("");
         isPlaying = false;
         playPauseButton->setText("▶");
-    } else if (selectedRow < currentVideoIndex) {
-        // 如果刪除的歌曲在當前播放歌曲之前，需要調整索引
-        currentVideoIndex--;
     }
     
-    // 從播放清單中移除
-    playlist.videos.removeAt(selectedRow);
+    // 從播放清單中移除（模型只通知被移除的那一列，播放順序隨之調整）
+    playlistLibrary.removeTrack(currentPlaylistIndex, selectedRow);
+    
+    // 列號已改變，調整預先轉錄
+    updateTranscriptionQueue();
     
     // 更新顯示
-    updatePlaylistDisplay();
     updateButtonStates();
-    
-    // 保存變更
-    savePlaylistsToFile();
 }
 
 bool Widget::eventFilter(QObject *obj, QEvent *event)
@@ -2130,14 +2053,14 @@ void Widget::onVolumeLabelClicked()
         // 確保至少有最小音量（避免從0恢復到0的情況）
         int restoreVolume = (previousVolume >= 1) ? previousVolume : 50;
         volumeSlider->setValue(restoreVolume);
-        audioOutput->setVolume(restoreVolume / 100.0);
+        mediaPlayer->setVolume(restoreVolume / 100.0);
         updateVolumeIcon(restoreVolume);
     } else {
         // 靜音，保存當前音量
         previousVolume = volumeSlider->value();
         isMuted = true;
         // 直接設置音量為0，但不改變滑桿位置
-        audioOutput->setVolume(0.0);
+        mediaPlayer->setVolume(0.0);
         updateVolumeIcon(0);
     }
 }
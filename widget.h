@@ -10,10 +10,10 @@
 #include <QLabel>
 // 引入 Qt 滑桿元件類別
 #include <QSlider>
-// 引入 Qt 清單視窗元件類別
+// 引入 Qt 清單視圖元件類別
+#include <QListView>
+// 引入 Qt 清單元件類別
 #include <QListWidget>
-// 引入 Qt 清單視窗項目類別
-#include <QListWidgetItem>
 // 引入 Qt 下拉式選單元件類別
 #include <QComboBox>
 // 引入 Qt 單行文字輸入框元件類別
@@ -34,8 +34,6 @@
 #include <QSet>
 // 引入 Qt 媒體播放器類別
 #include <QMediaPlayer>
-// 引入 Qt 音訊輸出類別
-#include <QAudioOutput>
 // 引入 Qt 檔案對話框類別
 #include <QFileDialog>
 // 引入 Qt JSON 文件類別
@@ -54,6 +52,32 @@
 #include <QTimer>
 // 引入 Qt 事件處理類別
 #include <QEvent>
+// 引入播放清單與影片資訊結構
+#include "playlist.h"
+// 引入播放清單持久化引擎
+#include "playliststore.h"
+// 引入播放清單資料模型
+#include "playlistmodel.h"
+// 引入播放位置（正在播放的曲目、播放順序與待播佇列）
+#include "playbackcursor.h"
+// 引入搜尋索引的維護（載入、收錄與保存）
+#include "searchindexer.h"
+// 引入播放清單的編輯
+#include "playlistlibrary.h"
+// 引入資料夾匯入器
+#include "folderimporter.h"
+// 引入以音訊內容為鍵值的字幕快取
+#include "transcriptcache.h"
+// 引入背景轉錄排程器
+#include "transcriptionqueue.h"
+// 引入字幕段落資料模型
+#include "subtitlemodel.h"
+// 引入無縫接續播放的媒體播放器
+#include "gaplessplayer.h"
+// 引入顯示波形概覽的播放進度條
+#include "waveformslider.h"
+// 引入背景響度掃描器
+#include "loudnessscanner.h"
 // Qt 命名空間起始標記
 QT_BEGIN_NAMESPACE
 // 前向宣告 Ui 命名空間中的 Widget 類別
@@ -63,25 +87,6 @@ class Widget;
 // Qt 命名空間結束標記
 QT_END_NAMESPACE
 
-// 影片/音樂資訊結構
-struct VideoInfo {
-    QString videoId;          // YouTube 影片 ID (用於 YouTube 連結)
-    QString filePath;         // 本地檔案路徑 (用於本地音樂)
-    QString title;            // 影片/音樂標題
-    QString channelTitle;     // 頻道名稱/藝術家
-    QString thumbnailUrl;     // 縮圖 URL
-    QString description;      // 描述
-    QString subtitlePath;     // 字幕檔案路徑 (SRT 檔案)
-    bool isFavorite;          // 是否為喜愛的影片/音樂
-    bool isLocalFile;         // 是否為本地檔案
-};
-
-// 播放清單結構
-struct Playlist {
-    QString name;              // 播放清單名稱
-    QList<VideoInfo> videos;   // 影片列表
-};
-
 // Widget 類別，繼承自 QWidget，並使用 Q_OBJECT 宏啟用 Qt 的信號槽機制
 class Widget : public QWidget
 {
@@ -107,11 +112,19 @@ private slots:
     
     // 載入本地檔案按鈕點擊處理函式
     void onLoadLocalFileClicked();
+    // 匯入資料夾按鈕點擊處理函式（匯入中再次點擊則取消）
+    void onImportFolderClicked();
+    // 資料夾匯入的一批曲目讀取完成處理函式
+    void onImportedTracksReady(const QList<VideoInfo>& tracks);
+    // 資料夾匯入進度處理函式
+    void onImportProgressChanged(int done, int total);
+    // 資料夾匯入結束處理函式
+    void onImportFinished(bool canceled);
     // 載入字幕檔案按鈕點擊處理函式
     void onLoadSubtitleFileClicked();
     
     // 播放清單項目雙擊處理函式
-    void onVideoDoubleClicked(QListWidgetItem* item);
+    void onVideoDoubleClicked(const QModelIndex& index);
     // 加入播放清單按鈕點擊處理函式
     void onAddToPlaylistClicked();
     // 從播放清單刪除項目的處理函式
@@ -126,12 +139,27 @@ private slots:
     // 播放清單切換處理函式
     void onPlaylistChanged(int index);
     
+    // 搜尋框文字改變處理函式（即時搜尋）
+    void onSearchTextChanged(const QString& text);
+    // 搜尋結果啟用處理函式（雙擊或按 Enter 播放該曲目，字幕段落則從該段落開始播放）
+    void onSearchResultActivated(QListWidgetItem* item);
+    // 保存的搜尋索引在背景載入完成處理函式
+    void onSearchIndexLoaded();
+    
     // 媒體播放器狀態改變處理函式
     void onMediaPlayerStateChanged();
     // 媒體播放器播放位置改變處理函式
     void onMediaPlayerPositionChanged(qint64 position);
     // 媒體播放器總時長改變處理函式
     void onMediaPlayerDurationChanged(qint64 duration);
+    // 播放器已無縫接上預先開啟的下一首
+    void onMediaPlayerAdvanced(const QUrl& source);
+    // 正在播放曲目的波形峰值就緒處理函式（顯示波形）
+    void onWaveformReady(const QString& audioFilePath, const WaveformPeaks& peaks);
+    // 曲目響度分析完成處理函式（寫回播放清單）
+    void onTrackLoudnessAnalyzed(const QString& audioFilePath, double loudness, float peak);
+    // 響度掃描進度處理函式
+    void onLoudnessScanProgress(int done, int total);
     
     // 進度條按下處理函式
     void onProgressSliderPressed();
@@ -144,62 +172,76 @@ private slots:
     // 音量標籤點擊處理函式（靜音/取消靜音）
     void onVolumeLabelClicked();
     
-    // Whisper 輸出準備就緒處理函式
-    void onWhisperOutputReady();
-    // Whisper 完成處理函式
-    void onWhisperFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    // 轉錄程序啟動處理函式
+    void onTranscriptionStarted(const QString& audioFilePath);
+    // 轉錄程序輸出進度訊息處理函式
+    void onTranscriptionOutput(const QString& audioFilePath, const QString& text);
+    // 轉錄出字幕分段處理函式（邊轉錄邊加入字幕清單）
+    void onTranscriptSegment(const QString& audioFilePath, qint64 startMs, qint64 endMs, const QString& text);
+    // 轉錄完成處理函式
+    void onTranscriptReady(const QString& audioFilePath, const QString& srtFilePath);
+    // 轉錄失敗處理函式
+    void onTranscriptFailed(const QString& audioFilePath, const QString& message, const QString& errorOutput);
     
     // 字幕連結點擊處理函式（跳轉到指定時間）
     void onSubtitleLinkClicked(const QUrl& url);
+    // 字幕段落點擊處理函式（跳轉到段落開始時間）
+    void onSubtitleCueClicked(const QModelIndex& index);
 
 private:
     // 設定使用者介面的函式
     void setupUI();
     // 建立信號與槽連接的函式
     void createConnections();
-    // 更新播放清單顯示的函式
+    // 將播放清單視圖切換到目前的播放清單
     void updatePlaylistDisplay();
     // 更新目標播放清單下拉選單的函式
     void updateTargetPlaylistComboBox();
-    // 播放指定索引的影片/音樂
-    void playVideo(int index);
+    // 播放指定播放清單中指定索引的影片/音樂，sourceStarted 為 true 時播放器已開始播放該曲目（無縫接續）；
+    // startPositionMs 不為 -1 時本地檔案從該位置開始，paused 為 true 時只開啟並定位，不開始播放
+    void playVideo(int playlistIndex, int index, bool sourceStarted = false, qint64 startPositionMs = -1, bool paused = false);
+    // 播放 track，來自待播佇列時從佇列移除
+    void playTrack(const TrackLocation& track, bool sourceStarted = false);
+    // 換成由 index 播放清單決定播放順序（不影響顯示中的播放清單）
+    void setPlayingPlaylist(int index);
+    // 正在播放的曲目，沒有時回傳 nullptr
+    const VideoInfo* currentVideo() const;
+    // 將顯示中播放清單的 row 加入待播佇列，playNext 為 true 時排在最前面
+    void queueTrack(int row, bool playNext);
+    // 播放狀態有變化時寫入檢查點（由計時器定期呼叫）
+    void checkpointPlayback();
+    // 恢復上次播放的曲目：預先開啟並定位到上次的位置，按下播放即可繼續
+    void restorePlayback();
     // 更新按鈕啟用/停用狀態的函式
     void updateButtonStates();
-    // 儲存播放清單到檔案的函式
-    void savePlaylistsToFile();
-    // 從檔案載入播放清單的函式
-    void loadPlaylistsFromFile();
-    // 取得下一首影片/音樂的索引
-    int getNextVideoIndex();
-    // 取得隨機影片/音樂的索引，excludeCurrent 決定是否排除當前播放的項目
-    int getRandomVideoIndex(bool excludeCurrent = true);
-    // 取得未播放的影片/音樂索引清單
-    QList<int> getUnplayedVideoIndices(bool excludeCurrent = true);
     // 播放 YouTube 連結的函式
     void playYouTubeLink(const QString& link);
     // 播放本地檔案的函式
     void playLocalFile(const QString& filePath);
-    // 從 URL 提取 YouTube 影片 ID 的函式
-    QString extractYouTubeVideoId(const QString& url);
-    // 產生 YouTube 顯示用的 HTML 內容
-    QString generateYouTubeDisplayHTML(const QString& title, const QString& channel, const QString& videoId);
-    // 產生本地音樂顯示用的 HTML 內容
-    QString generateLocalMusicHTML(const QString& title, const QString& fileName);
-    // 產生歡迎畫面的 HTML 內容
-    QString generateWelcomeHTML();
     // 更新影片資訊標籤的函式
     void updateVideoLabels(const VideoInfo& video);
-    // 建立影片顯示用的 HTML 內容
-    QString createVideoDisplayHTML(const VideoInfo& video);
-    // 啟動 Whisper 語音轉錄的函式
+    // 啟動 Whisper 語音轉錄的函式（有快取時直接載入，否則排入轉錄佇列）
     void startWhisperTranscription(const QString& audioFilePath);
+    // 依正在播放與即將播放的曲目更新轉錄佇列的優先順序
+    void updateTranscriptionQueue();
+    // 讓播放器預先開啟下一首本地曲目，播放結束時無縫接上
+    void preloadNextTrack();
+    // 顯示曲目的波形概覽（見 LoudnessScanner::analyzePlaying()）；
+    // measureLoudness 為 true 時同一次解碼一併量測響度
+    void loadWaveform(const QString& audioFilePath, bool measureLoudness = false);
     // 載入 SRT 字幕檔案的函式
     void loadSrt(const QString& srtFilePath);
     // 更新當前播放影片的字幕顯示
     void updateSubtitleDisplay();
+    // 清除字幕段落與字幕狀態訊息
+    void clearSubtitles();
+    // 跳轉到字幕的指定位置（毫秒）並顯示提示
+    void seekToSubtitle(qint64 positionMs);
+    // 依播放位置標示正在播放的字幕段落並自動捲動
+    void updateActiveSubtitle(qint64 positionMs);
     // 恢復當前影片標題的函式
     void restoreCurrentVideoTitle();
-    // 更新本地音樂顯示區域，包含字幕內容
+    // 更新本地音樂顯示區域，subtitles 為字幕狀態訊息（段落顯示在字幕清單中）
     void updateLocalMusicDisplay(const QString& title, const QString& fileName, const QString& subtitles);
     // 根據音量等級更新音量圖示
     void updateVolumeIcon(int volume);
@@ -211,21 +253,39 @@ protected:
     // Qt Designer 產生的 UI 物件指標
     Ui::Widget *ui;
     
-    // Qt 媒體播放器物件指標
-    QMediaPlayer* mediaPlayer;
-    // Qt 音訊輸出物件指標
-    QAudioOutput* audioOutput;
+    // 媒體播放器物件指標（內含兩組播放器，預先開啟下一首）
+    GaplessPlayer* mediaPlayer;
     
-    // 影片顯示區域 - 使用 QTextBrowser 顯示內容和字幕
+    // 影片顯示區域 - 使用 QTextBrowser 顯示歌曲資訊和字幕狀態
     QTextBrowser* videoDisplayArea;
+    // 字幕段落清單視圖（只繪製可見的段落）
+    QListView* subtitleView;
+    // 字幕段落資料模型
+    SubtitleModel* subtitleModel;
     
-    // Whisper 語音轉錄外部程序物件指標
-    QProcess* whisperProcess;
-    // 當前 SRT 字幕檔案的路徑
-    QString currentSrtFilePath;
+    // 播放清單持久化引擎（快照 + 僅追加的變更日誌）
+    PlaylistStore* playlistStore;
+    // 背景資料夾匯入器
+    FolderImporter* folderImporter;
+    // 匯入目標播放清單的名稱（匯入途中切換播放清單時仍加入原本的播放清單）
+    QString importPlaylistName;
+    // 以音訊內容為鍵值的字幕快取
+    TranscriptCache transcriptCache;
+    // 背景轉錄排程器
+    TranscriptionQueue* transcriptionQueue;
+    // 波形峰值檔案的快取目錄
+    QString peaksDirectory;
+    // 正在顯示波形的音訊檔案路徑
+    QString waveformAudioPath;
+    // 背景響度掃描器
+    LoudnessScanner* loudnessScanner;
+    // 正在播放且等待轉錄結果的音訊檔案路徑，沒有時為空字串
+    QString currentTranscriptAudioPath;
     
     // 載入本地檔案的按鈕指標
     QPushButton* loadLocalFileButton;
+    // 匯入資料夾的按鈕指標
+    QPushButton* importFolderButton;
     // 載入字幕檔案的按鈕指標
     QPushButton* loadSubtitleButton;
     // 影片標題標籤指標
@@ -250,12 +310,20 @@ protected:
     QPushButton* newPlaylistButton;
     // 刪除播放清單按鈕指標
     QPushButton* deletePlaylistButton;
-    // 播放清單視窗元件指標
-    QListWidget* playlistWidget;
+    // 播放清單視圖指標
+    QListView* playlistView;
+    // 播放清單資料模型指標
+    PlaylistModel* playlistModel;
     // 播放清單選擇下拉選單指標
     QComboBox* playlistComboBox;
-    // 播放進度條滑桿指標
-    QSlider* progressSlider;
+    // 搜尋框指標
+    QLineEdit* searchEdit;
+    // 搜尋結果清單指標（有搜尋文字時取代播放清單視圖）
+    QListWidget* searchResultsView;
+    // 響度掃描進度標籤指標（掃描時顯示在播放清單下方）
+    QLabel* loudnessStatusLabel;
+    // 播放進度條滑桿指標（顯示波形概覽）
+    WaveformSlider* progressSlider;
     // 當前時間標籤指標
     QLabel* currentTimeLabel;
     // 總時長標籤指標
@@ -267,14 +335,14 @@ protected:
     
     // 所有播放清單的清單
     QList<Playlist> playlists;
-    // 當前選中的播放清單索引
+    // 當前顯示的播放清單索引
     int currentPlaylistIndex;
-    // 當前播放的影片/音樂索引
-    int currentVideoIndex;
-    // 是否啟用隨機播放模式
-    bool isShuffleMode;
-    // 是否啟用循環播放模式
-    bool isRepeatMode;
+    // 正在播放的播放清單與曲目、播放順序與待播佇列（與顯示中的播放清單無關）
+    PlaybackCursor playbackCursor;
+    // 曲目資訊與字幕的全文搜尋索引（載入、收錄與保存）
+    SearchIndexer* searchIndexer;
+    // 播放清單與曲目的新增、刪除與寫回（同步模型、播放位置、持久化與搜尋索引）
+    PlaylistLibrary playlistLibrary;
     // 是否正在播放
     bool isPlaying;
     // 追蹤進度條是否被使用者按下
@@ -285,20 +353,18 @@ protected:
     int previousVolume;
     // 追蹤是否正在手動切換歌曲
     bool isSwitchingSongs;
-    // 上次使用的播放清單名稱
-    QString lastPlaylistName;
-    // 當前會話中已播放的影片/音樂索引集合
-    QSet<int> playedVideosInCurrentSession;
-    // 用於解析字幕時間戳的正則表達式
-    QRegularExpression subtitleTimestampRegex;
-    // 用於解析 SRT 格式時間戳的正則表達式
-    QRegularExpression srtTimestampRegex;
-    // 用於識別 SRT 序號行的正則表達式
-    QRegularExpression sequenceNumberRegex;
-    // 累積的字幕內容，用於整合顯示在主視窗
+    // 預先轉錄接下來幾首曲目（0 表示關閉）
+    int transcriptionLookahead;
+    // 字幕狀態訊息（轉錄進度、錯誤），顯示在主視窗的字幕區塊
     QString currentSubtitles;
     // 用於恢復影片標題的計時器（在字幕跳轉通知後）
     QTimer* titleRestoreTimer;
+    // 使用者捲動字幕清單後暫停自動捲動的計時器
+    QTimer* subtitleScrollHoldTimer;
+    // 定期寫入播放狀態檢查點的計時器
+    QTimer* checkpointTimer;
+    // 最後寫入的播放狀態（沒有變化時不重寫）
+    PlaybackState lastCheckpoint;
 };
 
 // 結束標頭檔保護宏